@@ -0,0 +1,70 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_FILE_MAPPED_CPU_BUFFER_H_INCLUDED_
+#define _NBL_ASSET_C_FILE_MAPPED_CPU_BUFFER_H_INCLUDED_
+
+#include "nbl/system/IFile.h"
+
+#include "nbl/asset/ICPUBuffer.h"
+
+namespace nbl::asset
+{
+
+//! ICPUBuffer over a range of a file's read-only memory mapping
+/**
+	Nothing gets copied, the OS pages the file in as the contents get accessed, so untouched parts of large files never occupy RAM.
+	The content hash is only computed once something asks for it, because hashing would page the whole range in.
+
+	The mapping is read-only, the non-const `getPointer` makes a private copy of the range first.
+	Discarding the content drops the reference to the file, which unmaps it once nothing else holds it.
+*/
+class CFileMappedCPUBuffer final : public ICPUBuffer
+{
+	public:
+		//! Fails if the file is not mapped (was not opened with `IFile::ECF_MAPPABLE`) or the range is out of bounds
+		static inline core::smart_refctd_ptr<CFileMappedCPUBuffer> create(core::smart_refctd_ptr<system::IFile>&& file, const size_t offset, const size_t size)
+		{
+			if (!file || offset+size>file->getSize() || size==0ull)
+				return nullptr;
+			const system::IFile* constFile = file.get();
+			const auto* mapped = reinterpret_cast<const uint8_t*>(constFile->getMappedPointer());
+			if (!mapped)
+				return nullptr;
+
+			auto retval = new CFileMappedCPUBuffer(std::move(file),const_cast<uint8_t*>(mapped)+offset,size);
+			retval->setContentHashLazily();
+			return core::smart_refctd_ptr<CFileMappedCPUBuffer>(retval,core::dont_grab);
+		}
+		static inline core::smart_refctd_ptr<CFileMappedCPUBuffer> create(core::smart_refctd_ptr<system::IFile>&& file)
+		{
+			const size_t size = file ? file->getSize():0ull;
+			return create(std::move(file),0ull,size);
+		}
+
+		//! Null after `discardContent`
+		inline const system::IFile* getBackingFile() const {return m_file.get();}
+
+	protected:
+		inline CFileMappedCPUBuffer(core::smart_refctd_ptr<system::IFile>&& file, void* mapped, const size_t size) : ICPUBuffer(size,mapped), m_file(std::move(file))
+		{
+			m_readOnlyStorage = true;
+		}
+		virtual inline ~CFileMappedCPUBuffer()
+		{
+			freeData();
+		}
+
+		inline void freeData() override
+		{
+			m_file = nullptr;
+			ICPUBuffer::data = nullptr;
+			m_creationParams.size = 0ull;
+		}
+
+		core::smart_refctd_ptr<system::IFile> m_file;
+};
+
+}
+
+#endif
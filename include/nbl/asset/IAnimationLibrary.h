@@ -29,17 +29,16 @@ class IAnimationLibrary : public virtual core::IReferenceCounted
 
 		struct alignas(8) Keyframe
 		{
-				Keyframe() : scale(0ull) // TODO: initialize scale to 1.f
+				Keyframe() : scale(core::rgb32f_to_rgb18e7s3(1.f,1.f,1.f))
 				{
 					translation[2] = translation[1] = translation[0] = 0.f;
-					quat = core::vectorSIMDu32(128u,128u,128u,255u); // should be (0,0,0,1) encoded
+					quat = core::vectorSIMDu32(0u,0u,0u,127u); // (0,0,0,1) encoded
 				}
 				Keyframe(const core::vectorSIMDf& _scale, const core::quaternion& _quat, const CQuantQuaternionCache* quantCache, const core::vectorSIMDf& _translation)
 				{
 					std::copy(_translation.pointer,_translation.pointer+3,translation);
-					quat = quantCache->template quantize<decltype(quat)>(_quat);
-					// TODO: encode to RGB18E7S3
-					//scale = ;
+					quat = quantCache->template quantize<EF_R8G8B8A8_SNORM>(_quat);
+					scale = core::rgb32f_to_rgb18e7s3(_scale.pointer);
 				}
 
 				inline core::quaternion getRotation() const
@@ -50,10 +49,21 @@ class IAnimationLibrary : public virtual core::IReferenceCounted
 					auto q = core::normalize(core::vectorSIMDf(out[0],out[1],out[2],out[3]));
 					return reinterpret_cast<const core::quaternion*>(&q)[0];
 				}
+				//! Raw R8G8B8A8_SNORM rotation, for decoding many keyframes at once
+				inline const CQuantQuaternionCache::Vector8u4& getQuantizedRotation() const
+				{
+					return quat;
+				}
 
 				inline core::vectorSIMDf getScale() const
 				{
-					return core::vectorSIMDf(0.f/0.f); // TODO: decode from RGB18E7S3
+					const auto decoded = core::rgb18e7s3_to_rgb32f(scale);
+					return core::vectorSIMDf(decoded.x,decoded.y,decoded.z);
+				}
+
+				inline const float* getTranslation() const
+				{
+					return translation;
 				}
 
 			private:
@@ -96,7 +106,7 @@ class IAnimationLibrary : public virtual core::IReferenceCounted
 				}
 				inline E_INTERPOLATION_MODE getInterpolationMode() const
 				{
-					return data[1]&EIM_MASK;
+					return static_cast<E_INTERPOLATION_MODE>(data[1]&EIM_MASK);
 				}
 
 			private:
@@ -91,16 +91,34 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
             Loaders() : perFileExt{&refCtdGreet<IAssetLoader>, &refCtdDispose<IAssetLoader>} {}
 
             core::vector<core::smart_refctd_ptr<IAssetLoader> > vector;
+            //! Parallel to `vector`, empty for loaders which can only be probed with `isALoadableFileFormat`
+            core::vector<std::span<const IAssetLoader::SFileSignature>> signatures;
+            //! How many bytes from the start of a file need to be read to match all signatures
+            size_t signaturePrefixSize = 0ull;
             //! The key is file extension
             core::CMultiObjectCache<std::string, IAssetLoader*, std::vector> perFileExt;
 
             void pushToVector(core::smart_refctd_ptr<IAssetLoader>&& _loader)
 			{
+                const auto loaderSignatures = _loader->getFileSignatures();
+                for (const auto& signature : loaderSignatures)
+                {
+                    assert(signature.getPrefixSize()<=IAssetLoader::SFileSignature::MaxProbePrefix);
+                    signaturePrefixSize = std::max(signaturePrefixSize,signature.getPrefixSize());
+                }
+                signatures.push_back(loaderSignatures);
                 vector.push_back(std::move(_loader));
             }
             void eraseFromVector(decltype(vector)::const_iterator _loaderItr)
 			{
+                if (_loaderItr==vector.end())
+                    return;
+                signatures.erase(signatures.begin()+std::distance(vector.cbegin(),_loaderItr));
                 vector.erase(_loaderItr);
+                signaturePrefixSize = 0ull;
+                for (const auto& loaderSignatures : signatures)
+                for (const auto& signature : loaderSignatures)
+                    signaturePrefixSize = std::max(signaturePrefixSize,signature.getPrefixSize());
             }
         } m_loaders;
 
@@ -193,10 +211,22 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted
                 _override->getLoadFilename(filePath, m_system.get(), ctx, _hierarchyLevel);
             }
             
+            // a file which isn't mappable would make the loaders fall back to copying into buffers
+            core::bitflag<system::IFile::E_CREATE_FLAGS> createFlags = system::IFile::ECF_READ;
+            if (ctx.params.loaderFlags&IAssetLoader::ELPF_ALLOW_FILE_MAPPED_BUFFERS)
+                createFlags |= system::IFile::ECF_MAPPABLE;
             system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
-            m_system->createFile(future, filePath, system::IFile::ECF_READ);
+            m_system->createFile(future, filePath, createFlags);
             if (auto file=future.acquire())
                 return getAssetInHierarchy_impl(file->get(), filePath.string(), ctx.params, _hierarchyLevel, _override);
+            // mapping can fail where plain reads don't (empty files for one)
+            if (createFlags.hasFlags(system::IFile::ECF_MAPPABLE))
+            {
+                system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> unmappedFuture;
+                m_system->createFile(unmappedFuture, filePath, system::IFile::ECF_READ);
+                if (auto file=unmappedFuture.acquire())
+                    return getAssetInHierarchy_impl(file->get(), filePath.string(), ctx.params, _hierarchyLevel, _override);
+            }
             return SAssetBundle(0);
         }
 
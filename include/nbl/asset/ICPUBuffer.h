@@ -4,6 +4,7 @@
 #ifndef _NBL_ASSET_I_CPU_BUFFER_H_INCLUDED_
 #define _NBL_ASSET_I_CPU_BUFFER_H_INCLUDED_
 
+#include <atomic>
 #include <type_traits>
 
 #include "nbl/core/alloc/null_allocator.h"
@@ -41,11 +42,27 @@ class ICPUBuffer : public asset::IBuffer, public IPreHashed
             m_creationParams.size = sizeInBytes;
         }
 
+        //! The clone shares the storage until either of them calls the non-const `getPointer`, the writer then gets a private copy
         core::smart_refctd_ptr<IAsset> clone(uint32_t = ~0u) const override final
         {
-            auto cp = core::make_smart_refctd_ptr<ICPUBuffer>(m_creationParams.size);
-            memcpy(cp->getPointer(), data, m_creationParams.size);
-            cp->setContentHash(getContentHash());
+            core::smart_refctd_ptr<ICPUBuffer> cp;
+            if (missingContent())
+                cp = core::smart_refctd_ptr<ICPUBuffer>(new ICPUBuffer(0ull,nullptr),core::dont_grab);
+            // a private copy has already diverged from the storage, it can't be shared without copying it again
+            else if (m_cowPrivate.load(std::memory_order_acquire))
+            {
+                cp = core::make_smart_refctd_ptr<ICPUBuffer>(m_creationParams.size);
+                memcpy(cp->getPointer(), getPointer(), m_creationParams.size);
+            }
+            else
+            {
+                // always alias the buffer owning the storage, so chains of clones don't form
+                const ICPUBuffer* owner = m_cowSource ? m_cowSource.get():this;
+                owner->m_cowSharers++;
+                cp = core::smart_refctd_ptr<ICPUBuffer>(new ICPUBuffer(core::smart_refctd_ptr<const ICPUBuffer>(owner)),core::dont_grab);
+            }
+            // the content is the same, so a hash which hasn't been computed yet can stay that way
+            cp->setContentHashFrom(*this);
             return cp;
         }
 
@@ -58,20 +75,40 @@ class ICPUBuffer : public asset::IBuffer, public IPreHashed
         inline core::blake3_hash_t computeContentHash() const override
         {
 			core::blake3_hasher hasher;
-            if (data)
-                hasher.update(data,m_creationParams.size);
+            if (const void* content=getPointer(); content)
+                hasher.update(content,m_creationParams.size);
 			return static_cast<core::blake3_hash_t>(hasher);
         }
 
-        inline bool missingContent() const override {return !data;}
+        inline bool missingContent() const override {return !getPointer();}
 
-        //! Returns pointer to data.
-        const void* getPointer() const {return data;}
+        //! Returns pointer to data, never copies so it's safe to call from many threads at once.
+        const void* getPointer() const
+        {
+            if (m_contentDiscarded)
+                return nullptr;
+            if (void* privateCopy=m_cowPrivate.load(std::memory_order_acquire); privateCopy)
+                return privateCopy;
+            if (m_cowSource)
+                return m_cowSource->data;
+            return data;
+        }
+        //! Makes the content private first if it's shared with clones (or read-only)
+        /**
+        Concurrent calls are safe, they all return the same private copy. Writes through it still need the usual external synchronization.
+        */
         void* getPointer() 
         { 
             assert(isMutable());
+            if (m_contentDiscarded)
+                return nullptr;
+            makeContentPrivate();
+            if (void* privateCopy=m_cowPrivate.load(std::memory_order_acquire); privateCopy)
+                return privateCopy;
             return data;
         }
+        //! Whether any clones still alias this buffer's storage
+        inline bool isStorageShared() const {return m_cowSharers.load()!=0u || (m_cowSource && !m_cowPrivate.load(std::memory_order_acquire));}
         
         inline core::bitflag<E_USAGE_FLAGS> getUsageFlags() const
         {
@@ -91,6 +128,12 @@ class ICPUBuffer : public asset::IBuffer, public IPreHashed
         }
 
     protected:
+        virtual inline ~ICPUBuffer()
+        {
+            releaseCopyOnWrite();
+            ICPUBuffer::freeData();
+        }
+
         inline IAsset* getDependant_impl(const size_t ix) override
         {
             return nullptr;
@@ -98,6 +141,13 @@ class ICPUBuffer : public asset::IBuffer, public IPreHashed
 
         inline void discardContent_impl() override
         {
+            releaseCopyOnWrite();
+            // clones still read the storage, so it only gets freed with this buffer, which the last of the clones keeps alive
+            if (m_cowSharers.load())
+            {
+                m_contentDiscarded = true;
+                return;
+            }
             return freeData();
         }
 
@@ -113,6 +163,62 @@ class ICPUBuffer : public asset::IBuffer, public IPreHashed
         }
 
         void* data;
+        // set by derived classes whose storage must never be written to, such as file mappings
+        bool m_readOnlyStorage = false;
+
+    private:
+        //! Copy-on-write clone aliasing the `source`'s storage
+        inline ICPUBuffer(core::smart_refctd_ptr<const ICPUBuffer>&& source) : asset::IBuffer({source->getSize(),EUF_TRANSFER_DST_BIT}), data(nullptr), m_cowSource(std::move(source)) {}
+
+        inline void makeContentPrivate()
+        {
+            if (m_cowPrivate.load(std::memory_order_acquire))
+                return;
+
+            const void* shared = nullptr;
+            if (m_cowSource)
+                shared = m_cowSource->data;
+            // the owner of shared storage can't write to it either, it keeps the storage intact for the clones
+            else if (data && (m_readOnlyStorage || m_cowSharers.load()))
+                shared = data;
+            if (!shared)
+                return;
+
+            void* privateCopy = _NBL_ALIGNED_MALLOC(m_creationParams.size,_NBL_SIMD_ALIGNMENT);
+            memcpy(privateCopy,shared,m_creationParams.size);
+            // when many threads race to make the copy, the first one wins and the others throw theirs away
+            void* expected = nullptr;
+            if (m_cowPrivate.compare_exchange_strong(expected,privateCopy,std::memory_order_acq_rel))
+            {
+                // readers in other threads could still be looking at the owner's storage, so the reference stays until `releaseCopyOnWrite`
+                if (m_cowSource)
+                    m_cowSource->m_cowSharers--;
+            }
+            else
+                _NBL_ALIGNED_FREE(privateCopy);
+        }
+        inline void releaseCopyOnWrite()
+        {
+            void* privateCopy = m_cowPrivate.exchange(nullptr,std::memory_order_acq_rel);
+            if (m_cowSource)
+            {
+                // a clone with a private copy stopped counting as a sharer when it made it
+                if (!privateCopy)
+                    m_cowSource->m_cowSharers--;
+                m_cowSource = nullptr;
+            }
+            if (privateCopy)
+                _NBL_ALIGNED_FREE(privateCopy);
+        }
+
+        // storage owner this buffer aliases, kept until destruction or discard even after a write made the content private
+        core::smart_refctd_ptr<const ICPUBuffer> m_cowSource = nullptr;
+        // copy made on the first write when the storage is shared (or read-only)
+        std::atomic<void*> m_cowPrivate = nullptr;
+        // number of clones aliasing `data`
+        mutable std::atomic_uint32_t m_cowSharers = 0u;
+        // set when an owner still aliased by clones discards its content
+        bool m_contentDiscarded = false;
 };
 
 
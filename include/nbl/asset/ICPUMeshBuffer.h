@@ -310,10 +310,11 @@ class ICPUMeshBuffer final : public IMeshBuffer<ICPUBuffer,ICPUDescriptorSet,ICP
         \return Pointer to index array. */
         inline const void* getIndices() const
         {
-            if (!m_indexBufferBinding.buffer)
+            const ICPUBuffer* buffer = m_indexBufferBinding.buffer.get();
+            if (!buffer)
                 return nullptr;
 
-            return reinterpret_cast<const uint8_t*>(m_indexBufferBinding.buffer->getPointer()) + m_indexBufferBinding.offset;
+            return reinterpret_cast<const uint8_t*>(buffer->getPointer()) + m_indexBufferBinding.offset;
         }
 
         //! Accesses given index of mapped position attribute buffer.
@@ -344,33 +345,20 @@ class ICPUMeshBuffer final : public IMeshBuffer<ICPUBuffer,ICPUDescriptorSet,ICP
         {
             assert(isMutable());
 
-            if (!m_pipeline)
-                return nullptr;
-
-            const auto& cachedParams = m_pipeline->getCachedCreationParams();
-            const auto& vtxInputParams = cachedParams.vertexInput;
-            if (!isAttributeEnabled(attrId))
-                return nullptr;
-
-            const uint32_t bindingNum = vtxInputParams.attributes[attrId].binding;
-            if (!isVertexAttribBufferBindingEnabled(bindingNum))
-                return nullptr;
-
-            ICPUBuffer* mappedAttrBuf = m_vertexBufferBindings[bindingNum].buffer.get();
+            int64_t ix;
+            ICPUBuffer* mappedAttrBuf = const_cast<ICPUBuffer*>(getAttribBufferAndOffset(attrId,ix));
             if (!mappedAttrBuf)
                 return nullptr;
-
-            int64_t ix = vtxInputParams.bindings[bindingNum].inputRate!=SVertexInputBindingParams::EVIR_PER_VERTEX ? baseInstance:baseVertex;
-            ix *= vtxInputParams.bindings[bindingNum].stride;
-            ix += (m_vertexBufferBindings[bindingNum].offset + vtxInputParams.attributes[attrId].relativeOffset);
-            if (ix < 0 || static_cast<uint64_t>(ix) >= mappedAttrBuf->getSize())
-                return nullptr;
-
+            // the non-const `getPointer` can copy shared storage, so only writers should go through it
             return reinterpret_cast<uint8_t*>(mappedAttrBuf->getPointer()) + ix;
         }
         inline const uint8_t* getAttribPointer(uint32_t attrId) const
         {
-            return const_cast<typename std::decay<decltype(*this)>::type&>(*this).getAttribPointer(attrId);
+            int64_t ix;
+            const ICPUBuffer* mappedAttrBuf = getAttribBufferAndOffset(attrId,ix);
+            if (!mappedAttrBuf)
+                return nullptr;
+            return reinterpret_cast<const uint8_t*>(mappedAttrBuf->getPointer()) + ix;
         }
 
         static inline bool getAttribute(core::vectorSIMDf& output, const void* src, E_FORMAT format)
@@ -427,7 +415,8 @@ class ICPUMeshBuffer final : public IMeshBuffer<ICPUBuffer,ICPUDescriptorSet,ICP
 
             const uint8_t* src = getAttribPointer(attrId);
             src += ix * getAttribStride(attrId);
-            if (src >= reinterpret_cast<const uint8_t*>(m_vertexBufferBindings[bindingId].buffer->getPointer()) + m_vertexBufferBindings[bindingId].buffer->getSize())
+            const ICPUBuffer* buf = m_vertexBufferBindings[bindingId].buffer.get();
+            if (src >= reinterpret_cast<const uint8_t*>(buf->getPointer()) + buf->getSize())
                 return false;
 
             return getAttribute(output, src, getAttribFormat(attrId));
@@ -587,13 +576,18 @@ class ICPUMeshBuffer final : public IMeshBuffer<ICPUBuffer,ICPUDescriptorSet,ICP
             if (!m_inverseBindPoseBufferBinding.buffer)
                 return nullptr;
 
-            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(m_inverseBindPoseBufferBinding.buffer->getPointer());
+            const ICPUBuffer* buffer = m_inverseBindPoseBufferBinding.buffer.get();
+            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(buffer->getPointer());
             return reinterpret_cast<const core::matrix3x4SIMD*>(ptr+m_inverseBindPoseBufferBinding.offset);
         }
         inline core::matrix3x4SIMD* getInverseBindPoses()
         {
             assert(isMutable());
-            return const_cast<core::matrix3x4SIMD*>(const_cast<const ICPUMeshBuffer*>(this)->getInverseBindPoses());
+            if (!m_inverseBindPoseBufferBinding.buffer)
+                return nullptr;
+
+            uint8_t* ptr = reinterpret_cast<uint8_t*>(m_inverseBindPoseBufferBinding.buffer->getPointer());
+            return reinterpret_cast<core::matrix3x4SIMD*>(ptr+m_inverseBindPoseBufferBinding.offset);
         }
 
         //!
@@ -602,13 +596,18 @@ class ICPUMeshBuffer final : public IMeshBuffer<ICPUBuffer,ICPUDescriptorSet,ICP
             if (!m_jointAABBBufferBinding.buffer)
                 return nullptr;
 
-            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(m_jointAABBBufferBinding.buffer->getPointer());
+            const ICPUBuffer* buffer = m_jointAABBBufferBinding.buffer.get();
+            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(buffer->getPointer());
             return reinterpret_cast<const core::aabbox3df*>(ptr+ m_jointAABBBufferBinding.offset);
         }
         inline core::aabbox3df* getJointAABBs()
         {
             assert(isMutable());
-            return const_cast<core::aabbox3df*>(const_cast<const ICPUMeshBuffer*>(this)->getJointAABBs());
+            if (!m_jointAABBBufferBinding.buffer)
+                return nullptr;
+
+            uint8_t* ptr = reinterpret_cast<uint8_t*>(m_jointAABBBufferBinding.buffer->getPointer());
+            return reinterpret_cast<core::aabbox3df*>(ptr+m_jointAABBBufferBinding.offset);
         }
 
         //! CLASS IS DEPRECATED ANYWAY
@@ -616,6 +615,36 @@ class ICPUMeshBuffer final : public IMeshBuffer<ICPUBuffer,ICPUDescriptorSet,ICP
 
 	protected:
 		inline IAsset* getDependant_impl(const size_t ix) override {return nullptr;}
+
+    private:
+        //! Buffer the attribute reads from and the byte offset of its first element (`baseVertex` or `baseInstance` included), nullptr if it's not bound or out of range
+        inline const ICPUBuffer* getAttribBufferAndOffset(const uint32_t attrId, int64_t& outOffset) const
+        {
+            if (!m_pipeline)
+                return nullptr;
+
+            const auto& cachedParams = m_pipeline->getCachedCreationParams();
+            const auto& vtxInputParams = cachedParams.vertexInput;
+            if (!isAttributeEnabled(attrId))
+                return nullptr;
+
+            const uint32_t bindingNum = vtxInputParams.attributes[attrId].binding;
+            if (!isVertexAttribBufferBindingEnabled(bindingNum))
+                return nullptr;
+
+            const ICPUBuffer* mappedAttrBuf = m_vertexBufferBindings[bindingNum].buffer.get();
+            if (!mappedAttrBuf)
+                return nullptr;
+
+            int64_t ix = vtxInputParams.bindings[bindingNum].inputRate!=SVertexInputBindingParams::EVIR_PER_VERTEX ? baseInstance:baseVertex;
+            ix *= vtxInputParams.bindings[bindingNum].stride;
+            ix += (m_vertexBufferBindings[bindingNum].offset + vtxInputParams.attributes[attrId].relativeOffset);
+            if (ix < 0 || static_cast<uint64_t>(ix) >= mappedAttrBuf->getSize())
+                return nullptr;
+
+            outOffset = ix;
+            return mappedAttrBuf;
+        }
 };
 
 }
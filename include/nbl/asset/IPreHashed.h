@@ -7,6 +7,9 @@
 #include "nbl/core/hash/blake.h"
 #include "nbl/asset/IAsset.h"
 
+#include <atomic>
+#include <thread>
+
 namespace nbl::asset
 {
 //! Sometimes an asset is too complex or big to be hashed, so we need a hash to be set explicitly.
@@ -16,13 +19,25 @@ class IPreHashed : public IAsset
 	public:
 		constexpr static inline core::blake3_hash_t INVALID_HASH = { 0xaf,0x13,0x49,0xb9,0xf5,0xf9,0xa1,0xa6,0xa0,0x40,0x4d,0xea,0x36,0xdc,0xc9,0x49,0x9b,0xcb,0x25,0xc9,0xad,0xc1,0x12,0xb7,0xcc,0x9a,0x93,0xca,0xe4,0x1f,0x32,0x62 };
 		//
-		inline const core::blake3_hash_t& getContentHash() const {return m_contentHash;}
+		inline const core::blake3_hash_t& getContentHash() const
+		{
+			resolveLazyContentHash();
+			return m_contentHash;
+		}
 		//
 		inline void setContentHash(const core::blake3_hash_t& hash)
 		{
 			if (!isMutable())
 				return;
 			m_contentHash = hash;
+			m_contentHashState.store(EHS_VALID,std::memory_order_release);
+		}
+		//! Defers `computeContentHash` until the hash is first requested, for content that is expensive to touch (e.g. file mappings)
+		inline void setContentHashLazily()
+		{
+			if (!isMutable())
+				return;
+			m_contentHashState.store(EHS_PENDING,std::memory_order_release);
 		}
 
 		//
@@ -36,7 +51,11 @@ class IPreHashed : public IAsset
 		inline void discardContent()
 		{
 			if (isMutable() && !missingContent())
+			{
+				// the hash has to outlive the content
+				resolveLazyContentHash();
 				discardContent_impl();
+			}
 		}
 
 		static inline void discardDependantsContents(const std::span<IAsset*> roots)
@@ -124,9 +143,42 @@ class IPreHashed : public IAsset
 
 		virtual void discardContent_impl() = 0;
 
+		//! For copies of `other`'s content, a hash `other` still defers stays deferred instead of getting computed now
+		inline void setContentHashFrom(const IPreHashed& other)
+		{
+			if (other.m_contentHashState.load(std::memory_order_acquire)==EHS_PENDING)
+				setContentHashLazily();
+			else
+				setContentHash(other.getContentHash());
+		}
+
 	private:
+		enum E_HASH_STATE : uint8_t
+		{
+			EHS_VALID,
+			EHS_PENDING,
+			EHS_COMPUTING
+		};
+		// only one thread computes a pending hash, the others wait for it
+		inline void resolveLazyContentHash() const
+		{
+			uint8_t state = EHS_PENDING;
+			if (m_contentHashState.compare_exchange_strong(state,EHS_COMPUTING,std::memory_order_acquire))
+			{
+				m_contentHash = computeContentHash();
+				m_contentHashState.store(EHS_VALID,std::memory_order_release);
+				return;
+			}
+			while (state==EHS_COMPUTING)
+			{
+				std::this_thread::yield();
+				state = m_contentHashState.load(std::memory_order_acquire);
+			}
+		}
+
 		// The initial value is a hash of an "as if" of a zero-length array
-		core::blake3_hash_t m_contentHash = static_cast<core::blake3_hash_t>(core::blake3_hasher{});
+		mutable core::blake3_hash_t m_contentHash = static_cast<core::blake3_hash_t>(core::blake3_hasher{});
+		mutable std::atomic_uint8_t m_contentHashState = EHS_VALID;
 };
 }
 
@@ -21,6 +21,7 @@
 
 // base
 #include "nbl/asset/ICPUBuffer.h"
+#include "nbl/asset/CFileMappedCPUBuffer.h"
 #include "nbl/asset/IMesh.h" //depr
 
 // images
@@ -81,6 +81,8 @@ class NBL_API2 IAssetLoader : public virtual core::IReferenceCounted
 			a way that it'll look correctly in right-handed camera system. If it isn't set, compatibility with 
 			left-handed coordinate camera is assumed.
 			E_LOADER_PARAMETER_FLAGS::ELPF_DONT_COMPILE_GLSL means that GLSL won't be compiled to SPIR-V if it is loaded or generated.
+			E_LOADER_PARAMETER_FLAGS::ELPF_ALLOW_FILE_MAPPED_BUFFERS means that buffers may keep the (mappable) file alive and page its contents in on demand,
+			such buffers are read-only until cloned.
 		*/
 
 		enum E_LOADER_PARAMETER_FLAGS : uint64_t
@@ -88,7 +90,8 @@ class NBL_API2 IAssetLoader : public virtual core::IReferenceCounted
 			ELPF_NONE = 0,											//!< default value, it doesn't do anything
 			ELPF_RIGHT_HANDED_MESHES = 0x1,							//!< specifies that a mesh will be flipped in such a way that it'll look correctly in right-handed camera system
 			ELPF_DONT_COMPILE_GLSL = 0x2,							//!< it states that GLSL won't be compiled to SPIR-V if it is loaded or generated
-			ELPF_LOAD_METADATA_ONLY = 0x4							//!< it forces the loader to not load the entire scene for performance in special cases to fetch metadata.
+			ELPF_LOAD_METADATA_ONLY = 0x4,							//!< it forces the loader to not load the entire scene for performance in special cases to fetch metadata.
+			ELPF_ALLOW_FILE_MAPPED_BUFFERS = 0x8					//!< lets the loader return `CFileMappedCPUBuffer`s referencing the file's read-only mapping instead of copying its contents
 		};
 
 		struct SAssetLoadParams
@@ -274,6 +277,44 @@ class NBL_API2 IAssetLoader : public virtual core::IReferenceCounted
 		};
 
 	public:
+		//! Cheap identification of a format from the start of a file.
+		/**
+			IAssetManager reads the first bytes of a file once and matches them against the signatures of all loaders,
+			so a loader with signatures never gets its `isALoadableFileFormat` called (unless a probe asks for it),
+			and loaders whose signature matched get tried before the ones which have none.
+
+			A signature is either `magic` bytes expected at `offset`, or a `probe` on the file's prefix when a fixed magic isn't enough.
+		*/
+		struct SFileSignature
+		{
+			enum class E_MATCH : uint8_t
+			{
+				NO,
+				YES,
+				//! the prefix isn't enough to decide, makes IAssetManager call `isALoadableFileFormat`
+				MAYBE
+			};
+			//! How much of the file a probe gets to see at most.
+			static inline constexpr size_t MaxProbePrefix = 4096ull;
+
+			size_t offset = 0ull;
+			std::string_view magic = {};
+			//! If set takes precedence over `magic`, gets the first `min(fileSize,MaxProbePrefix)` bytes of the file.
+			E_MATCH(*probe)(const std::span<const uint8_t> prefix, const size_t fileSize) = nullptr;
+
+			inline size_t getPrefixSize() const {return probe ? MaxProbePrefix:(offset+magic.size());}
+			inline E_MATCH match(const std::span<const uint8_t> prefix, const size_t fileSize) const
+			{
+				if (probe)
+					return probe(prefix,fileSize);
+				if (offset+magic.size()>prefix.size())
+					return E_MATCH::NO;
+				return memcmp(prefix.data()+offset,magic.data(),magic.size())==0 ? E_MATCH::YES:E_MATCH::NO;
+			}
+		};
+		//! Any one of them matching means the file is loadable, empty means the loader can only be probed with `isALoadableFileFormat`.
+		virtual std::span<const SFileSignature> getFileSignatures() const { return {}; }
+
 		//! Check if the file might be loaded by this class
 		/** Check might look into the file.
 		\param file File handle to check.
@@ -9,6 +9,7 @@
 #include <nbl/core/declarations.h>
 
 #include <ostream>
+#include <chrono>
 
 #include <nbl/asset/utils/ICPUVirtualTexture.h>
 #include <nbl/asset/material_compiler/IR.h>
@@ -607,7 +608,32 @@ public:
 		};
 		core::unordered_map<VTallocKey, instr_stream::VTID, VTallocKeyHash> VTallocMap;
 
+		// roots get compiled in parallel with their own contexts, which only record the textures they need,
+		// the actual VT allocations happen in root order when the results get merged so the VT layout stays deterministic
+		bool deferVTallocs = false;
+		core::vector<VTallocKey> deferredVTallocs;
+
+		static inline instr_stream::VTID makeDeferredVTID(const uint32_t _ix)
+		{
+			auto retval = instr_stream::VTID::invalid();
+			retval.origsize_x = (_ix+1u)&0xffffu;
+			retval.origsize_y = (_ix+1u)>>16u;
+			return retval;
+		}
+		//! @returns ~0u if the VTID is not a placeholder handed out by a context with deferred VT allocation
+		static inline uint32_t getDeferredVTIDIndex(const instr_stream::VTID& _vtid)
+		{
+			if (!instr_stream::VTID::is_invalid(_vtid))
+				return ~0u;
+			return static_cast<uint32_t>(_vtid.origsize_x|(_vtid.origsize_y<<16u))-1u;
+		}
+
+		instr_stream::VTID packTexture(const VTallocKey& _key);
+
 	public:
+		//! Upper bound on the threads used by `compile` to process the roots, 0 means `std::thread::hardware_concurrency()`
+		uint32_t maxCompileThreads = 0u;
+
 		struct VT
 		{
 			using addr_t = asset::ICPUVirtualTexture::SMasterTextureData;
@@ -705,8 +731,20 @@ public:
 		core::unordered_set<instr_stream::E_OPCODE> opcodes;
 		core::unordered_set<instr_stream::E_NDF> NDFs;
 
-		//one element for each input IR root node
+		//one element for each input IR root node, roots which compiled to identical instructions share the same streams
 		core::unordered_map<const IR::INode*, instr_streams_t> streams;
+		uint32_t deduplicatedStreamCount;
+
+		//! wall-clock time spent in each phase of `compile`
+		struct SPhaseTimings
+		{
+			// per-root traversals, done in parallel
+			std::chrono::nanoseconds traversal;
+			// VT allocation, BSDF data remapping and stream deduplication
+			std::chrono::nanoseconds merge;
+			// opcode, NDF and parameter statistics plus the preprocessor definitions
+			std::chrono::nanoseconds analysis;
+		} timings;
 
 		//has to go after #version and before required user-provided descriptors and functions
 		std::string fragmentShaderSource_declarations;
@@ -717,6 +755,12 @@ public:
 	void debugPrint(std::ostream& _out, const result_t::instr_streams_t& _streams, const result_t& _res, const SContext* _ctx) const;
 
 	virtual result_t compile(SContext* _ctx, IR* _ir, E_GENERATOR_STREAM_TYPE _generatorChoiceStream=EGST_PRESENT);
+
+protected:
+	// everything a single root compiles to, BSDF data indices and VTIDs are local to `ctx` until the merge
+	struct SRootCompilation;
+	void compileRoot(SRootCompilation& _out, const IR::INode* _root, IR* _scratchIR, E_GENERATOR_STREAM_TYPE _generatorChoiceStream);
+	result_t::instr_streams_t mergeRoot(result_t& _res, SContext* _ctx, SRootCompilation& _compiled, core::unordered_map<size_t,core::vector<result_t::instr_streams_t>>& _streamCache) const;
 };
 
 }
@@ -9,97 +9,99 @@
 #include <nbl/core/containers/refctd_dynamic_array.h>
 #include <nbl/asset/ICPUImageView.h>
 #include <nbl/asset/ICPUSampler.h>
-#include <nbl/core/alloc/LinearAddressAllocator.h>
+#include <nbl/core/math/intutil.h>
+#include <nbl/core/algorithm/utility.h>
 
 namespace nbl::asset::material_compiler
 {
 
 class IR : public core::IReferenceCounted
 {
+public:
+    //! Nodes are addressed by a 32bit offset into the (paged) backing memory
+    using node_handle_t = uint32_t;
+    _NBL_STATIC_INLINE_CONSTEXPR node_handle_t INVALID_NODE_HANDLE = ~0u;
+
+private:
+    //! Growable arena made out of fixed size pages which never move, so the address of a node stays valid for the lifetime of the IR.
+    /** The handle of an allocation is its offset in a virtual contiguous address space of `pages.size()*PAGE_SIZE` bytes,
+    allocations never straddle pages and rewinding the cursor keeps the already allocated pages around for reuse.
+    */
     class SBackingMemManager
     {
-        _NBL_STATIC_INLINE_CONSTEXPR size_t INITIAL_MEM_SIZE = 1ull<<20;
-        _NBL_STATIC_INLINE_CONSTEXPR size_t MAX_MEM_SIZE = 1ull<<20;
-        _NBL_STATIC_INLINE_CONSTEXPR size_t ALIGNMENT = _NBL_SIMD_ALIGNMENT;
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t PAGE_SIZE_LOG2 = 16u;
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t PAGE_SIZE = 0x1u<<PAGE_SIZE_LOG2;
+        _NBL_STATIC_INLINE_CONSTEXPR uint32_t ALIGNMENT = _NBL_SIMD_ALIGNMENT;
 
-        uint8_t* mem;
-        size_t currSz;
-        using addr_alctr_t = core::LinearAddressAllocator<uint32_t>;
-        addr_alctr_t addrAlctr;
+        core::vector<uint8_t*> pages;
+        uint32_t cursor = 0u;
 
     public:
-        SBackingMemManager() : mem(nullptr), currSz(INITIAL_MEM_SIZE), addrAlctr(nullptr, 0u, 0u, ALIGNMENT, MAX_MEM_SIZE) {
-            mem = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(currSz, ALIGNMENT));
-        }
+        SBackingMemManager() = default;
         ~SBackingMemManager() {
-            _NBL_ALIGNED_FREE(mem);
+            for (auto* page : pages)
+                _NBL_ALIGNED_FREE(page);
         }
 
-        uint8_t* alloc(size_t bytes)
+        node_handle_t alloc(size_t bytes)
         {
-            auto addr = addrAlctr.alloc_addr(bytes, ALIGNMENT);
-            assert(addr != addr_alctr_t::invalid_address);
-            //TODO reallocation will invalidate all pointers to nodes, so...
-            //1) never reallocate (just have reasonably big buffer for nodes)
-            //2) make some node_handle class that will work as pointer but is based on offset instead of actual address
-            if (addr+bytes > currSz) {
-                size_t newSz = currSz<<1;
-                if (newSz > MAX_MEM_SIZE) {
-                    addrAlctr.free_addr(addr, bytes);
-                    return nullptr;
-                }
-
-                void* newMem = _NBL_ALIGNED_MALLOC(newSz, ALIGNMENT);
-                memcpy(newMem, mem, currSz);
-                _NBL_ALIGNED_FREE(mem);
-                mem = reinterpret_cast<uint8_t*>(newMem);
-                currSz = newSz;
+            assert(bytes <= PAGE_SIZE);
+            uint64_t addr = core::roundUp<uint64_t>(cursor, ALIGNMENT);
+            // don't straddle pages, skip to the next one
+            if ((addr&(PAGE_SIZE-1u))+bytes > PAGE_SIZE)
+                addr = core::roundUp<uint64_t>(addr, PAGE_SIZE);
+            if (addr+bytes > INVALID_NODE_HANDLE)
+                return INVALID_NODE_HANDLE;
+
+            const size_t pageIx = addr>>PAGE_SIZE_LOG2;
+            if (pageIx >= pages.size())
+            {
+                auto* page = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(PAGE_SIZE, ALIGNMENT));
+                if (!page)
+                    return INVALID_NODE_HANDLE;
+                pages.push_back(page);
             }
+            cursor = static_cast<uint32_t>(addr+bytes);
+
+            return static_cast<node_handle_t>(addr);
+        }
 
-            return mem+addr;
+        inline uint8_t* deref(const node_handle_t handle) const
+        {
+            assert(handle < cursor);
+            return pages[handle>>PAGE_SIZE_LOG2]+(handle&(PAGE_SIZE-1u));
         }
 
         uint32_t getAllocatedSize() const
         {
-            return addrAlctr.get_allocated_size();
+            return cursor;
         }
 
         void freeLastAllocatedBytes(uint32_t _bytes)
         {
-            assert(addrAlctr.get_allocated_size() >= _bytes);
-            const uint32_t newCursor = addrAlctr.get_allocated_size() - _bytes;
-            addrAlctr.reset(newCursor);
+            assert(cursor >= _bytes);
+            cursor -= _bytes;
         }
     };
 
 protected:
     ~IR()
     {
-        //call destructors on all nodes
-        for (auto* root : roots)
-        {
-            core::stack<decltype(root)> s;
-            s.push(root);
-            while (!s.empty())
-            {
-                auto* n = s.top();
-                s.pop();
-                for (auto* c : n->children)
-                    s.push(c);
-
-                if (!n->deinited) {
-                    n->~INode();
-                    n->deinited = true;
-                }
-            }
-        }
+        deinitTmpNodes();
+        //call destructors on all nodes, each exactly once even if shared between trees
+        for (const node_handle_t h : nodes)
+            getNode(h)->~INode();
     }
 
     template <typename NodeType, typename ...Args>
     NodeType* allocNode_impl(Args&& ...args)
     {
-        uint8_t* ptr = memMgr.alloc(sizeof(NodeType));
-        return new (ptr) NodeType(std::forward<Args>(args)...);
+        const node_handle_t handle = memMgr.alloc(sizeof(NodeType));
+        if (handle == INVALID_NODE_HANDLE)
+            return nullptr;
+        auto* node = new (memMgr.deref(handle)) NodeType(std::forward<Args>(args)...);
+        node->handle = handle;
+        return node;
     }
 
 public:
@@ -107,6 +109,9 @@ public:
 
     struct INode;
 
+    inline INode* getNode(const node_handle_t handle) { return reinterpret_cast<INode*>(memMgr.deref(handle)); }
+    inline const INode* getNode(const node_handle_t handle) const { return reinterpret_cast<const INode*>(memMgr.deref(handle)); }
+
     void deinitTmpNodes()
     {
         for (INode* n : tmp)
@@ -116,29 +121,52 @@ public:
         tmpSize = 0u;
     }
 
-    void addRootNode(INode* node)
+    //! Adds a fully constructed tree as a root, returns the root which should be used from now on.
+    /** A tree structurally identical to an already added one returns the existing root, so duplicate materials get compiled once.
+    Only whole trees get shared, never subtrees, because backends assign per-root state (such as texture prefetch registers) to every node.
+    */
+    INode* addRootNode(INode* node)
     {
-        roots.push_back(node);
+        auto& bucket = rootHashTable[hashTree(node)];
+        for (INode* root : bucket)
+        if (treesEquivalent(root,node))
+            return root;
+        bucket.push_back(node);
+        if (uniqueRoots.insert(node->handle).second)
+            roots.push_back(node);
+        return node;
     }
 
+    //! @returns nullptr if the node memory is exhausted
     template <typename NodeType, typename ...Args>
     NodeType* allocNode(Args&& ...args)
     {
         tmpSize = 0u;
-        return allocNode_impl<NodeType>(std::forward<Args>(args)...);
+        auto* node = allocNode_impl<NodeType>(std::forward<Args>(args)...);
+        if (node)
+            nodes.push_back(node->handle);
+        return node;
     }
+    //! The tree will not take part in hash-consing, because its contents are not known yet
+    /** @returns nullptr if the node memory is exhausted, nothing gets added as a root then. */
     template <typename NodeType, typename ...Args>
     NodeType* allocRootNode(Args&& ...args)
     {
         auto* root = allocNode<NodeType>(std::forward<Args>(args)...);
-        addRootNode(root);
+        if (!root)
+            return nullptr;
+        uniqueRoots.insert(root->handle);
+        roots.push_back(root);
         return root;
     }
+    //! @returns nullptr if the node memory is exhausted
     template <typename NodeType, typename ...Args>
     NodeType* allocTmpNode(Args&& ...args)
     {
         const uint32_t cursor = memMgr.getAllocatedSize();
         auto* node = allocNode_impl<NodeType>(std::forward<Args>(args)...);
+        if (!node)
+            return nullptr;
         tmp.push_back(node);
         tmpSize += (memMgr.getAllocatedSize() - cursor);
         return node;
@@ -161,8 +189,26 @@ public:
             float scale;
 
             bool operator==(const STextureSource& rhs) const { return image==rhs.image && sampler==rhs.sampler && scale==rhs.scale; }
+            inline void hash(size_t& seed) const
+            {
+                core::hash_combine(seed, image.get());
+                core::hash_combine(seed, sampler.get());
+                core::hash_combine(seed, scale);
+            }
         };
 
+        using color_t = core::vector3df_SIMD;
+
+        static inline bool constantsEqual(const float lhs, const float rhs) { return lhs==rhs; }
+        static inline bool constantsEqual(const color_t& lhs, const color_t& rhs) { return lhs.x==rhs.x && lhs.y==rhs.y && lhs.z==rhs.z; }
+        static inline void hashConstant(size_t& seed, const float c) { core::hash_combine(seed, c); }
+        static inline void hashConstant(size_t& seed, const color_t& c)
+        {
+            core::hash_combine(seed, c.x);
+            core::hash_combine(seed, c.y);
+            core::hash_combine(seed, c.z);
+        }
+
         enum E_PARAM_SOURCE
         {
             EPS_CONSTANT,
@@ -254,14 +300,22 @@ public:
                 switch (source)
                 {
                 case EPS_CONSTANT:
-                    return value.constant==value.constant;
+                    return constantsEqual(value.constant,rhs.value.constant);
                 case EPS_TEXTURE:
-                    return value.texture==value.texture;
+                    return value.texture==rhs.value.texture;
                 default: return false;
                 }
             }
+            inline void hash(size_t& seed) const
+            {
+                core::hash_combine<uint32_t>(seed, source);
+                if (source==EPS_CONSTANT)
+                    hashConstant(seed, value.constant);
+                else
+                    value.texture.hash(seed);
+            }
 
-            E_PARAM_SOURCE source;
+            E_PARAM_SOURCE source = EPS_CONSTANT;
             TextureOrConstant value;
         };
 
@@ -323,17 +377,37 @@ public:
             return a; 
         }
 
-        using color_t = core::vector3df_SIMD;
-
         explicit INode(E_SYMBOL s) : symbol(s) {}
         virtual ~INode() = default;
 
+        // copying a node's contents must never copy its address
+        INode& operator=(const INode& rhs)
+        {
+            children = rhs.children;
+            symbol = rhs.symbol;
+            return *this;
+        }
+
+        //! Hash of the node's own contents, the children only contribute their count (see `IR::hashTree`)
+        virtual size_t hash() const
+        {
+            size_t seed = std::hash<uint32_t>()(symbol);
+            core::hash_combine(seed, children.count);
+            return seed;
+        }
+        //! Equality of the node's own contents, same caveat about children as `hash()`
+        virtual bool isEquivalent(const INode* rhs) const
+        {
+            return symbol==rhs->symbol && children.count==rhs->children.count;
+        }
+
         // TODO: Why does every INode have children!? Leaf BxDFs do not need this!
         children_array_t children;
         E_SYMBOL symbol;
-        bool deinited = false;
+        node_handle_t handle = INVALID_NODE_HANDLE;
     };
 
+    //! @returns nullptr if the node memory is exhausted
     INode* copyNode(const INode* _rhs)
     {
         INode* node = nullptr;
@@ -342,22 +416,19 @@ public:
         case INode::ES_GEOM_MODIFIER:
         {
             auto* rhs = static_cast<const CGeomModifierNode*>(_rhs);
-            node = allocNode<CGeomModifierNode>(rhs->type);
-            *static_cast<CGeomModifierNode*>(node) = *rhs;
+            node = copyNodeAs<CGeomModifierNode>(rhs,rhs->type);
         }
             break;
         case INode::ES_EMISSION:
         {
             auto* rhs = static_cast<const CEmissionNode*>(_rhs);
-            node = allocNode<CEmissionNode>();
-            *static_cast<CEmissionNode*>(node) = *rhs;
+            node = copyNodeAs<CEmissionNode>(rhs);
         }
             break;
         case INode::ES_OPACITY:
         {
             auto* rhs = static_cast<const COpacityNode*>(_rhs);
-            node = allocNode<COpacityNode>();
-            *static_cast<COpacityNode*>(node) = *rhs;
+            node = copyNodeAs<COpacityNode>(rhs);
         }
             break;
         case INode::ES_BSDF:
@@ -369,42 +440,36 @@ public:
             case CBSDFNode::ET_MICROFACET_DIFFTRANS:
             {
                 auto* rhs = static_cast<const CMicrofacetDifftransBSDFNode*>(_rhs);
-                node = allocNode<CMicrofacetDifftransBSDFNode>();
-                *static_cast<CMicrofacetDifftransBSDFNode*>(node) = *rhs;
+                node = copyNodeAs<CMicrofacetDifftransBSDFNode>(rhs);
             }
             break;
             case CBSDFNode::ET_MICROFACET_DIFFUSE:
             {
                 auto* rhs = static_cast<const CMicrofacetDiffuseBSDFNode*>(_rhs);
-                node = allocNode<CMicrofacetDiffuseBSDFNode>();
-                *static_cast<CMicrofacetDiffuseBSDFNode*>(node) = *rhs;
+                node = copyNodeAs<CMicrofacetDiffuseBSDFNode>(rhs);
             }
             break;
             case CBSDFNode::ET_MICROFACET_SPECULAR:
             {
                 auto* rhs = static_cast<const CMicrofacetSpecularBSDFNode*>(_rhs);
-                node = allocNode<CMicrofacetSpecularBSDFNode>();
-                *static_cast<CMicrofacetSpecularBSDFNode*>(node) = *rhs;
+                node = copyNodeAs<CMicrofacetSpecularBSDFNode>(rhs);
             }
             break;
             case CBSDFNode::ET_MICROFACET_COATING:
             {
                 auto* rhs = static_cast<const CMicrofacetCoatingBSDFNode*>(_rhs);
-                node = allocNode<CMicrofacetCoatingBSDFNode>();
-                *static_cast<CMicrofacetCoatingBSDFNode*>(node) = *rhs;
+                node = copyNodeAs<CMicrofacetCoatingBSDFNode>(rhs);
             }
             break;
             case CBSDFNode::ET_MICROFACET_DIELECTRIC:
             {
                 auto* rhs = static_cast<const CMicrofacetDielectricBSDFNode*>(_rhs);
-                node = allocNode<CMicrofacetDielectricBSDFNode>();
-                *static_cast<CMicrofacetDielectricBSDFNode*>(node) = *rhs;
+                node = copyNodeAs<CMicrofacetDielectricBSDFNode>(rhs);
             }
             break;
             default:
             {
-                node = allocNode<CBSDFNode>(rhs_bsdf->type);
-                *static_cast<CBSDFNode*>(node) = *rhs_bsdf;
+                node = copyNodeAs<CBSDFNode>(rhs_bsdf,rhs_bsdf->type);
             }
             }
         }
@@ -417,21 +482,18 @@ public:
             case CBSDFCombinerNode::ET_WEIGHT_BLEND:
             {
                 auto* rhs = static_cast<const CBSDFBlendNode*>(_rhs);
-                node = allocNode<CBSDFBlendNode>();
-                *static_cast<CBSDFBlendNode*>(node) = *rhs;
+                node = copyNodeAs<CBSDFBlendNode>(rhs);
             }
             break;
             case CBSDFCombinerNode::ET_MIX:
             {
                 auto* rhs = static_cast<const CBSDFMixNode*>(_rhs);
-                node = allocNode<CBSDFMixNode>();
-                *static_cast<CBSDFMixNode*>(node) = *rhs;
+                node = copyNodeAs<CBSDFMixNode>(rhs);
             }
             break;
             default:
             {
-                node = allocNode<CBSDFCombinerNode>(rhs_combiner->type);
-                *static_cast<CBSDFCombinerNode*>(node) = *rhs_combiner;
+                node = copyNodeAs<CBSDFCombinerNode>(rhs_combiner,rhs_combiner->type);
             }
             break;
             }
@@ -462,6 +524,21 @@ public:
 
         CGeomModifierNode(E_TYPE t) : INode(ES_GEOM_MODIFIER), type(t) {}
 
+        size_t hash() const override
+        {
+            size_t seed = INode::hash();
+            core::hash_combine<uint32_t>(seed, type);
+            texture.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* _rhs) const override
+        {
+            if (!INode::isEquivalent(_rhs))
+                return false;
+            auto* rhs = static_cast<const CGeomModifierNode*>(_rhs);
+            return type==rhs->type && texture==rhs->texture;
+        }
+
         E_TYPE type;
         //no other (than texture) source supported for now (uncomment in the future) [far future TODO]
         //E_SOURCE source;
@@ -476,6 +553,17 @@ public:
     {
         CEmissionNode() : INode(ES_EMISSION) {}
 
+        size_t hash() const override
+        {
+            size_t seed = INode::hash();
+            hashConstant(seed, intensity);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return INode::isEquivalent(rhs) && constantsEqual(intensity, static_cast<const CEmissionNode*>(rhs)->intensity);
+        }
+
         color_t intensity = color_t(1.f);
     };
 
@@ -483,6 +571,17 @@ public:
     {
         COpacityNode() : INode(ES_OPACITY) {}
 
+        size_t hash() const override
+        {
+            size_t seed = INode::hash();
+            opacity.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return INode::isEquivalent(rhs) && opacity==static_cast<const COpacityNode*>(rhs)->opacity;
+        }
+
         SParameter<color_t> opacity;
     };
 
@@ -503,17 +602,52 @@ public:
         E_TYPE type;
 
         CBSDFCombinerNode(E_TYPE t) : INode(ES_BSDF_COMBINER), type(t) {}
+
+        size_t hash() const override
+        {
+            size_t seed = INode::hash();
+            core::hash_combine<uint32_t>(seed, type);
+            return seed;
+        }
+        // the type fixes the most derived class, so derived classes can safely downcast after this returns true
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return INode::isEquivalent(rhs) && type==static_cast<const CBSDFCombinerNode*>(rhs)->type;
+        }
     };
     struct CBSDFBlendNode : CBSDFCombinerNode
     {
         CBSDFBlendNode() : CBSDFCombinerNode(ET_WEIGHT_BLEND) {}
 
+        size_t hash() const override
+        {
+            size_t seed = CBSDFCombinerNode::hash();
+            weight.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return CBSDFCombinerNode::isEquivalent(rhs) && weight==static_cast<const CBSDFBlendNode*>(rhs)->weight;
+        }
+
         SParameter<color_t> weight;
     };
     struct CBSDFMixNode : CBSDFCombinerNode
     {
         CBSDFMixNode() : CBSDFCombinerNode(ET_MIX) {}
 
+        size_t hash() const override
+        {
+            size_t seed = CBSDFCombinerNode::hash();
+            for (size_t i=0ull; i<children.count; i++)
+                core::hash_combine(seed, weights[i]);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return CBSDFCombinerNode::isEquivalent(rhs) && std::equal(weights,weights+children.count,static_cast<const CBSDFMixNode*>(rhs)->weights);
+        }
+
         float weights[MAX_CHILDREN];
     };
 
@@ -537,6 +671,23 @@ public:
             etaK(0.f)
         {}
 
+        size_t hash() const override
+        {
+            size_t seed = INode::hash();
+            core::hash_combine<uint32_t>(seed, type);
+            hashConstant(seed, eta);
+            hashConstant(seed, etaK);
+            return seed;
+        }
+        // the type fixes the most derived class, so derived classes can safely downcast after this returns true
+        bool isEquivalent(const INode* _rhs) const override
+        {
+            if (!INode::isEquivalent(_rhs))
+                return false;
+            auto* rhs = static_cast<const CBSDFNode*>(_rhs);
+            return type==rhs->type && constantsEqual(eta,rhs->eta) && constantsEqual(etaK,rhs->etaK);
+        }
+
         E_TYPE type;
         // TODO: why does this base class have IoR!? Diffuse inherits from this!!!
         color_t eta, etaK;
@@ -559,6 +710,23 @@ public:
 
         CMicrofacetSpecularBSDFNode() : CBSDFNode(ET_MICROFACET_SPECULAR) {}
 
+        size_t hash() const override
+        {
+            size_t seed = CBSDFNode::hash();
+            core::hash_combine<uint32_t>(seed, ndf);
+            core::hash_combine<uint32_t>(seed, shadowing);
+            alpha_u.hash(seed);
+            alpha_v.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* _rhs) const override
+        {
+            if (!CBSDFNode::isEquivalent(_rhs))
+                return false;
+            auto* rhs = static_cast<const CMicrofacetSpecularBSDFNode*>(_rhs);
+            return ndf==rhs->ndf && shadowing==rhs->shadowing && alpha_u==rhs->alpha_u && alpha_v==rhs->alpha_v;
+        }
+
         void setSmooth(E_NDF _ndf = ENDF_GGX)
         {
             ndf = _ndf;
@@ -579,6 +747,21 @@ public:
     {
         CMicrofacetDiffuseBxDFBase(E_TYPE t) : CBSDFNode(t) {}
 
+        size_t hash() const override
+        {
+            size_t seed = CBSDFNode::hash();
+            alpha_u.hash(seed);
+            alpha_v.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* _rhs) const override
+        {
+            if (!CBSDFNode::isEquivalent(_rhs))
+                return false;
+            auto* rhs = static_cast<const CMicrofacetDiffuseBxDFBase*>(_rhs);
+            return alpha_u==rhs->alpha_u && alpha_v==rhs->alpha_v;
+        }
+
         void setSmooth()
         {
             alpha_u.source = EPS_CONSTANT;
@@ -593,28 +776,104 @@ public:
     {
         CMicrofacetDiffuseBSDFNode() : CMicrofacetDiffuseBxDFBase(ET_MICROFACET_DIFFUSE) {}
 
+        size_t hash() const override
+        {
+            size_t seed = CMicrofacetDiffuseBxDFBase::hash();
+            reflectance.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return CMicrofacetDiffuseBxDFBase::isEquivalent(rhs) && reflectance==static_cast<const CMicrofacetDiffuseBSDFNode*>(rhs)->reflectance;
+        }
+
         SParameter<color_t> reflectance = color_t(1.f);
     };
     struct CMicrofacetDifftransBSDFNode : CMicrofacetDiffuseBxDFBase
     {
         CMicrofacetDifftransBSDFNode() : CMicrofacetDiffuseBxDFBase(ET_MICROFACET_DIFFTRANS) {}
 
+        size_t hash() const override
+        {
+            size_t seed = CMicrofacetDiffuseBxDFBase::hash();
+            transmittance.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return CMicrofacetDiffuseBxDFBase::isEquivalent(rhs) && transmittance==static_cast<const CMicrofacetDifftransBSDFNode*>(rhs)->transmittance;
+        }
+
         SParameter<color_t> transmittance = color_t(0.5f);
     };
     struct CMicrofacetCoatingBSDFNode : CMicrofacetSpecularBSDFNode
     {
         CMicrofacetCoatingBSDFNode() : CMicrofacetSpecularBSDFNode(ET_MICROFACET_COATING) {}
 
+        size_t hash() const override
+        {
+            size_t seed = CMicrofacetSpecularBSDFNode::hash();
+            thicknessSigmaA.hash(seed);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return CMicrofacetSpecularBSDFNode::isEquivalent(rhs) && thicknessSigmaA==static_cast<const CMicrofacetCoatingBSDFNode*>(rhs)->thicknessSigmaA;
+        }
+
         SParameter<color_t> thicknessSigmaA;
     };
     struct CMicrofacetDielectricBSDFNode : CMicrofacetSpecularBSDFNode
     {
         CMicrofacetDielectricBSDFNode() : CMicrofacetSpecularBSDFNode(ET_MICROFACET_DIELECTRIC) {}
+
+        size_t hash() const override
+        {
+            size_t seed = CMicrofacetSpecularBSDFNode::hash();
+            core::hash_combine(seed, thin);
+            return seed;
+        }
+        bool isEquivalent(const INode* rhs) const override
+        {
+            return CMicrofacetSpecularBSDFNode::isEquivalent(rhs) && thin==static_cast<const CMicrofacetDielectricBSDFNode*>(rhs)->thin;
+        }
         bool thin = false;
     };
 
+protected:
+    template <typename NodeType, typename ...Args>
+    NodeType* copyNodeAs(const NodeType* rhs, Args&& ...args)
+    {
+        auto* node = allocNode<NodeType>(std::forward<Args>(args)...);
+        if (node)
+            *node = *rhs;
+        return node;
+    }
+
+    static size_t hashTree(const INode* root)
+    {
+        size_t seed = root->hash();
+        for (const INode* child : root->children)
+            core::hash_combine(seed, hashTree(child));
+        return seed;
+    }
+    static bool treesEquivalent(const INode* lhs, const INode* rhs)
+    {
+        if (!lhs->isEquivalent(rhs))
+            return false;
+        for (size_t i=0u; i<lhs->children.count; i++)
+        if (!treesEquivalent(lhs->children[i],rhs->children[i]))
+            return false;
+        return true;
+    }
+
+public:
     SBackingMemManager memMgr;
+    // every persistent node, for destruction
+    core::vector<node_handle_t> nodes;
     core::vector<INode*> roots;
+    core::unordered_set<node_handle_t> uniqueRoots;
+    core::unordered_map<size_t,core::vector<INode*>> rootHashTable;
 
     core::vector<INode*> tmp;
     uint32_t tmpSize = 0u;
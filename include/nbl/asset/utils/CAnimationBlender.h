@@ -0,0 +1,291 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_ANIMATION_BLENDER_H_INCLUDED_
+#define _NBL_ASSET_C_ANIMATION_BLENDER_H_INCLUDED_
+
+#include "nbl/core/execution.h"
+
+#include "nbl/asset/ICPUAnimationLibrary.h"
+#include "nbl/asset/ICPUSkeleton.h"
+
+namespace nbl::asset
+{
+
+//! CPU counterpart of the GPU animation blending, samples and blends the keyframes of an `ICPUAnimationLibrary` for many skeleton instances.
+/**
+Joints get processed 4 at a time in Structure of Arrays form, so decoding of the quantized rotations, interpolation,
+quaternion normalized-lerp blending and conversion into `core::matrix3x4SIMD` all happen on 4 joints per instruction.
+
+Every layer of an instance provides one animation per joint (or an invalid one which does not contribute),
+the layers are blended with their weights and normalized. Joints which end up with no contribution get the bind pose of the skeleton.
+
+`EIM_CUBIC` animations get interpolated linearly, because `ICPUAnimationLibrary` keyframes do not store the tangents a cubic spline needs.
+*/
+class CAnimationBlender
+{
+	public:
+		using animation_t = ICPUAnimationLibrary::animation_t;
+		using timestamp_t = ICPUAnimationLibrary::timestamp_t;
+		using joint_id_t = ICPUSkeleton::joint_id_t;
+
+		//! One animation contributing to the pose of a skeleton instance
+		struct SLayer
+		{
+			// `getJointCount()` entries, anything out of the library's animation range means the joint is not animated by this layer
+			const animation_t* jointAnimations = nullptr;
+			timestamp_t time = 0u;
+			float weight = 1.f;
+		};
+		struct SInstance
+		{
+			const SLayer* layers = nullptr;
+			uint32_t layerCount = 0u;
+			// `getJointCount()` joint-space transforms, same convention as `ICPUSkeleton::getDefaultTransformMatrix`
+			core::matrix3x4SIMD* outJointTransforms = nullptr;
+		};
+
+		CAnimationBlender(core::smart_refctd_ptr<const ICPUAnimationLibrary>&& _library, core::smart_refctd_ptr<const ICPUSkeleton>&& _skeleton)
+			: m_library(std::move(_library)), m_skeleton(std::move(_skeleton)) {}
+
+		inline const ICPUAnimationLibrary* getLibrary() const {return m_library.get();}
+		inline const ICPUSkeleton* getSkeleton() const {return m_skeleton.get();}
+		inline joint_id_t getJointCount() const {return m_skeleton->getJointCount();}
+
+		//! Instances are independent, so the policy decides whether they get evaluated in parallel
+		template<class ExecutionPolicy>
+		inline void evaluate(ExecutionPolicy&& policy, const SInstance* instancesBegin, const SInstance* instancesEnd) const
+		{
+			core::for_each(std::forward<ExecutionPolicy>(policy),instancesBegin,instancesEnd,[this](const SInstance& instance)->void{evaluate(instance);});
+		}
+		inline void evaluate(const SInstance* instancesBegin, const SInstance* instancesEnd) const
+		{
+			evaluate(core::execution::seq,instancesBegin,instancesEnd);
+		}
+
+		inline void evaluate(const SInstance& instance) const
+		{
+			const joint_id_t jointCount = getJointCount();
+			for (joint_id_t firstJoint=0u; firstJoint<jointCount; firstJoint+=BlockSize)
+			{
+				SBlock accumulator = {};
+				for (uint32_t l=0u; l<instance.layerCount; l++)
+					accumulateLayer(accumulator,instance.layers[l],firstJoint);
+				writeBlock(accumulator,firstJoint,instance.outJointTransforms);
+			}
+		}
+
+	private:
+		static inline constexpr uint32_t BlockSize = 4u;
+
+		// SoA state of `BlockSize` joints
+		struct SBlock
+		{
+			__m128 translation[3];
+			__m128 rotation[4];
+			__m128 scale[3];
+			__m128 weight;
+		};
+		// what gets gathered out of the library before the vectorized part can run
+		struct alignas(16) SGathered
+		{
+			uint32_t rotation[2][BlockSize];
+			float translation[2][3][BlockSize];
+			float scale[2][3][BlockSize];
+			float interpolant[BlockSize];
+			float weight[BlockSize];
+		};
+
+		//! Finds the two keyframes around `time` and the linear interpolant between them
+		inline void findKeyframes(const ICPUAnimationLibrary::Animation& animation, const timestamp_t time, uint32_t& outFirst, uint32_t& outSecond, float& outInterpolant) const
+		{
+			const uint32_t offset = animation.getKeyframeOffset();
+			const uint32_t count = animation.getKeyframeCount();
+			const timestamp_t* timestamps = &m_library->getTimestamp(offset);
+
+			const uint32_t next = std::upper_bound(timestamps,timestamps+count,time)-timestamps;
+			outInterpolant = 0.f;
+			if (next==0u)
+				outFirst = outSecond = offset;
+			else if (next==count)
+				outFirst = outSecond = offset+count-1u;
+			else
+			{
+				outFirst = offset+next-1u;
+				outSecond = offset+next;
+				// `EIM_CUBIC` falls back to linear, see the class documentation
+				if (animation.getInterpolationMode()!=ICPUAnimationLibrary::Animation::EIM_NEAREST)
+					outInterpolant = float(time-timestamps[next-1u])/float(timestamps[next]-timestamps[next-1u]);
+			}
+		}
+
+		inline void gather(SGathered& out, const SLayer& layer, const joint_id_t firstJoint) const
+		{
+			const joint_id_t jointCount = getJointCount();
+			const uint32_t animationCapacity = m_library->getAnimationCapacity();
+			for (uint32_t lane=0u; lane<BlockSize; lane++)
+			{
+				const joint_id_t joint = firstJoint+lane;
+				const animation_t animationID = joint<jointCount ? layer.jointAnimations[joint]:animationCapacity;
+				const ICPUAnimationLibrary::Animation* animation = animationID<animationCapacity ? &m_library->getAnimation(animationID):nullptr;
+				if (!animation || animation->getKeyframeCount()==0u)
+				{
+					out.weight[lane] = 0.f;
+					out.interpolant[lane] = 0.f;
+					for (auto k=0u; k<2u; k++)
+					{
+						out.rotation[k][lane] = 0x7f000000u; // identity in R8G8B8A8_SNORM
+						for (auto c=0u; c<3u; c++)
+						{
+							out.translation[k][c][lane] = 0.f;
+							out.scale[k][c][lane] = 1.f;
+						}
+					}
+					continue;
+				}
+				out.weight[lane] = layer.weight;
+
+				uint32_t keyframes[2];
+				findKeyframes(*animation,layer.time,keyframes[0],keyframes[1],out.interpolant[lane]);
+				for (auto k=0u; k<2u; k++)
+				{
+					const auto& keyframe = m_library->getKeyframe(keyframes[k]);
+					memcpy(out.rotation[k]+lane,&keyframe.getQuantizedRotation(),sizeof(uint32_t));
+					const float* translation = keyframe.getTranslation();
+					const auto scale = keyframe.getScale();
+					for (auto c=0u; c<3u; c++)
+					{
+						out.translation[k][c][lane] = translation[c];
+						out.scale[k][c][lane] = scale.pointer[c];
+					}
+				}
+			}
+		}
+
+		//! R8G8B8A8_SNORM quaternions of 4 joints straight into SoA form, the shifts sign-extend every byte of a lane
+		static inline void decodeRotations(const uint32_t* packed, __m128* outXYZW)
+		{
+			const __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(packed));
+			const __m128 rcp127 = _mm_set1_ps(1.f/127.f);
+			const __m128 minusOne = _mm_set1_ps(-1.f);
+			const __m128i bytes[4] = {
+				_mm_srai_epi32(_mm_slli_epi32(v,24),24),
+				_mm_srai_epi32(_mm_slli_epi32(v,16),24),
+				_mm_srai_epi32(_mm_slli_epi32(v,8),24),
+				_mm_srai_epi32(v,24)
+			};
+			for (auto c=0u; c<4u; c++)
+				outXYZW[c] = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(bytes[c]),rcp127),minusOne);
+		}
+		static inline __m128 dot4(const __m128* a, const __m128* b)
+		{
+			__m128 retval = _mm_mul_ps(a[0],b[0]);
+			for (auto c=1u; c<4u; c++)
+				retval = _mm_add_ps(retval,_mm_mul_ps(a[c],b[c]));
+			return retval;
+		}
+		// flips `q` wherever it lies on the other side of the double cover than `reference`
+		static inline void alignHemisphere(__m128* q, const __m128* reference)
+		{
+			const __m128 signMask = _mm_and_ps(dot4(q,reference),_mm_set1_ps(-0.f));
+			for (auto c=0u; c<4u; c++)
+				q[c] = _mm_xor_ps(q[c],signMask);
+		}
+		static inline __m128 lerp(const __m128 a, const __m128 b, const __m128 t)
+		{
+			return _mm_add_ps(a,_mm_mul_ps(_mm_sub_ps(b,a),t));
+		}
+
+		inline void accumulateLayer(SBlock& accumulator, const SLayer& layer, const joint_id_t firstJoint) const
+		{
+			SGathered gathered;
+			gather(gathered,layer,firstJoint);
+
+			const __m128 weight = _mm_load_ps(gathered.weight);
+			if (_mm_movemask_ps(_mm_cmpneq_ps(weight,_mm_setzero_ps()))==0)
+				return;
+			const __m128 t = _mm_load_ps(gathered.interpolant);
+
+			__m128 rotation[2][4];
+			decodeRotations(gathered.rotation[0],rotation[0]);
+			decodeRotations(gathered.rotation[1],rotation[1]);
+			// nlerp between the keyframes, then between the layers
+			alignHemisphere(rotation[1],rotation[0]);
+			__m128 q[4];
+			for (auto c=0u; c<4u; c++)
+				q[c] = lerp(rotation[0][c],rotation[1][c],t);
+			alignHemisphere(q,accumulator.rotation);
+			for (auto c=0u; c<4u; c++)
+				accumulator.rotation[c] = _mm_add_ps(accumulator.rotation[c],_mm_mul_ps(q[c],weight));
+
+			for (auto c=0u; c<3u; c++)
+			{
+				const __m128 translation = lerp(_mm_load_ps(gathered.translation[0][c]),_mm_load_ps(gathered.translation[1][c]),t);
+				accumulator.translation[c] = _mm_add_ps(accumulator.translation[c],_mm_mul_ps(translation,weight));
+				const __m128 scale = lerp(_mm_load_ps(gathered.scale[0][c]),_mm_load_ps(gathered.scale[1][c]),t);
+				accumulator.scale[c] = _mm_add_ps(accumulator.scale[c],_mm_mul_ps(scale,weight));
+			}
+			accumulator.weight = _mm_add_ps(accumulator.weight,weight);
+		}
+
+		inline void writeBlock(const SBlock& accumulator, const joint_id_t firstJoint, core::matrix3x4SIMD* out) const
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const int contributing = _mm_movemask_ps(_mm_cmpgt_ps(accumulator.weight,zero));
+			// avoid NaNs in the lanes which will get the bind pose anyway
+			const __m128 rcpWeight = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.f),accumulator.weight),_mm_cmpgt_ps(accumulator.weight,zero));
+
+			__m128 q[4];
+			{
+				const __m128 lenSq = dot4(accumulator.rotation,accumulator.rotation);
+				const __m128 rcpLen = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.f),_mm_sqrt_ps(lenSq)),_mm_cmpgt_ps(lenSq,zero));
+				for (auto c=0u; c<4u; c++)
+					q[c] = _mm_mul_ps(accumulator.rotation[c],rcpLen);
+			}
+			__m128 translation[3], scale[3];
+			for (auto c=0u; c<3u; c++)
+			{
+				translation[c] = _mm_mul_ps(accumulator.translation[c],rcpWeight);
+				scale[c] = _mm_mul_ps(accumulator.scale[c],rcpWeight);
+			}
+
+			// same as `matrix3x4SIMD::setScaleRotationAndTranslation` but for 4 joints at once
+			const __m128 two = _mm_set1_ps(2.f);
+			const __m128 xx = _mm_mul_ps(q[0],q[0]), yy = _mm_mul_ps(q[1],q[1]), zz = _mm_mul_ps(q[2],q[2]);
+			const __m128 xy = _mm_mul_ps(q[0],q[1]), xz = _mm_mul_ps(q[0],q[2]), yz = _mm_mul_ps(q[1],q[2]);
+			const __m128 wx = _mm_mul_ps(q[3],q[0]), wy = _mm_mul_ps(q[3],q[1]), wz = _mm_mul_ps(q[3],q[2]);
+			const __m128 one = _mm_set1_ps(1.f);
+			__m128 rows[3][4] = {
+				{_mm_sub_ps(one,_mm_mul_ps(two,_mm_add_ps(yy,zz))),_mm_mul_ps(two,_mm_sub_ps(xy,wz)),_mm_mul_ps(two,_mm_add_ps(xz,wy)),translation[0]},
+				{_mm_mul_ps(two,_mm_add_ps(xy,wz)),_mm_sub_ps(one,_mm_mul_ps(two,_mm_add_ps(xx,zz))),_mm_mul_ps(two,_mm_sub_ps(yz,wx)),translation[1]},
+				{_mm_mul_ps(two,_mm_sub_ps(xz,wy)),_mm_mul_ps(two,_mm_add_ps(yz,wx)),_mm_sub_ps(one,_mm_mul_ps(two,_mm_add_ps(xx,yy))),translation[2]}
+			};
+			for (auto r=0u; r<3u; r++)
+			{
+				for (auto c=0u; c<3u; c++)
+					rows[r][c] = _mm_mul_ps(rows[r][c],scale[c]);
+				// lane `i` of row `r` now turns into the `r`-th row of joint `i`
+				_MM_TRANSPOSE4_PS(rows[r][0],rows[r][1],rows[r][2],rows[r][3]);
+			}
+
+			const joint_id_t jointCount = getJointCount();
+			for (uint32_t lane=0u; lane<BlockSize && firstJoint+lane<jointCount; lane++)
+			{
+				const joint_id_t joint = firstJoint+lane;
+				if (contributing&(0x1<<lane))
+				{
+					for (auto r=0u; r<3u; r++)
+						_mm_store_ps(out[joint].rows[r].pointer,rows[r][lane]);
+				}
+				else
+					out[joint] = m_skeleton->getDefaultTransformMatrix(joint);
+			}
+		}
+
+		core::smart_refctd_ptr<const ICPUAnimationLibrary> m_library;
+		core::smart_refctd_ptr<const ICPUSkeleton> m_skeleton;
+};
+
+}
+
+#endif
@@ -9,12 +9,15 @@
 #include <iostream>
 #include <limits>
 #include <cmath>
+#include <shared_mutex>
+#include <span>
 
 #include "parallel-hashmap/parallel_hashmap/phmap_dump.h"
 
 
 #include "nbl/core/declarations.h"
 #include "vectorSIMD.h"
+#include "nbl/core/math/batchSIMD.h"
 
 #include "nbl/system/declarations.h"
 
@@ -243,6 +246,12 @@ struct CDirQuantCacheBase::value_type<EF_R16G16B16A16_SNORM>
 }
 
 
+//! Caches the best fitting quantized value of directions, keyed by a projection of the direction.
+/**
+All methods are thread-safe, lookups take a shared lock and only inserting the fits of cache misses takes an exclusive one,
+the fitting itself happens outside the lock. Prefer the batch `quantize` overloads, they lock once per batch and fit
+all the misses together in SIMD lanes (for 3D directions, see `core::batch::bestFitDirections`).
+*/
 template<typename Key, class Hash, E_FORMAT... Formats>
 class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 { 
@@ -264,6 +273,7 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 		template<E_FORMAT CacheFormat>
 		inline void insertIntoCache(const Key& key, const value_type_t<CacheFormat>& value)
 		{
+			std::unique_lock lock(cacheMutex);
 			std::get<cache_type_t<CacheFormat>>(cache).insert(std::make_pair(key,value));		
 		}
 
@@ -275,6 +285,7 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 			if (!validateSerializedCache<CacheFormat>(buffer))
 				return false;
 
+			std::unique_lock lock(cacheMutex);
 			auto& particularCache = std::get<cache_type_t<CacheFormat>>(cache);
 			cache_type_t<CacheFormat> backup;
 
@@ -333,6 +344,7 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 				return false;
 
 			CBufferPhmapOutputArchive buffWrap(buffer);
+			std::shared_lock lock(cacheMutex);
 			return std::get<cache_type_t<CacheFormat>>(cache).dump(buffWrap);
 		}
 
@@ -370,47 +382,146 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 		template<E_FORMAT CacheFormat>
 		inline size_t getSerializedCacheSizeInBytes()
 		{
+			std::shared_lock lock(cacheMutex);
 			return getSerializedCacheSizeInBytes_impl<CacheFormat>(std::get<cache_type_t<CacheFormat>>(cache).capacity());
 		}
 
 	protected:
-		std::tuple<cache_type_t<Formats>...> cache;
+		// the cache only memoizes `findBestFit`, so filling it in does not change the observable state
+		mutable std::tuple<cache_type_t<Formats>...> cache;
+		mutable std::shared_mutex cacheMutex;
 		
 		template<uint32_t dimensions, E_FORMAT CacheFormat>
-		value_type_t<CacheFormat> quantize(const core::vectorSIMDf& value)
+		value_type_t<CacheFormat> quantize(const core::vectorSIMDf& value) const
 		{
-			const auto negativeMask = value < core::vectorSIMDf(0.0f);
-
 			const core::vectorSIMDf absValue = abs(value);
 			const auto key = Key(absValue);
 
 			constexpr auto quantizationBits = quantization_bits_v<CacheFormat>;
-			value_type_t<CacheFormat> quantized;
+			auto& particularCache = std::get<cache_type_t<CacheFormat>>(cache);
 			{
-				auto& particularCache = std::get<cache_type_t<CacheFormat>>(cache);
+				std::shared_lock lock(cacheMutex);
 				auto found = particularCache.find(key);
 				if (found != particularCache.end() && (found->first == key))
-					quantized = found->second;
-				else
+					return restoreSign<CacheFormat>(found->second,value);
+			}
+
+			const core::vectorSIMDf fit = findBestFit<dimensions,quantizationBits>(absValue);
+			const value_type_t<CacheFormat> quantized(core::vectorSIMDu32(core::abs(fit)));
+			// if another thread beat us to it, it found the same fit
+			{
+				std::unique_lock lock(cacheMutex);
+				particularCache.insert(std::make_pair(key,quantized));
+			}
+			return restoreSign<CacheFormat>(quantized,value);
+		}
+
+		//! Batch version of the above, `out` needs space for `values.size()` elements.
+		template<uint32_t dimensions, E_FORMAT CacheFormat>
+		void quantize(const std::span<const core::vectorSIMDf> values, value_type_t<CacheFormat>* out) const
+		{
+			constexpr auto quantizationBits = quantization_bits_v<CacheFormat>;
+			constexpr uint32_t NoMiss = ~0u;
+			auto& particularCache = std::get<cache_type_t<CacheFormat>>(cache);
+
+			// the same direction tends to repeat a lot within a batch (flat shading, split vertices), so misses get deduplicated
+			core::unordered_map<Key,uint32_t,Hash> misses;
+			core::vector<core::vectorSIMDf> missValues;
+			core::vector<uint32_t> missIndices(values.size(),NoMiss);
+			{
+				std::shared_lock lock(cacheMutex);
+				for (size_t i=0ull; i<values.size(); i++)
 				{
-					const core::vectorSIMDf fit = findBestFit<dimensions,quantizationBits>(absValue);
+					const core::vectorSIMDf absValue = abs(values[i]);
+					const auto key = Key(absValue);
+					auto found = particularCache.find(key);
+					if (found != particularCache.end())
+					{
+						out[i] = found->second;
+						continue;
+					}
+					const auto inserted = misses.emplace(key,uint32_t(missValues.size()));
+					if (inserted.second)
+						missValues.push_back(absValue);
+					missIndices[i] = inserted.first->second;
+				}
+			}
 
-					quantized = core::vectorSIMDu32(core::abs(fit));
-					insertIntoCache<CacheFormat>(key,quantized);
+			if (!missValues.empty())
+			{
+				core::vector<core::vectorSIMDf> fits(missValues.size());
+				findBestFits<dimensions,quantizationBits>(missValues,fits.data());
+				core::vector<value_type_t<CacheFormat>> quantized(fits.size());
+				for (size_t i=0ull; i<fits.size(); i++)
+					quantized[i] = core::vectorSIMDu32(core::abs(fits[i]));
+				{
+					std::unique_lock lock(cacheMutex);
+					for (const auto& miss : misses)
+						particularCache.insert(std::make_pair(miss.first,quantized[miss.second]));
 				}
+				for (size_t i=0ull; i<values.size(); i++)
+				if (missIndices[i]!=NoMiss)
+					out[i] = quantized[missIndices[i]];
 			}
 
+			for (size_t i=0ull; i<values.size(); i++)
+				out[i] = restoreSign<CacheFormat>(out[i],values[i]);
+		}
+
+		template<E_FORMAT CacheFormat>
+		static inline value_type_t<CacheFormat> restoreSign(const value_type_t<CacheFormat>& quantized, const core::vectorSIMDf& value)
+		{
+			constexpr auto quantizationBits = quantization_bits_v<CacheFormat>;
+			const auto negativeMask = value < core::vectorSIMDf(0.0f);
+
 			const core::vectorSIMDu32 xorflag((0x1u<<(quantizationBits+1u))-1u);
 			auto restoredAsVec = quantized.getValue()^core::mix(core::vectorSIMDu32(0u),xorflag,negativeMask);
 			restoredAsVec += core::mix(core::vectorSIMDu32(0u),core::vectorSIMDu32(1u),negativeMask);
 			return value_type_t<CacheFormat>(restoredAsVec&xorflag);
 		}
 
+		//max component of 3d normal cannot be less than sqrt(1/D)
+		template<uint32_t dimensions>
+		static inline bool isFittable(const core::vectorSIMDf& value)
+		{
+			float maxDirectionComp = value[0];
+			for (auto i=1u; i<dimensions; i++)
+				maxDirectionComp = std::max(maxDirectionComp,value[i]);
+			return maxDirectionComp >= std::sqrtf(0.9998f / float(dimensions));
+		}
+
+		//! `out` may not alias `values`
+		template<uint32_t dimensions, uint32_t quantizationBits>
+		static inline void findBestFits(const std::span<const core::vectorSIMDf> values, core::vectorSIMDf* out)
+		{
+			if constexpr (dimensions==3u)
+			{
+				constexpr uint32_t cubeHalfSize = (0x1u << quantizationBits) - 1u;
+				core::batch::bestFitDirections(values,cubeHalfSize,out);
+				for (size_t i=0ull; i<values.size(); i++)
+				if (!isFittable<dimensions>(values[i]))
+				{
+					_NBL_DEBUG_BREAK_IF(true);
+					out[i] = core::vectorSIMDf(0.f);
+				}
+			}
+			else
+			for (size_t i=0ull; i<values.size(); i++)
+				out[i] = findBestFit<dimensions,quantizationBits>(values[i]);
+		}
+
 		template<uint32_t dimensions, uint32_t quantizationBits>
 		static inline core::vectorSIMDf findBestFit(const core::vectorSIMDf& value)
 		{
 			static_assert(dimensions>1u,"No point");
 			static_assert(dimensions<=4u,"High Dimensions are Hard!");
+			// 3D goes through the SIMD search, which compares sines instead of cosines so it doesn't lose all precision at 16 bits
+			if constexpr (dimensions==3u)
+			{
+				core::vectorSIMDf bestFit;
+				findBestFits<dimensions,quantizationBits>(std::span<const core::vectorSIMDf>(&value,1ull),&bestFit);
+				return bestFit;
+			}
 			// precise normalize
 			const auto vectorForDots = value.preciseDivision(length(value));
 
@@ -426,8 +537,7 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 					maxDirCompIndex = i;
 				//
 				const float maxDirectionComp = value[maxDirCompIndex];
-				//max component of 3d normal cannot be less than sqrt(1/D)
-				if (maxDirectionComp < std::sqrtf(0.9998f / float(dimensions)))
+				if (!isFittable<dimensions>(value))
 				{
 					_NBL_DEBUG_BREAK_IF(true);
 					return core::vectorSIMDf(0.f);
@@ -0,0 +1,212 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_MESH_BVH_H_INCLUDED_
+#define _NBL_ASSET_C_MESH_BVH_H_INCLUDED_
+
+#include "nbl/asset/ICPUMeshBuffer.h"
+
+#include <cfloat>
+#include <chrono>
+#include <span>
+
+namespace nbl::asset
+{
+
+//! Common part of `CMeshBVH` and `CInstanceBVH`, 4-wide bounding volume hierarchies built with binned SAH for ray queries on the CPU.
+/**
+A node holds the boxes of all 4 of its children in Structure of Arrays form (128 bytes, two cache lines),
+so a ray gets tested against all of them with a handful of SSE instructions and the children which got hit are visited front to back.
+
+The build splits with the Surface Area Heuristic evaluated over bins of primitive centroids. The top of the tree gets built serially
+(with the binning of big ranges split across threads) until the ranges left are small enough, then those subtrees get built in parallel.
+
+This is meant for baking, picking and other tools, the GPU acceleration structures are `ICPUAccelerationStructure`.
+*/
+class NBL_API2 IBVH : public core::IReferenceCounted
+{
+	public:
+		static inline constexpr uint32_t Width = 4u;
+		static inline constexpr uint32_t InvalidID = ~0u;
+		// deeper subtrees get flattened into leaves, bounds the traversal stack
+		static inline constexpr uint32_t MaxDepth = 64u;
+
+		//! The direction need not be normalized, hit distances are in multiples of it.
+		struct SRay
+		{
+			core::vectorSIMDf origin;
+			core::vectorSIMDf direction;
+			float tMin = 0.f;
+			float tMax = FLT_MAX;
+		};
+		struct SHit
+		{
+			inline bool valid() const {return primitiveID!=InvalidID;}
+
+			// along the ray
+			float t = FLT_MAX;
+			// barycentrics of the 2nd and 3rd vertex of the triangle
+			float u = 0.f;
+			float v = 0.f;
+			// triangle, so its first index is at `3*primitiveID` in the index buffer
+			uint32_t primitiveID = InvalidID;
+			// index into the instances a `CInstanceBVH` was created from
+			uint32_t instanceID = InvalidID;
+		};
+
+		struct SBuildParams
+		{
+			inline bool valid() const
+			{
+				return maxLeafSize>=1u && binCount>=2u && binCount<=MaxBins;
+			}
+
+			static inline constexpr uint32_t MaxBins = 64u;
+
+			// primitives a leaf can hold before it has to be split, triangles get intersected 4 at a time so multiples of 4 are best
+			uint32_t maxLeafSize = 4u;
+			// SAH bins per axis
+			uint32_t binCount = 16u;
+		};
+		struct SStatistics
+		{
+			//! Primitives processed per second.
+			inline double getPrimitivesPerSecond() const
+			{
+				const auto seconds = std::chrono::duration<double>(buildTime).count();
+				return seconds>0.0 ? double(primitiveCount)/seconds:0.0;
+			}
+
+			uint64_t primitiveCount = 0ull;
+			uint64_t nodeCount = 0ull;
+			uint64_t leafCount = 0ull;
+			uint32_t maxDepth = 0u;
+			// expected cost of a ray hitting the root box, in units of one box or primitive test, lower is better
+			float sahCost = 0.f;
+			std::chrono::nanoseconds buildTime = {};
+		};
+
+		inline const core::aabbox3df& getBoundingBox() const {return m_boundingBox;}
+		inline size_t getNodeCount() const {return m_nodes.size();}
+
+		//! Closest hit within [tMin,tMax] of the ray, `_hit` only gets written if there is one.
+		virtual bool intersect(const SRay& _ray, SHit& _hit) const = 0;
+		//! Any hit within [tMin,tMax] of the ray, for shadow and visibility rays.
+		virtual bool occluded(const SRay& _ray) const = 0;
+
+		//! Closest hits of many rays in parallel, rays which miss get an invalid `SHit`.
+		void intersect(std::span<const SRay> _rays, SHit* _outHits) const;
+		//! Any hit test of many rays in parallel, writes 1 for rays which hit something and 0 for the others.
+		void occluded(std::span<const SRay> _rays, uint8_t* _outOccluded) const;
+
+	protected:
+		struct alignas(64) SNode
+		{
+			// boxes of the children as min X, max X, min Y, max Y, min Z, max Z rows, empty slots are inverted so they never get hit
+			float bounds[6][Width];
+			// inner children have a `count` of 0 and `child` indexes the nodes, leaves cover `count` entries from `child` onwards
+			uint32_t child[Width];
+			uint32_t count[Width];
+		};
+		static_assert(sizeof(SNode)==128u);
+
+		IBVH() = default;
+		virtual ~IBVH() = default;
+
+		//! Builds `m_nodes` and `m_boundingBox` over the boxes of `_count` primitives.
+		/**
+		`_outOrder` gets the primitive permutation, leaves cover ranges of it until the derived class repacks them.
+		*/
+		void buildNodes(const core::vectorSIMDf* _boxMin, const core::vectorSIMDf* _boxMax, const uint32_t _count, const SBuildParams& _params, core::vector<uint32_t>& _outOrder, SStatistics& _stats);
+
+		//! Visits the leaves the ray's box tests pass front to back, `_leaf(first,count,tMax)` returns whether it hit something and can shorten `tMax`.
+		template<bool AnyHit, typename LeafFunc>
+		bool traverse(const SRay& _ray, float _tMax, LeafFunc&& _leaf) const;
+
+		core::vector<SNode> m_nodes;
+		core::aabbox3df m_boundingBox;
+};
+
+//! BVH over the triangles of a triangle list.
+/**
+Leaves store their triangles 4 at a time in Structure of Arrays form (first vertex and two edges), so the Möller-Trumbore test runs on 4 triangles at once.
+Triangles are double sided and the BVH keeps its own copy of the positions, so it doesn't reference the meshbuffer.
+*/
+class NBL_API2 CMeshBVH final : public IBVH
+{
+	public:
+		//! Builds over a triangle list meshbuffer, indexed or not.
+		/**
+		@returns nullptr if the meshbuffer isn't a triangle list, has no positions or `_params` are invalid.
+		*/
+		static core::smart_refctd_ptr<CMeshBVH> create(const ICPUMeshBuffer* _meshbuffer, const SBuildParams& _params, SStatistics* _outStats = nullptr, const system::logger_opt_ptr logger = nullptr);
+		//! Builds over a raw triangle list, `_indices` must all be less than `_positions.size()`.
+		static core::smart_refctd_ptr<CMeshBVH> create(std::span<const uint32_t> _indices, std::span<const core::vectorSIMDf> _positions, const SBuildParams& _params, SStatistics* _outStats = nullptr);
+
+		inline size_t getTriangleCount() const {return m_triangleCount;}
+
+		using IBVH::intersect;
+		using IBVH::occluded;
+		bool intersect(const SRay& _ray, SHit& _hit) const override;
+		bool occluded(const SRay& _ray) const override;
+
+	private:
+		struct alignas(16) STrianglePack
+		{
+			// XYZ rows, unused lanes are all zero which makes them degenerate so they never get hit
+			float v0[3][Width];
+			float edge1[3][Width];
+			float edge2[3][Width];
+			uint32_t primitiveID[Width];
+		};
+
+		CMeshBVH() = default;
+
+		core::vector<STrianglePack> m_packs;
+		size_t m_triangleCount = 0ull;
+};
+
+//! BVH over instances of `CMeshBVH`es, rays get transformed into the space of every instance whose world space box they hit.
+class NBL_API2 CInstanceBVH final : public IBVH
+{
+	public:
+		struct SInstance
+		{
+			core::smart_refctd_ptr<const CMeshBVH> bvh;
+			// object to world
+			core::matrix3x4SIMD transform;
+		};
+
+		//! Instances can share the same `CMeshBVH`.
+		/**
+		@returns nullptr if an instance has no BVH, a transform which can't be inverted or `_params` are invalid.
+		*/
+		static core::smart_refctd_ptr<CInstanceBVH> create(std::span<const SInstance> _instances, const SBuildParams& _params, SStatistics* _outStats = nullptr);
+
+		inline size_t getInstanceCount() const {return m_instances.size();}
+
+		using IBVH::intersect;
+		using IBVH::occluded;
+		bool intersect(const SRay& _ray, SHit& _hit) const override;
+		bool occluded(const SRay& _ray) const override;
+
+	private:
+		struct SLeafInstance
+		{
+			const CMeshBVH* bvh;
+			// world to object
+			core::matrix3x4SIMD inverseTransform;
+			uint32_t instanceID;
+		};
+
+		CInstanceBVH() = default;
+
+		// keeps the BVHs alive
+		core::vector<SInstance> m_instances;
+		// in leaf order
+		core::vector<SLeafInstance> m_leafInstances;
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_MESH_SIMPLIFIER_H_INCLUDED_
+#define _NBL_ASSET_C_MESH_SIMPLIFIER_H_INCLUDED_
+
+#include "nbl/asset/ICPUMeshBuffer.h"
+
+#include <chrono>
+#include <span>
+
+// Edge collapse scheme and vertex classification based on zeux's meshoptimizer (https://github.com/zeux/meshoptimizer) available under MIT license
+
+namespace nbl::asset
+{
+
+//! Decimates triangle lists by collapsing edges in the order of their quadric error (Garland-Heckbert).
+/**
+Vertices only ever collapse onto other existing vertices, so only the index buffer changes and the vertex buffers get shared with the input.
+
+Vertices with the same position but different IDs are attribute seams (UV islands, hard normals), these only collapse along the seam and
+together with their counterpart on the other side, so the seams don't tear. Open borders only collapse along themselves.
+Vertices where more than two attribute islands meet or the topology is non-manifold never move.
+This means the input should have been welded (`IMeshManipulator::createMeshBufferWelded`) so only genuine seams remain.
+*/
+class NBL_API2 CMeshSimplifier
+{
+	public:
+		struct SParams
+		{
+			// fraction of the triangles to keep, simplification can stop earlier if it would exceed `targetError`
+			float targetRatio = 0.5f;
+			// largest allowed distance from the original surface, relative to the largest extent of the mesh's bounding box
+			float targetError = 1e-2f;
+			// keeps the open borders intact, so LoDs of meshes tiling a larger surface still line up
+			bool lockBorders = false;
+		};
+
+		struct SStatistics
+		{
+			inline float getReduction() const
+			{
+				return inputTriangleCount ? float(double(outputTriangleCount)/double(inputTriangleCount)):1.f;
+			}
+			//! Input triangles processed per second.
+			inline double getTrianglesPerSecond() const
+			{
+				const auto seconds = std::chrono::duration<double>(buildTime).count();
+				return seconds>0.0 ? double(inputTriangleCount)/seconds:0.0;
+			}
+
+			uint64_t inputTriangleCount = 0ull;
+			uint64_t outputTriangleCount = 0ull;
+			// largest collapse error, as a distance relative to the mesh's extent and in object space
+			float relativeError = 0.f;
+			float absoluteError = 0.f;
+			std::chrono::nanoseconds buildTime = {};
+		};
+
+		//! Simplifies a raw triangle list, `_indices` must all be less than `_positions.size()`.
+		/**
+		@returns false if the index count isn't a multiple of 3 or an index is out of range.
+		*/
+		static bool simplify(core::vector<uint32_t>& _outIndices, std::span<const uint32_t> _indices, std::span<const core::vectorSIMDf> _positions, const SParams& _params, SStatistics* _outStats = nullptr);
+
+		//! Creates a meshbuffer sharing everything but the index buffer with `_inbuffer`, which must be an indexed triangle list.
+		/**
+		Vertices which aren't referenced anymore are left in the vertex buffers.
+		The bounding box gets copied, so stays conservative.
+		@returns nullptr on failure.
+		*/
+		static core::smart_refctd_ptr<ICPUMeshBuffer> createSimplified(const ICPUMeshBuffer* _inbuffer, const SParams& _params, SStatistics* _outStats = nullptr, const system::logger_opt_ptr logger = nullptr);
+
+		//! Creates a LoD per element of `_levels` in parallel, each simplified from `_inbuffer` directly so the errors don't accumulate.
+		/**
+		@param _outStats Either nullptr or an array of `_levels.size()` statistics.
+		@returns One meshbuffer per level, nullptr for the ones which failed.
+		*/
+		static core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> createLoDChain(const ICPUMeshBuffer* _inbuffer, std::span<const SParams> _levels, SStatistics* _outStats = nullptr, const system::logger_opt_ptr logger = nullptr);
+
+	private:
+		CMeshSimplifier() = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,147 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_ASSET_C_MESHLET_BUILDER_H_INCLUDED_
+#define _NBL_ASSET_C_MESHLET_BUILDER_H_INCLUDED_
+
+#include "nbl/asset/ICPUMeshBuffer.h"
+
+#include <chrono>
+#include <span>
+
+// Greedy clustering and cone bounds based on zeux's meshoptimizer (https://github.com/zeux/meshoptimizer) available under MIT license
+
+namespace nbl::asset
+{
+
+//! Partitions triangle lists into meshlets (clusters) of bounded vertex and triangle count, with culling data for each.
+/**
+Triangles get grown into a meshlet greedily across shared vertices, preferring the ones which need the fewest new vertices and
+finish off vertices with few triangles left, so the meshlets come out compact and with a high vertex reuse. When a meshlet has no
+more connected triangles the next one gets picked in index buffer order, so run the vertex cache/overdraw optimizers first.
+
+Within a meshlet vertices are ordered by first use, so the local indices of consecutive triangles are close together
+and the vertex remap of a meshlet reads the original vertex buffer in a cache friendly order.
+
+The output layout is what mesh shaders and `IMeshPackerV2` style batching want: a meshlet references a range of `vertexRemap`
+(meshlet local vertex -> original vertex ID) and a range of `localIndices` (3 bytes per triangle, indexing the meshlet's vertices).
+*/
+class NBL_API2 CMeshletBuilder
+{
+	public:
+		// local indices are bytes
+		static inline constexpr uint32_t MaxVertices = 256u;
+		// only bounds the per meshlet scratch, mesh shader limits are usually much lower
+		static inline constexpr uint32_t MaxTriangles = 512u;
+
+		struct SParams
+		{
+			inline bool valid() const
+			{
+				return maxVertices>=3u && maxVertices<=MaxVertices && maxTriangles>=1u && maxTriangles<=MaxTriangles;
+			}
+
+			uint32_t maxVertices = 64u;
+			uint32_t maxTriangles = 124u;
+			// how much a triangle facing away from the meshlet's average normal gets penalized while growing, in [0,1],
+			// higher values give tighter normal cones (better backface culling) at the cost of fuller meshlets
+			float coneWeight = 0.f;
+		};
+
+		struct SMeshlet
+		{
+			// into `SResult::vertexRemap`
+			uint32_t vertexOffset;
+			// into `SResult::localIndices`, in bytes
+			uint32_t triangleOffset;
+			uint32_t vertexCount;
+			uint32_t triangleCount;
+		};
+		//! Culling data, all in the mesh's object space.
+		/**
+		The meshlet can be skipped if its sphere is outside the frustum.
+		It is entirely backfacing (so can also be skipped) if `dot(normalize(coneApex-cameraPosition),coneAxis) >= coneCutoff`,
+		a cone which can't ever be culled has a `coneCutoff` of 1.
+		*/
+		struct SBounds
+		{
+			// xyz is the center, w the radius
+			core::vectorSIMDf boundingSphere;
+			core::vectorSIMDf coneApex;
+			// xyz is the axis, w the cutoff
+			core::vectorSIMDf coneAxisCutoff;
+		};
+
+		struct SStatistics
+		{
+			inline SStatistics& operator+=(const SStatistics& other)
+			{
+				meshletCount += other.meshletCount;
+				triangleCount += other.triangleCount;
+				vertexCount += other.vertexCount;
+				buildTime += other.buildTime;
+				return *this;
+			}
+
+			//! Average fraction of the vertex limit used per meshlet.
+			inline float getVertexFillRate(const SParams& params) const
+			{
+				return meshletCount ? float(double(vertexCount)/(double(meshletCount)*params.maxVertices)):0.f;
+			}
+			//! Average fraction of the triangle limit used per meshlet.
+			inline float getTriangleFillRate(const SParams& params) const
+			{
+				return meshletCount ? float(double(triangleCount)/(double(meshletCount)*params.maxTriangles)):0.f;
+			}
+			//! Meshlet vertices per triangle, the vertex shader invocations a mesh shader pipeline would make per triangle.
+			inline float getVerticesPerTriangle() const
+			{
+				return triangleCount ? float(double(vertexCount)/double(triangleCount)):0.f;
+			}
+			//! Build throughput, summed build times of meshbuffers built in parallel give the per-thread throughput.
+			inline double getTrianglesPerSecond() const
+			{
+				const auto seconds = std::chrono::duration<double>(buildTime).count();
+				return seconds>0.0 ? double(triangleCount)/seconds:0.0;
+			}
+
+			uint64_t meshletCount = 0ull;
+			uint64_t triangleCount = 0ull;
+			// sum of the meshlets' vertex counts, so vertices shared between meshlets count multiple times
+			uint64_t vertexCount = 0ull;
+			std::chrono::nanoseconds buildTime = {};
+		};
+
+		struct SResult
+		{
+			core::vector<SMeshlet> meshlets;
+			// one per meshlet
+			core::vector<SBounds> bounds;
+			core::vector<uint32_t> vertexRemap;
+			core::vector<uint8_t> localIndices;
+			SStatistics statistics;
+		};
+
+		//! Builds meshlets for an indexed or non-indexed triangle list meshbuffer, vertex IDs in the output are the ones the index buffer uses.
+		/**
+		@returns false (leaving `_out` empty) if the meshbuffer isn't a triangle list, has no position attribute or `_params` are invalid.
+		*/
+		static bool build(SResult& _out, const ICPUMeshBuffer* _meshbuffer, const SParams& _params, const system::logger_opt_ptr logger = nullptr);
+		//! Builds meshlets for many meshbuffers in parallel, `_out` must have the same length as `_meshbuffers`.
+		/**
+		@returns false if any of the meshbuffers failed, the others still get built.
+		*/
+		static bool build(std::span<SResult> _out, std::span<const ICPUMeshBuffer* const> _meshbuffers, const SParams& _params, const system::logger_opt_ptr logger = nullptr);
+
+		//! Builds meshlets for a raw triangle list, `_indices` must all be less than `_positions.size()`.
+		static bool build(SResult& _out, std::span<const uint32_t> _indices, std::span<const core::vectorSIMDf> _positions, const SParams& _params);
+
+	private:
+		CMeshletBuilder() = delete;
+
+		static SBounds computeBounds(const uint32_t* _remap, const uint8_t* _localIndices, const SMeshlet& _meshlet, const core::vectorSIMDf* _positions);
+};
+
+}
+
+#endif
@@ -56,11 +56,20 @@ class CQuantNormalCache : public CDirQuantCacheBase<impl::VectorUV,impl::QuantNo
 
 	public:
 		template<E_FORMAT CacheFormat>
-		value_type_t<CacheFormat> quantize(core::vectorSIMDf normal)
+		value_type_t<CacheFormat> quantize(core::vectorSIMDf normal) const
 		{
 			normal.makeSafe3D();
 			return Base::quantize<3u,CacheFormat>(normal);
 		}
+		//! Quantizes a whole array of normals at once, much faster than one by one when many of them miss the cache.
+		template<E_FORMAT CacheFormat>
+		void quantize(const std::span<const core::vectorSIMDf> normals, value_type_t<CacheFormat>* out) const
+		{
+			core::vector<core::vectorSIMDf> safeNormals(normals.begin(),normals.end());
+			for (auto& normal : safeNormals)
+				normal.makeSafe3D();
+			Base::quantize<3u,CacheFormat>(safeNormals,out);
+		}
 };
 
 }
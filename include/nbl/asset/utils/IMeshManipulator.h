@@ -17,6 +17,9 @@
 
 #include "nbl/asset/utils/CQuantNormalCache.h"
 #include "nbl/asset/utils/CQuantQuaternionCache.h"
+#include "nbl/asset/utils/CForsythVertexCacheOptimizer.h"
+#include "nbl/asset/utils/CMeshletBuilder.h"
+#include "nbl/asset/utils/CMeshSimplifier.h"
 
 namespace nbl
 {
@@ -385,6 +388,19 @@ class NBL_API2 IMeshManipulator : public virtual core::IReferenceCounted
 				const uint32_t maxWeights = computeJointAABBs ? getFormatChannelCount(meshbuffer->getAttribFormat(jointWeightAttrId)):0u;
 				const auto* inverseBindPoses = meshbuffer->getInverseBindPoses();
 
+				// unskinned positions get batched up for a wide SIMD min/max instead of growing the box one point at a time
+				constexpr uint32_t BatchSize = 256u;
+				core::vectorSIMDf batchedPositions[BatchSize];
+				uint32_t batchedCount = 0u;
+				auto flushBatch = [&]() -> void
+				{
+					core::vectorSIMDf batchMin,batchMax;
+					core::batch::minMax({batchedPositions,batchedCount},batchMin,batchMax);
+					aabb.addInternalPoint(batchMin.getAsVector3df());
+					aabb.addInternalPoint(batchMax.getAsVector3df());
+					batchedCount = 0u;
+				};
+
 				for (uint32_t j=0u; j<indexCountOverride; j++)
 				{
 					uint32_t ix;
@@ -418,8 +434,14 @@ class NBL_API2 IMeshManipulator : public virtual core::IReferenceCounted
 					}
 					
 					if (noJointInfluence)
-						aabb.addInternalPoint(pos.getAsVector3df());
+					{
+						batchedPositions[batchedCount++] = pos;
+						if (batchedCount==BatchSize)
+							flushBatch();
+					}
 				}
+				if (batchedCount)
+					flushBatch();
 			};
 
 			if (!indexBufferOverride)
@@ -486,9 +508,32 @@ class NBL_API2 IMeshManipulator : public virtual core::IReferenceCounted
 		\return Mesh without redundant vertices. */
 		static core::smart_refctd_ptr<ICPUMeshBuffer> createMeshBufferWelded(ICPUMeshBuffer *inbuffer, const SErrorMetric* errMetrics, const bool& optimIndexType = true, const bool& makeNewMesh = false);
 
+		//! Vertex cache efficiency before and after `createOptimizedMeshBuffer`, as simulated by `CForsythVertexCacheOptimizer::analyzeVertexCache`.
+		struct SOptimizationStatistics
+		{
+			//! Throughput of the whole optimizing pipeline, summed times of meshbuffers optimized in parallel give the per-thread throughput.
+			inline double getIndicesPerSecond() const
+			{
+				const auto seconds = std::chrono::duration<double>(optimizeTime).count();
+				return seconds>0.0 ? double(indexCount)/seconds:0.0;
+			}
+
+			// of the triangle list the input converts to, before welding
+			CForsythVertexCacheOptimizer::SCacheStatistics before;
+			// of the reordered triangle list, before requantization which doesn't change the order
+			CForsythVertexCacheOptimizer::SCacheStatistics after;
+			uint64_t indexCount = 0ull;
+			std::chrono::nanoseconds optimizeTime = {};
+		};
+
 		//! Throws meshbuffer into full optimizing pipeline consisting of: vertices welding, z-buffer optimization, vertex cache optimization (Forsyth's algorithm), fetch optimization and attributes requantization. A new meshbuffer is created unless given meshbuffer doesn't own (getMeshDataAndFormat()==NULL) a data format descriptor.
-		/**@return A new meshbuffer or NULL if an error occured. */
-		static core::smart_refctd_ptr<ICPUMeshBuffer> createOptimizedMeshBuffer(const ICPUMeshBuffer* inbuffer, const SErrorMetric* _errMetric);
+		/**@param _outStats Optional, filled in if the meshbuffer got optimized.
+		@return A new meshbuffer or NULL if an error occured. */
+		static core::smart_refctd_ptr<ICPUMeshBuffer> createOptimizedMeshBuffer(const ICPUMeshBuffer* inbuffer, const SErrorMetric* _errMetric, SOptimizationStatistics* _outStats = nullptr);
+		//! Runs `createOptimizedMeshBuffer` on independent meshbuffers (e.g. the submeshes of a mesh) in parallel.
+		/**@param _outStats Either nullptr or an array of `_inbuffers.size()` statistics.
+		@return One meshbuffer per input, NULL for the ones which failed. */
+		static core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> createOptimizedMeshBuffers(std::span<const ICPUMeshBuffer* const> _inbuffers, const SErrorMetric* _errMetric, SOptimizationStatistics* _outStats = nullptr);
 
 		//! Requantizes vertex attributes to the smallest possible types taking into account values of the attribute under consideration. A brand new vertex buffer is created and attributes are going to be interleaved in single buffer.
 		/**
@@ -499,6 +544,35 @@ class NBL_API2 IMeshManipulator : public virtual core::IReferenceCounted
 		*/
 		static void requantizeMeshBuffer(ICPUMeshBuffer* _meshbuffer, const SErrorMetric* _errMetric);
 
+		//! Partitions a triangle list into meshlets of bounded size with per meshlet bounding spheres and normal cones, see `CMeshletBuilder`.
+		/**
+		@param _out Meshlets, their culling data and the build statistics.
+		@param _meshbuffer Input meshbuffer, ideally already vertex cache optimized (e.g. by `createOptimizedMeshBuffer`).
+		@param _params Vertex and triangle limits per meshlet.
+		@returns false if the meshbuffer isn't a triangle list or has no positions.
+		*/
+		static inline bool createMeshlets(CMeshletBuilder::SResult& _out, const ICPUMeshBuffer* _meshbuffer, const CMeshletBuilder::SParams& _params)
+		{
+			return CMeshletBuilder::build(_out,_meshbuffer,_params);
+		}
+
+		//! Creates a decimated copy of an indexed triangle list, sharing the vertex buffers with the input, see `CMeshSimplifier`.
+		/**
+		@param _inbuffer Input meshbuffer, welded so that only genuine attribute seams remain (e.g. by `createMeshBufferWelded`).
+		@param _params Target triangle ratio and error.
+		@returns A new meshbuffer or nullptr if an error occured.
+		*/
+		static inline core::smart_refctd_ptr<ICPUMeshBuffer> createMeshBufferSimplified(const ICPUMeshBuffer* _inbuffer, const CMeshSimplifier::SParams& _params)
+		{
+			return CMeshSimplifier::createSimplified(_inbuffer,_params);
+		}
+
+		//! Creates one LoD per element of `_levels` in parallel, for the LoD tables of `scene::CLevelOfDetailLibrary`.
+		static inline core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> createLoDChain(const ICPUMeshBuffer* _inbuffer, std::span<const CMeshSimplifier::SParams> _levels)
+		{
+			return CMeshSimplifier::createLoDChain(_inbuffer,_levels);
+		}
+
         //! Creates a 32bit index buffer for a mesh with primitive types changed to list types
         /**#
 		@param _newPrimitiveType
@@ -8,6 +8,7 @@
 #include <atomic>
 #include <thread>
 #include <iterator>
+#include <span>
 
 namespace nbl::core
 {
@@ -374,6 +375,100 @@ public:
 
 }
 
+// Lock-free ring for exactly one producer thread and one consumer thread
+// Unlike the buffers above it never overwrites, pushing into a full ring fails and the producer decides what to do about it.
+template <typename T>
+class CSPSCCircularBuffer : public impl::CConstantRuntimeSizedCircularBufferBase<T>
+{
+    using base_t = impl::CConstantRuntimeSizedCircularBufferBase<T>;
+    using counter_t = uint64_t;
+
+    // keeps the producer's and the consumer's counters on separate cache lines
+    static inline constexpr size_t CounterAlignment = 64ull;
+
+    counter_t wrapAround(counter_t x) const
+    {
+        return x & (static_cast<counter_t>(base_t::capacity()) - static_cast<counter_t>(1));
+    }
+
+public:
+    using type = T;
+
+    explicit CSPSCCircularBuffer(size_t cap) : base_t(cap) {}
+    ~CSPSCCircularBuffer()
+    {
+        consume([](std::span<type>) -> void {});
+    }
+
+    // Producer only
+    template <typename... Args>
+    bool try_emplace_back(Args&&... args)
+    {
+        const counter_t end = m_end.load(std::memory_order_relaxed);
+        // only go to the consumer's cache line when the stale view says the ring is full
+        if (end-m_producerCachedBegin >= base_t::capacity())
+        {
+            m_producerCachedBegin = m_begin.load(std::memory_order_acquire);
+            if (end-m_producerCachedBegin >= base_t::capacity())
+                return false;
+        }
+        new (base_t::getStorage()+wrapAround(end)) type(std::forward<Args>(args)...);
+        m_end.store(end+1u, std::memory_order_release);
+        return true;
+    }
+    bool try_push_back(const type& a)
+    {
+        return try_emplace_back(a);
+    }
+    bool try_push_back(type&& a)
+    {
+        return try_emplace_back(std::move(a));
+    }
+
+    // Consumer only, passes the oldest `maxCount` (or fewer) elements to `f` as at most two contiguous spans, then pops them
+    template <typename F>
+    size_t consume(F&& f, const size_t maxCount = ~0ull)
+    {
+        const counter_t begin = m_begin.load(std::memory_order_relaxed);
+        const counter_t end = m_end.load(std::memory_order_acquire);
+        const counter_t count = std::min<counter_t>(end-begin, maxCount);
+        if (count == 0u)
+            return 0ull;
+
+        type* const storage = base_t::getStorage();
+        const counter_t first = wrapAround(begin);
+        const counter_t firstCount = std::min<counter_t>(count, base_t::capacity()-first);
+        f(std::span<type>(storage+first, firstCount));
+        if (count > firstCount)
+            f(std::span<type>(storage, count-firstCount));
+
+        if constexpr (!std::is_trivially_destructible_v<type>)
+        for (counter_t i = 0u; i < count; ++i)
+            storage[wrapAround(begin+i)].~type();
+        m_begin.store(begin+count, std::memory_order_release);
+        return count;
+    }
+
+    // Only a snapshot when called concurrently with the other thread
+    size_t size() const
+    {
+        // loading `begin` first guarantees it can't overtake `end`
+        const counter_t begin = m_begin.load(std::memory_order_acquire);
+        return m_end.load(std::memory_order_acquire) - begin;
+    }
+    bool empty() const
+    {
+        return size() == 0ull;
+    }
+
+private:
+    // written by the consumer
+    alignas(CounterAlignment) std::atomic<counter_t> m_begin = 0u;
+    // written by the producer
+    alignas(CounterAlignment) std::atomic<counter_t> m_end = 0u;
+    counter_t m_producerCachedBegin = 0u;
+};
+
 template <typename T, size_t S, bool AllowOverflows = true>
 class CCompileTimeSizedCircularBuffer : public impl::CCircularBufferBase<impl::CCompileTimeSizedCircularBufferBase<T, S>, AllowOverflows>
 {
@@ -51,6 +51,7 @@
 #include "nbl/core/math/rational.h"
 #include "nbl/core/math/plane3dSIMD.h"
 #include "nbl/core/math/matrixutil.h"
+#include "nbl/core/math/batchSIMD.h"
 // memory
 #include "nbl/core/memory/memory.h"
 #include "nbl/core/memory/new_delete.h"
@@ -64,6 +65,7 @@
 // string
 #include "nbl/core/string/stringutil.h"
 #include "nbl/core/string/StringLiteral.h"
+#include "nbl/core/string/base64.h"
 // util
 #include "nbl/core/util/bitflag.h"
 #include "nbl/core/util/to_underlying.h"
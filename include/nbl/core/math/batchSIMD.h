@@ -0,0 +1,92 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_CORE_MATH_BATCH_SIMD_H_INCLUDED_
+#define _NBL_CORE_MATH_BATCH_SIMD_H_INCLUDED_
+
+#include "aabbox3d.h"
+#include "nbl/core/math/plane3dSIMD.h"
+
+#include <span>
+
+//! Batched geometry math over whole arrays, for when `vectorSIMDf` one-at-a-time processing leaves 3/4 of an AVX register empty.
+/**
+Internally everything is processed "lane per element" (Structure of Arrays), so an AVX2 register holds 8 points' X coordinates
+and an AVX-512 register 16 of them. The Array of Structures overloads gather/scatter on the fly, if you control the storage
+prefer the SoA overloads as they're plain loads and stores.
+
+The kernels are compiled once per instruction set (SSE4.2, AVX2+FMA, AVX-512F) and the best one the CPU and OS support is picked
+on first use, so there's no need to build Nabla with `-march=native` to benefit. Results only differ between ISAs by FMA rounding.
+*/
+namespace nbl::core::batch
+{
+
+enum class E_ISA : uint8_t
+{
+	SSE4_2,
+	AVX2,
+	AVX512
+};
+//! ISA the batch functions currently dispatch to.
+NBL_API2 E_ISA getISA();
+//! The best ISA the CPU and OS support.
+NBL_API2 E_ISA getMaxSupportedISA();
+//! Mainly for benchmarking and testing the fallbacks, gets clamped to `getMaxSupportedISA()`, returns the ISA actually set.
+//! Not thread-safe with respect to batch calls already in flight.
+NBL_API2 E_ISA setISA(const E_ISA isa);
+
+//! Points laid out as separate X, Y and Z arrays.
+struct SPointsSoA
+{
+	float* x;
+	float* y;
+	float* z;
+};
+struct SConstPointsSoA
+{
+	const float* x;
+	const float* y;
+	const float* z;
+};
+
+//! Component-wise min and max of the XYZ of `points`, the W component of the outputs is 0.
+//! Returns an inverted (+FLT_MAX min, -FLT_MAX max) box for empty input.
+NBL_API2 void minMax(const std::span<const vectorSIMDf> points, vectorSIMDf& outMin, vectorSIMDf& outMax);
+NBL_API2 void minMax(const SConstPointsSoA points, const size_t count, vectorSIMDf& outMin, vectorSIMDf& outMax);
+//! Convenience for the above producing an `aabbox3df`.
+inline aabbox3df computeAABB(const std::span<const vectorSIMDf> points)
+{
+	vectorSIMDf mn,mx;
+	minMax(points,mn,mx);
+	return aabbox3df(mn.getAsVector3df(),mx.getAsVector3df());
+}
+
+//! Same as `matrix3x4SIMD::pseudoMulWith4x1` on every point, so the input W is ignored and the output W is 1.
+//! `out` may alias `in`, but the arrays may not partially overlap.
+NBL_API2 void transformPoints(const matrix3x4SIMD& m, const std::span<const vectorSIMDf> in, vectorSIMDf* out);
+NBL_API2 void transformPoints(const matrix3x4SIMD& m, const SConstPointsSoA in, const SPointsSoA out, const size_t count);
+
+//! Transforms boxes and recomputes tight axis aligned bounds of the result (Arvo's method), all boxes must be valid (Min<=Max).
+//! `out` may alias `in`.
+NBL_API2 void transformAABBs(const matrix3x4SIMD& m, const std::span<const aabbox3df> in, aabbox3df* out);
+
+//! Tests boxes against a convex volume given by planes with normals pointing inwards (a frustum), a box is rejected only if it
+//! lies fully on the negative side of any plane so the test is conservative. The planes need not be normalized.
+//! Writes 1 for visible and 0 for rejected boxes to `outVisible` (if not null) and returns the number of visible boxes.
+NBL_API2 size_t cullAABBs(const std::span<const plane3dSIMDf> planes, const std::span<const aabbox3df> boxes, uint8_t* outVisible);
+
+//! For every direction finds the indices of the points with the smallest and largest projection onto it,
+//! ties get resolved to the lowest index. Directions need not be normalized, only their XYZ is used.
+//! `outMinIx` and `outMaxIx` must hold `dirs.size()` elements, all indices are 0 when there are no points.
+NBL_API2 void extremalPoints(const std::span<const vectorSIMDf> points, const std::span<const vectorSIMDf> dirs, uint32_t* outMinIx, uint32_t* outMaxIx);
+
+//! For the absolute value of the XYZ of every direction finds the vector of integers in [0,maxComponent] pointing closest to it,
+//! trying every length of the largest component with the other components rounded either way (an exhaustive best fit).
+//! Writes the integers as floats into the XYZ of `out` with W=0, zero length directions produce 0. `out` may alias `dirs`.
+//! Cost is linear in `maxComponent`, this is what `asset::CDirQuantCacheBase` uses to fill its cache.
+//! The search uses no fused multiply-adds, so the results (and caches serialized from them) are the same whichever ISA runs it.
+NBL_API2 void bestFitDirections(const std::span<const vectorSIMDf> dirs, const uint32_t maxComponent, vectorSIMDf* out);
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_CORE_STRING_BASE64_H_INCLUDED_
+#define _NBL_CORE_STRING_BASE64_H_INCLUDED_
+
+#include "nbl/core/decl/compile_config.h"
+
+#include <cstdint>
+#include <string_view>
+
+namespace nbl::core::base64
+{
+
+//! Exact number of bytes `decode` will produce for a well formed (optionally padded) input
+inline size_t decodedSize(const std::string_view encoded)
+{
+	size_t len = encoded.size();
+	while (len && encoded[len-1u]=='=')
+		len--;
+	return (len/4u)*3u+((len%4u)*3u)/4u;
+}
+
+namespace impl
+{
+// 0xff marks characters outside of the RFC 4648 alphabet, padding is handled separately
+constexpr inline uint8_t InvalidSextet = 0xffu;
+struct SDecodeTable
+{
+	constexpr SDecodeTable() : value()
+	{
+		for (auto i=0u; i<256u; i++)
+			value[i] = InvalidSextet;
+		for (auto i=0u; i<26u; i++)
+		{
+			value['A'+i] = i;
+			value['a'+i] = 26u+i;
+		}
+		for (auto i=0u; i<10u; i++)
+			value['0'+i] = 52u+i;
+		value['+'] = 62u;
+		value['/'] = 63u;
+	}
+
+	uint8_t value[256];
+};
+constexpr inline SDecodeTable DecodeTable = {};
+
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+// Decodes 16 characters into 12 bytes (writes 16), returns false if any character is outside the alphabet.
+// Classification and translation via nibble lookup tables as described by W. Mula and D. Lemire.
+inline bool decode16(const char* in, uint8_t* out)
+{
+	const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+
+	const __m128i lutLo = _mm_setr_epi8(0x15,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x13,0x1A,0x1B,0x1B,0x1B,0x1A);
+	const __m128i lutHi = _mm_setr_epi8(0x10,0x10,0x01,0x02,0x04,0x08,0x04,0x08,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10);
+	const __m128i lutRoll = _mm_setr_epi8(0,16,19,4,-65,-65,-71,-71,0,0,0,0,0,0,0,0);
+	const __m128i mask2F = _mm_set1_epi8(0x2f);
+
+	const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(chars,4),mask2F);
+	const __m128i loNibbles = _mm_and_si128(chars,mask2F);
+	const __m128i lo = _mm_shuffle_epi8(lutLo,loNibbles);
+	const __m128i hi = _mm_shuffle_epi8(lutHi,hiNibbles);
+	if (!_mm_testz_si128(lo,hi))
+		return false;
+
+	const __m128i eq2F = _mm_cmpeq_epi8(chars,mask2F);
+	const __m128i roll = _mm_shuffle_epi8(lutRoll,_mm_add_epi8(eq2F,hiNibbles));
+	const __m128i sextets = _mm_add_epi8(chars,roll);
+
+	// pack 4x6bit into 3x8bit in every 32bit lane, then squeeze the lanes together
+	const __m128i mergedPairs = _mm_maddubs_epi16(sextets,_mm_set1_epi32(0x01400140));
+	const __m128i mergedQuads = _mm_madd_epi16(mergedPairs,_mm_set1_epi32(0x00011000));
+	const __m128i packed = _mm_shuffle_epi8(mergedQuads,_mm_setr_epi8(2,1,0,6,5,4,10,9,8,14,13,12,-1,-1,-1,-1));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out),packed);
+	return true;
+}
+#endif
+}
+
+//! Decodes RFC 4648 base64 (standard alphabet, optional `=` padding) into `out`
+/** `out` must have room for at least `decodedSize(encoded)` bytes, nothing past that is ever written.
+@returns number of bytes written, or `~0ull` if the input is malformed.
+*/
+inline size_t decode(const std::string_view encoded, uint8_t* out)
+{
+	size_t len = encoded.size();
+	while (len && encoded[len-1u]=='=')
+		len--;
+	if (encoded.size()-len>2u || (len%4u)==1u)
+		return ~0ull;
+
+	const char* in = encoded.data();
+	uint8_t* const outBegin = out;
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+	// the vector path stores 16 bytes for every 12 decoded, staying 8 characters away from the tail keeps the overhang in bounds
+	for (const char* const inEnd=in+len; inEnd-in>=24; in+=16, out+=12)
+	{
+		if (!impl::decode16(in,out))
+			return ~0ull;
+	}
+#endif
+	const char* const end = encoded.data()+len;
+	for (; end-in>=4; in+=4, out+=3)
+	{
+		const uint32_t a = impl::DecodeTable.value[uint8_t(in[0])];
+		const uint32_t b = impl::DecodeTable.value[uint8_t(in[1])];
+		const uint32_t c = impl::DecodeTable.value[uint8_t(in[2])];
+		const uint32_t d = impl::DecodeTable.value[uint8_t(in[3])];
+		if ((a|b|c|d)&0x80u)
+			return ~0ull;
+		const uint32_t triple = (a<<18u)|(b<<12u)|(c<<6u)|d;
+		out[0] = uint8_t(triple>>16u);
+		out[1] = uint8_t(triple>>8u);
+		out[2] = uint8_t(triple);
+	}
+	// 2 or 3 leftover characters encode 1 or 2 bytes
+	if (const auto leftover=end-in; leftover)
+	{
+		uint32_t triple = 0u;
+		for (auto i=0; i<leftover; i++)
+		{
+			const uint32_t sextet = impl::DecodeTable.value[uint8_t(in[i])];
+			if (sextet&0x80u)
+				return ~0ull;
+			triple |= sextet<<(18u-6u*i);
+		}
+		*(out++) = uint8_t(triple>>16u);
+		if (leftover==3)
+			*(out++) = uint8_t(triple>>8u);
+	}
+	return out-outBegin;
+}
+
+}
+
+#endif
@@ -90,7 +90,7 @@ public:
 		float64_t2 size;
 	};
 
-	FontFace(core::smart_refctd_ptr<TextRenderer>&& textRenderer, const std::string& path)
+	FontFace(core::smart_refctd_ptr<TextRenderer>&& textRenderer, const std::string& path) : m_path(path)
 	{
 		m_textRenderer = std::move(textRenderer);
 
@@ -132,6 +132,7 @@ public:
 	float32_t2 getUV(float32_t2 uv, float32_t2 glyphSize, uint32_t2 textureExtents, uint32_t msdfPixelRange);
 
 	size_t getHash() { return m_hash; }
+	const std::string& getPath() const { return m_path; }
 	
 	// TODO: make these protected, it's only used for customized tests such as building shapes for hatches
 	FT_GlyphSlot getGlyphSlot(uint32_t glyphId)
@@ -145,9 +146,76 @@ public:
 
 protected:
 
+	friend class FontAtlas;
 	core::smart_refctd_ptr<TextRenderer> m_textRenderer;
 	FT_Face m_ftFace;
 	size_t m_hash;
+	std::string m_path;
+};
+
+// Bakes the MSDFs of a set of codepoints into the layers of one atlas image
+// Shapes are extracted serially (FreeType faces aren't thread safe), then the MSDFs get generated in parallel straight into the
+// pages packed with `stb_rect_pack`. Baked atlases can be cached on disk, keyed by the font file's contents and the creation parameters.
+class FontAtlas : public nbl::core::IReferenceCounted
+{
+public:
+	struct SCreationParams
+	{
+		// codepoints without a glyph in the font get skipped
+		std::span<const wchar_t> codepoints;
+		// size of the font's em square in atlas pixels, every glyph gets rasterized with the same scale
+		float32_t pixelsPerEm = 32.f;
+		uint32_t msdfPixelRange = 4u;
+		uint32_t2 pageExtents = uint32_t2(1024u, 1024u);
+	};
+
+	struct SGlyph
+	{
+		uint32_t glyphIndex;
+		// array layer of the atlas image, meaningless if the glyph has no outline (e.g. a space) and `extents` are zero
+		uint32_t page;
+		uint32_t2 offset;
+		uint32_t2 extents;
+		// l,b,r,t rectangle in the same units as `FontFace::GlyphMetrics` (relative to the pen position) which maps onto the texels above
+		float32_t4 planeBounds;
+	};
+
+	// Generates all the glyphs, returns nullptr if a glyph doesn't fit on a page
+	static core::smart_refctd_ptr<FontAtlas> create(FontFace* face, const SCreationParams& params);
+	// Loads the atlas from `cachePath` if it was baked from the same font file with the same parameters, otherwise bakes it and writes it there
+	static core::smart_refctd_ptr<FontAtlas> create(system::ISystem* system, const system::path& cachePath, FontFace* face, const SCreationParams& params);
+
+	// Hash of the font file's contents and everything in `params` that influences the output, nullopt if the font file can't be read
+	static std::optional<core::blake3_hash_t> computeCacheKey(system::ISystem* system, const FontFace* face, const SCreationParams& params);
+
+	// Only atlases created with a cache key can be saved
+	bool save(system::ISystem* system, const system::path& cachePath) const;
+	static core::smart_refctd_ptr<FontAtlas> load(system::ISystem* system, const system::path& cachePath, const core::blake3_hash_t& cacheKey);
+
+	// nullptr if the codepoint wasn't baked
+	inline const SGlyph* getGlyph(wchar_t codepoint) const
+	{
+		auto found = m_glyphs.find(codepoint);
+		return found != m_glyphs.end() ? &found->second : nullptr;
+	}
+
+	// 2D array image in `TextRenderer::MSDFTextureFormat` with one layer per page
+	ICPUImage* getImage() { return m_image.get(); }
+	const ICPUImage* getImage() const { return m_image.get(); }
+	uint32_t getPageCount() const { return m_image->getCreationParameters().arrayLayers; }
+
+	const core::blake3_hash_t& getCacheKey() const { return m_cacheKey; }
+
+protected:
+	FontAtlas(core::unordered_map<wchar_t, SGlyph>&& glyphs, core::smart_refctd_ptr<ICPUImage>&& image, const core::blake3_hash_t& cacheKey) :
+		m_glyphs(std::move(glyphs)), m_image(std::move(image)), m_cacheKey(cacheKey) {}
+
+	static core::smart_refctd_ptr<ICPUImage> createPages(uint32_t2 pageExtents, uint32_t pageCount);
+
+	core::unordered_map<wchar_t, SGlyph> m_glyphs;
+	core::smart_refctd_ptr<ICPUImage> m_image;
+	// all zeroes for atlases which weren't created with a cache
+	core::blake3_hash_t m_cacheKey = {};
 };
 
 // Helper class for building an msdfgen shape from a glyph
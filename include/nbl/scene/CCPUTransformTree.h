@@ -0,0 +1,158 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_SCENE_C_CPU_TRANSFORM_TREE_H_INCLUDED_
+#define _NBL_SCENE_C_CPU_TRANSFORM_TREE_H_INCLUDED_
+
+#include "nbl/core/declarations.h"
+#include "nbl/core/execution.h"
+
+namespace nbl::scene
+{
+
+//! Host-side transform hierarchy, resolves global transforms (and optionally normal matrices) without a GPU.
+/**
+The node attributes are kept in Structure of Arrays form and sorted by depth, so every level is a contiguous range
+whose parents all live in the previous levels. Propagation walks the levels in order and processes each of them in parallel.
+
+Only nodes whose relative transform changed since the last `propagate`, or whose ancestor got recomputed, are evaluated again.
+The normal matrices use the same compressed encoding as the GPU transform tree's `nbl_glsl_CompressedNormalMatrix_t`.
+*/
+class CCPUTransformTree final : public core::IReferenceCounted
+{
+	public:
+		using node_t = uint32_t;
+		static inline constexpr node_t invalid_node = 0xdeadbeefu;
+
+		using parent_t = node_t;
+		using relative_transform_t = core::matrix3x4SIMD;
+		using global_transform_t = core::matrix3x4SIMD;
+		struct normal_matrix_t
+		{
+			uint32_t compressedComponents[4];
+		};
+
+		static inline core::smart_refctd_ptr<CCPUTransformTree> create(const bool withNormalMatrices=false)
+		{
+			return core::smart_refctd_ptr<CCPUTransformTree>(new CCPUTransformTree(withNormalMatrices),core::dont_grab);
+		}
+
+		//
+		inline bool hasNormalMatrices() const {return m_withNormalMatrices;}
+		inline uint32_t getNodeCount() const {return m_nodeToSlot.size();}
+		//! Only accounts for nodes added since the last `propagate` once it runs again
+		inline uint32_t getLevelCount() const {return m_levelBegin.size()-1u;}
+
+		//! Parents need to be added before their children, returns the handle of the first node, the rest follow consecutively
+		node_t addNodes(const relative_transform_t* relativeTransforms, const parent_t* parents, const uint32_t count);
+		inline node_t addNode(const relative_transform_t& relativeTransform, const parent_t parent=invalid_node)
+		{
+			return addNodes(&relativeTransform,&parent,1u);
+		}
+
+		//
+		inline parent_t getParent(const node_t node) const
+		{
+			const uint32_t parentSlot = m_parentSlot[m_nodeToSlot[node]];
+			return parentSlot!=invalid_node ? m_slotToNode[parentSlot]:invalid_node;
+		}
+		inline const relative_transform_t& getRelativeTransform(const node_t node) const
+		{
+			return m_relativeTransforms[m_nodeToSlot[node]];
+		}
+		inline void setRelativeTransform(const node_t node, const relative_transform_t& relativeTransform)
+		{
+			const uint32_t slot = m_nodeToSlot[node];
+			m_relativeTransforms[slot] = relativeTransform;
+			m_dirty[slot] = true;
+		}
+		//! Up to date after `propagate`
+		inline const global_transform_t& getGlobalTransform(const node_t node) const
+		{
+			return m_globalTransforms[m_nodeToSlot[node]];
+		}
+		inline const normal_matrix_t& getNormalMatrix(const node_t node) const
+		{
+			assert(m_withNormalMatrices);
+			return m_normalMatrices[m_nodeToSlot[node]];
+		}
+
+		//! Same encoding as `nbl_glsl_CompressedNormalMatrix_t_encode` applied to the transpose of the cofactors
+		static normal_matrix_t encodeNormalMatrix(const global_transform_t& globalTransform);
+
+		//! Recomputes the global transforms of all modified nodes and their descendants, returns how many nodes got recomputed
+		template<class ExecutionPolicy>
+		inline uint32_t propagate(ExecutionPolicy&& policy)
+		{
+			if (m_layoutOutdated)
+				sortByDepth();
+
+			std::atomic_uint32_t recomputedCount = 0u;
+			for (uint32_t level=0u; level<getLevelCount(); level++)
+			{
+				const uint32_t levelBegin = m_levelBegin[level];
+				const uint32_t levelEnd = m_levelBegin[level+1u];
+				m_batches.clear();
+				for (uint32_t batch=levelBegin; batch<levelEnd; batch+=BatchSize)
+					m_batches.push_back(batch);
+				// levels only depend on the ones before them, so the batches within a level are independent
+				core::for_each(policy,m_batches.begin(),m_batches.end(),[&](const uint32_t batchBegin)->void
+				{
+					const uint32_t batchEnd = std::min(batchBegin+BatchSize,levelEnd);
+					uint32_t recomputed = 0u;
+					for (uint32_t slot=batchBegin; slot<batchEnd; slot++)
+					{
+						const uint32_t parentSlot = m_parentSlot[slot];
+						if (!m_dirty[slot] && (parentSlot==invalid_node || !m_dirty[parentSlot]))
+							continue;
+						// propagates to the children on the next level
+						m_dirty[slot] = true;
+						if (parentSlot!=invalid_node)
+							m_globalTransforms[slot] = core::concatenateBFollowedByA(m_globalTransforms[parentSlot],m_relativeTransforms[slot]);
+						else
+							m_globalTransforms[slot] = m_relativeTransforms[slot];
+						if (m_withNormalMatrices)
+							m_normalMatrices[slot] = encodeNormalMatrix(m_globalTransforms[slot]);
+						recomputed++;
+					}
+					recomputedCount += recomputed;
+				});
+			}
+			std::fill(m_dirty.begin(),m_dirty.end(),false);
+			return recomputedCount;
+		}
+		inline uint32_t propagate()
+		{
+			return propagate(core::execution::seq);
+		}
+
+	protected:
+		static inline constexpr uint32_t BatchSize = 256u;
+
+		CCPUTransformTree(const bool withNormalMatrices) : m_withNormalMatrices(withNormalMatrices), m_levelBegin(1u,0u) {}
+		~CCPUTransformTree() = default;
+
+		// counting sort of all the slots by depth, keeps the relative order of nodes within a level
+		void sortByDepth();
+
+		const bool m_withNormalMatrices;
+		bool m_layoutOutdated = false;
+		// indexed by `node_t`
+		core::vector<uint32_t> m_nodeToSlot;
+		core::vector<uint32_t> m_depth;
+		// indexed by slot, `m_levelBegin` tells where every level starts (with a past-the-end sentinel)
+		core::vector<node_t> m_slotToNode;
+		core::vector<uint32_t> m_parentSlot;
+		core::vector<relative_transform_t> m_relativeTransforms;
+		core::vector<global_transform_t> m_globalTransforms;
+		core::vector<normal_matrix_t> m_normalMatrices;
+		// not a `vector<bool>` because the batches write to it concurrently
+		core::vector<uint8_t> m_dirty;
+		core::vector<uint32_t> m_levelBegin;
+		// scratch
+		core::vector<uint32_t> m_batches;
+};
+
+}
+
+#endif
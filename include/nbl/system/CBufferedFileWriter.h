@@ -0,0 +1,160 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_SYSTEM_C_BUFFERED_FILE_WRITER_H_INCLUDED_
+#define _NBL_SYSTEM_C_BUFFERED_FILE_WRITER_H_INCLUDED_
+
+#include "nbl/system/IFile.h"
+
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+namespace nbl::system
+{
+
+//! Sequential writer over an `IFile` which coalesces small writes into large blocks.
+/**
+Every `IFile::write` on an unmapped file is a round-trip to the `ISystem` I/O thread, so issuing one per vertex attribute or newline
+makes the writing throughput bound by the request queue instead of the disk. This accumulates the output in a block and only hands
+full blocks to the file. There are two blocks, one is being filled while the previous one's write is in flight, so formatting and I/O overlap.
+
+Also provides allocation free ASCII formatting of numbers, based on `std::to_chars`.
+
+Nothing is guaranteed to be in the file before `flush()` returns, the destructor flushes too but has no way to report failure.
+*/
+class CBufferedFileWriter final
+{
+	public:
+		static inline constexpr size_t DefaultBlockSize = 1ull<<20;
+		// must fit any single formatted number
+		static inline constexpr size_t MinBlockSize = 8ull<<10;
+
+		//! Writes start at `offset` in `file`, which must outlive the writer.
+		inline CBufferedFileWriter(IFile* file, const size_t offset=0ull, const size_t blockSize=DefaultBlockSize)
+			: m_file(file), m_blockSize(std::max(blockSize,MinBlockSize)), m_offset(offset)
+		{
+			for (auto& block : m_blocks)
+				block = std::make_unique<char[]>(m_blockSize);
+		}
+		inline ~CBufferedFileWriter()
+		{
+			// pending writes get cancelled when their future dies
+			flush();
+		}
+
+		//! Offset in the file one past the last byte written so far (not necessarily flushed yet).
+		inline size_t getOffset() const {return m_offset+m_fill;}
+
+		//! Submits whatever is buffered and waits for all writes to complete.
+		//! Returns false if any write since the last flush came up short (e.g. a full disk or a mapped file which can't grow).
+		inline bool flush()
+		{
+			submit();
+			wait(m_current^1u);
+			const bool retval = m_ok;
+			m_ok = true;
+			return retval;
+		}
+
+		//
+		inline void write(const void* data, size_t size)
+		{
+			const auto* src = reinterpret_cast<const char*>(data);
+			while (size)
+			{
+				if (m_fill==m_blockSize)
+					submit();
+				const size_t count = std::min(size,m_blockSize-m_fill);
+				memcpy(m_blocks[m_current].get()+m_fill,src,count);
+				m_fill += count;
+				src += count;
+				size -= count;
+			}
+		}
+		inline void write(const std::string_view str) {write(str.data(),str.size());}
+		inline void put(const char c)
+		{
+			if (m_fill==m_blockSize)
+				submit();
+			m_blocks[m_current][m_fill++] = c;
+		}
+		//! Writes the object representation of `value`, for binary formats.
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline void writeBinary(const T& value) {write(&value,sizeof(T));}
+
+		//! Writes `value` in decimal.
+		template<typename T> requires std::is_integral_v<T>
+		inline void writeInteger(const T value)
+		{
+			formatInPlace([value](char* first, char* last) -> std::to_chars_result {return std::to_chars(first,last,value);});
+		}
+		//! Same as `std::ostream << std::setprecision(precision) << value` with the default floatfield, so `%g` style.
+		template<typename T> requires std::is_floating_point_v<T>
+		inline void writeFloat(const T value, const int precision=6)
+		{
+			formatInPlace([value,precision](char* first, char* last) -> std::to_chars_result {return std::to_chars(first,last,value,std::chars_format::general,precision);});
+		}
+		//! Same as `std::ostream << std::fixed << std::setprecision(precision) << value`, so `%f` style.
+		template<typename T> requires std::is_floating_point_v<T>
+		inline void writeFixed(const T value, const int precision=6)
+		{
+			formatInPlace([value,precision](char* first, char* last) -> std::to_chars_result {return std::to_chars(first,last,value,std::chars_format::fixed,precision);});
+		}
+
+	private:
+		// formats straight into the block, only if the remaining space is too small does the block get submitted and formatting retried
+		template<typename F>
+		inline void formatInPlace(F&& format)
+		{
+			auto* block = m_blocks[m_current].get();
+			auto result = format(block+m_fill,block+m_blockSize);
+			if (result.ec==std::errc::value_too_large)
+			{
+				submit();
+				block = m_blocks[m_current].get();
+				result = format(block,block+m_blockSize);
+				// even a fixed notation `long double` fits in an empty block
+				assert(result.ec==std::errc());
+			}
+			m_fill = result.ptr-block;
+		}
+
+		inline void wait(const uint32_t block)
+		{
+			auto& pending = m_pending[block];
+			if (!pending.has_value())
+				return;
+			if (!pending.value())
+				m_ok = false;
+			pending.reset();
+		}
+		// hands the current block to the file and switches to the other one, which first needs its previous write to complete
+		inline void submit()
+		{
+			if (m_fill)
+			{
+				m_pending[m_current].emplace();
+				m_file->write(m_pending[m_current].value(),m_blocks[m_current].get(),m_offset,m_fill);
+				m_offset += m_fill;
+				m_fill = 0ull;
+				m_current ^= 1u;
+			}
+			wait(m_current);
+		}
+
+		IFile* const m_file;
+		const size_t m_blockSize;
+		std::unique_ptr<char[]> m_blocks[2];
+		// `success_t` can't move, so it gets constructed in place per write
+		std::optional<IFile::success_t> m_pending[2];
+		// offset of the current block's start in the file
+		size_t m_offset;
+		size_t m_fill = 0ull;
+		uint32_t m_current = 0u;
+		bool m_ok = true;
+};
+
+}
+
+#endif
@@ -5,41 +5,37 @@
 
 #include "nbl/system/IFile.h"
 
+#include <chrono>
+#include <mutex>
+
 namespace nbl::system
 {
 
 
-class CMountDirectoryArchive : public IFileArchive
+//! Exposes a directory (recursively) as an archive.
+/**
+The sorted entry list gets built on the first lookup and then kept current from OS change notifications
+(inotify on Linux and Android, incremental; a change notification handle on Windows, rescans only when something changed),
+so `getItemFromPath` and `ISystem::findFileInArchive` are a binary search instead of a walk of the whole tree.
+Elsewhere, or if the notifications can't be set up, the tree gets rescanned when the index is older than `getPollingInterval()`.
+*/
+class NBL_API2 CMountDirectoryArchive : public IFileArchive
 {
-        ISystem* m_system;
-
     public:
-        inline CMountDirectoryArchive(path&& _defaultAbsolutePath, system::logger_opt_smart_ptr&& logger, ISystem* system) :
-            IFileArchive(std::move(_defaultAbsolutePath), std::move(logger))
-        {
-            m_system = system;
-        }
+        CMountDirectoryArchive(path&& _defaultAbsolutePath, system::logger_opt_smart_ptr&& logger, ISystem* system);
 
- 
-        SFileList listAssets() const override
-        {
-            auto items = m_system->listItemsInDirectory(m_defaultAbsolutePath);
-            auto new_entries = std::make_shared<core::vector<SFileList::SEntry>>();
-            for (auto item : items)
-            {
-                if (item.has_extension())
-                {
-                    auto relpath = item.lexically_relative(m_defaultAbsolutePath);
-                    auto entry = SFileList::SEntry{ relpath, 0xdeadbeefu, 0xdeadbeefu, 0xdeadbeefu, EAT_NONE };
-                    new_entries->push_back(entry);
-                }
-            }
-            setItemList(new_entries);
-
-            return IFileArchive::listAssets();
-        }
+        SFileList listAssets() const override;
+
+        //! Forces a full rescan on the next lookup, for when you know the directory changed behind the notifications' back.
+        inline void invalidate() {m_indexValid.store(false);}
+
+        //! Only matters for the polling fallback.
+        inline void setPollingInterval(const std::chrono::milliseconds interval) {m_pollingInterval = interval;}
+        inline std::chrono::milliseconds getPollingInterval() const {return m_pollingInterval;}
+
+    protected:
+        ~CMountDirectoryArchive() override;
 
-    protected:		
 		inline core::smart_refctd_ptr<IFile> getFile_impl(const SFileList::found_t& found, const core::bitflag<IFile::E_CREATE_FLAGS> flags, const std::string_view& password) override
 		{
             system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
@@ -49,7 +45,23 @@ class CMountDirectoryArchive : public IFileArchive
 
             return nullptr;
         }
+
+    private:
+        // platform specific notification state
+        struct SWatcher;
+
+        // both need `m_indexMutex` locked
+        void rebuildIndex() const;
+        // returns false if the changes couldn't be applied incrementally and the index needs a rebuild
+        bool applyChanges() const;
+
+        ISystem* m_system;
+        std::unique_ptr<SWatcher> m_watcher;
+        std::chrono::milliseconds m_pollingInterval = std::chrono::milliseconds(500);
+        mutable std::chrono::steady_clock::time_point m_lastScan = {};
+        mutable std::mutex m_indexMutex;
+        mutable std::atomic_bool m_indexValid = false;
 };
 
 } //namespace nbl::system
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,266 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_SYSTEM_C_MOUNT_POINT_TRIE_H_INCLUDED_
+#define _NBL_SYSTEM_C_MOUNT_POINT_TRIE_H_INCLUDED_
+
+#include "nbl/system/IFileArchive.h"
+
+#include <atomic>
+#include <mutex>
+#include <string_view>
+
+namespace nbl::system
+{
+
+//! Archives mounted in the virtual filesystem, keyed by mount point in a trie of path components.
+/**
+Path components are interned, so finding every archive mounted at a prefix of a path is a single descent which
+slices the path's native string in place and neither allocates nor touches the real filesystem.
+
+The trie is copy-on-write: mounting and unmounting build a new immutable snapshot under a mutex and publish it atomically,
+lookups just grab the current snapshot, so they never block and are safe against concurrent (un)mounts.
+*/
+class CMountPointTrie final
+{
+	public:
+		using archive_ptr_t = core::smart_refctd_ptr<IFileArchive>;
+		using char_t = path::value_type;
+		using string_view_t = std::basic_string_view<char_t>;
+
+		inline CMountPointTrie() : m_snapshot(std::make_shared<const SSnapshot>()) {}
+
+		//
+		inline void insert(const path& mountPoint, archive_ptr_t&& archive)
+		{
+			std::lock_guard lock(m_writeMutex);
+			auto snapshot = std::make_shared<SSnapshot>(*m_snapshot.load());
+			const auto normalized = mountPoint.lexically_normal();
+			uint32_t node = 0u;
+			forEachComponent(normalized.native(),[&](const string_view_t component, size_t) -> bool
+			{
+				node = snapshot->getOrCreateChild(node,component);
+				return true;
+			});
+			snapshot->nodes[node].archives.push_back(std::move(archive));
+			m_snapshot.store(std::move(snapshot));
+		}
+		//! Returns whether `archive` was mounted at `mountPoint`.
+		inline bool remove(const IFileArchive* archive, const path& mountPoint)
+		{
+			return removeIf(mountPoint,[archive](const archive_ptr_t& mounted)->bool{return mounted.get()==archive;});
+		}
+		//! Unmounts every archive at `mountPoint`.
+		inline bool removeAll(const path& mountPoint)
+		{
+			return removeIf(mountPoint,[](const archive_ptr_t&)->bool{return true;});
+		}
+
+		//! Calls `f(archive)` for every archive mounted exactly at `mountPoint`.
+		template<typename F>
+		inline void forEachAt(const path& mountPoint, F&& f) const
+		{
+			const auto snapshot = m_snapshot.load();
+			const auto* node = snapshot->find(mountPoint.native());
+			if (node)
+			for (const auto& archive : node->archives)
+				f(archive.get());
+		}
+
+		//! Calls `f(archive,relative)` for every archive mounted at a prefix of `p`, deepest mount point first, until `f` returns true.
+		//! `relative` is the remainder of `p` past the mount point (empty if the mount point is `p` itself) and only valid during the call.
+		//! Returns whether `f` ever returned true. Matching is purely lexical, `p` only gets normalized (allocating) if it contains "..".
+		template<typename F>
+		inline bool forEachMountOf(const path& p, F&& f) const
+		{
+			const auto snapshot = m_snapshot.load();
+			switch (snapshot->forEachMountOf(p.native(),f,false))
+			{
+				case E_DESCENT_RESULT::FOUND:
+					return true;
+				case E_DESCENT_RESULT::NEEDS_NORMALIZATION:
+					return snapshot->forEachMountOf(p.lexically_normal().native(),f,true)==E_DESCENT_RESULT::FOUND;
+				default:
+					break;
+			}
+			return false;
+		}
+
+	private:
+		enum class E_DESCENT_RESULT : uint8_t
+		{
+			NOT_FOUND,
+			FOUND,
+			NEEDS_NORMALIZATION
+		};
+		static inline constexpr uint32_t InvalidNode = ~0u;
+		static inline constexpr char_t ParentDirectory[] = {char_t('.'),char_t('.'),char_t(0)};
+		static inline constexpr char_t CurrentDirectory[] = {char_t('.'),char_t(0)};
+		// the root of an absolute path gets its own component so that "/a" and "a" differ
+		static inline constexpr char_t RootDirectory[] = {char_t('/'),char_t(0)};
+
+		static inline bool isSeparator(const char_t c)
+		{
+			return c==char_t('/') || c==path::preferred_separator;
+		}
+		static inline size_t skipSeparators(const path::string_type& str, size_t pos)
+		{
+			while (pos<str.size() && isSeparator(str[pos]))
+				pos++;
+			return pos;
+		}
+		// `f(component,end)` gets called with every non-empty component other than ".", `end` is the position one past it
+		template<typename F>
+		static inline void forEachComponent(const path::string_type& str, F&& f)
+		{
+			size_t pos = 0ull;
+			if (!str.empty() && isSeparator(str[0]))
+			{
+				if (!f(string_view_t(RootDirectory),1ull))
+					return;
+				pos = 1ull;
+			}
+			while (pos<str.size())
+			{
+				size_t end = pos;
+				while (end<str.size() && !isSeparator(str[end]))
+					end++;
+				const auto component = string_view_t(str.data()+pos,end-pos);
+				if (!component.empty() && component!=string_view_t(CurrentDirectory))
+				if (!f(component,end))
+					return;
+				pos = end+1ull;
+			}
+		}
+
+		struct SComponentHash
+		{
+			using is_transparent = void;
+			inline size_t operator()(const string_view_t str) const {return std::hash<string_view_t>()(str);}
+		};
+		struct SComponentEqual
+		{
+			using is_transparent = void;
+			inline bool operator()(const string_view_t lhs, const string_view_t rhs) const {return lhs==rhs;}
+		};
+
+		struct SSnapshot
+		{
+			struct SNode
+			{
+				// sorted by interned component
+				core::vector<std::pair<uint32_t,uint32_t>> children;
+				core::vector<archive_ptr_t> archives;
+			};
+
+			inline SSnapshot() : nodes(1u) {}
+
+			inline uint32_t findChild(const uint32_t node, const string_view_t component) const
+			{
+				const auto found = components.find(component);
+				if (found==components.end())
+					return InvalidNode;
+				const auto& children = nodes[node].children;
+				const auto child = std::lower_bound(children.begin(),children.end(),std::pair(found->second,0u));
+				if (child==children.end() || child->first!=found->second)
+					return InvalidNode;
+				return child->second;
+			}
+			inline uint32_t getOrCreateChild(const uint32_t node, const string_view_t component)
+			{
+				auto found = components.find(component);
+				if (found==components.end())
+					found = components.emplace(path::string_type(component),uint32_t(components.size())).first;
+				auto& children = nodes[node].children;
+				const auto child = std::lower_bound(children.begin(),children.end(),std::pair(found->second,0u));
+				if (child!=children.end() && child->first==found->second)
+					return child->second;
+				const uint32_t newNode = nodes.size();
+				children.insert(child,{found->second,newNode});
+				// `children` is a dangling reference after this
+				nodes.emplace_back();
+				return newNode;
+			}
+			inline const SNode* find(const path::string_type& str) const
+			{
+				uint32_t node = 0u;
+				forEachComponent(str,[&](const string_view_t component, size_t) -> bool
+				{
+					node = findChild(node,component);
+					return node!=InvalidNode;
+				});
+				return node!=InvalidNode ? (nodes.data()+node):nullptr;
+			}
+			template<typename F>
+			inline E_DESCENT_RESULT forEachMountOf(const path::string_type& str, F& f, const bool allowParentDirectory) const
+			{
+				struct SMatch
+				{
+					uint32_t node;
+					size_t offset;
+				};
+				// mount points nested deeper than this get ignored, it keeps us allocation free and is way more than anyone needs
+				constexpr uint32_t MaxMatches = 32u;
+				SMatch matches[MaxMatches];
+				uint32_t matchCount = 0u;
+
+				uint32_t node = 0u;
+				if (!nodes[node].archives.empty())
+					matches[matchCount++] = {node,0ull};
+				bool needsNormalization = false;
+				forEachComponent(str,[&](const string_view_t component, const size_t end) -> bool
+				{
+					// a ".." further down could still step back into a mount point
+					if (!allowParentDirectory && component==string_view_t(ParentDirectory))
+					{
+						needsNormalization = true;
+						return false;
+					}
+					if (node==InvalidNode)
+						return !allowParentDirectory;
+					node = findChild(node,component);
+					if (node!=InvalidNode && !nodes[node].archives.empty() && matchCount<MaxMatches)
+						matches[matchCount++] = {node,skipSeparators(str,end)};
+					return true;
+				});
+				if (needsNormalization)
+					return E_DESCENT_RESULT::NEEDS_NORMALIZATION;
+
+				while (matchCount--)
+				{
+					const auto& match = matches[matchCount];
+					const auto relative = string_view_t(str.data()+match.offset,str.size()-match.offset);
+					for (const auto& archive : nodes[match.node].archives)
+					if (f(archive.get(),relative))
+						return E_DESCENT_RESULT::FOUND;
+				}
+				return E_DESCENT_RESULT::NOT_FOUND;
+			}
+
+			core::unordered_map<path::string_type,uint32_t,SComponentHash,SComponentEqual> components;
+			// root is the first node, nodes never get removed (only emptied) so indices stay stable
+			core::vector<SNode> nodes;
+		};
+
+		template<typename F>
+		inline bool removeIf(const path& mountPoint, F&& pred)
+		{
+			std::lock_guard lock(m_writeMutex);
+			const auto current = m_snapshot.load();
+			const auto* node = current->find(mountPoint.lexically_normal().native());
+			if (!node || std::none_of(node->archives.begin(),node->archives.end(),pred))
+				return false;
+			auto snapshot = std::make_shared<SSnapshot>(*current);
+			auto& archives = snapshot->nodes[node-current->nodes.data()].archives;
+			std::erase_if(archives,pred);
+			m_snapshot.store(std::move(snapshot));
+			return true;
+		}
+
+		std::atomic<std::shared_ptr<const SSnapshot>> m_snapshot;
+		std::mutex m_writeMutex;
+};
+
+}
+
+#endif
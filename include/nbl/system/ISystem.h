@@ -8,6 +8,7 @@
 #include <variant>
 
 #include "nbl/system/IFileArchive.h"
+#include "nbl/system/CMountPointTrie.h"
 #include "nbl/system/IAsyncQueueDispatcher.h"
 
 namespace nbl::system
@@ -130,22 +131,22 @@ class NBL_API2 ISystem : public core::IReferenceCounted
         }
 
         // After opening and archive, you must mount it if you want the global path lookup to work seamlessly.
+        // Mounting and unmounting is safe to do while other threads are looking files up.
         inline void mount(core::smart_refctd_ptr<IFileArchive>&& archive, const system::path& pathAlias="")
         {
             if (pathAlias.empty())
-                m_cachedArchiveFiles.insert(archive->getDefaultAbsolutePath(),std::move(archive));
+                m_mountPoints.insert(archive->getDefaultAbsolutePath(),std::move(archive));
             else
-                m_cachedArchiveFiles.insert(pathAlias,std::move(archive));
+                m_mountPoints.insert(pathAlias,std::move(archive));
         }
 
         //
         inline void unmount(const IFileArchive* archive, const system::path& pathAlias = "")
         {
-            auto dummy = reinterpret_cast<const core::smart_refctd_ptr<IFileArchive>&>(archive);
             if (pathAlias.empty())
-                m_cachedArchiveFiles.removeObject(dummy,archive->getDefaultAbsolutePath());
+                m_mountPoints.remove(archive,archive->getDefaultAbsolutePath());
             else
-                m_cachedArchiveFiles.removeObject(dummy,pathAlias);
+                m_mountPoints.remove(archive,pathAlias);
         }
 
         void unmountBuiltins();
@@ -212,7 +213,7 @@ class NBL_API2 ISystem : public core::IReferenceCounted
             core::CMultiObjectCache<std::string,core::smart_refctd_ptr<IArchiveLoader>,std::vector> perFileExt;
         } m_loaders;
         //
-        core::CMultiObjectCache<system::path,core::smart_refctd_ptr<IFileArchive>> m_cachedArchiveFiles;
+        CMountPointTrie m_mountPoints;
 
     private:
         struct SRequestParams_NOOP
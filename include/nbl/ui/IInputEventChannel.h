@@ -1,7 +1,7 @@
 #ifndef __NBL_I_INPUT_EVENT_CHANNEL_H_INCLUDED__
 #define __NBL_I_INPUT_EVENT_CHANNEL_H_INCLUDED__
 
-#include <mutex>
+#include <atomic>
 #include <chrono>
 
 #include "nbl/core/IReferenceCounted.h"
@@ -49,33 +49,39 @@ class IEventChannelBase : public IInputEventChannel
         {
         }
 
+        using bg_cb_t = core::CSPSCCircularBuffer<EventType>;
         using cb_t = core::CConstantRuntimeSizedCircularBuffer<EventType>;
         using iterator_t = typename cb_t::iterator;
 
-        std::mutex m_bgEventBufMtx;
-        cb_t m_bgEventBuf;
+        // the OS thread produces and `getEvents` consumes, so no lock is needed between them
+        bg_cb_t m_bgEventBuf;
         cb_t m_frontEventBuf;
+        std::atomic_uint64_t m_droppedEventCount = 0ull;
 
     public:
         //
-        inline size_t getBackgroundBufferCapacity() const {return m_frontEventBuf.capacity();}
+        inline size_t getBackgroundBufferCapacity() const {return m_bgEventBuf.capacity();}
         inline size_t getFrontBufferCapacity() const {return m_frontEventBuf.capacity();}
 
-        // Lock while working with background event buffer
-        inline std::unique_lock<std::mutex> lockBackgroundBuffer()
+        inline bool empty() const override final
         {
-            return std::unique_lock<std::mutex>(m_bgEventBufMtx);
+            return m_bgEventBuf.empty();
         }
 
-        inline bool empty() const override final
+        // Use this within OS-specific impl (Windows callback/XNextEvent loop thread/etc...), only one thread may push into a channel
+        // Returns false if the event got dropped because `getEvents` fell behind by a whole background buffer
+        inline bool pushIntoBackground(EventType&& ev)
         {
-            return m_bgEventBuf.size() == 0ull;
+            if (m_bgEventBuf.try_push_back(std::move(ev)))
+                return true;
+            m_droppedEventCount.fetch_add(1ull,std::memory_order_relaxed);
+            return false;
         }
 
-        // Use this within OS-specific impl (Windows callback/XNextEvent loop thread/etc...)
-        inline void pushIntoBackground(EventType&& ev)
+        // Total number of events `pushIntoBackground` had to drop
+        inline uint64_t getDroppedEventCount() const
         {
-            m_bgEventBuf.push_back(std::move(ev));
+            return m_droppedEventCount.load(std::memory_order_relaxed);
         }
 
         // WARNING: Access to getEvents() must be externally synchronized to be safe!
@@ -118,13 +124,11 @@ class IEventChannelBase : public IInputEventChannel
     private:
         inline void downloadFromBackgroundIntoFront()
         {
-            auto lk = lockBackgroundBuffer();
-
-            while (m_bgEventBuf.size() > 0ull)
+            m_bgEventBuf.consume([this](std::span<EventType> batch) -> void
             {
-                auto ev = m_bgEventBuf.pop_front();
-                m_frontEventBuf.push_back(std::move(ev));
-            }
+                for (auto& ev : batch)
+                    m_frontEventBuf.push_back(std::move(ev));
+            });
         }
 };
 }
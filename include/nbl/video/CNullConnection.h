@@ -0,0 +1,69 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_VIDEO_C_NULL_CONNECTION_H_INCLUDED_
+#define _NBL_VIDEO_C_NULL_CONNECTION_H_INCLUDED_
+
+#include "nbl/video/IAPIConnection.h"
+#include "nbl/video/IPhysicalDevice.h"
+
+namespace nbl::video
+{
+
+//! API Connection with no driver behind it, exposes a single fake Physical Device with the limits and features you give it.
+/**
+Every object creation, memory allocation and command recording goes through all the engine-side validation and bookkeeping,
+but the backend itself does nothing, so it can be used to measure and regression-test the CPU overhead of Nabla without a GPU.
+
+Queue submissions complete immediately (signal semaphores are signalled during the submit), mappable memory
+is backed by host allocations so mapping works, anything requiring actual GPU results (queries, acceleration structures) is unsupported.
+*/
+class NBL_API2 CNullConnection final : public IAPIConnection
+{
+    public:
+        struct SCreationParams
+        {
+            // zero `memoryTypeCount` gets you a device local heap and a host heap, with device local, host coherent and "ReBAR" memory types
+            IPhysicalDevice::SMemoryProperties memoryProperties = {};
+            // empty gets you a single family with all flags and 16 queues
+            core::vector<IPhysicalDevice::SQueueFamilyProperties> queueFamilies = {};
+            IPhysicalDevice::SProperties properties = {};
+            IPhysicalDevice::SFeatures features = {};
+            // when true every format is reported as supporting every usage, and the usages below are ignored
+            bool allFormatUsages = true;
+            IPhysicalDevice::SFormatImageUsages linearTilingUsages = {};
+            IPhysicalDevice::SFormatImageUsages optimalTilingUsages = {};
+            IPhysicalDevice::SFormatBufferUsages bufferUsages = {};
+        };
+        static core::smart_refctd_ptr<CNullConnection> create(
+            core::smart_refctd_ptr<system::ISystem>&& sys, core::smart_refctd_ptr<system::ILogger>&& logger,
+            SCreationParams&& params, const SFeatures& featuresToEnable={}
+        );
+
+        inline E_API_TYPE getAPIType() const override {return EAT_NULL;}
+
+        inline IDebugCallback* getDebugCallback() const override {return m_debugCallback.get();}
+
+        // nothing to capture
+        inline bool startCapture() override {return false;}
+        inline bool endCapture() override {return false;}
+
+    protected:
+        class CDebugCallback final : public IDebugCallback
+        {
+            public:
+                explicit inline CDebugCallback(core::smart_refctd_ptr<system::ILogger>&& _logger) : IDebugCallback(std::move(_logger)) {}
+        };
+
+        explicit inline CNullConnection(const SFeatures& enabledFeatures, core::smart_refctd_ptr<system::ILogger>&& logger)
+            : IAPIConnection(enabledFeatures), m_debugCallback(std::make_unique<CDebugCallback>(std::move(logger))) {}
+
+        virtual ~CNullConnection() = default;
+
+    private:
+        const std::unique_ptr<CDebugCallback> m_debugCallback;
+};
+
+}
+
+#endif
@@ -2,6 +2,10 @@
 #define _NBL_VIDEO_THREADSAFE_QUEUE_ADAPTER_H_INCLUDED_
 
 #include "nbl/video/IQueue.h"
+#include "nbl/video/IGPUCommandBuffer.h"
+
+#include <atomic>
+#include <thread>
 
 namespace nbl::video
 {
@@ -9,6 +13,13 @@ namespace nbl::video
 /*
     A thread-safe implementation of IQueue.
     Note, that using the same queue as both a threadsafe queue and a normal queue invalidates the safety.
+
+    With submit coalescing turned on, concurrent `submit` calls don't queue up on the mutex one by one. Instead every caller pushes
+    its submit span onto a lock-free staging list and whichever thread manages to grab the mutex flushes everything staged so far
+    as a single combined submit, in staging order. Every `submit` still only returns after its span has been submitted,
+    so the ordering of submits made by the same thread is preserved and the spans don't need to outlive the call.
+    If the combined submit fails validation, the flushing thread falls back to submitting every staged span separately
+    (except for those whose command buffers the failed validation already touched), so an invalid submit can't fail the other threads' submits.
 */
 
 class CThreadSafeQueueAdapter final : public IQueue
@@ -38,20 +49,55 @@ class CThreadSafeQueueAdapter final : public IQueue
         }
 
         inline RESULT submit(const std::span<const SSubmitInfo> _submits) override
+        {
+            if (!m_coalesceSubmits.load(std::memory_order_relaxed))
+            {
+                std::lock_guard g(m);
+                flushStaged();
+                return originalQueue->submit(_submits);
+            }
+
+            if (_submits.empty())
+                return RESULT::OTHER_ERROR;
+            // lives on our stack, we don't return until a flush is done with it
+            SStagedSubmit staged = {.submits=_submits,.next=m_staged.load(std::memory_order_relaxed)};
+            while (!m_staged.compare_exchange_weak(staged.next,&staged,std::memory_order_release,std::memory_order_relaxed)) {}
+            // whoever wins the lock flushes for everyone
+            while (!staged.done.load(std::memory_order_acquire))
+            {
+                if (m.try_lock())
+                {
+                    flushStaged();
+                    m.unlock();
+                }
+                else
+                    std::this_thread::yield();
+            }
+            return staged.result;
+        }
+
+        // Opt-in, can be toggled at any time (submits staged before turning it off get flushed by the next call that takes the lock).
+        inline void setSubmitCoalescing(const bool enable) {m_coalesceSubmits.store(enable,std::memory_order_relaxed);}
+        inline bool getSubmitCoalescing() const {return m_coalesceSubmits.load(std::memory_order_relaxed);}
+
+        // Explicit flush point, submits everything staged by other threads so far.
+        inline void flushSubmits()
         {
             std::lock_guard g(m);
-            return originalQueue->submit(_submits);
+            flushStaged();
         }
 
         inline RESULT waitIdle() override
         {
             std::lock_guard g(m);
+            flushStaged();
             return originalQueue->waitIdle();
         }
 
         inline uint32_t cullResources(const ISemaphore* sema=nullptr) override
         {
             std::lock_guard g(m);
+            flushStaged();
             return originalQueue->cullResources(sema);
         }
 
@@ -83,9 +129,80 @@ class CThreadSafeQueueAdapter final : public IQueue
             return originalQueue->waitIdle_impl();
         }
 
+        struct SStagedSubmit
+        {
+            std::span<const SSubmitInfo> submits;
+            SStagedSubmit* next;
+            RESULT result = RESULT::OTHER_ERROR;
+            std::atomic_bool done = false;
+        };
+        // `m` must be held
+        inline void flushStaged()
+        {
+            SStagedSubmit* staged = m_staged.exchange(nullptr,std::memory_order_acquire);
+            if (!staged)
+                return;
+            // the staging list is a stack, so reverse it back into staging order
+            m_flushScratch.clear();
+            for (; staged; staged=staged->next)
+                m_flushScratch.push_back(staged);
+            std::reverse(m_flushScratch.begin(),m_flushScratch.end());
+
+            m_combinedSubmits.clear();
+            for (const auto* s : m_flushScratch)
+                m_combinedSubmits.insert(m_combinedSubmits.end(),s->submits.begin(),s->submits.end());
+            m_stateScratch.clear();
+            for (const auto& submit : m_combinedSubmits)
+            for (const auto& commandBuffer : submit.commandBuffers)
+                m_stateScratch.push_back(commandBuffer.cmdbuf ? commandBuffer.cmdbuf->getState():IGPUCommandBuffer::STATE::INVALID);
+            const RESULT combinedResult = originalQueue->submit(m_combinedSubmits);
+            // Only the validation `IQueue::submit` does before `submit_impl` leaves the command buffers alone, so a span can only be retried
+            // on its own if none of its command buffers changed state. A command buffer which went PENDING means `submit_impl` ran and
+            // failed, then nothing may be resubmitted and the error goes to every span. Otherwise only the spans with a changed command buffer
+            // (e.g. made INVALID by a descriptor set updated after binding) get the combined error, the rest get retried one by one.
+            m_retryScratch.assign(m_flushScratch.size(),combinedResult==RESULT::OTHER_ERROR && m_flushScratch.size()>1);
+            if (m_retryScratch.front())
+            {
+                bool submitted = false;
+                auto state = m_stateScratch.begin();
+                for (size_t i=0; i<m_flushScratch.size(); i++)
+                for (const auto& submit : m_flushScratch[i]->submits)
+                for (const auto& commandBuffer : submit.commandBuffers)
+                {
+                    if (commandBuffer.cmdbuf && commandBuffer.cmdbuf->getState()!=*state)
+                    {
+                        m_retryScratch[i] = false;
+                        submitted |= commandBuffer.cmdbuf->getState()==IGPUCommandBuffer::STATE::PENDING;
+                    }
+                    state++;
+                }
+                if (submitted)
+                    std::fill(m_retryScratch.begin(),m_retryScratch.end(),false);
+            }
+            for (size_t i=0; i<m_flushScratch.size(); i++)
+            {
+                auto* s = m_flushScratch[i];
+                if (m_retryScratch[i])
+                    s->result = originalQueue->submit(s->submits);
+                else
+                    s->result = combinedResult;
+                // the owning thread may return and pop `s` off its stack as soon as this is set
+                s->done.store(true,std::memory_order_release);
+            }
+        }
+
         // used to use unique_ptr here, but it needed `~IQueue` to be public, which requires a custom deleter, etc.
         IQueue* const originalQueue = nullptr;
         mutable std::mutex m;
+        // coalescing stuff
+        std::atomic_bool m_coalesceSubmits = false;
+        std::atomic<SStagedSubmit*> m_staged = nullptr;
+        core::vector<SStagedSubmit*> m_flushScratch;
+        core::vector<SSubmitInfo> m_combinedSubmits;
+        // command buffer states from before the combined submit
+        core::vector<IGPUCommandBuffer::STATE> m_stateScratch;
+        // whether each staged span gets resubmitted on its own after a failed combined submit
+        core::vector<bool> m_retryScratch;
 };
 
 }
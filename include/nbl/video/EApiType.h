@@ -10,6 +10,7 @@ namespace nbl::video
 enum E_API_TYPE : uint32_t
 {
     EAT_VULKAN,
+    EAT_NULL, // no driver behind it, see `CNullConnection`
     //EAT_WEBGPU
 };
 
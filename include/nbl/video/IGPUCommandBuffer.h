@@ -99,6 +99,27 @@ class NBL_API2 IGPUCommandBuffer : public IBackendObject
         // if you use `getNativeHandle()` to record some custom commands between `begin()` and `end()`
         inline void setNotEmtpy() {m_noCommands = true;}
 
+        //! How the resources referenced by the recorded commands are kept alive until the command buffer gets reset
+        enum class RESOURCE_TRACKING : uint8_t
+        {
+            //! Every command holds its own references, so each recorded command costs atomic increments (and later decrements) for all its resources
+            PER_COMMAND,
+            //! Resources get referenced once per recording no matter how many commands use them, worth it when recording many commands over the same resources
+            DEDUPLICATED
+        };
+        inline RESOURCE_TRACKING getResourceTracking() const { return m_resourceTracking; }
+        //! Cannot change while recording, because the resources already tracked the other way would not be found on release
+        inline bool setResourceTracking(const RESOURCE_TRACKING tracking)
+        {
+            if (m_state==STATE::RECORDING)
+            {
+                m_logger.log("Cannot change the resource tracking mode of a command buffer while it is recording!", system::ILogger::ELL_ERROR);
+                return false;
+            }
+            m_resourceTracking = tracking;
+            return true;
+        }
+
         //! Begin, Reset, End
         enum class USAGE : uint8_t
         {
@@ -675,6 +696,8 @@ class NBL_API2 IGPUCommandBuffer : public IBackendObject
             m_state = STATE::INITIAL;
 
             m_boundDescriptorSetsRecord.clear();
+            // the pool reset only released what the command segments were holding
+            releaseTrackedResources();
 
             m_commandList.head = nullptr;
             m_commandList.tail = nullptr;
@@ -687,10 +710,40 @@ class NBL_API2 IGPUCommandBuffer : public IBackendObject
         inline void releaseResourcesBackToPool()
         {
             deleteCommandList();
+            releaseTrackedResources();
             m_boundDescriptorSetsRecord.clear();
             releaseResourcesBackToPool_impl();
         }
 
+        // only used with `RESOURCE_TRACKING::DEDUPLICATED`
+        inline void trackResource(const core::IReferenceCounted* resource)
+        {
+            if (resource && m_trackedResources.insert(resource).second)
+                resource->grab();
+        }
+        inline void releaseTrackedResources()
+        {
+            for (const auto* resource : m_trackedResources)
+                resource->drop();
+            m_trackedResources.clear();
+        }
+
+        template<typename T>
+        static inline const T* trackedPointer(const T* resource) { return resource; }
+        template<typename T>
+        static inline const T* trackedPointer(const core::smart_refctd_ptr<T>& resource) { return resource.get(); }
+        // Emplaces a fixed size command whose only job is to hold on to `resources`, unless they get tracked in the deduplicated set instead
+        template<class Cmd, typename... Resources>
+        inline bool recordResources(const Resources&... resources)
+        {
+            if (m_resourceTracking==RESOURCE_TRACKING::DEDUPLICATED)
+            {
+                (trackResource(trackedPointer(resources)),...);
+                return true;
+            }
+            return m_cmdpool->m_commandListPool.emplace<Cmd>(m_commandList,core::smart_refctd_ptr<std::remove_pointer_t<decltype(trackedPointer(resources))>>(trackedPointer(resources))...)!=nullptr;
+        }
+
         inline void deleteCommandList()
         {
             m_cmdpool->m_commandListPool.deleteList(m_commandList.head);
@@ -805,6 +858,9 @@ class NBL_API2 IGPUCommandBuffer : public IBackendObject
         core::unordered_map<const IGPUDescriptorSet*,uint64_t> m_boundDescriptorSetsRecord;
     
         IGPUCommandPool::CCommandSegmentListPool::SCommandSegmentList m_commandList = {};
+        // referenced once each, instead of by the commands in `m_commandList`
+        core::unordered_set<const core::IReferenceCounted*> m_trackedResources;
+        RESOURCE_TRACKING m_resourceTracking = RESOURCE_TRACKING::PER_COMMAND;
 
         uint64_t m_resetCheckedStamp;
         STATE m_state = STATE::INITIAL;
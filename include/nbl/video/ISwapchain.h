@@ -401,6 +401,8 @@ class ISwapchain : public IBackendObject
             if (threadsafeQ)
             {
                 threadsafeQ->m.lock();
+                // anything staged by other threads before we got here needs to go in before the present
+                threadsafeQ->flushStaged();
                 info.queue = threadsafeQ->getUnderlyingQueue();
             }
             const auto retval = present_impl(info);
@@ -4,7 +4,10 @@
 
 #include "nbl/video/ILogicalDevice.h"
 
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <thread>
 
 
 namespace nbl::video
@@ -34,8 +37,7 @@ class TimelineEventHandlerBase : core::Unmovable, core::Uncopyable
         core::smart_refctd_ptr<const ISemaphore> m_sema;
 };
 
-// Could be made MT and relatively lockless, if only had a good lock-few circular buffer impl
-// Not sure its worth the effort as anything using this will probably need to be lockful to be MT
+// If you need to latch from multiple threads, see `TimelineEventHandlerMT` below
 template<typename Functor>
 class TimelineEventHandlerST final : public TimelineEventHandlerBase
 {
@@ -225,6 +227,331 @@ class TimelineEventHandlerST final : public TimelineEventHandlerBase
         }
 };
 
+// Multi-producer counterpart of `TimelineEventHandlerST`, you can `latch` from any number of threads concurrently without any locks.
+// Every latching thread gets assigned one of `ShardCount` buckets, and pushes onto that bucket's intrusive list with a single atomic exchange.
+// The consuming side (`poll`,`wait`,`abort*`) is serialized by a mutex the producers never touch; it grabs whole buckets at once,
+// cuts them up into runs of non-decreasing semaphore values and keeps the runs in a min-heap keyed by their first value.
+// This way draining the completed events costs O(completed*log(runs)) regardless of how many events are still pending.
+// Unlike the ST version the latch values don't need to be monotonic, and the functors execute in order of their semaphore values
+// (the order between events latched on the same value from different threads is unspecified).
+// NOTE: the bucket pushes are wait-free, but every latch still allocates a node through the global allocator.
+template<typename Functor, uint32_t ShardCount=16>
+class TimelineEventHandlerMT final : public TimelineEventHandlerBase
+{
+        static_assert(ShardCount>0u);
+
+    public:
+        inline TimelineEventHandlerMT(core::smart_refctd_ptr<const ISemaphore>&& sema) :
+            TimelineEventHandlerBase(std::move(sema)), m_greatestSignal(m_sema->getCounterValue()) {}
+        // If you don't want to deadlock here, look into the `abort*` family of methods
+        ~TimelineEventHandlerMT()
+        {
+            while (wait(std::chrono::steady_clock::now()+std::chrono::seconds(5))) {}
+            for (auto* run : m_runs)
+                delete run;
+            for (auto* run : m_freeRuns)
+                delete run;
+        }
+
+        // only a snapshot, other threads may be latching as you read it
+        inline uint32_t count() const {return m_count.load(std::memory_order_relaxed);}
+
+        // Thread-safe, you can latch in any order too.
+        inline void latch(const uint64_t geSemaValue, Functor&& function)
+        {
+            auto* node = new SNode(std::move(function),geSemaValue);
+            m_count.fetch_add(1u,std::memory_order_relaxed);
+            auto& shard = m_shards[getShardIx()];
+            // Publish first, link later. The consumer will spin on `Pending` for the few instructions between the two lines.
+            SNode* const prev = shard.head.exchange(node,std::memory_order_acq_rel);
+            node->next.store(prev,std::memory_order_release);
+        }
+
+        //
+        template<typename... Args>
+        inline PollResult poll(Args&&... args)
+        {
+            std::unique_lock lock(m_consumerMutex);
+            m_greatestSignal = m_sema->getCounterValue();
+            return drain(std::forward<Args>(args)...);
+        }
+
+        template<class Clock, class Duration=typename Clock::duration, typename... Args>
+        inline uint32_t wait(const std::chrono::time_point<Clock,Duration>& timeout_time, Args&&... args)
+        {
+            std::unique_lock lock(m_consumerMutex);
+            constexpr bool ReturnsBool = std::is_same_v<decltype(std::declval<Functor>()(std::forward<Args>(args)...)),bool>;
+            PollResult result = {};
+            auto currentTime = Clock::now();
+            do
+            {
+                ingest();
+                if (m_runs.empty())
+                    return 0;
+                // same strategy as the ST version, bailing functors get waited on in small slices one value at a time
+                const uint64_t waitVal = ReturnsBool ? m_runs.front()->front():m_greatestLatch;
+                if (waitVal>m_greatestSignal)
+                {
+                    std::chrono::time_point<Clock> waitPoint = timeout_time;
+                    if constexpr (ReturnsBool)
+                    {
+                        const auto uniqueValueEstimate = core::max<uint64_t>(core::min<uint64_t>(count(),m_greatestLatch-m_greatestSignal),1ull);
+                        waitPoint = std::chrono::time_point<Clock>((currentTime.time_since_epoch()*(uniqueValueEstimate-1u)+timeout_time.time_since_epoch())/uniqueValueEstimate);
+                    }
+                    if (waitPoint>currentTime)
+                    {
+                        auto device = const_cast<ILogicalDevice*>(m_sema->getOriginDevice());
+                        const auto nanosecondsLeft = std::chrono::duration_cast<std::chrono::nanoseconds>(waitPoint-currentTime).count();
+                        const ISemaphore::SWaitInfo info = {.semaphore=m_sema.get(),.value=waitVal};
+                        device->waitForSemaphores({&info,1},true,nanosecondsLeft);
+                    }
+                    m_greatestSignal = m_sema->getCounterValue();
+                }
+                result = drain(std::forward<Args>(args)...);
+                if (result.bailed)
+                    break;
+            } while (result.eventsLeft && (currentTime=Clock::now())<timeout_time);
+            return result.eventsLeft;
+        }
+
+        // The default behaviour is to wait for all events in the destructor, this will deadlock if you latched on values that will never be signalled.
+        // Same as the ST version, these execute everything a single `poll()` would have executed (ignoring bails) and then drop
+        // the selected events without calling them. Events latched concurrently may survive.
+        template<typename... Args>
+        inline uint32_t abortOldest(const uint64_t upTo, Args&&... args)
+        {
+            std::unique_lock lock(m_consumerMutex);
+            executeCompleted(std::forward<Args>(args)...);
+            return dropEvents([upTo](SRun* run)->void
+                {
+                    while (!run->empty() && run->front()<=upTo)
+                        delete run->events[run->begin++];
+                    run->compact();
+                }
+            );
+        }
+        template<typename... Args>
+        inline uint32_t abortLatest(const uint64_t from, Args&&... args)
+        {
+            std::unique_lock lock(m_consumerMutex);
+            executeCompleted(std::forward<Args>(args)...);
+            // runs are sorted, so the events to drop are always a suffix
+            return dropEvents([from](SRun* run)->void
+                {
+                    while (!run->empty() && run->back()>=from)
+                    {
+                        delete run->events.back();
+                        run->events.pop_back();
+                    }
+                }
+            );
+        }
+        template<typename... Args>
+        inline void abortAll(Args&&... args) {abortOldest(~0ull,std::forward<Args>(args)...);}
+
+    private:
+        struct SNode
+        {
+            inline SNode(Functor&& _func, const uint64_t _geSemaValue) : func(std::move(_func)), geSemaValue(_geSemaValue), next(Pending()) {}
+
+            Functor func;
+            uint64_t geSemaValue;
+            std::atomic<SNode*> next;
+        };
+        // marks a node that's already been published in a bucket but whose `next` hasn't been written yet
+        static inline SNode* Pending() {return reinterpret_cast<SNode*>(alignof(SNode));}
+
+        struct alignas(64) SShard
+        {
+            std::atomic<SNode*> head = nullptr;
+        };
+        static inline uint32_t getShardIx()
+        {
+            static std::atomic_uint32_t nextThreadIx = 0u;
+            thread_local const uint32_t threadIx = nextThreadIx.fetch_add(1u,std::memory_order_relaxed);
+            return threadIx%ShardCount;
+        }
+
+        // a sorted run of events, gets consumed from the front
+        struct SRun
+        {
+            inline uint64_t front() const {return events[begin]->geSemaValue;}
+            inline uint64_t back() const {return events.back()->geSemaValue;}
+            inline bool empty() const {return begin==events.size();}
+            // a run keeps getting extended while its front is consumed, so the consumed prefix has to go at some point
+            inline void compact()
+            {
+                if (begin>events.size()/2)
+                {
+                    events.erase(events.begin(),events.begin()+begin);
+                    begin = 0;
+                }
+            }
+
+            core::vector<SNode*> events;
+            size_t begin = 0;
+            uint32_t shardIx;
+        };
+        // for a min-heap
+        static inline bool runGreater(const SRun* lhs, const SRun* rhs) {return lhs->front()>rhs->front();}
+
+        inline SRun* allocateRun(const uint32_t shardIx)
+        {
+            SRun* run;
+            if (m_freeRuns.empty())
+                run = new SRun();
+            else
+            {
+                run = m_freeRuns.back();
+                m_freeRuns.pop_back();
+            }
+            run->shardIx = shardIx;
+            return run;
+        }
+        inline void recycleRun(SRun* run)
+        {
+            if (m_shardTailRuns[run->shardIx]==run)
+                m_shardTailRuns[run->shardIx] = nullptr;
+            run->events.clear();
+            run->begin = 0;
+            m_freeRuns.push_back(run);
+        }
+
+        // moves everything latched so far out of the buckets and into the runs
+        inline void ingest()
+        {
+            for (uint32_t s=0u; s<ShardCount; s++)
+            {
+                SNode* node = m_shards[s].head.exchange(nullptr,std::memory_order_acquire);
+                if (!node)
+                    continue;
+                // the bucket is a stack, so reverse it to get back the latch order
+                m_scratch.clear();
+                while (node)
+                {
+                    m_scratch.push_back(node);
+                    SNode* next;
+                    while ((next=node->next.load(std::memory_order_acquire))==Pending())
+                        std::this_thread::yield();
+                    node = next;
+                }
+                // A thread usually latches in increasing order, so usually the whole bucket extends the run we made from it last time
+                SRun* run = m_shardTailRuns[s];
+                bool runInHeap = run!=nullptr;
+                for (auto it=m_scratch.rbegin(); it!=m_scratch.rend(); it++)
+                {
+                    const uint64_t value = (*it)->geSemaValue;
+                    if (!run || value<run->back())
+                    {
+                        if (run && !runInHeap)
+                        {
+                            m_runs.push_back(run);
+                            std::push_heap(m_runs.begin(),m_runs.end(),runGreater);
+                        }
+                        run = allocateRun(s);
+                        runInHeap = false;
+                    }
+                    run->events.push_back(*it);
+                    m_greatestLatch = core::max(m_greatestLatch,value);
+                }
+                if (!runInHeap)
+                {
+                    m_runs.push_back(run);
+                    std::push_heap(m_runs.begin(),m_runs.end(),runGreater);
+                }
+                m_shardTailRuns[s] = run;
+            }
+        }
+
+        // executes the completed events in order of their values, needs an up to date `m_greatestSignal`
+        template<typename... Args>
+        inline PollResult drain(Args&&... args)
+        {
+            constexpr bool ReturnsBool = std::is_same_v<decltype(std::declval<Functor>()(std::forward<Args>(args)...)),bool>;
+            ingest();
+
+            PollResult retval = {};
+            while (!retval.bailed && !m_runs.empty() && m_runs.front()->front()<=m_greatestSignal)
+            {
+                std::pop_heap(m_runs.begin(),m_runs.end(),runGreater);
+                SRun* run = m_runs.back();
+                m_runs.pop_back();
+                // keep going in this run as long as we don't overtake the next smallest run
+                const uint64_t limit = m_runs.empty() ? m_greatestSignal:core::min(m_greatestSignal,m_runs.front()->front());
+                do
+                {
+                    SNode* node = run->events[run->begin++];
+                    if constexpr (ReturnsBool)
+                        retval.bailed = node->func(std::forward<Args>(args)...);
+                    else
+                        node->func(std::forward<Args>(args)...);
+                    delete node;
+                    m_count.fetch_sub(1u,std::memory_order_relaxed);
+                } while (!retval.bailed && !run->empty() && run->front()<=limit);
+
+                if (run->empty())
+                    recycleRun(run);
+                else
+                {
+                    run->compact();
+                    m_runs.push_back(run);
+                    std::push_heap(m_runs.begin(),m_runs.end(),runGreater);
+                }
+            }
+            if (m_runs.empty())
+                m_greatestLatch = 0;
+            retval.eventsLeft = count();
+            return retval;
+        }
+
+        // for the `abort*` methods, a bailing functor only stops the current `poll()` so keep draining until nothing completed is left
+        template<typename... Args>
+        inline void executeCompleted(Args&&... args)
+        {
+            m_greatestSignal = m_sema->getCounterValue();
+            while (drain(std::forward<Args>(args)...).bailed) {}
+        }
+
+        // `drop` deletes some of the events of a run, they're still sorted afterwards but their fronts may change so the heap gets rebuilt
+        template<typename Lambda>
+        inline uint32_t dropEvents(Lambda&& drop)
+        {
+            m_greatestLatch = 0;
+            for (size_t i=0; i<m_runs.size();)
+            {
+                SRun* run = m_runs[i];
+                const size_t eventsBefore = run->events.size()-run->begin;
+                drop(run);
+                m_count.fetch_sub(static_cast<uint32_t>(eventsBefore-(run->events.size()-run->begin)),std::memory_order_relaxed);
+                if (run->empty())
+                {
+                    recycleRun(run);
+                    m_runs[i] = m_runs.back();
+                    m_runs.pop_back();
+                }
+                else
+                {
+                    m_greatestLatch = core::max(m_greatestLatch,run->back());
+                    i++;
+                }
+            }
+            std::make_heap(m_runs.begin(),m_runs.end(),runGreater);
+            return count();
+        }
+
+        // producer side
+        std::array<SShard,ShardCount> m_shards = {};
+        alignas(64) std::atomic_uint32_t m_count = 0u;
+        // consumer side
+        alignas(64) std::mutex m_consumerMutex;
+        core::vector<SRun*> m_runs;
+        core::vector<SRun*> m_freeRuns;
+        std::array<SRun*,ShardCount> m_shardTailRuns = {};
+        core::vector<SNode*> m_scratch;
+        uint64_t m_greatestSignal;
+        uint64_t m_greatestLatch = 0;
+};
+
 // `RefcountTheDevice` should be false for any "internal user" of the Handler inside the Logical Device, such as the IQueue to avoid circular refs
 /*
 template<bool RefcountTheDevice>
@@ -23,6 +23,9 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
         constexpr static inline uint32_t maxStreamingBufferAllocationAlignment = 64u*1024u; // if you need larger alignments then you're not right in the head
         constexpr static inline uint32_t minStreamingBufferAllocationSize = 1024u;
         constexpr static inline uint32_t OptimalCoalescedInvocationXferSize = sizeof(uint32_t);
+        // staging copies smaller than this are not worth waking up the worker threads for
+        constexpr static inline size_t ParallelStagingCopyThreshold = 1u<<20u;
+        constexpr static inline size_t ParallelStagingCopyMinChunk = 256u<<10u;
 
         uint32_t m_allocationAlignment = 0u;
         uint32_t m_allocationAlignmentForBufferImageCopy = 0u;
@@ -125,6 +128,9 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
                 assert(access.value);
                 mem->map({0ull,reqs.size},access);
 
+                // uncached host writable memory is write-combined, we don't want to pollute our caches writing to it
+                m_uploadBufferWriteCombined = !memProps.hasFlags(IDeviceMemoryAllocation::EMPF_HOST_CACHED_BIT);
+
                 m_defaultUploadBuffer = core::make_smart_refctd_ptr<StreamingTransientDataBufferMT<>>(asset::SBufferRange<video::IGPUBuffer>{0ull,upstreamSize,std::move(buffer)},maxStreamingBufferAllocationAlignment,minStreamingBufferAllocationSize);
                 m_defaultUploadBuffer->getBuffer()->setObjectDebugName(("Default Upload Buffer of Utilities "+std::to_string(ptrdiff_t(this))).c_str());
             }
@@ -157,6 +163,39 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
             return m_defaultDownloadBuffer.get();
         }
 
+        //! Throughput counters of the upload paths (`updateBufferRangeViaStagingBuffer` and `updateImageViaStagingBuffer`), summed over all threads
+        struct SStagingStats
+        {
+            // bytes written by the CPU into the staging buffer
+            uint64_t bytesStaged = 0ull;
+            // time spent writing them, divide the two to get the CPU side bandwidth
+            uint64_t stagingNanoseconds = 0ull;
+            // time spent blocked waiting for the GPU to free up staging memory
+            uint64_t blockedNanoseconds = 0ull;
+            // submits forced by running out of staging memory
+            uint32_t overflowSubmits = 0u;
+            // submits made ahead of time to let the GPU consume a chunk while the CPU fills the next one
+            uint32_t earlySubmits = 0u;
+        };
+        inline SStagingStats getStagingStats() const
+        {
+            SStagingStats retval;
+            retval.bytesStaged = m_stagingStats.bytesStaged.load(std::memory_order_relaxed);
+            retval.stagingNanoseconds = m_stagingStats.stagingNanoseconds.load(std::memory_order_relaxed);
+            retval.blockedNanoseconds = m_stagingStats.blockedNanoseconds.load(std::memory_order_relaxed);
+            retval.overflowSubmits = m_stagingStats.overflowSubmits.load(std::memory_order_relaxed);
+            retval.earlySubmits = m_stagingStats.earlySubmits.load(std::memory_order_relaxed);
+            return retval;
+        }
+        inline void resetStagingStats()
+        {
+            m_stagingStats.bytesStaged.store(0ull,std::memory_order_relaxed);
+            m_stagingStats.stagingNanoseconds.store(0ull,std::memory_order_relaxed);
+            m_stagingStats.blockedNanoseconds.store(0ull,std::memory_order_relaxed);
+            m_stagingStats.overflowSubmits.store(0u,std::memory_order_relaxed);
+            m_stagingStats.earlySubmits.store(0u,std::memory_order_relaxed);
+        }
+
 #if 0 // TODO: port
         //!
         virtual CPropertyPoolHandler* getDefaultPropertyPoolHandler() const
@@ -328,13 +367,17 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
             // TODO: Why did we settle on `/4` ? It definitely wasn't about the uint32_t size!
             const uint32_t optimalTransferAtom = core::min<uint32_t>(limits.maxResidentInvocations*OptimalCoalescedInvocationXferSize,m_defaultUploadBuffer->get_total_size()/4);
 
+            // once this much has been recorded we submit early, so the GPU copies chunk N while we fill chunk N+1,
+            // but only if there's more than one scratch commandbuffer, otherwise we'd block right away on beginning the next one
+            const size_t earlySubmitSize = nextSubmit.scratchCommandBuffers.size()>1 ? (m_defaultUploadBuffer->get_total_size()/2):(~0ull);
+            size_t recordedSinceSubmit = 0ull;
             // no pipeline barriers necessary because write and optional flush happens before submit, and memory allocation is reclaimed after fence signal
             for (size_t uploadedSize=0ull; uploadedSize<bufferRange.size;)
             {
                 // how much hasn't been uploaded yet
                 const size_t size = bufferRange.size-uploadedSize;
-                // how large we can make the allocation
-                uint32_t maxFreeBlock = m_defaultUploadBuffer.get()->max_size();
+                // how large we can make the allocation, without running past the next early submit so the other half of the staging buffer stays free to fill meanwhile
+                uint32_t maxFreeBlock = core::min<size_t>(m_defaultUploadBuffer.get()->max_size(),earlySubmitSize-recordedSinceSubmit);
                 // get allocation size
                 const uint32_t allocationSize = getAllocationSizeForStreamingBuffer(size,m_allocationAlignment,maxFreeBlock,optimalTransferAtom);
                 // make sure we dont overrun the destination buffer due to padding
@@ -346,17 +389,20 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
                 if (localOffset!=StreamingTransientDataBufferMT<>::invalid_value)
                 {
                     const void* dataPtr = reinterpret_cast<const uint8_t*>(data) + uploadedSize;
-                    memcpy(reinterpret_cast<uint8_t*>(m_defaultUploadBuffer->getBufferPointer()) + localOffset, dataPtr, subSize);
+                    const auto copyStart = std::chrono::steady_clock::now();
+                    copyToStagingMemory(reinterpret_cast<uint8_t*>(m_defaultUploadBuffer->getBufferPointer()) + localOffset, dataPtr, subSize);
+                    m_stagingStats.bytesStaged.fetch_add(subSize,std::memory_order_relaxed);
+                    m_stagingStats.stagingNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-copyStart).count(),std::memory_order_relaxed);
                 }
                 else
                 {
                     const auto completed = nextSubmit.getFutureScratchSemaphore();
                     nextSubmit.overflowSubmit(scratch);
                     // overflowSubmit no longer blocks for the last submit to have completed, so we must do it ourselves here
-                    // TODO: if we cleverly overflowed BEFORE completely running out of memory (better heuristics) then we wouldn't need to do this and some CPU-GPU overlap could be achieved
                     if (nextSubmit.overflowCallback)
                         nextSubmit.overflowCallback(completed);
-                    m_device->blockForSemaphores({&completed,1});
+                    blockForStagingMemory(completed);
+                    recordedSinceSubmit = 0ull;
                     continue; // keep trying again
                 }
                 // some platforms expose non-coherent host-visible GPU memory, so writes need to be flushed explicitly
@@ -374,6 +420,15 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
                 // this doesn't actually free the memory, the memory is queued up to be freed only after the `scratchSemaphore` reaches a value a future submit will signal
                 m_defaultUploadBuffer.get()->multi_deallocate(1u,&localOffset,&allocationSize,nextSubmit.getFutureScratchSemaphore(),&scratch->cmdbuf);
                 uploadedSize += subSize;
+                recordedSinceSubmit += subSize;
+                // don't make the GPU sit idle until we run out of staging memory
+                if (recordedSinceSubmit>=earlySubmitSize && uploadedSize<bufferRange.size)
+                {
+                    if (nextSubmit.overflowSubmit(scratch)!=IQueue::RESULT::SUCCESS)
+                        return false;
+                    m_stagingStats.earlySubmits.fetch_add(1u,std::memory_order_relaxed);
+                    recordedSinceSubmit = 0ull;
+                }
             }
             return true;
         }
@@ -674,6 +729,19 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
         }
 
     protected:
+        //! Copies into mapped staging memory, large copies get split across the worker threads of the parallel STL,
+        //! and use non-temporal stores if the upload memory is write-combined.
+        void copyToStagingMemory(void* dst, const void* src, const size_t size) const;
+
+        //! Waits for an overflow submit to complete, while counting the overflow and the time blocked
+        inline void blockForStagingMemory(const ISemaphore::SWaitInfo& completed)
+        {
+            const auto waitStart = std::chrono::steady_clock::now();
+            m_device->blockForSemaphores({&completed,1});
+            m_stagingStats.blockedNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-waitStart).count(),std::memory_order_relaxed);
+            m_stagingStats.overflowSubmits.fetch_add(1u,std::memory_order_relaxed);
+        }
+
         //
         inline const IQueue::SSubmitInfo::SCommandBufferInfo* commonTransferValidation(const SIntendedSubmitInfo& intendedNextSubmit)
         {
@@ -711,6 +779,16 @@ class NBL_API2 IUtilities : public core::IReferenceCounted
 
         core::smart_refctd_ptr<StreamingTransientDataBufferMT<> > m_defaultDownloadBuffer;
         core::smart_refctd_ptr<StreamingTransientDataBufferMT<> > m_defaultUploadBuffer;
+        bool m_uploadBufferWriteCombined = false;
+
+        struct
+        {
+            std::atomic_uint64_t bytesStaged = 0ull;
+            std::atomic_uint64_t stagingNanoseconds = 0ull;
+            std::atomic_uint64_t blockedNanoseconds = 0ull;
+            std::atomic_uint32_t overflowSubmits = 0u;
+            std::atomic_uint32_t earlySubmits = 0u;
+        } m_stagingStats;
 
 #if 0 // TODO: port
         core::smart_refctd_ptr<CPropertyPoolHandler> m_propertyPoolHandler;
@@ -230,17 +230,61 @@ SAssetBundle IAssetManager::getAssetInHierarchy_impl(system::IFile* _file, const
     if (!file)
         return {};//return empty bundle
 
+    // read what the loaders' signatures need once, instead of every loader issuing its own reads to probe the file
+    const size_t fileSize = file->getSize();
+    uint8_t prefixStorage[IAssetLoader::SFileSignature::MaxProbePrefix];
+    std::span<const uint8_t> prefix;
+    bool prefixValid = false;
+    if (m_loaders.signaturePrefixSize)
+    {
+        const size_t prefixSize = std::min(fileSize,m_loaders.signaturePrefixSize);
+        system::IFile::success_t success;
+        file->read(success, prefixStorage, 0, prefixSize);
+        prefixValid = bool(success);
+        prefix = {prefixStorage,prefixSize};
+    }
+    auto isLoadable = [&](IAssetLoader* loader, const std::span<const IAssetLoader::SFileSignature> signatures) -> bool
+    {
+        if (signatures.empty() || !prefixValid)
+            return loader->isALoadableFileFormat(file.get());
+        bool needsProbing = false;
+        for (const auto& signature : signatures)
+        switch (signature.match(prefix,fileSize))
+        {
+            case IAssetLoader::SFileSignature::E_MATCH::YES:
+                return true;
+            case IAssetLoader::SFileSignature::E_MATCH::MAYBE:
+                needsProbing = true;
+                break;
+            default:
+                break;
+        }
+        return needsProbing && loader->isALoadableFileFormat(file.get());
+    };
+    // a loader which already failed won't have more luck the second time
+    core::vector<const IAssetLoader*> triedLoaders;
+    auto tryLoader = [&](IAssetLoader* loader, const std::span<const IAssetLoader::SFileSignature> signatures) -> bool
+    {
+        if (std::find(triedLoaders.begin(),triedLoaders.end(),loader)!=triedLoaders.end())
+            return false;
+        triedLoaders.push_back(loader);
+        return isLoadable(loader,signatures) && !(bundle = loader->loadAsset(file.get(), params, _override, _hierarchyLevel)).getContents().empty();
+    };
+
     auto ext = system::extension_wo_dot(filename);
     auto capableLoadersRng = m_loaders.perFileExt.findRange(ext);
     // loaders associated with the file's extension tryout
     for (auto& loader : capableLoadersRng)
     {
-        if (loader.second->isALoadableFileFormat(file.get()) && !(bundle = loader.second->loadAsset(file.get(), params, _override, _hierarchyLevel)).getContents().empty())
+        if (tryLoader(loader.second, loader.second->getFileSignatures()))
             break;
     }
-    for (auto loaderItr = std::begin(m_loaders.vector); bundle.getContents().empty() && loaderItr != std::end(m_loaders.vector); ++loaderItr) // all loaders tryout
+    // then all loaders, the ones which can identify the file from its signature first, so a catch-all loader doesn't get to grab a mislabelled file
+    for (const bool withSignatures : {true,false})
+    for (size_t i = 0u; bundle.getContents().empty() && i < m_loaders.vector.size(); ++i)
     {
-        if ((*loaderItr)->isALoadableFileFormat(file.get()) && !(bundle = (*loaderItr)->loadAsset(file.get(), params, _override, _hierarchyLevel)).getContents().empty())
+        const auto& signatures = m_loaders.signatures[i];
+        if (signatures.empty() != withSignatures && tryLoader(m_loaders.vector[i].get(), signatures))
             break;
     }
 
@@ -3,6 +3,8 @@
 // For conditions of distribution and use, see copyright notice in nabla.h
 #include "CBufferLoaderBIN.h"
 
+#include "nbl/asset/CFileMappedCPUBuffer.h"
+
 using namespace nbl;
 using namespace nbl::asset;
 
@@ -11,6 +13,11 @@ asset::SAssetBundle CBufferLoaderBIN::loadAsset(system::IFile* _file, const asse
 	if (!_file)
 		return {};
 
+	// no point copying immutable data the OS can page in for us
+	if (_params.loaderFlags&IAssetLoader::ELPF_ALLOW_FILE_MAPPED_BUFFERS)
+	if (auto mapped=CFileMappedCPUBuffer::create(core::smart_refctd_ptr<system::IFile>(_file)); mapped)
+		return SAssetBundle(nullptr,{std::move(mapped)});
+
 	SContext ctx(_file->getSize());
 	ctx.file = _file;
 
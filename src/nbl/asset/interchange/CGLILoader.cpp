@@ -232,7 +232,6 @@ namespace nbl
 
 		bool performLoadingAsIFile(gli::texture& texture, system::IFile* file, const system::logger_opt_ptr logger)
 		{
-			const auto fileName = file->getFileName().string();
 			core::vector<char> memory(file->getSize());
 
 			const auto sizeOfData = memory.size();
@@ -242,12 +241,8 @@ namespace nbl
 			if (!success)
 				return false;
 
-			if (fileName.rfind(".dds") != std::string::npos)
-				texture = gli::load_dds(memory.data(), sizeOfData);
-			else if (fileName.rfind(".kmg") != std::string::npos)
-				texture = gli::load_kmg(memory.data(), sizeOfData);
-			else if (fileName.rfind(".ktx") != std::string::npos)
-				texture = gli::load_ktx(memory.data(), sizeOfData);
+			// dispatches on the magic number, so a mislabelled file loads just fine
+			texture = gli::load(memory.data(), sizeOfData);
 
 			if (!texture.empty())
 				return true;
@@ -258,47 +253,38 @@ namespace nbl
 			}
 		}
 
-		bool CGLILoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+		namespace
 		{
-			const auto fileName = std::string(_file->getFileName().string());
+			constexpr std::string_view DDSMagic = "DDS ";
+			constexpr std::string_view KTXMagic = "\xABKTX 11\xBB\r\n\x1A\n";
+			constexpr std::string_view KMGMagic = "\x55\x55\x55\x55\x55\x55\x55\x55\x55\x55\x55\x55\x55\x55\x55\x55";
+		}
 
-			constexpr auto ddsMagic = 0x20534444;
-			constexpr std::array<uint8_t, 12> ktxMagic = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
-			constexpr std::array<uint8_t, 16> kmgMagic = { 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55 };
+		bool CGLILoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+		{
+			char header[KMGMagic.size()];
+			const size_t headerSize = std::min<size_t>(_file->getSize(), sizeof(header));
 
-			// TODO: try to read the headers regardless of extension
 			system::IFile::success_t success;
-			if (fileName.rfind(".dds") != std::string::npos)
-			{
-				std::remove_const<decltype(ddsMagic)>::type tmpBuffer;
-				_file->read(success, &tmpBuffer, 0, sizeof(ddsMagic));
-				if (success && *reinterpret_cast<decltype(ddsMagic)*>(&tmpBuffer) == ddsMagic)
-					return true;
-				else
-					logger.log("LOAD GLI: Invalid (non-DDS) file!", system::ILogger::ELL_ERROR);
-			}
-			else if (fileName.rfind(".kmg") != std::string::npos)
-			{
-				std::remove_const<decltype(kmgMagic)>::type tmpBuffer;
-				_file->read(success, tmpBuffer.data(), 0, sizeof(kmgMagic[0]) * kmgMagic.size());
-				if (success && tmpBuffer==kmgMagic)
-					return true;
-				else
-					logger.log("LOAD GLI: Invalid (non-KMG) file!", system::ILogger::ELL_ERROR);
-			}
-			else if (fileName.rfind(".ktx") != std::string::npos)
+			_file->read(success, header, 0, headerSize);
+			if (success)
 			{
-				std::remove_const<decltype(ktxMagic)>::type tmpBuffer;
-				_file->read(success, tmpBuffer.data(), 0, sizeof(ktxMagic[0]) * ktxMagic.size());
-				if (success && tmpBuffer==ktxMagic)
+				const std::string_view prefix(header, headerSize);
+				for (const auto magic : {DDSMagic, KTXMagic, KMGMagic})
+				if (prefix.starts_with(magic))
 					return true;
-				else
-					logger.log("LOAD GLI: Invalid (non-KTX) file!", system::ILogger::ELL_ERROR);
 			}
-			
+
+			logger.log("LOAD GLI: Invalid (non-DDS, non-KTX and non-KMG) file!", system::ILogger::ELL_ERROR);
 			return false;
 		}
 
+		std::span<const IAssetLoader::SFileSignature> CGLILoader::getFileSignatures() const
+		{
+			static const SFileSignature signatures[] = {{.magic=DDSMagic},{.magic=KTXMagic},{.magic=KMGMagic}};
+			return signatures;
+		}
+
 		inline std::pair<E_FORMAT, ICPUImageView::SComponentMapping> getTranslatedGLIFormat(const gli::texture& texture, const gli::gl& glVersion, const system::logger_opt_ptr logger)
 		{
 			using namespace gli;
@@ -27,6 +27,7 @@ class CGLILoader final : public asset::IAssetLoader
 		explicit CGLILoader() = default;
 
 		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+		std::span<const SFileSignature> getFileSignatures() const override;
 
 		const char** getAssociatedFileExtensions() const override
 		{
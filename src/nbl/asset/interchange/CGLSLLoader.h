@@ -45,6 +45,17 @@ class CGLSLLoader final : public asset::IAssetLoader
 
 			return false;
 		}
+		std::span<const SFileSignature> getFileSignatures() const override
+		{
+			// the version directive is nearly always right at the start, only a long license header needs the full scan
+			static const SFileSignature signatures[] = {{.probe=[](const std::span<const uint8_t> prefix, const size_t fileSize) -> SFileSignature::E_MATCH
+			{
+				if (std::string_view(reinterpret_cast<const char*>(prefix.data()),prefix.size()).find("#version ")!=std::string_view::npos)
+					return SFileSignature::E_MATCH::YES;
+				return prefix.size()<fileSize ? SFileSignature::E_MATCH::MAYBE:SFileSignature::E_MATCH::NO;
+			}}};
+			return signatures;
+		}
 
 		const char** getAssociatedFileExtensions() const override
 		{
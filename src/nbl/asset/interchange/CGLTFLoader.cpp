@@ -111,35 +111,71 @@ using namespace nbl::asset;
 			IRenderpassIndependentPipelineLoader::initialize();
 		}
 		
-		bool CGLTFLoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+		auto CGLTFLoader::probe(const std::span<const uint8_t> prefix, const size_t fileSize, std::optional<uint32_t>* outGLBVersion) -> SFileSignature::E_MATCH
 		{
-			simdjson::dom::parser parser;
+			if (prefix.size()>=sizeof(SGLBHeader))
+			{
+				SGLBHeader header;
+				memcpy(&header,prefix.data(),sizeof(header));
+				if (header.magic==SGLBHeader::Magic)
+				{
+					if (outGLBVersion)
+						*outGLBVersion = header.version;
+					return header.version==SGLBHeader::Version && header.length<=fileSize ? SFileSignature::E_MATCH::YES:SFileSignature::E_MATCH::MAYBE;
+				}
+			}
 
-			auto jsonBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(_file->getSize());
+			// a .gltf is a JSON object (optionally preceeded by an UTF-8 BOM) which must have an "asset" property
+			const auto* it = reinterpret_cast<const char*>(prefix.data());
+			const auto* const end = it+prefix.size();
+			if (prefix.size()>=3u && memcmp(it,"\xEF\xBB\xBF",3u)==0)
+				it += 3u;
+			while (it!=end && isspace(static_cast<unsigned char>(*it)))
+				it++;
+			if (it==end || *it!='{')
+				return SFileSignature::E_MATCH::NO;
+
+			// exporters write "asset" first, but it is not mandated, so a longer document without it in the prefix is left for `loadAsset` to reject
+			if (std::string_view(it,end).find("\"asset\"")!=std::string_view::npos)
+				return SFileSignature::E_MATCH::YES;
+			return prefix.size()<fileSize ? SFileSignature::E_MATCH::MAYBE:SFileSignature::E_MATCH::NO;
+		}
+
+		bool CGLTFLoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+		{
+			uint8_t prefix[SFileSignature::MaxProbePrefix];
+			const size_t prefixSize = std::min<size_t>(_file->getSize(),SFileSignature::MaxProbePrefix);
 			{
 				system::IFile::success_t success;
-				_file->read(success, jsonBuffer->getPointer(), 0u, jsonBuffer->getSize());
+				_file->read(success, prefix, 0u, prefixSize);
 				if (!success)
 					return false;
 			}
 
-			simdjson::dom::object tweets;
-			auto error = parser.parse(reinterpret_cast<uint8_t*>(jsonBuffer->getPointer()), jsonBuffer->getSize()).get(tweets);
-
-			if (error)
+			std::optional<uint32_t> glbVersion;
+			switch (probe({prefix,prefixSize},_file->getSize(),&glbVersion))
 			{
-				logger.log("Could not parse '" + _file->getFileName().string() + "' file!");
-				return false;
-			}
-
-			simdjson::dom::element element;
-			if (tweets.at_key("asset").get(element) == simdjson::error_code::SUCCESS)
-				if (element.at_key("version").get(element) == simdjson::error_code::SUCCESS)
+				case SFileSignature::E_MATCH::YES:
 					return true;
-
+				case SFileSignature::E_MATCH::NO:
+					return false;
+				default:
+					break;
+			}
+			if (!glbVersion.has_value())
+				return true;
+			if (glbVersion.value()!=SGLBHeader::Version)
+				logger.log("'%s' is a GLB container of unsupported version %d!",system::ILogger::ELL_ERROR,_file->getFileName().string().c_str(),glbVersion.value());
 			return false;
 		}
 
+		std::span<const IAssetLoader::SFileSignature> CGLTFLoader::getFileSignatures() const
+		{
+			// `isALoadableFileFormat` only needs calling if "asset" doesn't show up early or to report a bad GLB
+			static const SFileSignature signatures[] = {{.probe=[](const std::span<const uint8_t> prefix, const size_t fileSize) -> SFileSignature::E_MATCH {return probe(prefix,fileSize);}}};
+			return signatures;
+		}
+
 		asset::SAssetBundle CGLTFLoader::loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 		{
 			auto overrideAssetLoadParams = _params;
@@ -156,15 +192,29 @@ using namespace nbl::asset;
 				return {};
 
 			core::vector<core::smart_refctd_ptr<ICPUBuffer>> cpuBuffers;
+			cpuBuffers.reserve(glTF.buffers.size());
 			for (auto& glTFBuffer : glTF.buffers)
 			{
-				// FarFuture TODO: handle buffer embedded in glTF
-				auto buffer_bundle = interm_getAssetInHierarchy(assetManager,glTFBuffer.uri.value(),context.loadContext.params,_hierarchyLevel+ICPUMesh::BUFFER_HIERARCHYLEVELS_BELOW,_override);
-				if (buffer_bundle.getContents().empty())
+				auto cpuBuffer = loadGLTFBuffer(glTFBuffer,cpuBuffers.size(),context);
+				if (!cpuBuffer)
 					return {};
-
-				auto cpuBuffer = core::smart_refctd_ptr_static_cast<ICPUBuffer>(buffer_bundle.getContents().begin()[0]);
-				cpuBuffers.emplace_back() = core::smart_refctd_ptr<ICPUBuffer>(cpuBuffer);
+				if (cpuBuffer->getSize()<glTFBuffer.byteLength.value())
+				{
+					context.loadContext.params.logger.log("GLTF: buffer %d is smaller than its `byteLength`!",system::ILogger::ELL_ERROR,static_cast<uint32_t>(cpuBuffers.size()));
+					return {};
+				}
+				cpuBuffers.push_back(std::move(cpuBuffer));
+			}
+			// accessors read through the views without any further bounds checks
+			for (const auto& glTFBufferView : glTF.bufferViews)
+			{
+				const size_t bufferViewOffset = glTFBufferView.byteOffset.has_value() ? glTFBufferView.byteOffset.value():0u;
+				if (!glTFBufferView.buffer.has_value() || !glTFBufferView.byteLength.has_value() || glTFBufferView.buffer.value()>=glTF.buffers.size() ||
+					bufferViewOffset+glTFBufferView.byteLength.value()>glTF.buffers[glTFBufferView.buffer.value()].byteLength.value())
+				{
+					context.loadContext.params.logger.log("GLTF: a bufferView lies outside of its buffer!",system::ILogger::ELL_ERROR);
+					return {};
+				}
 			}
 
 			const auto imageViewHierarchyLevel = _hierarchyLevel+ICPUMesh::IMAGEVIEW_HIERARCHYLEVELS_BELOW;
@@ -1653,20 +1703,116 @@ using namespace nbl::asset;
 			return SAssetBundle(std::move(glTFMetadata), cpuMeshes);
 		}
 
+		core::smart_refctd_ptr<ICPUBuffer> CGLTFLoader::loadGLTFBuffer(const SGLTF::SGLTFBuffer& glTFBuffer, const uint32_t bufferID, SContext& context)
+		{
+			const auto& logger = context.loadContext.params.logger;
+			if (!glTFBuffer.uri.has_value())
+			{
+				// the BIN chunk was read straight into its own buffer, bufferViews and accessors address it by offset
+				if (bufferID!=0u || !context.glbBinaryChunk)
+				{
+					logger.log("GLTF: buffer %d has no `uri` and does not refer to a GLB binary chunk!",system::ILogger::ELL_ERROR,bufferID);
+					return nullptr;
+				}
+				return core::smart_refctd_ptr(context.glbBinaryChunk);
+			}
+
+			const std::string_view uri = glTFBuffer.uri.value();
+			if (uri.substr(0u,5u)=="data:")
+			{
+				constexpr std::string_view Base64Marker = ";base64,";
+				const auto markerPos = uri.find(Base64Marker);
+				if (markerPos==std::string_view::npos)
+				{
+					logger.log("GLTF: buffer %d has a data URI which is not base64 encoded!",system::ILogger::ELL_ERROR,bufferID);
+					return nullptr;
+				}
+
+				const auto encoded = uri.substr(markerPos+Base64Marker.size());
+				const size_t decodedSize = core::base64::decodedSize(encoded);
+				auto cpuBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(decodedSize);
+				if (!cpuBuffer->getPointer() || core::base64::decode(encoded,reinterpret_cast<uint8_t*>(cpuBuffer->getPointer()))!=decodedSize)
+				{
+					logger.log("GLTF: buffer %d has a malformed base64 data URI!",system::ILogger::ELL_ERROR,bufferID);
+					return nullptr;
+				}
+				return cpuBuffer;
+			}
+
+			auto buffer_bundle = interm_getAssetInHierarchy(assetManager,glTFBuffer.uri.value(),context.loadContext.params,context.hierarchyLevel+ICPUMesh::BUFFER_HIERARCHYLEVELS_BELOW,context.loaderOverride);
+			if (buffer_bundle.getContents().empty())
+				return nullptr;
+			return core::smart_refctd_ptr_static_cast<ICPUBuffer>(buffer_bundle.getContents().begin()[0]);
+		}
+
 		bool CGLTFLoader::loadAndGetGLTF(SGLTF& glTF, SContext& context)
 		{
 			simdjson::dom::parser parser;
 			auto* _file = context.loadContext.mainFile;
+			const auto& logger = context.loadContext.params.logger;
 
-			auto jsonBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(_file->getSize());
+			auto readAt = [_file](void* dst, const size_t offset, const size_t size) -> bool
 			{
 				system::IFile::success_t success;
-				_file->read(success, jsonBuffer->getPointer(), 0u, jsonBuffer->getSize());
-				if (!success)
+				_file->read(success, dst, offset, size);
+				return bool(success);
+			};
+
+			// the JSON is either the whole file or the first chunk of a GLB container
+			size_t jsonOffset = 0u;
+			size_t jsonSize = _file->getSize();
+			SGLBHeader glbHeader = {};
+			if (jsonSize>=sizeof(SGLBHeader)+sizeof(SGLBChunkHeader) && readAt(&glbHeader,0u,sizeof(glbHeader)) && glbHeader.magic==SGLBHeader::Magic)
+			{
+				if (glbHeader.version!=SGLBHeader::Version || glbHeader.length>_file->getSize())
+				{
+					logger.log("GLTF: '%s' has an invalid GLB header!",system::ILogger::ELL_ERROR,_file->getFileName().string().c_str());
 					return false;
+				}
+
+				SGLBChunkHeader jsonChunk;
+				if (!readAt(&jsonChunk,sizeof(SGLBHeader),sizeof(jsonChunk)) || jsonChunk.type!=SGLBChunkHeader::ET_JSON)
+				{
+					logger.log("GLTF: '%s' GLB container must start with a JSON chunk!",system::ILogger::ELL_ERROR,_file->getFileName().string().c_str());
+					return false;
+				}
+				jsonOffset = sizeof(SGLBHeader)+sizeof(SGLBChunkHeader);
+				if (jsonOffset+jsonChunk.length>glbHeader.length)
+				{
+					logger.log("GLTF: '%s' GLB JSON chunk is truncated!",system::ILogger::ELL_ERROR,_file->getFileName().string().c_str());
+					return false;
+				}
+				jsonSize = jsonChunk.length;
+
+				// optional BIN chunk follows, chunks are 4 byte aligned
+				const size_t binChunkOffset = core::roundUp<size_t>(jsonOffset+jsonSize,4ull);
+				SGLBChunkHeader binChunk;
+				if (binChunkOffset+sizeof(SGLBChunkHeader)<=glbHeader.length && readAt(&binChunk,binChunkOffset,sizeof(binChunk)) && binChunk.type==SGLBChunkHeader::ET_BIN)
+				{
+					const size_t binOffset = binChunkOffset+sizeof(SGLBChunkHeader);
+					if (binOffset+binChunk.length>glbHeader.length)
+					{
+						logger.log("GLTF: '%s' GLB binary chunk is truncated!",system::ILogger::ELL_ERROR,_file->getFileName().string().c_str());
+						return false;
+					}
+					// read directly into the final buffer, no intermediate copy of the whole container
+					context.glbBinaryChunk = core::make_smart_refctd_ptr<ICPUBuffer>(binChunk.length);
+					if (!context.glbBinaryChunk->getPointer() || !readAt(context.glbBinaryChunk->getPointer(),binOffset,binChunk.length))
+						return false;
+				}
 			}
 
-			simdjson::dom::object tweets = parser.parse(reinterpret_cast<uint8_t*>(jsonBuffer->getPointer()), jsonBuffer->getSize());
+			// simdjson needs padding past the end of the document, allocate it up-front so it doesn't make its own copy
+			core::vector<uint8_t> jsonBuffer(jsonSize+simdjson::SIMDJSON_PADDING);
+			if (!readAt(jsonBuffer.data(),jsonOffset,jsonSize))
+				return false;
+
+			simdjson::dom::object tweets;
+			if (parser.parse(jsonBuffer.data(),jsonSize,false).get(tweets))
+			{
+				logger.log("GLTF: Could not parse '%s' file!",system::ILogger::ELL_ERROR,_file->getFileName().string().c_str());
+				return false;
+			}
 			simdjson::dom::element element;
 
 			//std::filesystem::path filePath(_file->getFileName().c_str());
@@ -1692,6 +1838,12 @@ using namespace nbl::asset;
 			const auto& extensions = tweets.at_key("extensions");
 			const auto& extras = tweets.at_key("extras");
 
+			if (asset.error() == simdjson::error_code::NO_SUCH_FIELD)
+			{
+				logger.log("GLTF: '%s' has no `asset` property!",system::ILogger::ELL_ERROR,_file->getFileName().string().c_str());
+				return false;
+			}
+
 			if (scene.error() != simdjson::error_code::NO_SUCH_FIELD)
 				glTF.defaultScene = static_cast<uint32_t>(scene.get_uint64());
 
@@ -1721,11 +1873,22 @@ using namespace nbl::asset;
 					const auto& extensions = jsonBuffer.at_key("extensions");
 					const auto& extras = jsonBuffer.at_key("extras");
 
+					const auto& byteLength = jsonBuffer.at_key("byteLength");
+
 					if (uri.error() != simdjson::error_code::NO_SUCH_FIELD)
-						glTFBuffer.uri = uri.get_string().value().data();
+						glTFBuffer.uri = uri.get_string().value();
+
+					if (byteLength.error() != simdjson::error_code::NO_SUCH_FIELD)
+						glTFBuffer.byteLength = byteLength.get_uint64().value();
 
 					if (name.error() != simdjson::error_code::NO_SUCH_FIELD)
 						glTFBuffer.name = name.get_string().value();
+
+					if (!glTFBuffer.validate(context.glbBinaryChunk && glTF.buffers.size()==1u))
+					{
+						logger.log("GLTF: buffer %d is invalid!",system::ILogger::ELL_ERROR,static_cast<uint32_t>(glTF.buffers.size()-1u));
+						return false;
+					}
 				}
 			}
 
@@ -1783,10 +1946,10 @@ using namespace nbl::asset;
 						glTFImage.uri = uri.get_string().value();
 
 					if (mimeType.error() != simdjson::error_code::NO_SUCH_FIELD)
-						glTFImage.mimeType = uri.get_string().value();
+						glTFImage.mimeType = mimeType.get_string().value();
 
 					if (bufferViewId.error() != simdjson::error_code::NO_SUCH_FIELD)
-						glTFImage.bufferView = uri.get_uint64().value();
+						glTFImage.bufferView = bufferViewId.get_uint64().value();
 
 					if (name.error() != simdjson::error_code::NO_SUCH_FIELD)
 						glTFImage.name = name.get_string().value();
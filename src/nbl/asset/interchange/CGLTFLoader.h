@@ -18,7 +18,7 @@
 namespace nbl::asset
 {
 
-//! glTF Loader capable of loading .gltf files
+//! glTF Loader capable of loading .gltf and binary .glb files
 /*
 	glTF bridges the gap between 3D content creation tools and modern 3D applications 
 	by providing an efficient, extensible, interoperable format for the transmission and loading of 3D content.
@@ -29,10 +29,11 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 		CGLTFLoader(asset::IAssetManager* _m_assetMgr);
 
 		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+		std::span<const SFileSignature> getFileSignatures() const override;
 
 		const char** getAssociatedFileExtensions() const override
 		{
-			static const char* extensions[]{ "gltf", nullptr };
+			static const char* extensions[]{ "gltf", "glb", nullptr };
 			return extensions;
 		}
 
@@ -57,6 +58,8 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 			SAssetLoadContext loadContext;
 			asset::IAssetLoader::IAssetLoaderOverride* loaderOverride;
 			uint32_t hierarchyLevel;
+			//! the BIN chunk of a .glb container, the first glTF buffer refers to it when it has no `uri`
+			core::smart_refctd_ptr<ICPUBuffer> glbBinaryChunk;
 		};
 
 	private:
@@ -166,6 +169,33 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 			return pipeline;
 		}
 
+		//! Binary glTF container layout, all fields are little endian
+		struct SGLBHeader
+		{
+			static inline constexpr uint32_t Magic = 0x46546C67u; // "glTF"
+			static inline constexpr uint32_t Version = 2u;
+
+			uint32_t magic;
+			uint32_t version;
+			uint32_t length; //!< of the whole file including this header
+		};
+		struct SGLBChunkHeader
+		{
+			enum E_TYPE : uint32_t
+			{
+				ET_JSON = 0x4E4F534Au,
+				ET_BIN = 0x004E4942u
+			};
+
+			uint32_t length; //!< of the payload, excluding this header
+			E_TYPE type;
+		};
+		static_assert(sizeof(SGLBHeader)==12u && sizeof(SGLBChunkHeader)==8u);
+
+		//! Sniffs the format from a prefix of the file instead of parsing the whole document (`loadAsset` parses it anyway), shared by the
+		//! signature probe and `isALoadableFileFormat`. A GLB container which can't be loaded is a MAYBE with `outGLBVersion` set, so the latter gets to report it.
+		static SFileSignature::E_MATCH probe(const std::span<const uint8_t> prefix, const size_t fileSize, std::optional<uint32_t>* outGLBVersion=nullptr);
+
 		struct CGLTFHeader
 		{
 			uint32_t version;
@@ -488,12 +518,13 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 			struct SGLTFBuffer
 			{
 				std::optional<std::string> uri;
-				std::optional<uint32_t> byteLength;
+				std::optional<size_t> byteLength;
 				std::optional<std::string> name;
 
-				bool validate()
+				//! only the first buffer of a .glb may omit the `uri`, it then refers to the BIN chunk
+				bool validate(const bool isGLBBinaryChunk=false)
 				{
-					if (!uri.has_value())
+					if (!uri.has_value() && !isGLBBinaryChunk)
 						return false;
 
 					if (!byteLength.has_value())
@@ -813,6 +844,7 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 		};
 
 		bool loadAndGetGLTF(SGLTF& glTF, SContext& context);
+		core::smart_refctd_ptr<ICPUBuffer> loadGLTFBuffer(const SGLTF::SGLTFBuffer& glTFBuffer, const uint32_t bufferID, SContext& context);
 
 		asset::IAssetManager* const assetManager;
 };
@@ -136,6 +136,18 @@ bool CGraphicsPipelineLoaderMTL::isALoadableFileFormat(system::IFile* _file, con
     return success && mtl.find("newmtl")!=std::string::npos;
 }
 
+std::span<const IAssetLoader::SFileSignature> CGraphicsPipelineLoaderMTL::getFileSignatures() const
+{
+    // saves reading the whole file when a material gets declared early on
+    static const SFileSignature signatures[] = {{.probe=[](const std::span<const uint8_t> prefix, const size_t fileSize) -> SFileSignature::E_MATCH
+    {
+        if (std::string_view(reinterpret_cast<const char*>(prefix.data()),prefix.size()).find("newmtl")!=std::string_view::npos)
+            return SFileSignature::E_MATCH::YES;
+        return prefix.size()<fileSize ? SFileSignature::E_MATCH::MAYBE:SFileSignature::E_MATCH::NO;
+    }}};
+    return signatures;
+}
+
 SAssetBundle CGraphicsPipelineLoaderMTL::loadAsset(system::IFile* _file, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
     SContext ctx(
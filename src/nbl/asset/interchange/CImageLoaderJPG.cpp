@@ -145,6 +145,12 @@ namespace jpeg
 		// DO NOTHING
 	}
 
+	//! `header` are the 4 bytes at offset 6 of the file
+	inline bool isJPGHeader(const uint32_t header)
+	{
+		return (header&0x00FFD8FFu)==0x00FFD8FFu || header == 0x4a464946 || header == 0x4649464a || header == 0x66697845u || header == 0x70747468u; // maybe 0x4a464946 can go
+	}
+
 }
 #endif // _NBL_COMPILE_WITH_LIBJPEG_
 
@@ -160,7 +166,24 @@ bool CImageLoaderJPG::isALoadableFileFormat(system::IFile* _file, const system::
 	uint32_t header = 0;	
 	system::IFile::success_t success;
 	_file->read(success, &header, 6, sizeof(uint32_t));
-	return success && ((header&0x00FFD8FFu)==0x00FFD8FFu || header == 0x4a464946 || header == 0x4649464a || header == 0x66697845u || header == 0x70747468u); // maybe 0x4a464946 can go
+	return success && jpeg::isJPGHeader(header);
+#endif
+}
+
+std::span<const IAssetLoader::SFileSignature> CImageLoaderJPG::getFileSignatures() const
+{
+#ifndef _NBL_COMPILE_WITH_LIBJPEG_
+	return {};
+#else
+	static const SFileSignature signatures[] = {{.probe=[](const std::span<const uint8_t> prefix, const size_t fileSize) -> SFileSignature::E_MATCH
+	{
+		uint32_t header;
+		if (prefix.size()<6u+sizeof(header))
+			return SFileSignature::E_MATCH::NO;
+		memcpy(&header,prefix.data()+6u,sizeof(header));
+		return jpeg::isJPGHeader(header) ? SFileSignature::E_MATCH::YES:SFileSignature::E_MATCH::NO;
+	}}};
+	return signatures;
 #endif
 }
 
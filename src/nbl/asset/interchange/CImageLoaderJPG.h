@@ -37,6 +37,7 @@ private:
 	    CImageLoaderJPG();
 
         virtual bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+        virtual std::span<const SFileSignature> getFileSignatures() const override;
 
         virtual const char** getAssociatedFileExtensions() const override
         {
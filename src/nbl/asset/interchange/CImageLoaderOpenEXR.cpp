@@ -410,6 +410,12 @@ bool CImageLoaderOpenEXR::isALoadableFileFormat(system::IFile* _file, const syst
 	return success && isImfMagic(magicNumberBuffer);
 }
 
+std::span<const IAssetLoader::SFileSignature> CImageLoaderOpenEXR::getFileSignatures() const
+{
+	static const SFileSignature signatures[] = {{.magic=std::string_view("\x76\x2f\x31\x01",4)}};
+	return signatures;
+}
+
 template<typename rgbaFormat>
 void readRgba(InputFile& file, std::array<Array2D<rgbaFormat>, 4>& pixelRgbaMapArray, int& width, int& height, E_FORMAT& format, const suffixOfChannelBundle suffixOfChannels)
 {
@@ -26,6 +26,7 @@ class CImageLoaderOpenEXR final : public IImageLoader
 		CImageLoaderOpenEXR(IAssetManager* _manager) : m_manager(_manager) {}
 
 		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+		std::span<const SFileSignature> getFileSignatures() const override;
 
 		const char** getAssociatedFileExtensions() const override
 		{
@@ -96,6 +96,16 @@ bool CImageLoaderPng::isALoadableFileFormat(system::IFile* _file, const system::
 #endif // _NBL_COMPILE_WITH_LIBPNG_
 }
 
+std::span<const IAssetLoader::SFileSignature> CImageLoaderPng::getFileSignatures() const
+{
+#ifdef _NBL_COMPILE_WITH_LIBPNG_
+	static const SFileSignature signatures[] = {{.magic=std::string_view("\x89PNG\r\n\x1A\n",8)}};
+	return signatures;
+#else
+	return {};
+#endif // _NBL_COMPILE_WITH_LIBPNG_
+}
+
 
 // load in the image data
 asset::SAssetBundle CImageLoaderPng::loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
@@ -84,6 +84,11 @@ public:
         _file->read(succ, &firstChar, 0, sizeof(firstChar));
         return succ && (firstChar =='#' || firstChar =='v');
     }
+    std::span<const SFileSignature> getFileSignatures() const override
+    {
+        static const SFileSignature signatures[] = {{.magic="#"},{.magic="v"}};
+        return signatures;
+    }
 
     virtual const char** getAssociatedFileExtensions() const override
     {
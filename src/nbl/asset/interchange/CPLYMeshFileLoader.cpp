@@ -27,35 +27,55 @@ CPLYMeshFileLoader::CPLYMeshFileLoader(IAssetManager* _am)
 
 CPLYMeshFileLoader::~CPLYMeshFileLoader() {}
 
-bool CPLYMeshFileLoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+namespace
+{
+constexpr size_t PLYHeaderProbeSize = 40u;
+// `prefix` are the first `PLYHeaderProbeSize` bytes of the file
+bool isPLYHeader(const std::string_view prefix)
 {
-    const char* headers[3]{
+    const std::string_view headers[3]{
         "format ascii 1.0",
         "format binary_little_endian 1.0",
         "format binary_big_endian 1.0"
     };
 
-    char buf[40];
+    if (prefix.substr(0u, 3u) != "ply")
+        return false;
+
+    auto header = prefix.substr(4u);
+    const auto lf = header.find('\n');
+    if (lf == std::string_view::npos)
+        return false;
+    header = header.substr(0u, lf);
+
+    for (uint32_t i = 0u; i < 3u; ++i)
+        if (header == headers[i])
+            return true;
+    return false;
+}
+}
+
+bool CPLYMeshFileLoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
+{
+    char buf[PLYHeaderProbeSize];
 
 	system::IFile::success_t success;
 	_file->read(success, buf, 0, sizeof(buf));
 	if (!success)
 		return false;
 
-    char* header = buf;
-    if (strncmp(header, "ply", 3u) != 0)
-        return false;
-    
-    header += 4;
-    char* lf = strstr(header, "\n");
-    if (!lf)
-        return false;
-    *lf = 0;
+    return isPLYHeader(std::string_view(buf, sizeof(buf)));
+}
 
-    for (uint32_t i = 0u; i < 3u; ++i)
-        if (strcmp(header, headers[i]) == 0)
-            return true;
-    return false;
+std::span<const IAssetLoader::SFileSignature> CPLYMeshFileLoader::getFileSignatures() const
+{
+    static const SFileSignature signatures[] = {{.probe=[](const std::span<const uint8_t> prefix, const size_t fileSize) -> SFileSignature::E_MATCH
+    {
+        if (prefix.size() < PLYHeaderProbeSize || !isPLYHeader(std::string_view(reinterpret_cast<const char*>(prefix.data()), PLYHeaderProbeSize)))
+            return SFileSignature::E_MATCH::NO;
+        return SFileSignature::E_MATCH::YES;
+    }}};
+    return signatures;
 }
 
 void CPLYMeshFileLoader::initialize()
@@ -40,6 +40,7 @@ public:
 	CPLYMeshFileLoader(IAssetManager* _am);
 
     virtual bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+    virtual std::span<const SFileSignature> getFileSignatures() const override;
 
     virtual const char** getAssociatedFileExtensions() const override
     {
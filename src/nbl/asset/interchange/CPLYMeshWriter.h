@@ -6,10 +6,9 @@
 #ifndef __NBL_ASSET_PLY_MESH_WRITER_H_INCLUDED__
 #define __NBL_ASSET_PLY_MESH_WRITER_H_INCLUDED__
 
-#include <iomanip>
-
 #include "nbl/asset/ICPUMeshBuffer.h"
 #include "nbl/asset/interchange/IAssetWriter.h"
+#include "nbl/system/CBufferedFileWriter.h"
 
 namespace nbl
 {
@@ -42,7 +41,7 @@ class CPLYMeshWriter : public asset::IAssetWriter
         struct SContext
         {
             SAssetWriteContext writeContext;
-            size_t fileOffset = 0;
+            system::CBufferedFileWriter writer;
         };
 
         void writeBinary(const asset::ICPUMeshBuffer* _mbuf, size_t _vtxCount, size_t _fcCount, asset::E_INDEX_TYPE _idxType, void* const _indices, bool _forceFaces, const bool _vaidToWrite[4], SContext& context) const;
@@ -59,8 +58,6 @@ class CPLYMeshWriter : public asset::IAssetWriter
         void writeVectorAsText(SContext& context, const T* _vec, size_t _elementsToWrite, bool flipVectors = false) const
         {
 			constexpr size_t xID = 0u;
-            std::stringstream ss;
-            ss << std::fixed;
 			bool currentFlipOnVariable = false;
 			for (size_t i = 0u; i < _elementsToWrite; ++i)
 			{
@@ -69,13 +66,13 @@ class CPLYMeshWriter : public asset::IAssetWriter
 				else
 					currentFlipOnVariable = false;
 
-					ss << std::setprecision(6) << _vec[i] * (currentFlipOnVariable ? -1 : 1) << " ";
+				const auto value = _vec[i] * (currentFlipOnVariable ? -1 : 1);
+				if constexpr (std::is_floating_point_v<decltype(value)>)
+					context.writer.writeFixed(value, 6);
+				else
+					context.writer.writeInteger(value);
+				context.writer.put(' ');
 			}
-            auto str = ss.str();
-
-            system::IFile::success_t succ;
-            context.writeContext.outputFile->write(succ, str.c_str(), context.fileOffset, str.size());
-            context.fileOffset += succ.getBytesProcessed();
         }
 };
 
@@ -23,6 +23,12 @@ class CSPVLoader final : public asset::IAssetLoader
 			_file->read(success, &magicNumber, 0, sizeof magicNumber);
 			return success && magicNumber==SPV_MAGIC_NUMBER;
 		}
+		std::span<const SFileSignature> getFileSignatures() const override
+		{
+			// little endian `SPV_MAGIC_NUMBER`
+			static const SFileSignature signatures[] = {{.magic=std::string_view("\x03\x02\x23\x07",4)}};
+			return signatures;
+		}
 
 		const char** getAssociatedFileExtensions() const override
 		{
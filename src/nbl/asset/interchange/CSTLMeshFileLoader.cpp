@@ -348,6 +348,26 @@ bool CSTLMeshFileLoader::isALoadableFileFormat(system::IFile* _file, const syste
 	}
 }
 
+std::span<const IAssetLoader::SFileSignature> CSTLMeshFileLoader::getFileSignatures() const
+{
+	// same checks as `isALoadableFileFormat`, both the ASCII header and the binary triangle count fit in the prefix
+	static const SFileSignature signatures[] = {{.probe=[](const std::span<const uint8_t> prefix, const size_t fileSize) -> SFileSignature::E_MATCH
+	{
+		if (fileSize <= 6u)
+			return SFileSignature::E_MATCH::NO;
+		if (memcmp(prefix.data(), "solid ", 6u) == 0)
+			return SFileSignature::E_MATCH::YES;
+		if (fileSize < 84u)
+			return SFileSignature::E_MATCH::NO;
+
+		uint32_t triangleCount;
+		memcpy(&triangleCount, prefix.data() + 80u, sizeof(triangleCount));
+		constexpr size_t STL_TRI_SZ = 50u;
+		return fileSize == (STL_TRI_SZ * triangleCount + 84u) ? SFileSignature::E_MATCH::YES : SFileSignature::E_MATCH::NO;
+	}}};
+	return signatures;
+}
+
 //! Read 3d vector of floats
 void CSTLMeshFileLoader::getNextVector(SContext* context, core::vectorSIMDf& vec, bool binary) const
 {
@@ -27,6 +27,7 @@ class CSTLMeshFileLoader final : public IRenderpassIndependentPipelineLoader
 		asset::SAssetBundle loadAsset(system::IFile* _file, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
 
 		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
+		std::span<const SFileSignature> getFileSignatures() const override;
 
 		const char** getAssociatedFileExtensions() const override
 		{
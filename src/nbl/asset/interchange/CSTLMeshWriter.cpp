@@ -50,7 +50,7 @@ bool CSTLMeshWriter::writeAsset(system::IFile* _file, const SAssetWriteParams& _
 	if (!file)
 		return false;
 
-	SContext context = { SAssetWriteContext{ inCtx.params, file} };
+	SContext context = { SAssetWriteContext{ inCtx.params, file}, system::CBufferedFileWriter(file) };
 
 	_params.logger.log("WRITING STL: writing the file %s", system::ILogger::ELL_INFO, file->getFileName().string().c_str());
 
@@ -64,7 +64,7 @@ bool CSTLMeshWriter::writeAsset(system::IFile* _file, const SAssetWriteParams& _
 namespace
 {
 template <class I>
-inline void writeFacesBinary(const asset::ICPUMeshBuffer* buffer, const bool& noIndices, system::IFile* file, uint32_t _colorVaid, IAssetWriter::SAssetWriteContext* context, size_t* fileOffset)
+inline void writeFacesBinary(const asset::ICPUMeshBuffer* buffer, const bool& noIndices, system::CBufferedFileWriter& writer, uint32_t _colorVaid, IAssetWriter::SAssetWriteContext* context)
 {
 	auto& inputParams = buffer->getPipeline()->getCachedCreationParams().vertexInput;
 	bool hasColor = inputParams.enabledAttribFlags & core::createBitmask({ COLOR_ATTRIBUTE });
@@ -130,40 +130,11 @@ inline void writeFacesBinary(const asset::ICPUMeshBuffer* buffer, const bool& no
 		if (!(context->params.flags & E_WRITER_FLAGS::EWF_MESH_IS_RIGHT_HANDED))
 			flipVectors();
 
-		{
-			system::IFile::success_t success;;
-			file->write(success, &normal, *fileOffset, 12);
-	
-			*fileOffset += success.getBytesProcessed();
-		}
-
-		{
-			system::IFile::success_t success;;
-			file->write(success, &vertex1, *fileOffset, 12);
-	
-			*fileOffset += success.getBytesProcessed();
-		}
-
-		{
-			system::IFile::success_t success;;
-			file->write(success, &vertex2, *fileOffset, 12);
-	
-			*fileOffset += success.getBytesProcessed();
-		}
-
-		{
-			system::IFile::success_t success;;
-			file->write(success, &vertex3, *fileOffset, 12);
-	
-			*fileOffset += success.getBytesProcessed();
-		}
-
-		{
-			system::IFile::success_t success;;
-			file->write(success, &color, *fileOffset, 2); // saving color using non-standard VisCAM/SolidView trick
-	
-			*fileOffset += success.getBytesProcessed();
-		}
+		writer.write(&normal, 12);
+		writer.write(&vertex1, 12);
+		writer.write(&vertex2, 12);
+		writer.write(&vertex3, 12);
+		writer.write(&color, 2); // saving color using non-standard VisCAM/SolidView trick
     }
 }
 }
@@ -174,51 +145,24 @@ bool CSTLMeshWriter::writeMeshBinary(const asset::ICPUMesh* mesh, SContext* cont
     const char headerTxt[] = "Irrlicht-baw Engine";
     constexpr size_t HEADER_SIZE = 80u;
 
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, headerTxt, context->fileOffset, sizeof(headerTxt));
-
-		context->fileOffset += success.getBytesProcessed();
-	}
+	context->writer.write(headerTxt, sizeof(headerTxt));
 
 	const std::string name = context->writeContext.outputFile->getFileName().filename().replace_extension().string(); // TODO: check it
 	const int32_t sizeleft = HEADER_SIZE - sizeof(headerTxt) - name.size();
 
 	if (sizeleft < 0)
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, name.c_str(), context->fileOffset, HEADER_SIZE - sizeof(headerTxt));
-
-		context->fileOffset += success.getBytesProcessed();
-	}
+		context->writer.write(name.c_str(), HEADER_SIZE - sizeof(headerTxt));
 	else
 	{
 		const char buf[80] = {0};
-
-		{
-			system::IFile::success_t success;;
-			context->writeContext.outputFile->write(success, name.c_str(), context->fileOffset, name.size());
-	
-			context->fileOffset += success.getBytesProcessed();
-		}
-
-		{
-			system::IFile::success_t success;;
-			context->writeContext.outputFile->write(success, buf, context->fileOffset, sizeleft);
-	
-			context->fileOffset += success.getBytesProcessed();
-		}
+		context->writer.write(name);
+		context->writer.write(buf, sizeleft);
 	}
 
 	uint32_t facenum = 0;
 	for (auto& mb : mesh->getMeshBuffers())
 		facenum += mb->getIndexCount()/3;
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, &facenum, context->fileOffset, sizeof(facenum));
-
-		context->fileOffset += success.getBytesProcessed();
-	}
+	context->writer.write(&facenum, sizeof(facenum));
 	// write mesh buffers
 
 	for (auto& buffer : mesh->getMeshBuffers())
@@ -229,13 +173,13 @@ bool CSTLMeshWriter::writeMeshBinary(const asset::ICPUMesh* mesh, SContext* cont
             type = asset::EIT_UNKNOWN;
 
 		if (type== asset::EIT_16BIT)
-            writeFacesBinary<uint16_t>(buffer, false, context->writeContext.outputFile, COLOR_ATTRIBUTE, &context->writeContext, &context->fileOffset);
+            writeFacesBinary<uint16_t>(buffer, false, context->writer, COLOR_ATTRIBUTE, &context->writeContext);
 		else if (type== asset::EIT_32BIT)
-            writeFacesBinary<uint32_t>(buffer, false, context->writeContext.outputFile, COLOR_ATTRIBUTE, &context->writeContext, &context->fileOffset);
+            writeFacesBinary<uint32_t>(buffer, false, context->writer, COLOR_ATTRIBUTE, &context->writeContext);
 		else
-            writeFacesBinary<uint16_t>(buffer, true, context->writeContext.outputFile, COLOR_ATTRIBUTE, &context->writeContext, &context->fileOffset); //template param doesn't matter if there's no indices
+            writeFacesBinary<uint16_t>(buffer, true, context->writer, COLOR_ATTRIBUTE, &context->writeContext); //template param doesn't matter if there's no indices
 	}
-	return true;
+	return context->writer.flush();
 }
 
 bool CSTLMeshWriter::writeMeshASCII(const asset::ICPUMesh* mesh, SContext* context)
@@ -243,37 +187,13 @@ bool CSTLMeshWriter::writeMeshASCII(const asset::ICPUMesh* mesh, SContext* conte
 	// write STL MESH header
     const char headerTxt[] = "Irrlicht-baw Engine ";
 
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "solid ", context->fileOffset, 6);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, headerTxt, context->fileOffset, sizeof(headerTxt) - 1);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
+	context->writer.write("solid ");
+	context->writer.write(headerTxt, sizeof(headerTxt) - 1);
 
 	const std::string name = context->writeContext.outputFile->getFileName().filename().replace_extension().string();
 
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, name.c_str(), context->fileOffset, name.size());
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "\n", context->fileOffset, 1);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
+	context->writer.write(name);
+	context->writer.put('\n');
 
 	// write mesh buffers
 	for (auto& buffer : mesh->getMeshBuffers())
@@ -323,43 +243,25 @@ bool CSTLMeshWriter::writeMeshASCII(const asset::ICPUMesh* mesh, SContext* conte
             }
         }
 
-		{
-			system::IFile::success_t success;;
-			context->writeContext.outputFile->write(success, "\n", context->fileOffset, 1);
-	
-			context->fileOffset += success.getBytesProcessed();
-		}
+		context->writer.put('\n');
 	}
 
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "endsolid ", context->fileOffset, 9);
+	context->writer.write("endsolid ");
+	context->writer.write(headerTxt, sizeof(headerTxt) - 1);
+	context->writer.write(name);
 
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, headerTxt, context->fileOffset, sizeof(headerTxt) - 1);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, name.c_str(), context->fileOffset, name.size());
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	return true;
+	return context->writer.flush();
 }
 
-void CSTLMeshWriter::getVectorAsStringLine(const core::vectorSIMDf& v, std::string& s) const
+void CSTLMeshWriter::writeVectorAsStringLine(const core::vectorSIMDf& v, SContext* context) const
 {
-    std::ostringstream tmp;
-    tmp << v.X << " " << v.Y << " " << v.Z << "\n";
-    s = std::string(tmp.str().c_str());
+	auto& writer = context->writer;
+	writer.writeFloat(v.X);
+	writer.put(' ');
+	writer.writeFloat(v.Y);
+	writer.put(' ');
+	writer.writeFloat(v.Z);
+	writer.put('\n');
 }
 
 void CSTLMeshWriter::writeFaceText(
@@ -372,7 +274,6 @@ void CSTLMeshWriter::writeFaceText(
 	core::vectorSIMDf vertex2 = v2;
 	core::vectorSIMDf vertex3 = v1;
 	core::vectorSIMDf normal = core::plane3dSIMDf(vertex1, vertex2, vertex3).getNormal();
-	std::string tmp;
 
 	auto flipVectors = [&]()
 	{
@@ -385,90 +286,17 @@ void CSTLMeshWriter::writeFaceText(
 	if (!(context->writeContext.params.flags & E_WRITER_FLAGS::EWF_MESH_IS_RIGHT_HANDED))
 		flipVectors();
 	
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "facet normal ", context->fileOffset, 13);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	getVectorAsStringLine(normal, tmp);
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, tmp.c_str(), context->fileOffset, tmp.size());
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "  outer loop\n", context->fileOffset, 13);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "    vertex ", context->fileOffset, 11);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	getVectorAsStringLine(vertex1, tmp);
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, tmp.c_str(), context->fileOffset, tmp.size());
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "    vertex ", context->fileOffset, 11);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	getVectorAsStringLine(vertex2, tmp);
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, tmp.c_str(), context->fileOffset, tmp.size());
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "    vertex ", context->fileOffset, 11);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	getVectorAsStringLine(vertex3, tmp);
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, tmp.c_str(), context->fileOffset, tmp.size());
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "  endloop\n", context->fileOffset, 10);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
-
-	{
-		system::IFile::success_t success;;
-		context->writeContext.outputFile->write(success, "endfacet\n", context->fileOffset, 9);
-
-		context->fileOffset += success.getBytesProcessed();
-	}
+	context->writer.write("facet normal ");
+	writeVectorAsStringLine(normal, context);
+	context->writer.write("  outer loop\n");
+	context->writer.write("    vertex ");
+	writeVectorAsStringLine(vertex1, context);
+	context->writer.write("    vertex ");
+	writeVectorAsStringLine(vertex2, context);
+	context->writer.write("    vertex ");
+	writeVectorAsStringLine(vertex3, context);
+	context->writer.write("  endloop\n");
+	context->writer.write("endfacet\n");
 }
 
 #endif
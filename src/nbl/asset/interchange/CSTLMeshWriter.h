@@ -8,6 +8,7 @@
 
 #include "nbl/asset/ICPUMesh.h"
 #include "nbl/asset/interchange/IAssetWriter.h"
+#include "nbl/system/CBufferedFileWriter.h"
 
 namespace nbl
 {
@@ -42,7 +43,7 @@ class CSTLMeshWriter : public asset::IAssetWriter
         struct SContext
         {
             SAssetWriteContext writeContext;
-            size_t fileOffset;
+            system::CBufferedFileWriter writer;
         };
 
         // write binary format
@@ -51,8 +52,8 @@ class CSTLMeshWriter : public asset::IAssetWriter
         // write text format
         bool writeMeshASCII(const asset::ICPUMesh* mesh, SContext* context);
 
-        // create vector output with line end into string
-        void getVectorAsStringLine(const core::vectorSIMDf& v, std::string& s) const;
+        // write vector output with line end
+        void writeVectorAsStringLine(const core::vectorSIMDf& v, SContext* context) const;
 
         // write face information to file
         void writeFaceText(const core::vectorSIMDf& v1,
@@ -4,8 +4,11 @@
 
 #include <nbl/asset/material_compiler/CMaterialCompilerGLSLBackendCommon.h>
 
+#include "nbl/core/execution.h"
+
 #include <iostream>
-#include <nbl/asset/material_compiler/CMaterialCompilerGLSLBackendCommon.h>
+#include <numeric>
+#include <thread>
 
 namespace nbl
 {
@@ -38,6 +41,8 @@ class CInterpreter
 
 			// the coating is a dielectric, but it cannot transmit so make it a conductor
 			auto* coat = ir->allocTmpNode<IR::CMicrofacetSpecularBSDFNode>();
+			if (!coat)
+				return nullptr;
 			{
 				coat->alpha_u = coat_blend->alpha_u;
 				coat->alpha_v = coat_blend->alpha_v;
@@ -55,6 +60,8 @@ class CInterpreter
 				return found->second;
 
 			auto* coat = ir->allocTmpNode<IR::CBSDFNode>(IR::CBSDFNode::ET_DELTA_TRANSMISSION);
+			if (!coat)
+				return nullptr;
 			cache->insert({ coat_blend, coat });
 
 			return coat;
@@ -285,40 +292,7 @@ class ITraversalGenerator
 
 		instr_stream::VTID packTexture(const IR::INode::STextureSource& tex)
 		{
-			// cache, obviously
-			if (auto found = m_ctx->VTallocMap.find({ tex.image.get(),tex.sampler.get() }); found != m_ctx->VTallocMap.end())
-				return found->second;
-
-			auto img = tex.image->getCreationParameters().image;
-			img = m_ctx->vt.vt->createUpscaledImage(img.get());
-			auto* sampler = tex.sampler.get();
-
-			const auto& extent = img->getCreationParameters().extent;
-			const auto uwrap = static_cast<asset::ISampler::E_TEXTURE_CLAMP>(sampler->getParams().TextureWrapU);
-			const auto vwrap = static_cast<asset::ISampler::E_TEXTURE_CLAMP>(sampler->getParams().TextureWrapV);
-			const auto border = static_cast<asset::ISampler::E_TEXTURE_BORDER_COLOR>(sampler->getParams().BorderColor);
-
-			asset::IImage::SSubresourceRange subres;
-			subres.baseArrayLayer = 0u;
-			subres.layerCount = 1u;
-			subres.baseMipLevel = 0u;
-			const uint32_t mx = std::max(extent.width, extent.height);
-			const uint32_t round = core::roundUpToPoT<uint32_t>(mx);
-			const int32_t lsb = hlsl::findLSB(round);
-			subres.levelCount = static_cast<uint32_t>(lsb + 1);
-
-			SContext::VT::alloc_t alloc;
-			alloc.format = img->getCreationParameters().format;
-			alloc.extent = img->getCreationParameters().extent;
-			alloc.subresource = subres;
-			alloc.uwrap = uwrap;
-			alloc.vwrap = vwrap;
-			auto addr = m_ctx->vt.alloc(alloc, std::move(img), border);
-
-			std::pair<SContext::VTallocKey, instr_stream::VTID> item{{tex.image.get(),tex.sampler.get()}, addr};
-			m_ctx->VTallocMap.insert(item);
-
-			return addr;
+			return m_ctx->packTexture({tex.image.get(),tex.sampler.get()});
 		}
 
 		// returns if the instruction actually got pushed
@@ -618,6 +592,8 @@ const IR::INode* CInterpreter::translateMixIntoBlends(IR* ir, const IR::INode* _
 	while (q.size()>1ull)
 	{
 		auto* blend = ir->allocTmpNode<IR::CBSDFBlendNode>();
+		if (!blend)
+			return nullptr;
 		blend->weight.source = IR::INode::EPS_CONSTANT;
 
 		auto left = q.front();
@@ -663,9 +639,18 @@ std::pair<instr_t, const IR::INode*> CInterpreter::processSubtree(IR* ir, const
 		break;
 		case IR::CBSDFCombinerNode::ET_MIX:
 		{
-			tree = translateMixIntoBlends(ir, node);
-			instr = instr_stream::OP_BLEND;
-			out_next = tree->children;
+			// out of IR node memory, the mix gets skipped like an unsupported node
+			if (auto* blends=translateMixIntoBlends(ir, node); blends)
+			{
+				tree = blends;
+				instr = instr_stream::OP_BLEND;
+				out_next = tree->children;
+			}
+			else
+			{
+				instr = instr_stream::OP_INVALID;
+				out_next = node->children;
+			}
 		}
 		break;
 		}
@@ -674,11 +659,14 @@ std::pair<instr_t, const IR::INode*> CInterpreter::processSubtree(IR* ir, const
 	case IR::INode::ES_OPACITY:
 	{
 		auto* opacity = static_cast<const IR::COpacityNode*>(tree);
-		auto* blend = ir->allocTmpNode<IR::CBSDFBlendNode>();
-		blend->weight = opacity->opacity;
-		auto* deltatrans = getDeltaTransmissionNode(ir, cache, opacity);
 		assert(opacity->children.count == 1u);
 		auto* bxdf = const_cast<IR::INode*>(opacity->children[0]);
+		auto* blend = ir->allocTmpNode<IR::CBSDFBlendNode>();
+		auto* deltatrans = blend ? getDeltaTransmissionNode(ir, cache, opacity):nullptr;
+		// out of IR node memory, so the material gets treated as fully opaque
+		if (!deltatrans)
+			return processSubtree(ir, bxdf, out_next, cache);
+		blend->weight = opacity->opacity;
 		blend->children = IR::INode::createChildrenArray(deltatrans,bxdf);
 		out_next = blend->children;
 
@@ -702,6 +690,7 @@ std::pair<instr_t, const IR::INode*> CInterpreter::processSubtree(IR* ir, const
 		case IR::CBSDFNode::ET_MICROFACET_COATING:
 		{
 			auto* coat_blend = static_cast<const IR::CMicrofacetCoatingBSDFNode*>(node);
+			// null if out of IR node memory, then the coating layer gets ignored like it is over non-diffuse materials
 			auto* coat = getCoatNode(ir, cache, coat_blend);
 
 			assert(node->children.count == 1u);
@@ -717,7 +706,7 @@ std::pair<instr_t, const IR::INode*> CInterpreter::processSubtree(IR* ir, const
 			//assert(is_coated_diffuse);
 			// we dont support coating over non-diffuse materials
 			// so we ignore coating layer and process only the coated material
-			if (!is_coated_diffuse)
+			if (!is_coated_diffuse || !coat)
 			{
 				// TODO: use logger
 				// os::Printer::log("Material compiler GLSL: Coating over non-diffuse materials is not supported. Ignoring coating layer!", ELL_WARNING);
@@ -1199,159 +1188,367 @@ std::string CMaterialCompilerGLSLBackendCommon::genPreprocDefinitions(const resu
 	return defs;
 }
 
-auto CMaterialCompilerGLSLBackendCommon::compile(SContext* _ctx, IR* _ir, E_GENERATOR_STREAM_TYPE _generatorChoiceStream) -> result_t
+auto CMaterialCompilerGLSLBackendCommon::SContext::packTexture(const VTallocKey& _key) -> instr_stream::VTID
 {
-	result_t res;
-	res.noNormPrecompStream = true;
-	res.noPrefetchStream = true;
-	res.usedRegisterCount = 0u;
-	res.globalPrefetchRegCountFlags = 0u;
+	// cache, obviously
+	if (auto found = VTallocMap.find(_key); found != VTallocMap.end())
+		return found->second;
 
-	for (const IR::INode* root : _ir->roots)
+	instr_stream::VTID addr;
+	if (deferVTallocs)
 	{
-		uint32_t remainingRegisters = instr_stream::MAX_REGISTER_COUNT;
+		addr = makeDeferredVTID(deferredVTallocs.size());
+		deferredVTallocs.push_back(_key);
+	}
+	else
+	{
+		auto img = _key.first->getCreationParameters().image;
+		img = vt.vt->createUpscaledImage(img.get());
+		const auto* sampler = _key.second;
+
+		const auto& extent = img->getCreationParameters().extent;
+		const auto uwrap = static_cast<asset::ISampler::E_TEXTURE_CLAMP>(sampler->getParams().TextureWrapU);
+		const auto vwrap = static_cast<asset::ISampler::E_TEXTURE_CLAMP>(sampler->getParams().TextureWrapV);
+		const auto border = static_cast<asset::ISampler::E_TEXTURE_BORDER_COLOR>(sampler->getParams().BorderColor);
+
+		asset::IImage::SSubresourceRange subres;
+		subres.baseArrayLayer = 0u;
+		subres.layerCount = 1u;
+		subres.baseMipLevel = 0u;
+		const uint32_t mx = std::max(extent.width, extent.height);
+		const uint32_t round = core::roundUpToPoT<uint32_t>(mx);
+		const int32_t lsb = hlsl::findLSB(round);
+		subres.levelCount = static_cast<uint32_t>(lsb + 1);
+
+		VT::alloc_t alloc;
+		alloc.format = img->getCreationParameters().format;
+		alloc.extent = img->getCreationParameters().extent;
+		alloc.subresource = subres;
+		alloc.uwrap = uwrap;
+		alloc.vwrap = vwrap;
+		addr = vt.alloc(alloc, std::move(img), border);
+	}
+	VTallocMap.insert({_key,addr});
 
-		const size_t interm_bsdf_data_begin_ix = _ctx->bsdfData.size();
+	return addr;
+}
 
-		CIdGenerator id_gen;
+struct CMaterialCompilerGLSLBackendCommon::SRootCompilation
+{
+	SContext ctx;
 
-		remainder_and_pdf::CTraversalManipulator::id2pos_map_t id2pos;
-		tmp_bxdf_translation_cache_t translationCache;
+	traversal_t rem_pdf_stream;
+	traversal_t gen_choice_stream;
+	traversal_t normal_precomp_stream;
+	instr_stream::tex_prefetch::prefetch_stream_t tex_prefetch_stream;
 
-		uint32_t usedRegs{};
-		traversal_t rem_pdf_stream;
-		{
-			// TODO: investigate compression of return value registers from 11 to 5 DWORDs
-			const uint32_t regsPerRes = [_generatorChoiceStream]() -> auto
-			{
-				// In case of presence of generator choice stream, remainder_and_pdf stream has 2 roles in raster backend:
-				// * eval stream
-				// * remainder-and-pdf stream (for use in multiple importance sampling, as an example); in which case instructions need to write their PDF as well
-				// In raytracing backend _computeGenChoiceStream is always present
-				switch (_generatorChoiceStream)
-				{
-					case EGST_PRESENT:
-						return 4u;
-						break;
-					// When desiring Albedo and Normal Extraction, one needs to use extra registers for albedo, normal and throughput scale
-					case EGST_PRESENT_WITH_AOV_EXTRACTION:
-						// TODO: investigate whether using 10-16bit storage (fixed point or half float) makes execution faster, because 
-						// albedo could fit in 1.5 DWORDs as 16bit (or 1 DWORDs as 10 bit), normal+throughput scale in 2 DWORDs as half floats or 16 bit snorm
-						// and value/pdf is a low dynamic range so half float could be feasible! Giving us a total register count of 5 DWORDs.
-						return 11u;
-						break;
-					default:
-						break;
-				}
-				// only colour contribution
-				return 3u; 
-			}();
-
-			remainder_and_pdf::CTraversalGenerator gen(_ctx, _ir, &id_gen, &translationCache, remainingRegisters, regsPerRes);
-			rem_pdf_stream = gen.genTraversal(root, usedRegs);
-			assert(usedRegs <= remainingRegisters);
-			remainingRegisters -= usedRegs;
-			id2pos = gen.getId2PosMapping();
-		}
-		traversal_t gen_choice_stream;
-		if (_generatorChoiceStream!=EGST_ABSENT)
+	// final form of `ctx.bsdfData`, same indexing
+	core::vector<instr_stream::SBSDFUnion> bsdfData;
+
+	uint32_t prefetchRegCountFlags = 0u;
+	uint32_t usedRegisterCount = 0u;
+};
+
+void CMaterialCompilerGLSLBackendCommon::compileRoot(SRootCompilation& _out, const IR::INode* root, IR* _scratchIR, E_GENERATOR_STREAM_TYPE _generatorChoiceStream)
+{
+	SContext* const ctx = &_out.ctx;
+	ctx->deferVTallocs = true;
+
+	uint32_t remainingRegisters = instr_stream::MAX_REGISTER_COUNT;
+
+	CIdGenerator id_gen;
+
+	remainder_and_pdf::CTraversalManipulator::id2pos_map_t id2pos;
+	tmp_bxdf_translation_cache_t translationCache;
+
+	uint32_t usedRegs{};
+	traversal_t& rem_pdf_stream = _out.rem_pdf_stream;
+	{
+		// TODO: investigate compression of return value registers from 11 to 5 DWORDs
+		const uint32_t regsPerRes = [_generatorChoiceStream]() -> auto
 		{
-			gen_choice::CTraversalGenerator gen(_ctx, _ir, &id_gen, &translationCache, 0u);
-			// generator stream does not consume any registers
-			uint32_t dummyUsedRegs;
-			gen_choice_stream = gen.genTraversal(root,dummyUsedRegs);
-			assert(dummyUsedRegs==0u);
-
-			// final instructions in generator choice need to know which instruction in the remainder&pdf stream corresponds to the same BxDF
-			for (auto& instr : gen_choice_stream)
+			// In case of presence of generator choice stream, remainder_and_pdf stream has 2 roles in raster backend:
+			// * eval stream
+			// * remainder-and-pdf stream (for use in multiple importance sampling, as an example); in which case instructions need to write their PDF as well
+			// In raytracing backend _computeGenChoiceStream is always present
+			switch (_generatorChoiceStream)
 			{
-				const instr_stream::instr_id_t id = instr_stream::getInstrId(instr);
-				uint32_t rnp_pos = static_cast<uint32_t>(-1);
-				if (auto found = id2pos.find(id); found != id2pos.end())
-					rnp_pos = found->second;
-				instr_stream::gen_choice::setOffsetIntoRemAndPdfStream(instr, rnp_pos);
+				case EGST_PRESENT:
+					return 4u;
+					break;
+				// When desiring Albedo and Normal Extraction, one needs to use extra registers for albedo, normal and throughput scale
+				case EGST_PRESENT_WITH_AOV_EXTRACTION:
+					// TODO: investigate whether using 10-16bit storage (fixed point or half float) makes execution faster, because 
+					// albedo could fit in 1.5 DWORDs as 16bit (or 1 DWORDs as 10 bit), normal+throughput scale in 2 DWORDs as half floats or 16 bit snorm
+					// and value/pdf is a low dynamic range so half float could be feasible! Giving us a total register count of 5 DWORDs.
+					return 11u;
+					break;
+				default:
+					break;
 			}
-		}
-
-		// Texture Prefetch and Normal Precompute dont allocate their registers first because we count on 
-		instr_stream::tex_prefetch::prefetch_stream_t tex_prefetch_stream;
-		core::unordered_map<instr_stream::STextureData, uint32_t, instr_stream::STextureData::hash> tex2reg;
+			// only colour contribution
+			return 3u; 
+		}();
+
+		remainder_and_pdf::CTraversalGenerator gen(ctx, _scratchIR, &id_gen, &translationCache, remainingRegisters, regsPerRes);
+		rem_pdf_stream = gen.genTraversal(root, usedRegs);
+		assert(usedRegs <= remainingRegisters);
+		remainingRegisters -= usedRegs;
+		id2pos = gen.getId2PosMapping();
+	}
+	traversal_t& gen_choice_stream = _out.gen_choice_stream;
+	if (_generatorChoiceStream!=EGST_ABSENT)
+	{
+		gen_choice::CTraversalGenerator gen(ctx, _scratchIR, &id_gen, &translationCache, 0u);
+		// generator stream does not consume any registers
+		uint32_t dummyUsedRegs;
+		gen_choice_stream = gen.genTraversal(root,dummyUsedRegs);
+		assert(dummyUsedRegs==0u);
+
+		// final instructions in generator choice need to know which instruction in the remainder&pdf stream corresponds to the same BxDF
+		for (auto& instr : gen_choice_stream)
 		{
-			tex_prefetch_stream = tex_prefetch::genTraversal(rem_pdf_stream, _ctx->bsdfData, tex2reg, instr_stream::MAX_REGISTER_COUNT-remainingRegisters, usedRegs, res.globalPrefetchRegCountFlags);
-			assert(usedRegs <= remainingRegisters);
-			remainingRegisters -= usedRegs;
+			const instr_stream::instr_id_t id = instr_stream::getInstrId(instr);
+			uint32_t rnp_pos = static_cast<uint32_t>(-1);
+			if (auto found = id2pos.find(id); found != id2pos.end())
+				rnp_pos = found->second;
+			instr_stream::gen_choice::setOffsetIntoRemAndPdfStream(instr, rnp_pos);
 		}
+	}
 
-		traversal_t normal_precomp_stream;
-		// register allocation for bumpmaps is a nice linear affair
-		// TODO: investigate performance impact of quantizing normals to 16 or 21bit SNORM
-		const uint32_t firstRegForBumpmaps = instr_stream::MAX_REGISTER_COUNT-remainingRegisters;
+	// Texture Prefetch and Normal Precompute dont allocate their registers first because we count on 
+	core::unordered_map<instr_stream::STextureData, uint32_t, instr_stream::STextureData::hash> tex2reg;
+	{
+		_out.tex_prefetch_stream = tex_prefetch::genTraversal(rem_pdf_stream, ctx->bsdfData, tex2reg, instr_stream::MAX_REGISTER_COUNT-remainingRegisters, usedRegs, _out.prefetchRegCountFlags);
+		assert(usedRegs <= remainingRegisters);
+		remainingRegisters -= usedRegs;
+	}
+
+	traversal_t& normal_precomp_stream = _out.normal_precomp_stream;
+	// register allocation for bumpmaps is a nice linear affair
+	// TODO: investigate performance impact of quantizing normals to 16 or 21bit SNORM
+	const uint32_t firstRegForBumpmaps = instr_stream::MAX_REGISTER_COUNT-remainingRegisters;
+	{
+		normal_precomp_stream.reserve(std::count_if(rem_pdf_stream.begin(), rem_pdf_stream.end(), [](instr_t i) {return instr_stream::getOpcode(i)==instr_stream::OP_BUMPMAP;}));
+		assert(firstRegForBumpmaps+3u*normal_precomp_stream.capacity() <= instr_stream::MAX_REGISTER_COUNT);
+		for (instr_t instr : rem_pdf_stream)
 		{
-			normal_precomp_stream.reserve(std::count_if(rem_pdf_stream.begin(), rem_pdf_stream.end(), [](instr_t i) {return instr_stream::getOpcode(i)==instr_stream::OP_BUMPMAP;}));
-			assert(firstRegForBumpmaps+3u*normal_precomp_stream.capacity() <= instr_stream::MAX_REGISTER_COUNT);
-			for (instr_t instr : rem_pdf_stream)
+			if (instr_stream::getOpcode(instr)==instr_stream::OP_BUMPMAP)
 			{
-				if (instr_stream::getOpcode(instr)==instr_stream::OP_BUMPMAP)
-				{
-					constexpr uint32_t REGS_FOR_NORMAL = 3u;
-					//we can be sure that n_id is always in range [0,count of bumpmap instrs)
-					const uint32_t n_id = instr_stream::getNormalId(instr);
-					instr = core::bitfieldInsert<instr_t>(instr, firstRegForBumpmaps + REGS_FOR_NORMAL*n_id, instr_stream::normal_precomp::BITFIELDS_REG_DST_SHIFT, instr_stream::normal_precomp::BITFIELDS_REG_WIDTH);
-					normal_precomp_stream.push_back(instr);
-				}
+				constexpr uint32_t REGS_FOR_NORMAL = 3u;
+				//we can be sure that n_id is always in range [0,count of bumpmap instrs)
+				const uint32_t n_id = instr_stream::getNormalId(instr);
+				instr = core::bitfieldInsert<instr_t>(instr, firstRegForBumpmaps + REGS_FOR_NORMAL*n_id, instr_stream::normal_precomp::BITFIELDS_REG_DST_SHIFT, instr_stream::normal_precomp::BITFIELDS_REG_WIDTH);
+				normal_precomp_stream.push_back(instr);
 			}
-			remainingRegisters = instr_stream::MAX_REGISTER_COUNT - firstRegForBumpmaps - 3u*normal_precomp_stream.size();
 		}
+		remainingRegisters = instr_stream::MAX_REGISTER_COUNT - firstRegForBumpmaps - 3u*normal_precomp_stream.size();
+	}
 
-		//src1 reg for OP_BUMPMAPs is set to dst reg of corresponding instruction in normal precomp stream
-		setSourceRegForBumpmaps(rem_pdf_stream, firstRegForBumpmaps);
-		setSourceRegForBumpmaps(gen_choice_stream, firstRegForBumpmaps);
+	//src1 reg for OP_BUMPMAPs is set to dst reg of corresponding instruction in normal precomp stream
+	setSourceRegForBumpmaps(rem_pdf_stream, firstRegForBumpmaps);
+	setSourceRegForBumpmaps(gen_choice_stream, firstRegForBumpmaps);
 
-		for (auto it = _ctx->bsdfData.begin()+interm_bsdf_data_begin_ix; it != _ctx->bsdfData.end(); ++it)
+	_out.bsdfData.reserve(ctx->bsdfData.size());
+	for (const auto& interm_bsdf_data : ctx->bsdfData)
+	{
+		// zeroed so that the unused upper half of prefetch register params compares equal in `mergeRoot`
+		instr_stream::SBSDFUnion bsdf_data;
+		memset(&bsdf_data,0,sizeof(bsdf_data));
+		for (uint32_t i = 0u; i < instr_stream::SBSDFUnion::MAX_TEXTURES; ++i)
 		{
-			const auto& interm_bsdf_data = *it;
+			auto found = tex2reg.find(interm_bsdf_data.common.param[i].tex);
+			if (found != tex2reg.end())
+				bsdf_data.common.param[i].setPrefetchReg(found->second);
+			else
+				bsdf_data.common.param[i].setConst(interm_bsdf_data.common.param[i].getConst());
+		}
+		bsdf_data.common.extras[0] = interm_bsdf_data.common.extras[0];
+		bsdf_data.common.extras[1] = interm_bsdf_data.common.extras[1];
 
-			instr_stream::SBSDFUnion bsdf_data;
-			for (uint32_t i = 0u; i < instr_stream::SBSDFUnion::MAX_TEXTURES; ++i)
-			{
-				auto found = tex2reg.find(interm_bsdf_data.common.param[i].tex);
-				if (found != tex2reg.end())
-					bsdf_data.common.param[i].setPrefetchReg(found->second);
-				else
-					bsdf_data.common.param[i].setConst(interm_bsdf_data.common.param[i].getConst());
-			}
-			bsdf_data.common.extras[0] = interm_bsdf_data.common.extras[0];
-			bsdf_data.common.extras[1] = interm_bsdf_data.common.extras[1];
+		_out.bsdfData.push_back(bsdf_data);
+	}
+
+	_out.usedRegisterCount = instr_stream::MAX_REGISTER_COUNT-remainingRegisters;
+}
+
+auto CMaterialCompilerGLSLBackendCommon::mergeRoot(result_t& res, SContext* _ctx, SRootCompilation& _compiled, core::unordered_map<size_t,core::vector<result_t::instr_streams_t>>& _streamCache) const -> result_t::instr_streams_t
+{
+	// allocate the VT in exactly the order the textures would have been requested by a serial compilation
+	core::vector<instr_stream::VTID> vtids(_compiled.ctx.deferredVTallocs.size());
+	for (size_t i=0u; i<vtids.size(); i++)
+		vtids[i] = _ctx->packTexture(_compiled.ctx.deferredVTallocs[i]);
+	auto resolveVTID = [&vtids](instr_stream::VTID& vtid) -> void
+	{
+		if (const uint32_t ix=SContext::getDeferredVTIDIndex(vtid); ix<vtids.size())
+			vtid = vtids[ix];
+	};
+	for (auto& prefetch : _compiled.tex_prefetch_stream)
+		resolveVTID(prefetch.s.tex_data.vtid);
+
+	auto hasBSDFData = [](const instr_t instr) -> bool
+	{
+		const instr_stream::E_OPCODE op = instr_stream::getOpcode(instr);
+		return op!=instr_stream::OP_NOOP && op!=instr_stream::OP_INVALID;
+	};
+	// only the instructions know which parameters are textures, the rest of the union holds constants
+	auto& localBSDFData = _compiled.ctx.bsdfData;
+	for (const traversal_t* stream : {&_compiled.rem_pdf_stream,&_compiled.gen_choice_stream})
+	for (const instr_t instr : *stream)
+	{
+		const instr_stream::E_OPCODE op = instr_stream::getOpcode(instr);
+		if (!hasBSDFData(instr) || op==instr_stream::OP_SET_GEOM_NORMAL)
+			continue;
+		auto& data = localBSDFData[instr_stream::getBSDFDataIx(instr)];
+		for (uint32_t i=0u; i<instr_stream::getParamCount(op); ++i)
+		if (op==instr_stream::OP_BUMPMAP || core::bitfieldExtract(instr,instr_stream::BITFIELDS_SHIFT_PARAM_TEX[i],1))
+			resolveVTID(data.common.param[i].tex.vtid);
+	}
 
-			res.bsdfData.push_back(bsdf_data);
+	// BSDF data gets deduplicated by node, but texture prefetch registers are allocated per root,
+	// so a node only reuses an existing entry if its final data (with the register assignment) is identical
+	core::vector<const IR::INode*> localNodes(localBSDFData.size());
+	for (const auto& entry : _compiled.ctx.bsdfDataIndexMap)
+		localNodes[entry.second] = entry.first;
+	core::vector<uint32_t> local2global(localBSDFData.size());
+	for (size_t i=0u; i<localNodes.size(); i++)
+	{
+		const auto found = _ctx->bsdfDataIndexMap.find(localNodes[i]);
+		if (found!=_ctx->bsdfDataIndexMap.end() && memcmp(&res.bsdfData[found->second],&_compiled.bsdfData[i],sizeof(instr_stream::SBSDFUnion))==0)
+		{
+			local2global[i] = found->second;
+			continue;
 		}
 
-		result_t::instr_streams_t streams;
+		assert(res.bsdfData.size()==_ctx->bsdfData.size());
+		local2global[i] = _ctx->bsdfData.size();
+		// the first layout seen for a node stays the one it maps to
+		if (found==_ctx->bsdfDataIndexMap.end())
+			_ctx->bsdfDataIndexMap.insert({localNodes[i],_ctx->bsdfData.size()});
+		_ctx->bsdfData.push_back(localBSDFData[i]);
+		res.bsdfData.push_back(_compiled.bsdfData[i]);
+	}
+	for (traversal_t* stream : {&_compiled.rem_pdf_stream,&_compiled.gen_choice_stream,&_compiled.normal_precomp_stream})
+	for (instr_t& instr : *stream)
+	if (hasBSDFData(instr))
+		instr_stream::setBSDFDataIx(instr,local2global[instr_stream::getBSDFDataIx(instr)]);
+
+	// roots which are different IR trees can still compile to the exact same instructions
+	size_t streamHash = 0ull;
+	for (const traversal_t* stream : {&_compiled.rem_pdf_stream,&_compiled.gen_choice_stream,&_compiled.normal_precomp_stream})
+	{
+		core::hash_combine(streamHash,stream->size());
+		for (const instr_t instr : *stream)
+			core::hash_combine(streamHash,instr);
+	}
+	for (const auto& prefetch : _compiled.tex_prefetch_stream)
+	{
+		core::hash_combine(streamHash,prefetch.qword[0]);
+		core::hash_combine(streamHash,prefetch.qword[1]);
+	}
+	auto isSameAs = [&](const result_t::instr_streams_t& other) -> bool
+	{
+		if (other.rem_and_pdf_count!=_compiled.rem_pdf_stream.size() || other.gen_choice_count!=_compiled.gen_choice_stream.size() ||
+			other.norm_precomp_count!=_compiled.normal_precomp_stream.size() || other.tex_prefetch_count!=_compiled.tex_prefetch_stream.size())
+			return false;
+		auto instrIt = res.instructions.begin()+other.offset;
+		for (const traversal_t* stream : {&_compiled.rem_pdf_stream,&_compiled.gen_choice_stream,&_compiled.normal_precomp_stream})
 		{
-			streams.offset = res.instructions.size();
+			if (!std::equal(stream->begin(),stream->end(),instrIt))
+				return false;
+			instrIt += stream->size();
+		}
+		return std::equal(_compiled.tex_prefetch_stream.begin(),_compiled.tex_prefetch_stream.end(),res.prefetch_stream.begin()+other.prefetch_offset,
+			[](const auto& lhs, const auto& rhs) -> bool {return lhs.qword[0]==rhs.qword[0] && lhs.qword[1]==rhs.qword[1];}
+		);
+	};
+
+	result_t::instr_streams_t streams;
+	auto& candidates = _streamCache[streamHash];
+	if (auto found=std::find_if(candidates.begin(),candidates.end(),isSameAs); found!=candidates.end())
+	{
+		streams = *found;
+		res.deduplicatedStreamCount++;
+	}
+	else
+	{
+		streams.offset = res.instructions.size();
 
-			streams.rem_and_pdf_count = rem_pdf_stream.size();
-			res.instructions.insert(res.instructions.end(), rem_pdf_stream.begin(), rem_pdf_stream.end());
+		streams.rem_and_pdf_count = _compiled.rem_pdf_stream.size();
+		res.instructions.insert(res.instructions.end(), _compiled.rem_pdf_stream.begin(), _compiled.rem_pdf_stream.end());
 
-			streams.gen_choice_count = gen_choice_stream.size();
-			res.instructions.insert(res.instructions.end(), gen_choice_stream.begin(), gen_choice_stream.end());
+		streams.gen_choice_count = _compiled.gen_choice_stream.size();
+		res.instructions.insert(res.instructions.end(), _compiled.gen_choice_stream.begin(), _compiled.gen_choice_stream.end());
 
-			streams.norm_precomp_count = normal_precomp_stream.size();
-			res.instructions.insert(res.instructions.end(), normal_precomp_stream.begin(), normal_precomp_stream.end());
+		streams.norm_precomp_count = _compiled.normal_precomp_stream.size();
+		res.instructions.insert(res.instructions.end(), _compiled.normal_precomp_stream.begin(), _compiled.normal_precomp_stream.end());
 
-			streams.prefetch_offset = res.prefetch_stream.size();
-			streams.tex_prefetch_count = tex_prefetch_stream.size();
-			res.prefetch_stream.insert(res.prefetch_stream.end(), tex_prefetch_stream.begin(), tex_prefetch_stream.end());
-		}
+		streams.prefetch_offset = res.prefetch_stream.size();
+		streams.tex_prefetch_count = _compiled.tex_prefetch_stream.size();
+		res.prefetch_stream.insert(res.prefetch_stream.end(), _compiled.tex_prefetch_stream.begin(), _compiled.tex_prefetch_stream.end());
+
+		candidates.push_back(streams);
+	}
+
+	res.noNormPrecompStream = res.noNormPrecompStream && (streams.norm_precomp_count==0u);
+	res.noPrefetchStream = res.noPrefetchStream && (streams.tex_prefetch_count==0u);
+	res.usedRegisterCount = std::max(res.usedRegisterCount, _compiled.usedRegisterCount);
+	res.globalPrefetchRegCountFlags |= _compiled.prefetchRegCountFlags;
+
+	return streams;
+}
 
-		res.streams.insert({root,streams});
+auto CMaterialCompilerGLSLBackendCommon::compile(SContext* _ctx, IR* _ir, E_GENERATOR_STREAM_TYPE _generatorChoiceStream) -> result_t
+{
+	using clock_t = std::chrono::steady_clock;
 
-		res.noNormPrecompStream = res.noNormPrecompStream && (streams.norm_precomp_count==0u);
-		res.noPrefetchStream = res.noPrefetchStream && (streams.tex_prefetch_count==0u);
-		res.usedRegisterCount = std::max(res.usedRegisterCount, instr_stream::MAX_REGISTER_COUNT-remainingRegisters);
+	result_t res;
+	res.noNormPrecompStream = true;
+	res.noPrefetchStream = true;
+	res.usedRegisterCount = 0u;
+	res.globalPrefetchRegCountFlags = 0u;
+	res.deduplicatedStreamCount = 0u;
+
+	// every root only depends on its own subtree, so they get traversed in parallel and merged in order afterwards
+	const uint32_t rootCount = _ir->roots.size();
+	core::vector<SRootCompilation> compiled(rootCount);
+	// tmp nodes get allocated from per-thread IRs which are kept alive until the merge is done,
+	// this way the node addresses used for BSDF data deduplication never get reused
+	core::vector<core::smart_refctd_ptr<IR>> scratchIRs;
+	auto start = clock_t::now();
+	{
+		// every job gets its own scratch IR, so at most this many roots get compiled at once
+		uint32_t jobCount = _ctx->maxCompileThreads ? _ctx->maxCompileThreads:std::thread::hardware_concurrency();
+		jobCount = std::max(std::min(jobCount,rootCount),1u);
+		for (uint32_t i=0u; i<jobCount; i++)
+			scratchIRs.push_back(core::make_smart_refctd_ptr<IR>());
+
+		core::vector<uint32_t> jobs(jobCount);
+		std::iota(jobs.begin(),jobs.end(),0u);
+		// roots get interleaved between the jobs, so big subtrees which tend to come together get spread out
+		core::for_each(core::execution::par,jobs.begin(),jobs.end(),[&](const uint32_t job) -> void
+			{
+				for (uint32_t i=job; i<rootCount; i+=jobCount)
+					compileRoot(compiled[i],_ir->roots[i],scratchIRs[job].get(),_generatorChoiceStream);
+			}
+		);
 	}
+	auto end = clock_t::now();
+	res.timings.traversal = end-start;
 
+	start = end;
+	{
+		core::unordered_map<size_t,core::vector<result_t::instr_streams_t>> streamCache;
+		for (uint32_t i=0u; i<rootCount; i++)
+			res.streams.insert({_ir->roots[i],mergeRoot(res,_ctx,compiled[i],streamCache)});
+	}
+	compiled.clear();
+	scratchIRs.clear();
 	_ir->deinitTmpNodes();
+	end = clock_t::now();
+	res.timings.merge = end-start;
+
+	start = end;
 
 	auto isAniso = [&res](instr_t _i) -> bool {
 		const instr_stream::E_OPCODE op = instr_stream::getOpcode(_i);
@@ -1433,6 +1630,7 @@ auto CMaterialCompilerGLSLBackendCommon::compile(SContext* _ctx, IR* _ir, E_GENE
 R"(
 #include <nbl/builtin/glsl/material_compiler/common_declarations.glsl>
 )";
+	res.timings.analysis = clock_t::now()-start;
 
 	return res;
 }
@@ -22,6 +22,7 @@
 
 
 #include <cmath>
+#include <algorithm>
 
 
 #include "nbl/macros.h"
@@ -29,381 +30,263 @@
 #include "nbl/asset/utils/CForsythVertexCacheOptimizer.h"
 
 
-#define maxSIZE_VERTEX_CACHE 16
-
-namespace nbl
-{
-namespace asset
+namespace nbl::asset
 {
+	namespace
+	{
+		constexpr uint32_t CacheSize = CForsythVertexCacheOptimizer::CacheSize;
+		// cache position of vertices which aren't in the cache
+		constexpr uint32_t NotInCache = CacheSize;
+		// max length of the LRU list while a triangle is being added, before it gets trimmed back to `CacheSize`
+		constexpr uint32_t MaxCacheLength = CacheSize+3u;
+		// valences above this are rare enough to compute the boost on the fly
+		constexpr uint32_t MaxTabulatedValence = 64u;
+
+		// http://home.comcast.net/~tom_forsyth/papers/fast_vert_cache_opt.html
+		// The score only depends on the cache position and on the number of triangles left to emit, so both terms get tabulated once.
+		class CScoreTable
+		{
+				static inline constexpr float CacheDecayPower = 1.5f;
+				static inline constexpr float LastTriScore = 0.75f;
+				static inline constexpr float ValenceBoostScale = 2.0f;
+				static inline constexpr float ValenceBoostPower = 0.5f;
+
+				static inline float valenceBoost(const uint32_t numUnaddedReferences)
+				{
+					return ValenceBoostScale*std::pow(float(numUnaddedReferences),-ValenceBoostPower);
+				}
+
+				float m_cache[CacheSize+1u];
+				float m_valence[MaxTabulatedValence+1u];
+
+			public:
+				CScoreTable()
+				{
+					for (uint32_t i=0u; i<CacheSize; i++)
+					{
+						// This vertex was used in the last triangle,
+						// so it has a fixed score, whichever of the three
+						// it's in. Otherwise, you can get very different
+						// answers depending on whether you add
+						// the triangle 1,2,3 or 3,1,2 - which is silly.
+						if (i<3u)
+							m_cache[i] = LastTriScore;
+						else // Points for being high in the cache.
+							m_cache[i] = std::pow(1.f-float(i-3u)/float(CacheSize-3u),CacheDecayPower);
+					}
+					// Vertex is not in FIFO cache - no score.
+					m_cache[NotInCache] = 0.f;
+
+					// Nobody needs this vertex anymore, it's not part of any triangle's score
+					m_valence[0] = 0.f;
+					// Bonus points for having a low number of tris still to
+					// use the vert, so we get rid of lone verts quickly.
+					for (uint32_t i=1u; i<=MaxTabulatedValence; i++)
+						m_valence[i] = valenceBoost(i);
+				}
+
+				inline float operator()(const uint32_t cachePosition, const uint32_t numUnaddedReferences) const
+				{
+					const float boost = numUnaddedReferences<=MaxTabulatedValence ? m_valence[numUnaddedReferences]:valenceBoost(numUnaddedReferences);
+					return m_cache[cachePosition]+boost;
+				}
+		};
+		const CScoreTable score;
+	}
+
 	template<typename IdxT>
 	void CForsythVertexCacheOptimizer::optimizeTriangleOrdering(const size_t _numVerts, const size_t _numIndices, const IdxT* _indices, IdxT* _outIndices) const
 	{
 		if (_numVerts == 0 || _numIndices == 0)
 		{
-			memcpy(_outIndices, _indices, _numIndices*sizeof(IdxT));
+			if (_outIndices != _indices)
+				memcpy(_outIndices, _indices, _numIndices*sizeof(IdxT));
 			return;
 		}
 
 		const uint32_t NumPrimitives = _numIndices / 3;
-		_NBL_DEBUG_BREAK_IF(NumPrimitives != uint32_t(std::floor(_numIndices / 3.0f))); // Number of indicies not divisible by 3, not a good triangle list.
+		_NBL_DEBUG_BREAK_IF(NumPrimitives*3ull != _numIndices); // Number of indicies not divisible by 3, not a good triangle list.
 
 		//
-		// Step 1: Run through the data, and initialize
+		// Step 1: Build the vertex to triangle adjacency in flat arrays, nothing gets allocated past this point
 		//
-		core::vector<VertData> vertexData(_numVerts);
-		core::vector<TriData> triangleData(NumPrimitives);
-
-		uint32_t curIdx = 0;
-		for (int32_t tri = 0; tri < NumPrimitives; tri++)
+		// copy of the input, so it can alias the output
+		core::vector<uint32_t> triangleVertices(NumPrimitives*3u);
+		// the triangles of vertex `v` are `adjacency[adjacencyOffsets[v],adjacencyOffsets[v+1])`,
+		// the first `numUnaddedReferences[v]` of which haven't been emitted yet
+		core::vector<uint32_t> adjacencyOffsets(_numVerts+1u,0u);
+		core::vector<uint32_t> adjacency(NumPrimitives*3u);
+		core::vector<uint32_t> numUnaddedReferences(_numVerts,0u);
+		core::vector<uint32_t> cachePositions(_numVerts,NotInCache);
+		core::vector<float> vertexScores(_numVerts);
+		core::vector<float> triangleScores(NumPrimitives,0.f);
+		core::vector<uint8_t> isInList(NumPrimitives,0u);
+		// vertices of the emitted triangles, most recent last, to restart from when the cache runs out of triangles
+		core::vector<uint32_t> deadEndStack(NumPrimitives*3u);
+
+		for (uint32_t i = 0; i < NumPrimitives*3u; i++)
 		{
-			TriData &curTri = triangleData[tri];
-
-			for (int32_t c = 0; c < 3; c++)
-			{
-				const IdxT &curVIdx = _indices[curIdx];
-				_NBL_DEBUG_BREAK_IF(curVIdx >= _numVerts); // Out of range index.
-
-				// Add this vert to the list of verts that define the triangle
-				curTri.vertIdx[c] = curVIdx;
-
-				VertData &curVert = vertexData[curVIdx];
-
-				// Increment the number of triangles that reference this vertex
-				curVert.numUnaddedReferences++;
-
-				curIdx++;
-			}
+			const uint32_t curVIdx = _indices[i];
+			_NBL_DEBUG_BREAK_IF(curVIdx >= _numVerts); // Out of range index.
+			triangleVertices[i] = curVIdx;
+			adjacencyOffsets[curVIdx+1u]++;
 		}
-
-		// Allocate per-vertex triangle lists, and calculate the starting score of
-		// each of the verts
-		for (int32_t v = 0; v < _numVerts; v++)
+		for (size_t v = 0; v < _numVerts; v++)
+			adjacencyOffsets[v+1u] += adjacencyOffsets[v];
+		for (uint32_t i = 0; i < NumPrimitives*3u; i++)
 		{
-			VertData &curVert = vertexData[v];
-			curVert.triIndex = new int32_t[curVert.numUnaddedReferences];
-			curVert.score = score(curVert);
+			const uint32_t curVIdx = triangleVertices[i];
+			adjacency[adjacencyOffsets[curVIdx]+(numUnaddedReferences[curVIdx]++)] = i/3u;
 		}
 
-		// These variables will be used later, but need to be declared now
-		int32_t nextNextBestTriIdx = -1, nextBestTriIdx = -1;
-		float nextNextBestTriScore = -1.0f, nextBestTriScore = -1.0f;
-
-#define _VALIDATE_TRI_IDX(idx) if(idx > -1) { _NBL_DEBUG_BREAK_IF(idx >= NumPrimitives); /*Out of range triangle index.*/ _NBL_DEBUG_BREAK_IF(triangleData[idx].isInList); /*Triangle already in list, bad.*/ }
-#define _CHECK_NEXT_NEXT_BEST(scr, idx) { if(scr > nextNextBestTriScore) { nextNextBestTriIdx = idx; nextNextBestTriScore = scr; } }
-#define _CHECK_NEXT_BEST(scr, idx) { if(scr > nextBestTriScore) { _CHECK_NEXT_NEXT_BEST(nextBestTriScore, nextBestTriIdx); nextBestTriIdx = idx; nextBestTriScore = scr; } _VALIDATE_TRI_IDX(nextBestTriIdx); }
-
-		// Fill-in per-vertex triangle lists, and sum the scores of each vertex used
-		// per-triangle, to get the starting triangle score
-		curIdx = 0;
-		for (int32_t tri = 0; tri < NumPrimitives; tri++)
+		// starting scores, the first triangle is the highest scored one
+		for (size_t v = 0; v < _numVerts; v++)
+			vertexScores[v] = score(NotInCache,numUnaddedReferences[v]);
+		uint32_t nextBestTriIdx = 0u;
+		for (uint32_t tri = 0; tri < NumPrimitives; tri++)
 		{
-			TriData &curTri = triangleData[tri];
-
-			for (int32_t c = 0; c < 3; c++)
-			{
-				const IdxT &curVIdx = _indices[curIdx];
-				_NBL_DEBUG_BREAK_IF(curVIdx >= _numVerts); // Out of range index.
-				VertData &curVert = vertexData[curVIdx];
-
-				// Add triangle to triangle list
-				curVert.triIndex[curVert.numReferences++] = tri;
-
-				// Add vertex score to triangle score
-				curTri.score += curVert.score;
-
-				curIdx++;
-			}
-
-			// This will pick the first triangle to add to the list in 'Step 2'
-			_CHECK_NEXT_BEST(curTri.score, tri);
-			_CHECK_NEXT_NEXT_BEST(curTri.score, tri);
+			const uint32_t* const vertIdx = triangleVertices.data()+tri*3u;
+			triangleScores[tri] = vertexScores[vertIdx[0]]+vertexScores[vertIdx[1]]+vertexScores[vertIdx[2]];
+			if (triangleScores[tri] > triangleScores[nextBestTriIdx])
+				nextBestTriIdx = tri;
 		}
 
 		//
 		// Step 2: Start emitting triangles...this is the emit loop
 		//
-		LRUCacheModel lruCache;
-		for (int32_t outIdx = 0; outIdx < _numIndices; /* this space intentionally left blank */)
+		// LRU cache, most recently used first
+		uint32_t cache[MaxCacheLength];
+		uint32_t cacheLength = 0u;
+		uint32_t deadEndStackSize = 0u;
+		// all triangles before this one have been emitted
+		uint32_t scanCursor = 0u;
+		for (uint32_t outTri = 0; outTri < NumPrimitives; outTri++)
 		{
-			// If there is no next best triangle, than search for the next highest
-			// scored triangle that isn't in the list already
-			if (nextBestTriIdx < 0)
+			_NBL_DEBUG_BREAK_IF(nextBestTriIdx >= NumPrimitives || isInList[nextBestTriIdx]); // Next best triangle already in list, this is no good.
+			isInList[nextBestTriIdx] = 1u;
+
+			// Emit the triangle and put its vertices at the front of the cache
+			uint32_t newCache[MaxCacheLength];
+			uint32_t newCacheLength = 0u;
+			const uint32_t* const vertIdx = triangleVertices.data()+nextBestTriIdx*3u;
+			for (uint32_t i = 0; i < 3u; i++)
 			{
-				// TODO: Something better than linear performance here...
-				nextBestTriScore = nextNextBestTriScore = -1.0f;
-				nextBestTriIdx = nextNextBestTriIdx = -1;
-
-				for (int32_t tri = 0; tri < NumPrimitives; tri++)
+				const uint32_t curVIdx = vertIdx[i];
+				_outIndices[outTri*3u+i] = IdxT(curVIdx);
+
+				// Swap the triangle out of the vert's unadded part of the triangle list
+				uint32_t* const triIndex = adjacency.data()+adjacencyOffsets[curVIdx];
+				const uint32_t last = --numUnaddedReferences[curVIdx];
+				for (uint32_t t = 0u; t <= last; t++)
+				if (triIndex[t] == nextBestTriIdx)
 				{
-					TriData &curTri = triangleData[tri];
-
-					if (!curTri.isInList)
-					{
-						_CHECK_NEXT_BEST(curTri.score, tri);
-						_CHECK_NEXT_NEXT_BEST(curTri.score, tri);
-					}
+					std::swap(triIndex[t],triIndex[last]);
+					break;
 				}
+
+				deadEndStack[deadEndStackSize++] = curVIdx;
+				// degenerate triangles only put a vertex in the cache once
+				if (std::find(newCache,newCache+newCacheLength,curVIdx) == newCache+newCacheLength)
+					newCache[newCacheLength++] = curVIdx;
 			}
-			_NBL_DEBUG_BREAK_IF(nextBestTriIdx <= -1); // Ran out of 'nextBestTriangle' before I ran out of indices...not good.
+			for (uint32_t i = 0u; i < cacheLength; i++)
+			if (cache[i] != vertIdx[0] && cache[i] != vertIdx[1] && cache[i] != vertIdx[2])
+				newCache[newCacheLength++] = cache[i];
 
-			// Emit the next best triangle
-			TriData &nextBestTri = triangleData[nextBestTriIdx];
-			_NBL_DEBUG_BREAK_IF(nextBestTri.isInList); // Next best triangle already in list, this is no good.
-			for (int32_t i = 0; i < 3; i++)
+			// Update the cache positions and scores of all the verts which were or are in the cache,
+			// propagating the change in score to their triangles which still need emitting
+			for (uint32_t i = 0u; i < newCacheLength; i++)
 			{
-				// Emit index
-				_outIndices[outIdx++] = IdxT(nextBestTri.vertIdx[i]);
-
-				// Update the list of triangles on the vert
-				VertData &curVert = vertexData[nextBestTri.vertIdx[i]];
-				curVert.numUnaddedReferences--;
-				for (uint32_t t = 0; t < curVert.numReferences; t++)
-				{
-					if (curVert.triIndex[t] == nextBestTriIdx)
-					{
-						curVert.triIndex[t] = -1;
-						break;
-					}
-				}
-
-				// Update cache
-				lruCache.useVertex(nextBestTri.vertIdx[i], &curVert);
+				const uint32_t curVIdx = newCache[i];
+				const uint32_t cachePosition = i < CacheSize ? i : NotInCache;
+				cachePositions[curVIdx] = cachePosition;
+
+				const float newScore = score(cachePosition,numUnaddedReferences[curVIdx]);
+				const float scoreDelta = newScore-vertexScores[curVIdx];
+				vertexScores[curVIdx] = newScore;
+				if (scoreDelta == 0.f)
+					continue;
+				const uint32_t* const triIndex = adjacency.data()+adjacencyOffsets[curVIdx];
+				for (uint32_t t = 0u; t < numUnaddedReferences[curVIdx]; t++)
+					triangleScores[triIndex[t]] += scoreDelta;
 			}
-			nextBestTri.isInList = true;
-
-			// Enforce cache size, this will update the cache position of all verts
-			// still in the cache. It will also update the score of the verts in the
-			// cache, and give back a list of triangle indicies that need updating.
-			core::vector<uint32_t> trisToUpdate;
-			lruCache.enforceSize(maxSIZE_VERTEX_CACHE, trisToUpdate);
-
-			// Now update scores for triangles that need updates, and find the new best
-			// triangle score/index
-			nextBestTriIdx = -1;
-			nextBestTriScore = -1.0f;
-			for (core::vector<uint32_t>::iterator itr = trisToUpdate.begin(); itr != trisToUpdate.end(); ++itr)
-			{
-				TriData &tri = triangleData[*itr];
+			cacheLength = std::min(newCacheLength,CacheSize);
+			std::copy_n(newCache,cacheLength,cache);
 
-				// If this triangle isn't already emitted, re-score it
-				if (!tri.isInList)
+			// The next best triangle is one of the unadded triangles of the verts in the cache
+			nextBestTriIdx = ~0u;
+			float nextBestTriScore = -1.0f;
+			for (uint32_t i = 0u; i < cacheLength; i++)
+			{
+				const uint32_t curVIdx = cache[i];
+				const uint32_t* const triIndex = adjacency.data()+adjacencyOffsets[curVIdx];
+				for (uint32_t t = 0u; t < numUnaddedReferences[curVIdx]; t++)
+				if (triangleScores[triIndex[t]] > nextBestTriScore)
 				{
-					tri.score = 0.0f;
-
-					for (int32_t i = 0; i < 3; i++)
-						tri.score += vertexData[tri.vertIdx[i]].score;
-
-					_CHECK_NEXT_BEST(tri.score, *itr);
-					_CHECK_NEXT_NEXT_BEST(tri.score, *itr);
+					nextBestTriIdx = triIndex[t];
+					nextBestTriScore = triangleScores[nextBestTriIdx];
 				}
 			}
 
-			// If there was no love finding a good triangle, than see if there is a
-			// next-next-best triangle, and if there isn't one of those...well than
-			// I guess we have to find one next time
-			if (nextBestTriIdx < 0 && nextNextBestTriIdx > -1)
+			// If there was no love finding a good triangle, continue from the most recently emitted vertex
+			// which still has triangles left, and failing that from the first triangle not in the list yet
+			if (nextBestTriIdx == ~0u)
 			{
-				if (!triangleData[nextNextBestTriIdx].isInList)
+				while (deadEndStackSize)
 				{
-					nextBestTriIdx = nextNextBestTriIdx;
-					nextBestTriScore = nextNextBestTriScore;
-					_VALIDATE_TRI_IDX(nextNextBestTriIdx);
+					const uint32_t curVIdx = deadEndStack[--deadEndStackSize];
+					if (numUnaddedReferences[curVIdx])
+					{
+						nextBestTriIdx = adjacency[adjacencyOffsets[curVIdx]];
+						break;
+					}
 				}
-
-				// Nuke the next-next best
-				nextNextBestTriIdx = -1;
-				nextNextBestTriScore = -1.0f;
-			}
-
-			// Validate triangle we are marking as next-best
-			_VALIDATE_TRI_IDX(nextBestTriIdx);
-		}
-
-#undef _CHECK_NEXT_BEST
-#undef _CHECK_NEXT_NEXT_BEST
-#undef _VALIDATE_TRI_IDX
-
-		// FrameTemp will call destructInPlace to clean up vertex lists
-	}
-
-	// explicit instantiations
-	template void CForsythVertexCacheOptimizer::optimizeTriangleOrdering<uint16_t>(const size_t, const size_t, const uint16_t*, uint16_t*) const;
-	template void CForsythVertexCacheOptimizer::optimizeTriangleOrdering<uint32_t>(const size_t, const size_t, const uint32_t*, uint32_t*) const;
-
-	//------------------------------------------------------------------------------
-	//------------------------------------------------------------------------------
-
-	CForsythVertexCacheOptimizer::LRUCacheModel::~LRUCacheModel()
-	{
-		for (LRUCacheEntry* entry = mCacheHead; entry != NULL; )
-		{
-			LRUCacheEntry* next = entry->next;
-			delete entry;
-			entry = next;
-		}
-	}
-
-	//------------------------------------------------------------------------------
-
-	void CForsythVertexCacheOptimizer::LRUCacheModel::useVertex(const uint32_t vIdx, VertData *vData)
-	{
-		LRUCacheEntry *search = mCacheHead;
-		LRUCacheEntry *last = NULL;
-
-		while (search != NULL)
-		{
-			if (search->vIdx == vIdx)
-				break;
-
-			last = search;
-			search = search->next;
-		}
-
-		// If this vertex wasn't found in the cache, create a new entry
-		if (search == NULL)
-		{
-			search = new LRUCacheEntry;
-			search->vIdx = vIdx;
-			search->vData = vData;
-		}
-
-		if (search != mCacheHead)
-		{
-			// Unlink the entry from the linked list
-			if (last)
-				last->next = search->next;
-
-			// Vertex that got passed in is now at the head of the cache
-			search->next = mCacheHead;
-			mCacheHead = search;
-		}
-	}
-
-	//------------------------------------------------------------------------------
-
-	void CForsythVertexCacheOptimizer::LRUCacheModel::enforceSize(const size_t maxSize, core::vector<uint32_t> &outTrisToUpdate)
-	{
-		// Clear list of triangles to update scores for
-		outTrisToUpdate.clear();
-
-		size_t length = 0;
-		LRUCacheEntry *next = mCacheHead;
-		LRUCacheEntry *last = NULL;
-
-		// Run through list, up to the max size
-		while (next != NULL && length < maxSIZE_VERTEX_CACHE)
-		{
-			VertData &vData = *next->vData;
-
-			// Update cache position on verts still in cache
-			vData.cachePosition = length++;
-
-			for (int32_t i = 0; i < vData.numReferences; i++)
-			{
-				const int32_t &triIdx = vData.triIndex[i];
-				if (triIdx > -1)
+				if (nextBestTriIdx == ~0u)
 				{
-					int32_t j = 0;
-					for (; j < outTrisToUpdate.size(); j++)
-						if (outTrisToUpdate[j] == triIdx)
-							break;
-					if (j == outTrisToUpdate.size())
-						outTrisToUpdate.push_back(triIdx);
+					while (scanCursor < NumPrimitives && isInList[scanCursor])
+						scanCursor++;
+					nextBestTriIdx = scanCursor;
 				}
 			}
-
-			// Update score
-			vData.score = CForsythVertexCacheOptimizer::score(vData);
-
-			last = next;
-			next = next->next;
-		}
-
-		// NULL out the pointer to the next entry on the last valid entry
-		last->next = NULL;
-
-		// If next != NULL, than we need to prune entries from the tail of the cache
-		while (next != NULL)
-		{
-			// Update cache position on verts which are going to get tossed from cache
-			next->vData->cachePosition = -1;
-
-			LRUCacheEntry *curEntry = next;
-			next = next->next;
-
-			delete curEntry;
 		}
 	}
 
-	//------------------------------------------------------------------------------
-
-	int32_t CForsythVertexCacheOptimizer::LRUCacheModel::getCachePosition(const uint32_t vIdx)
+	template<typename IdxT>
+	CForsythVertexCacheOptimizer::SCacheStatistics CForsythVertexCacheOptimizer::analyzeVertexCache(const size_t _numVerts, const size_t _numIndices, const IdxT* _indices, const uint32_t _cacheSize)
 	{
-		size_t length = 0;
-		LRUCacheEntry *next = mCacheHead;
-		while (next != NULL)
+		SCacheStatistics retval;
+		const size_t NumPrimitives = _numIndices / 3;
+		if (_numVerts == 0 || NumPrimitives == 0)
+			return retval;
+
+		// a vertex is still in the cache if fewer than `_cacheSize` misses happened since it got loaded
+		core::vector<size_t> cacheTimestamps(_numVerts,0ull);
+		size_t timestamp = _cacheSize + 1ull;
+
+		size_t misses = 0ull;
+		size_t uniqueVertices = 0ull;
+		for (size_t i = 0; i < NumPrimitives*3ull; i++)
 		{
-			if (next->vIdx == vIdx)
-				return length;
-
-			length++;
-			next = next->next;
+			const IdxT curVIdx = _indices[i];
+			_NBL_DEBUG_BREAK_IF(curVIdx >= _numVerts); // Out of range index.
+			if (curVIdx >= _numVerts || timestamp-cacheTimestamps[curVIdx] <= _cacheSize)
+				continue;
+
+			if (cacheTimestamps[curVIdx] == 0ull)
+				uniqueVertices++;
+			cacheTimestamps[curVIdx] = timestamp++;
+			misses++;
 		}
 
-		return -1;
+		retval.acmr = float(double(misses)/double(NumPrimitives));
+		retval.atvr = uniqueVertices ? float(double(misses)/double(uniqueVertices)) : 0.f;
+		return retval;
 	}
 
-	//------------------------------------------------------------------------------
-	//------------------------------------------------------------------------------
-
-	// http://home.comcast.net/~tom_forsyth/papers/fast_vert_cache_opt.html
-	float CForsythVertexCacheOptimizer::score(const VertData &vertexData)
-	{
-		const float CacheDecayPower = 1.5f;
-		const float LastTriScore = 0.75f;
-		const float ValenceBoostScale = 2.0f;
-		const float ValenceBoostPower = 0.5f;
-
-		// If nobody needs this vertex, return -1.0
-		if (vertexData.numUnaddedReferences < 1)
-			return -1.0f;
-
-		float Score = 0.0f;
-
-		if (vertexData.cachePosition < 0)
-		{
-			// Vertex is not in FIFO cache - no score.
-		}
-		else
-		{
-			if (vertexData.cachePosition < 3)
-			{
-				// This vertex was used in the last triangle,
-				// so it has a fixed score, whichever of the three
-				// it's in. Otherwise, you can get very different
-				// answers depending on whether you add
-				// the triangle 1,2,3 or 3,1,2 - which is silly.
-				Score = LastTriScore;
-			}
-			else
-			{
-				_NBL_DEBUG_BREAK_IF(vertexData.cachePosition >= maxSIZE_VERTEX_CACHE); // Out of range cache position for vertex
-
-				// Points for being high in the cache.
-				const float Scaler = 1.0f / (maxSIZE_VERTEX_CACHE - 3);
-				Score = 1.0f - (vertexData.cachePosition - 3) * Scaler;
-				Score = pow(Score, CacheDecayPower);
-			}
-		}
-
-
-		// Bonus points for having a low number of tris still to
-		// use the vert, so we get rid of lone verts quickly.
-		float ValenceBoost = pow(vertexData.numUnaddedReferences, -ValenceBoostPower);
-		Score += ValenceBoostScale * ValenceBoost;
-
-		return Score;
-	}
-#undef maxSIZE_VERTEX_CACHE
+	// explicit instantiations
+	template void CForsythVertexCacheOptimizer::optimizeTriangleOrdering<uint16_t>(const size_t, const size_t, const uint16_t*, uint16_t*) const;
+	template void CForsythVertexCacheOptimizer::optimizeTriangleOrdering<uint32_t>(const size_t, const size_t, const uint32_t*, uint32_t*) const;
+	template CForsythVertexCacheOptimizer::SCacheStatistics CForsythVertexCacheOptimizer::analyzeVertexCache<uint16_t>(const size_t, const size_t, const uint16_t*, const uint32_t);
+	template CForsythVertexCacheOptimizer::SCacheStatistics CForsythVertexCacheOptimizer::analyzeVertexCache<uint32_t>(const size_t, const size_t, const uint32_t*, const uint32_t);
 
-}} // nbl::scene
+} // nbl::asset
@@ -0,0 +1,875 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/declarations.h"
+#include "nbl/core/execution.h"
+#include "nbl/core/math/batchSIMD.h"
+
+#include "nbl/asset/utils/CMeshBVH.h"
+#include "nbl/asset/utils/IMeshManipulator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace nbl::asset
+{
+
+namespace
+{
+// ranges with more primitives than this get their binning split across threads
+constexpr uint32_t ParallelBinningThreshold = 0x1u<<15;
+// ranges with at most this many primitives become subtrees built by a single thread, in parallel with the others
+constexpr uint32_t SubtreeTaskSize = 0x1u<<12;
+// rays and primitive boxes get processed in chunks of this many per job
+constexpr size_t ChunkSize = 1024ull;
+
+// calls `f(begin,end)` for consecutive chunks of [0,count) in parallel
+template<typename F>
+void forEachChunk(const size_t count, const size_t chunkSize, F&& f)
+{
+	core::vector<size_t> chunks((count+chunkSize-1ull)/chunkSize);
+	std::iota(chunks.begin(),chunks.end(),0ull);
+	core::for_each(core::execution::par, chunks.begin(), chunks.end(), [&](const size_t chunk) -> void
+		{
+			const size_t begin = chunk*chunkSize;
+			f(begin,std::min(begin+chunkSize,count));
+		}
+	);
+}
+
+inline float halfArea(const core::vectorSIMDf& boxMin, const core::vectorSIMDf& boxMax)
+{
+	const core::vectorSIMDf extent = core::max(boxMax-boxMin,core::vectorSIMDf(0.f));
+	return extent.x*extent.y+extent.y*extent.z+extent.z*extent.x;
+}
+
+// a contiguous range of the primitive permutation, which becomes a child of a node
+struct SBuildRange
+{
+	inline uint32_t size() const {return end-begin;}
+
+	core::vectorSIMDf boxMin;
+	core::vectorSIMDf boxMax;
+	// bounds of the primitive centroids, what the bins subdivide
+	core::vectorSIMDf centroidMin;
+	core::vectorSIMDf centroidMax;
+	uint32_t begin;
+	uint32_t end;
+};
+
+struct SBin
+{
+	inline void reset()
+	{
+		boxMin = centroidMin = core::vectorSIMDf(FLT_MAX);
+		boxMax = centroidMax = core::vectorSIMDf(-FLT_MAX);
+		count = 0u;
+	}
+	inline void add(const SBin& other)
+	{
+		boxMin = core::min(boxMin,other.boxMin);
+		boxMax = core::max(boxMax,other.boxMax);
+		centroidMin = core::min(centroidMin,other.centroidMin);
+		centroidMax = core::max(centroidMax,other.centroidMax);
+		count += other.count;
+	}
+
+	core::vectorSIMDf boxMin;
+	core::vectorSIMDf boxMax;
+	core::vectorSIMDf centroidMin;
+	core::vectorSIMDf centroidMax;
+	uint32_t count;
+};
+struct SBinning
+{
+	SBin bins[3][IBVH::SBuildParams::MaxBins];
+};
+
+// everything the recursive build reads, `order` gets partitioned in place
+struct SBuildContext
+{
+	// the primitive's bin along `axis` for a range whose centroid bounds start at `origin` and `scale` bins cover
+	inline uint32_t getBin(const uint32_t primitive, const uint32_t axis, const float origin, const float scale) const
+	{
+		const float bin = (centroids[primitive].pointer[axis]-origin)*scale;
+		// also catches NaN
+		if (!(bin>0.f))
+			return 0u;
+		return std::min(uint32_t(bin),params.binCount-1u);
+	}
+
+	void binRange(const SBuildRange& range, const float* origin, const float* scale, SBinning& binning) const
+	{
+		auto& bins = binning.bins;
+		for (uint32_t axis=0u; axis<3u; axis++)
+		for (uint32_t b=0u; b<params.binCount; b++)
+			bins[axis][b].reset();
+
+		for (uint32_t i=range.begin; i<range.end; i++)
+		{
+			const uint32_t primitive = order[i];
+			for (uint32_t axis=0u; axis<3u; axis++)
+			{
+				if (scale[axis]==0.f)
+					continue;
+				SBin& bin = bins[axis][getBin(primitive,axis,origin[axis],scale[axis])];
+				bin.boxMin = core::min(bin.boxMin,boxMin[primitive]);
+				bin.boxMax = core::max(bin.boxMax,boxMax[primitive]);
+				bin.centroidMin = core::min(bin.centroidMin,centroids[primitive]);
+				bin.centroidMax = core::max(bin.centroidMax,centroids[primitive]);
+				bin.count++;
+			}
+		}
+	}
+
+	void boundRange(SBuildRange& range) const
+	{
+		SBin bounds;
+		bounds.reset();
+		for (uint32_t i=range.begin; i<range.end; i++)
+		{
+			const uint32_t primitive = order[i];
+			bounds.boxMin = core::min(bounds.boxMin,boxMin[primitive]);
+			bounds.boxMax = core::max(bounds.boxMax,boxMax[primitive]);
+			bounds.centroidMin = core::min(bounds.centroidMin,centroids[primitive]);
+			bounds.centroidMax = core::max(bounds.centroidMax,centroids[primitive]);
+		}
+		range.boxMin = bounds.boxMin;
+		range.boxMax = bounds.boxMax;
+		range.centroidMin = bounds.centroidMin;
+		range.centroidMax = bounds.centroidMax;
+	}
+
+	// splits `range` in two with the lowest SAH cost, in half if all the centroids coincide
+	void split(const SBuildRange& range, SBuildRange& left, SBuildRange& right) const
+	{
+		float origin[3];
+		float scale[3];
+		bool binnable = false;
+		for (uint32_t axis=0u; axis<3u; axis++)
+		{
+			origin[axis] = range.centroidMin.pointer[axis];
+			const float extent = range.centroidMax.pointer[axis]-origin[axis];
+			// slightly less than `binCount` so the max centroid still lands in the last bin
+			scale[axis] = extent>0.f ? float(params.binCount)*(1.f-1e-5f)/extent:0.f;
+			binnable = binnable || scale[axis]!=0.f;
+		}
+
+		uint32_t bestAxis = 3u;
+		uint32_t bestSplit = 0u;
+		if (binnable)
+		{
+			SBinning binning;
+			auto& bins = binning.bins;
+			if (range.size()>ParallelBinningThreshold)
+			{
+				const uint32_t chunkCount = (range.size()+ParallelBinningThreshold-1u)/ParallelBinningThreshold;
+				core::vector<SBinning> partialBins(chunkCount);
+				forEachChunk(chunkCount,1ull,[&](const size_t chunk, const size_t) -> void
+					{
+						SBuildRange subrange = range;
+						subrange.begin = range.begin+uint32_t(chunk)*ParallelBinningThreshold;
+						subrange.end = std::min(subrange.begin+ParallelBinningThreshold,range.end);
+						binRange(subrange,origin,scale,partialBins[chunk]);
+					}
+				);
+				for (uint32_t axis=0u; axis<3u; axis++)
+				for (uint32_t b=0u; b<params.binCount; b++)
+				{
+					bins[axis][b] = partialBins[0].bins[axis][b];
+					for (uint32_t chunk=1u; chunk<chunkCount; chunk++)
+						bins[axis][b].add(partialBins[chunk].bins[axis][b]);
+				}
+			}
+			else
+				binRange(range,origin,scale,binning);
+
+			// sweep from the right to get the cost of everything past each split, then from the left
+			float bestCost = FLT_MAX;
+			for (uint32_t axis=0u; axis<3u; axis++)
+			{
+				if (scale[axis]==0.f)
+					continue;
+
+				float rightCost[IBVH::SBuildParams::MaxBins];
+				SBin accumulator;
+				accumulator.reset();
+				for (uint32_t b=params.binCount-1u; b>0u; b--)
+				{
+					accumulator.add(bins[axis][b]);
+					rightCost[b] = accumulator.count ? halfArea(accumulator.boxMin,accumulator.boxMax)*float(accumulator.count):FLT_MAX;
+				}
+				accumulator.reset();
+				for (uint32_t b=1u; b<params.binCount; b++)
+				{
+					accumulator.add(bins[axis][b-1u]);
+					if (!accumulator.count || rightCost[b]==FLT_MAX)
+						continue;
+					const float cost = halfArea(accumulator.boxMin,accumulator.boxMax)*float(accumulator.count)+rightCost[b];
+					if (cost<bestCost)
+					{
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = b;
+					}
+				}
+			}
+
+			if (bestAxis<3u)
+			{
+				uint32_t* const middle = std::partition(order+range.begin,order+range.end,[&](const uint32_t primitive)->bool
+					{
+						return getBin(primitive,bestAxis,origin[bestAxis],scale[bestAxis])<bestSplit;
+					}
+				);
+				left.begin = range.begin;
+				left.end = right.begin = uint32_t(middle-order);
+				right.end = range.end;
+
+				SBin leftBounds, rightBounds;
+				leftBounds.reset();
+				rightBounds.reset();
+				for (uint32_t b=0u; b<params.binCount; b++)
+					(b<bestSplit ? leftBounds:rightBounds).add(bins[bestAxis][b]);
+				left.boxMin = leftBounds.boxMin;
+				left.boxMax = leftBounds.boxMax;
+				left.centroidMin = leftBounds.centroidMin;
+				left.centroidMax = leftBounds.centroidMax;
+				right.boxMin = rightBounds.boxMin;
+				right.boxMax = rightBounds.boxMax;
+				right.centroidMin = rightBounds.centroidMin;
+				right.centroidMax = rightBounds.centroidMax;
+				return;
+			}
+		}
+
+		// nothing to tell the centroids apart by (or a non-finite one)
+		left.begin = range.begin;
+		left.end = right.begin = range.begin+range.size()/2u;
+		right.end = range.end;
+		boundRange(left);
+		boundRange(right);
+	}
+
+	const core::vectorSIMDf* boxMin;
+	const core::vectorSIMDf* boxMax;
+	const core::vectorSIMDf* centroids;
+	uint32_t* order;
+	IBVH::SBuildParams params;
+};
+
+// an inner child whose subtree gets built by a separate job
+struct SSubtreeTask
+{
+	SBuildRange range;
+	uint32_t node;
+	uint32_t slot;
+	uint32_t depth;
+};
+}
+
+template<typename Node>
+static uint32_t buildNode(const SBuildContext& ctx, const SBuildRange& range, const uint32_t depth, core::vector<Node>& nodes, core::vector<SSubtreeTask>* tasks, uint32_t& maxDepth)
+{
+	constexpr uint32_t Width = IBVH::Width;
+	maxDepth = std::max(maxDepth,depth);
+
+	const uint32_t nodeIx = nodes.size();
+	nodes.emplace_back();
+
+	// keep opening the child with the largest surface area that's too big for a leaf
+	SBuildRange children[Width];
+	children[0] = range;
+	uint32_t childCount = 1u;
+	while (childCount<Width)
+	{
+		uint32_t largest = Width;
+		float largestArea = -1.f;
+		for (uint32_t i=0u; i<childCount; i++)
+		{
+			const float area = halfArea(children[i].boxMin,children[i].boxMax);
+			if (children[i].size()>ctx.params.maxLeafSize && area>largestArea)
+			{
+				largest = i;
+				largestArea = area;
+			}
+		}
+		if (largest==Width)
+			break;
+		const SBuildRange toSplit = children[largest];
+		ctx.split(toSplit,children[largest],children[childCount++]);
+	}
+
+	for (uint32_t i=0u; i<Width; i++)
+	{
+		Node& node = nodes[nodeIx];
+		if (i>=childCount)
+		{
+			for (uint32_t axis=0u; axis<3u; axis++)
+			{
+				node.bounds[axis*2u+0u][i] = FLT_MAX;
+				node.bounds[axis*2u+1u][i] = -FLT_MAX;
+			}
+			node.child[i] = IBVH::InvalidID;
+			node.count[i] = 0u;
+			continue;
+		}
+
+		const SBuildRange& child = children[i];
+		for (uint32_t axis=0u; axis<3u; axis++)
+		{
+			node.bounds[axis*2u+0u][i] = child.boxMin.pointer[axis];
+			node.bounds[axis*2u+1u][i] = child.boxMax.pointer[axis];
+		}
+		if (child.size()<=ctx.params.maxLeafSize || depth+1u>=IBVH::MaxDepth)
+		{
+			node.child[i] = child.begin;
+			node.count[i] = child.size();
+		}
+		else if (tasks && child.size()<=SubtreeTaskSize)
+		{
+			node.child[i] = IBVH::InvalidID;
+			node.count[i] = 0u;
+			tasks->push_back({child,nodeIx,i,depth+1u});
+		}
+		else
+		{
+			const uint32_t childIx = buildNode(ctx,child,depth+1u,nodes,tasks,maxDepth);
+			nodes[nodeIx].child[i] = childIx;
+			nodes[nodeIx].count[i] = 0u;
+		}
+	}
+	return nodeIx;
+}
+
+void IBVH::buildNodes(const core::vectorSIMDf* _boxMin, const core::vectorSIMDf* _boxMax, const uint32_t _count, const SBuildParams& _params, core::vector<uint32_t>& _outOrder, SStatistics& _stats)
+{
+	m_nodes.clear();
+	_outOrder.resize(_count);
+	std::iota(_outOrder.begin(),_outOrder.end(),0u);
+	_stats.primitiveCount = _count;
+	if (!_count)
+	{
+		m_boundingBox = core::aabbox3df(core::vector3df(0.f),core::vector3df(0.f));
+		return;
+	}
+
+	core::vector<core::vectorSIMDf> centroids(_count);
+	forEachChunk(_count,ChunkSize,[&](const size_t begin, const size_t end) -> void
+		{
+			for (size_t i=begin; i<end; i++)
+				centroids[i] = (_boxMin[i]+_boxMax[i])*0.5f;
+		}
+	);
+
+	SBuildContext ctx;
+	ctx.boxMin = _boxMin;
+	ctx.boxMax = _boxMax;
+	ctx.centroids = centroids.data();
+	ctx.order = _outOrder.data();
+	ctx.params = _params;
+
+	SBuildRange root;
+	root.begin = 0u;
+	root.end = _count;
+	ctx.boundRange(root);
+	m_boundingBox = core::aabbox3df(core::vector3df(root.boxMin.x,root.boxMin.y,root.boxMin.z),core::vector3df(root.boxMax.x,root.boxMax.y,root.boxMax.z));
+
+	// top of the tree, leaving the small subtrees for later
+	core::vector<SSubtreeTask> tasks;
+	uint32_t maxDepth = 0u;
+	buildNode(ctx,root,0u,m_nodes,&tasks,maxDepth);
+
+	// the subtrees work on disjoint ranges of `order`, so they can all be built at once
+	core::vector<core::vector<SNode>> subtrees(tasks.size());
+	core::vector<uint32_t> subtreeDepths(tasks.size(),0u);
+	core::vector<size_t> jobs(tasks.size());
+	std::iota(jobs.begin(),jobs.end(),0ull);
+	core::for_each(core::execution::par, jobs.begin(), jobs.end(), [&](const size_t i) -> void
+		{
+			buildNode<SNode>(ctx,tasks[i].range,tasks[i].depth,subtrees[i],nullptr,subtreeDepths[i]);
+		}
+	);
+	// each subtree's nodes get appended in one block, so their child indices just need the block's offset
+	for (size_t i=0ull; i<tasks.size(); i++)
+	{
+		const uint32_t offset = m_nodes.size();
+		for (SNode& node : subtrees[i])
+		for (uint32_t slot=0u; slot<Width; slot++)
+		if (!node.count[slot] && node.child[slot]!=InvalidID)
+			node.child[slot] += offset;
+		m_nodes.insert(m_nodes.end(),subtrees[i].begin(),subtrees[i].end());
+		m_nodes[tasks[i].node].child[tasks[i].slot] = offset;
+		maxDepth = std::max(maxDepth,subtreeDepths[i]);
+	}
+
+	// SAH cost with box tests and primitive tests costing the same
+	const float rootArea = halfArea(root.boxMin,root.boxMax);
+	float sahCost = 1.f;
+	_stats.leafCount = 0ull;
+	for (const SNode& node : m_nodes)
+	for (uint32_t slot=0u; slot<Width; slot++)
+	{
+		if (!node.count[slot] && node.child[slot]==InvalidID)
+			continue;
+		const core::vectorSIMDf childMin(node.bounds[0][slot],node.bounds[2][slot],node.bounds[4][slot],0.f);
+		const core::vectorSIMDf childMax(node.bounds[1][slot],node.bounds[3][slot],node.bounds[5][slot],0.f);
+		const float probability = rootArea>0.f ? halfArea(childMin,childMax)/rootArea:1.f;
+		if (node.count[slot])
+		{
+			sahCost += probability*float(node.count[slot]);
+			_stats.leafCount++;
+		}
+		else
+			sahCost += probability;
+	}
+	_stats.nodeCount = m_nodes.size();
+	_stats.maxDepth = maxDepth;
+	_stats.sahCost = sahCost;
+}
+
+namespace
+{
+// the ray broadcast across the lanes
+struct SRaySIMD
+{
+	SRaySIMD(const IBVH::SRay& ray)
+	{
+		for (uint32_t axis=0u; axis<3u; axis++)
+		{
+			const float d = ray.direction.pointer[axis];
+			origin[axis] = _mm_set1_ps(ray.origin.pointer[axis]);
+			direction[axis] = _mm_set1_ps(d);
+			invDirection[axis] = _mm_set1_ps(1.f/d);
+			// the near plane of a box is its min along positive directions, the sign bit is what decides the sign of `invDirection` (-0 gives -inf)
+			const bool negative = std::signbit(d);
+			nearRow[axis] = axis*2u+(negative ? 1u:0u);
+			farRow[axis] = axis*2u+(negative ? 0u:1u);
+		}
+		tMin = _mm_set1_ps(ray.tMin);
+	}
+
+	__m128 origin[3];
+	__m128 direction[3];
+	__m128 invDirection[3];
+	__m128 tMin;
+	uint32_t nearRow[3];
+	uint32_t farRow[3];
+};
+
+struct SStackEntry
+{
+	uint32_t child;
+	uint32_t count;
+	float tNear;
+};
+}
+
+template<bool AnyHit, typename LeafFunc>
+bool IBVH::traverse(const SRay& _ray, float _tMax, LeafFunc&& _leaf) const
+{
+	if (m_nodes.empty())
+		return false;
+
+	const SRaySIMD ray(_ray);
+	// front to back order means popping the nearest child first
+	SStackEntry stack[MaxDepth*(Width-1u)+1u];
+	uint32_t stackSize = 0u;
+	stack[stackSize++] = {0u,0u,_ray.tMin};
+
+	bool hit = false;
+	while (stackSize)
+	{
+		const SStackEntry entry = stack[--stackSize];
+		// something closer got hit since this got pushed
+		if (entry.tNear>_tMax)
+			continue;
+
+		if (entry.count)
+		{
+			if (_leaf(entry.child,entry.count,_tMax))
+			{
+				hit = true;
+				if constexpr (AnyHit)
+					return true;
+			}
+			continue;
+		}
+
+		const SNode& node = m_nodes[entry.child];
+		__m128 tNear = ray.tMin;
+		__m128 tFar = _mm_set1_ps(_tMax);
+		for (uint32_t axis=0u; axis<3u; axis++)
+		{
+			const __m128 nearPlane = _mm_load_ps(node.bounds[ray.nearRow[axis]]);
+			const __m128 farPlane = _mm_load_ps(node.bounds[ray.farRow[axis]]);
+			// the `max`/`min` return the 2nd operand on NaN (0*inf for axis aligned rays on a plane), so these go 1st
+			tNear = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearPlane,ray.origin[axis]),ray.invDirection[axis]),tNear);
+			tFar = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farPlane,ray.origin[axis]),ray.invDirection[axis]),tFar);
+		}
+		uint32_t hitMask = uint32_t(_mm_movemask_ps(_mm_cmple_ps(tNear,tFar)));
+		if (!hitMask)
+			continue;
+
+		alignas(16) float distances[Width];
+		_mm_store_ps(distances,tNear);
+		// sort the children which got hit far to near, at most 4 so insertion sort
+		SStackEntry hits[Width];
+		uint32_t hitCount = 0u;
+		for (; hitMask; hitMask&=hitMask-1u)
+		{
+			const uint32_t slot = uint32_t(std::countr_zero(hitMask));
+			SStackEntry newEntry = {node.child[slot],node.count[slot],distances[slot]};
+			uint32_t j = hitCount++;
+			for (; j && hits[j-1u].tNear<newEntry.tNear; j--)
+				hits[j] = hits[j-1u];
+			hits[j] = newEntry;
+		}
+		for (uint32_t i=0u; i<hitCount; i++)
+			stack[stackSize++] = hits[i];
+	}
+	return hit;
+}
+
+void IBVH::intersect(std::span<const SRay> _rays, SHit* _outHits) const
+{
+	forEachChunk(_rays.size(),ChunkSize,[&](const size_t begin, const size_t end) -> void
+		{
+			for (size_t i=begin; i<end; i++)
+			{
+				_outHits[i] = {};
+				intersect(_rays[i],_outHits[i]);
+			}
+		}
+	);
+}
+
+void IBVH::occluded(std::span<const SRay> _rays, uint8_t* _outOccluded) const
+{
+	forEachChunk(_rays.size(),ChunkSize,[&](const size_t begin, const size_t end) -> void
+		{
+			for (size_t i=begin; i<end; i++)
+				_outOccluded[i] = occluded(_rays[i]) ? 1u:0u;
+		}
+	);
+}
+
+
+core::smart_refctd_ptr<CMeshBVH> CMeshBVH::create(const ICPUMeshBuffer* _meshbuffer, const SBuildParams& _params, SStatistics* _outStats, const system::logger_opt_ptr logger)
+{
+	if (!_meshbuffer)
+		return nullptr;
+
+	const auto* pipeline = _meshbuffer->getPipeline();
+	if (!pipeline || pipeline->getCachedCreationParams().primitiveAssembly.primitiveType!=EPT_TRIANGLE_LIST)
+	{
+		logger.log("BVH building: meshbuffer is not a triangle list.",system::ILogger::ELL_ERROR);
+		return nullptr;
+	}
+	const uint32_t posAttrId = _meshbuffer->getPositionAttributeIx();
+	if (!_meshbuffer->isAttributeEnabled(posAttrId))
+	{
+		logger.log("BVH building: meshbuffer has no position attribute.",system::ILogger::ELL_ERROR);
+		return nullptr;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const uint32_t indexCount = _meshbuffer->getIndexCount();
+	core::vector<uint32_t> indices(indexCount);
+	const void* const inIndices = _meshbuffer->getIndices();
+	switch (inIndices ? _meshbuffer->getIndexType():EIT_UNKNOWN)
+	{
+		case EIT_16BIT:
+			std::copy_n(reinterpret_cast<const uint16_t*>(inIndices),indexCount,indices.begin());
+			break;
+		case EIT_32BIT:
+			std::copy_n(reinterpret_cast<const uint32_t*>(inIndices),indexCount,indices.begin());
+			break;
+		default:
+			std::iota(indices.begin(),indices.end(),0u);
+			break;
+	}
+
+	const uint32_t vertexCount = IMeshManipulator::upperBoundVertexID(_meshbuffer);
+	core::vector<core::vectorSIMDf> positions(vertexCount);
+	for (uint32_t i=0u; i<vertexCount; ++i)
+		_meshbuffer->getAttribute(positions[i],posAttrId,i);
+
+	auto retval = create(indices,positions,_params,_outStats);
+	if (!retval)
+	{
+		logger.log("BVH building: invalid parameters or index buffer -- no BVH built.",system::ILogger::ELL_ERROR);
+		return nullptr;
+	}
+	// count the fetches and conversions too
+	if (_outStats)
+		_outStats->buildTime = std::chrono::steady_clock::now()-start;
+	return retval;
+}
+
+core::smart_refctd_ptr<CMeshBVH> CMeshBVH::create(std::span<const uint32_t> _indices, std::span<const core::vectorSIMDf> _positions, const SBuildParams& _params, SStatistics* _outStats)
+{
+	if (!_params.valid() || _indices.size()%3u || _indices.size()/3u>=InvalidID)
+		return nullptr;
+	for (const uint32_t index : _indices)
+	if (index>=_positions.size())
+		return nullptr;
+
+	const auto start = std::chrono::steady_clock::now();
+	const uint32_t triangleCount = _indices.size()/3u;
+	core::vector<core::vectorSIMDf> boxMin(triangleCount), boxMax(triangleCount);
+	forEachChunk(triangleCount,ChunkSize,[&](const size_t begin, const size_t end) -> void
+		{
+			for (size_t i=begin; i<end; i++)
+			{
+				const core::vectorSIMDf& p0 = _positions[_indices[i*3u+0u]];
+				const core::vectorSIMDf& p1 = _positions[_indices[i*3u+1u]];
+				const core::vectorSIMDf& p2 = _positions[_indices[i*3u+2u]];
+				boxMin[i] = core::min(core::min(p0,p1),p2);
+				boxMax[i] = core::max(core::max(p0,p1),p2);
+			}
+		}
+	);
+
+	auto retval = core::smart_refctd_ptr<CMeshBVH>(new CMeshBVH(),core::dont_grab);
+	retval->m_triangleCount = triangleCount;
+	SStatistics stats;
+	core::vector<uint32_t> order;
+	retval->buildNodes(boxMin.data(),boxMax.data(),triangleCount,_params,order,stats);
+
+	// repack the leaves' triangles 4 at a time, in node order so neighbouring leaves are close in memory
+	auto& packs = retval->m_packs;
+	packs.reserve((triangleCount+Width-1u)/Width+stats.leafCount);
+	for (SNode& node : retval->m_nodes)
+	for (uint32_t slot=0u; slot<Width; slot++)
+	{
+		if (!node.count[slot])
+			continue;
+		const uint32_t first = node.child[slot];
+		const uint32_t count = node.count[slot];
+		node.child[slot] = packs.size();
+		node.count[slot] = (count+Width-1u)/Width;
+		for (uint32_t i=0u; i<count; i+=Width)
+		{
+			// value initialized, so padding lanes are all zero
+			STrianglePack& pack = packs.emplace_back();
+			for (uint32_t lane=0u; lane<Width; lane++)
+			{
+				if (i+lane>=count)
+				{
+					pack.primitiveID[lane] = InvalidID;
+					continue;
+				}
+				const uint32_t triangle = order[first+i+lane];
+				const core::vectorSIMDf& p0 = _positions[_indices[triangle*3u+0u]];
+				const core::vectorSIMDf edge1 = _positions[_indices[triangle*3u+1u]]-p0;
+				const core::vectorSIMDf edge2 = _positions[_indices[triangle*3u+2u]]-p0;
+				for (uint32_t axis=0u; axis<3u; axis++)
+				{
+					pack.v0[axis][lane] = p0.pointer[axis];
+					pack.edge1[axis][lane] = edge1.pointer[axis];
+					pack.edge2[axis][lane] = edge2.pointer[axis];
+				}
+				pack.primitiveID[lane] = triangle;
+			}
+		}
+	}
+
+	stats.buildTime = std::chrono::steady_clock::now()-start;
+	if (_outStats)
+		*_outStats = stats;
+	return retval;
+}
+
+namespace
+{
+// Möller-Trumbore on 4 triangles, returns the mask of lanes hit within (tMin,tMax) and their distances and barycentrics
+template<typename Pack>
+inline uint32_t intersectPack(const Pack& pack, const SRaySIMD& ray, const float tMax, __m128& t, __m128& u, __m128& v)
+{
+	const __m128 v0[3] = {_mm_load_ps(pack.v0[0]),_mm_load_ps(pack.v0[1]),_mm_load_ps(pack.v0[2])};
+	const __m128 e1[3] = {_mm_load_ps(pack.edge1[0]),_mm_load_ps(pack.edge1[1]),_mm_load_ps(pack.edge1[2])};
+	const __m128 e2[3] = {_mm_load_ps(pack.edge2[0]),_mm_load_ps(pack.edge2[1]),_mm_load_ps(pack.edge2[2])};
+	const __m128* d = ray.direction;
+
+	auto cross = [](const __m128* a, const __m128* b, __m128* out) -> void
+	{
+		out[0] = _mm_sub_ps(_mm_mul_ps(a[1],b[2]),_mm_mul_ps(a[2],b[1]));
+		out[1] = _mm_sub_ps(_mm_mul_ps(a[2],b[0]),_mm_mul_ps(a[0],b[2]));
+		out[2] = _mm_sub_ps(_mm_mul_ps(a[0],b[1]),_mm_mul_ps(a[1],b[0]));
+	};
+	auto dot = [](const __m128* a, const __m128* b) -> __m128
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0],b[0]),_mm_mul_ps(a[1],b[1])),_mm_mul_ps(a[2],b[2]));
+	};
+
+	__m128 p[3];
+	cross(d,e2,p);
+	const __m128 det = dot(e1,p);
+	const __m128 invDet = _mm_div_ps(_mm_set1_ps(1.f),det);
+
+	const __m128 s[3] = {_mm_sub_ps(ray.origin[0],v0[0]),_mm_sub_ps(ray.origin[1],v0[1]),_mm_sub_ps(ray.origin[2],v0[2])};
+	u = _mm_mul_ps(dot(s,p),invDet);
+	__m128 q[3];
+	cross(s,e1,q);
+	v = _mm_mul_ps(dot(d,q),invDet);
+	t = _mm_mul_ps(dot(e2,q),invDet);
+
+	const __m128 zero = _mm_setzero_ps();
+	// degenerate (and padding) triangles have a zero determinant, NaNs fail all the ordered comparisons
+	__m128 mask = _mm_cmpneq_ps(det,zero);
+	mask = _mm_and_ps(mask,_mm_cmpge_ps(u,zero));
+	mask = _mm_and_ps(mask,_mm_cmpge_ps(v,zero));
+	mask = _mm_and_ps(mask,_mm_cmple_ps(_mm_add_ps(u,v),_mm_set1_ps(1.f)));
+	mask = _mm_and_ps(mask,_mm_cmpge_ps(t,ray.tMin));
+	mask = _mm_and_ps(mask,_mm_cmplt_ps(t,_mm_set1_ps(tMax)));
+	return uint32_t(_mm_movemask_ps(mask));
+}
+}
+
+bool CMeshBVH::intersect(const SRay& _ray, SHit& _hit) const
+{
+	const SRaySIMD ray(_ray);
+	return traverse<false>(_ray,_ray.tMax,[&](const uint32_t first, const uint32_t count, float& tMax) -> bool
+		{
+			bool hit = false;
+			for (uint32_t i=first; i<first+count; i++)
+			{
+				__m128 t, u, v;
+				uint32_t mask = intersectPack(m_packs[i],ray,tMax,t,u,v);
+				if (!mask)
+					continue;
+
+				alignas(16) float distances[Width], us[Width], vs[Width];
+				_mm_store_ps(distances,t);
+				_mm_store_ps(us,u);
+				_mm_store_ps(vs,v);
+				for (; mask; mask&=mask-1u)
+				{
+					const uint32_t lane = uint32_t(std::countr_zero(mask));
+					if (distances[lane]>=tMax)
+						continue;
+					tMax = distances[lane];
+					_hit.t = distances[lane];
+					_hit.u = us[lane];
+					_hit.v = vs[lane];
+					_hit.primitiveID = m_packs[i].primitiveID[lane];
+					hit = true;
+				}
+			}
+			return hit;
+		}
+	);
+}
+
+bool CMeshBVH::occluded(const SRay& _ray) const
+{
+	const SRaySIMD ray(_ray);
+	return traverse<true>(_ray,_ray.tMax,[&](const uint32_t first, const uint32_t count, float& tMax) -> bool
+		{
+			for (uint32_t i=first; i<first+count; i++)
+			{
+				__m128 t, u, v;
+				if (intersectPack(m_packs[i],ray,tMax,t,u,v))
+					return true;
+			}
+			return false;
+		}
+	);
+}
+
+
+core::smart_refctd_ptr<CInstanceBVH> CInstanceBVH::create(std::span<const SInstance> _instances, const SBuildParams& _params, SStatistics* _outStats)
+{
+	if (!_params.valid() || _instances.size()>=InvalidID)
+		return nullptr;
+
+	const auto start = std::chrono::steady_clock::now();
+	const uint32_t instanceCount = _instances.size();
+	auto retval = core::smart_refctd_ptr<CInstanceBVH>(new CInstanceBVH(),core::dont_grab);
+	retval->m_instances.assign(_instances.begin(),_instances.end());
+
+	core::vector<core::matrix3x4SIMD> inverseTransforms(instanceCount);
+	core::vector<core::vectorSIMDf> boxMin(instanceCount), boxMax(instanceCount);
+	for (uint32_t i=0u; i<instanceCount; i++)
+	{
+		const SInstance& instance = _instances[i];
+		if (!instance.bvh || !instance.transform.getInverse(inverseTransforms[i]))
+			return nullptr;
+
+		core::aabbox3df worldBox;
+		const core::aabbox3df& objectBox = instance.bvh->getBoundingBox();
+		core::batch::transformAABBs(instance.transform,{&objectBox,1ull},&worldBox);
+		boxMin[i] = core::vectorSIMDf(worldBox.MinEdge.X,worldBox.MinEdge.Y,worldBox.MinEdge.Z,0.f);
+		boxMax[i] = core::vectorSIMDf(worldBox.MaxEdge.X,worldBox.MaxEdge.Y,worldBox.MaxEdge.Z,0.f);
+	}
+
+	SStatistics stats;
+	core::vector<uint32_t> order;
+	retval->buildNodes(boxMin.data(),boxMax.data(),instanceCount,_params,order,stats);
+
+	// leaves cover ranges of `order`, store the instances in that order so a leaf reads them contiguously
+	retval->m_leafInstances.resize(instanceCount);
+	for (uint32_t i=0u; i<instanceCount; i++)
+	{
+		const uint32_t instanceID = order[i];
+		retval->m_leafInstances[i] = {_instances[instanceID].bvh.get(),inverseTransforms[instanceID],instanceID};
+	}
+
+	stats.buildTime = std::chrono::steady_clock::now()-start;
+	if (_outStats)
+		*_outStats = stats;
+	return retval;
+}
+
+bool CInstanceBVH::intersect(const SRay& _ray, SHit& _hit) const
+{
+	return traverse<false>(_ray,_ray.tMax,[&](const uint32_t first, const uint32_t count, float& tMax) -> bool
+		{
+			bool hit = false;
+			for (uint32_t i=first; i<first+count; i++)
+			{
+				const SLeafInstance& instance = m_leafInstances[i];
+				// transforming both the origin and direction keeps the distances along the ray the same
+				SRay objectRay = _ray;
+				instance.inverseTransform.pseudoMulWith4x1(objectRay.origin);
+				instance.inverseTransform.mulSub3x3WithNx1(objectRay.direction);
+				objectRay.tMax = tMax;
+
+				SHit objectHit;
+				if (instance.bvh->intersect(objectRay,objectHit))
+				{
+					tMax = objectHit.t;
+					_hit = objectHit;
+					_hit.instanceID = instance.instanceID;
+					hit = true;
+				}
+			}
+			return hit;
+		}
+	);
+}
+
+bool CInstanceBVH::occluded(const SRay& _ray) const
+{
+	return traverse<true>(_ray,_ray.tMax,[&](const uint32_t first, const uint32_t count, float& tMax) -> bool
+		{
+			for (uint32_t i=first; i<first+count; i++)
+			{
+				const SLeafInstance& instance = m_leafInstances[i];
+				SRay objectRay = _ray;
+				instance.inverseTransform.pseudoMulWith4x1(objectRay.origin);
+				instance.inverseTransform.mulSub3x3WithNx1(objectRay.direction);
+				objectRay.tMax = tMax;
+				if (instance.bvh->occluded(objectRay))
+					return true;
+			}
+			return false;
+		}
+	);
+}
+
+}
@@ -8,8 +8,12 @@
 #include <algorithm>
 #include <unordered_map>
 #include <unordered_set>
+#include <atomic>
+#include <chrono>
 
 
+#include "nbl/core/execution.h"
+
 #include "nbl/asset/asset.h"
 #include "nbl/asset/IRenderpassIndependentPipeline.h"
 #include "nbl/asset/utils/CMeshManipulator.h"
@@ -136,43 +140,67 @@ core::smart_refctd_ptr<ICPUMeshBuffer> CMeshManipulator::createMeshBufferFetchOp
 	if (!pipeline || !ind)
 		return nullptr;
 
-	auto outbuffer = core::move_and_static_cast<ICPUMeshBuffer>(_inbuffer->clone(1u));
-    outbuffer->setAttachedDescriptorSet(core::smart_refctd_ptr<ICPUDescriptorSet>(const_cast<ICPUDescriptorSet*>(_inbuffer->getAttachedDescriptorSet())));
-    outbuffer->setSkin(
-        SBufferBinding<ICPUBuffer>(reinterpret_cast<const SBufferBinding<ICPUBuffer>&>(_inbuffer->getInverseBindPoseBufferBinding())),
-        SBufferBinding<ICPUBuffer>(reinterpret_cast<const SBufferBinding<ICPUBuffer>&>(_inbuffer->getJointAABBBufferBinding())),
-        _inbuffer->getJointCount(),_inbuffer->getMaxJointsPerVertex()
-    );
+	// index and vertex buffers all get replaced, so only the pipeline needs copying while the skin and descriptor set stay shared
+	auto outbuffer = core::move_and_static_cast<ICPUMeshBuffer>(_inbuffer->clone(0u));
+	outbuffer->setPipeline(core::smart_refctd_ptr_static_cast<ICPURenderpassIndependentPipeline>(pipeline->clone(0u)));
 
     constexpr uint32_t MAX_ATTRIBS = asset::ICPUMeshBuffer::MAX_VERTEX_ATTRIB_COUNT;
 
 	// Find vertex count
-	size_t vertexCount = IMeshManipulator::upperBoundVertexID(_inbuffer);
+	const size_t vertexCount = IMeshManipulator::upperBoundVertexID(_inbuffer);
+
+	// STEP: renumber vertices in order of first use
+	const E_INDEX_TYPE idxType = _inbuffer->getIndexType();
+	const size_t idxCount = _inbuffer->getIndexCount();
+	const size_t indexSize = idxType == EIT_32BIT ? sizeof(uint32_t) : sizeof(uint16_t);
+	auto newIndexBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(idxCount*indexSize);
+
+	core::vector<uint32_t> remapBuffer(vertexCount, 0xffffffffu);
+	// new vertex ID -> old vertex ID
+	core::vector<uint32_t> vertexOrder;
+	vertexOrder.reserve(vertexCount);
+	auto remapIndices = [&](const auto* in, auto* out) -> void
+	{
+		for (size_t i = 0; i < idxCount; ++i)
+		{
+			uint32_t& remap = remapBuffer[in[i]];
+			if (remap == 0xffffffffu)
+			{
+				remap = vertexOrder.size();
+				vertexOrder.push_back(in[i]);
+			}
+			out[i] = remap;
+		}
+	};
+	if (idxType == EIT_32BIT)
+		remapIndices(reinterpret_cast<const uint32_t*>(ind), reinterpret_cast<uint32_t*>(newIndexBuffer->getPointer()));
+	else
+		remapIndices(reinterpret_cast<const uint16_t*>(ind), reinterpret_cast<uint16_t*>(newIndexBuffer->getPointer()));
+	outbuffer->setIndexBufferBinding({ 0ull, std::move(newIndexBuffer) });
+	const size_t nextVert = vertexOrder.size();
+	_NBL_DEBUG_BREAK_IF(nextVert > vertexCount)
 
+	// STEP: lay out the vertex buffers
 	core::unordered_set<const ICPUBuffer*> buffers;
 	for (size_t i = 0; i < MAX_ATTRIBS; ++i)
         if (auto* buf = _inbuffer->getAttribBoundBuffer(i).buffer.get())
 		    buffers.insert(buf);
 
-	size_t offsets[MAX_ATTRIBS];
-	memset(offsets, -1, sizeof(offsets));
-	E_FORMAT types[MAX_ATTRIBS];
 	if (buffers.size() != 1)
 	{
+		size_t offsets[MAX_ATTRIBS];
 		size_t lastOffset = 0u;
 		size_t lastSize = 0u;
 		for (size_t i = 0; i < MAX_ATTRIBS; ++i)
 		{
 			if (_inbuffer->isAttributeEnabled(i))
 			{
-				types[i] = _inbuffer->getAttribFormat(i);
+				const E_FORMAT type = _inbuffer->getAttribFormat(i);
 
-                const uint32_t typeSz = getTexelOrBlockBytesize(types[i]);
-                const size_t alignment = (typeSz/getFormatChannelCount(types[i]) == 8u) ? 8ull : 4ull; // if format 64bit per channel, then align to 8
+                const uint32_t typeSz = getTexelOrBlockBytesize(type);
+                const size_t alignment = (typeSz/getFormatChannelCount(type) == 8u) ? 8ull : 4ull; // if format 64bit per channel, then align to 8
 
-				offsets[i] = lastOffset + lastSize;
-				const size_t mod = offsets[i] % alignment;
-				offsets[i] += mod;
+				offsets[i] = core::alignUp(lastOffset + lastSize, alignment);
 
 				lastOffset = offsets[i];
                 lastSize = typeSz;
@@ -188,70 +216,52 @@ core::smart_refctd_ptr<ICPUMeshBuffer> CMeshManipulator::createMeshBufferFetchOp
         vtxParams.bindings[NEW_VTX_BUF_BINDING].stride = vertexSize;
         vtxParams.bindings[NEW_VTX_BUF_BINDING].inputRate = SVertexInputBindingParams::EVIR_PER_VERTEX;
 
-		auto newVertBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(vertexCount*vertexSize);
-        outbuffer->setVertexBufferBinding({ 0u, core::smart_refctd_ptr(newVertBuffer) }, NEW_VTX_BUF_BINDING);
+		for (uint32_t i = 0u; i < ICPUMeshBuffer::MAX_ATTR_BUF_BINDING_COUNT; ++i)
+			outbuffer->setVertexBufferBinding({ 0u, nullptr }, i);
+		// only the vertices which are referenced need space
+		auto newVertBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(nextVert*vertexSize);
+        outbuffer->setVertexBufferBinding({ 0u, std::move(newVertBuffer) }, NEW_VTX_BUF_BINDING);
 		for (size_t i = 0; i < MAX_ATTRIBS; ++i)
 		{
-			if (offsets[i] < 0xffffffff)
+			if (_inbuffer->isAttributeEnabled(i))
 			{
                 vtxParams.attributes[i].binding = NEW_VTX_BUF_BINDING;
-                vtxParams.attributes[i].format = types[i];
+                vtxParams.attributes[i].format = _inbuffer->getAttribFormat(i);
                 vtxParams.attributes[i].relativeOffset = offsets[i];
 			}
 		}
 	}
-	outbuffer->setBaseVertex(0);
-
-	core::vector<uint32_t> activeAttribs;
-	for (size_t i = 0; i < MAX_ATTRIBS; ++i)
-		if (outbuffer->isAttributeEnabled(i))
-			activeAttribs.push_back(i);
-
-	uint32_t* remapBuffer = _NBL_NEW_ARRAY(uint32_t,vertexCount);
-	memset(remapBuffer, 0xffffffffu, vertexCount*sizeof(uint32_t));
-
-	const E_INDEX_TYPE idxType = outbuffer->getIndexType();
-	void* indices = outbuffer->getIndices();
-	size_t nextVert = 0u;
-
-	for (size_t i = 0; i < outbuffer->getIndexCount(); ++i)
+	else
 	{
-		const uint32_t index = idxType == EIT_32BIT ? ((uint32_t*)indices)[i] : ((uint16_t*)indices)[i];
-
-		uint32_t& remap = remapBuffer[index];
-
-		if (remap == 0xffffffffu)
+		// keep the layout, the new buffer just mustn't alias the input
+		const ICPUBuffer* const oldVertBuffer = *buffers.begin();
+		auto newVertBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(oldVertBuffer->getSize());
+		for (uint32_t i = 0u; i < ICPUMeshBuffer::MAX_ATTR_BUF_BINDING_COUNT; ++i)
 		{
-			for (size_t j = 0; j < activeAttribs.size(); ++j)
-			{
-				E_FORMAT type = types[activeAttribs[j]];
-
-                if (!isNormalizedFormat(type) && (isIntegerFormat(type) || isScaledFormat(type)))
-				{
-					uint32_t dst[4];
-					_inbuffer->getAttribute(dst, activeAttribs[j], index);
-					outbuffer->setAttribute(dst, activeAttribs[j], nextVert);
-				}
-				else
-				{
-					core::vectorSIMDf dst;
-					_inbuffer->getAttribute(dst, activeAttribs[j], index);
-					outbuffer->setAttribute(dst, activeAttribs[j], nextVert);
-				}
-			}
-
-			remap = nextVert++;
+			const auto& binding = _inbuffer->getVertexBufferBindings()[i];
+			if (binding.buffer.get() == oldVertBuffer)
+				outbuffer->setVertexBufferBinding({ binding.offset, core::smart_refctd_ptr(newVertBuffer) }, i);
 		}
-
-		if (idxType == EIT_32BIT)
-			((uint32_t*)indices)[i] = remap;
-		else
-			((uint16_t*)indices)[i] = remap;
 	}
+	outbuffer->setBaseVertex(0);
 
-    _NBL_DELETE_ARRAY(remapBuffer,vertexCount);
+	// STEP: gather the vertices, formats don't change so every attribute gets copied as raw bytes
+	for (uint32_t i = 0u; i < MAX_ATTRIBS; ++i)
+	{
+		if (!outbuffer->isAttributeEnabled(i))
+			continue;
 
-	_NBL_DEBUG_BREAK_IF(nextVert > vertexCount)
+		const uint8_t* const src = _inbuffer->getAttribPointer(i);
+		uint8_t* const dst = outbuffer->getAttribPointer(i);
+		if (!src || !dst)
+			continue;
+		const size_t srcStride = _inbuffer->getAttribStride(i);
+		const size_t dstStride = outbuffer->getAttribStride(i);
+		const size_t attrSize = getTexelOrBlockBytesize(outbuffer->getAttribFormat(i));
+
+		for (size_t j = 0u; j < nextVert; ++j)
+			memcpy(dst+j*dstStride, src+vertexOrder[j]*srcStride, attrSize);
+	}
 
 	return outbuffer;
 }
@@ -619,10 +629,11 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createMeshBufferWelded(
         return core::smart_refctd_ptr<ICPUMeshBuffer>(inbuffer);
 }
 
-core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createOptimizedMeshBuffer(const ICPUMeshBuffer* _inbuffer, const SErrorMetric* _errMetric)
+core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createOptimizedMeshBuffer(const ICPUMeshBuffer* _inbuffer, const SErrorMetric* _errMetric, SOptimizationStatistics* _outStats)
 {
 	if (!_inbuffer)
 		return nullptr;
+	const auto start = std::chrono::steady_clock::now();
     const auto oldPipeline = _inbuffer->getPipeline();
 	auto outbuffer = core::move_and_static_cast<ICPUMeshBuffer>(_inbuffer->clone(oldPipeline ? 1u:0u));
 	if (!oldPipeline)
@@ -644,6 +655,12 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createOptimizedMeshBuff
     if (outbuffer->getPipeline()->getCachedCreationParams().primitiveAssembly.primitiveType != EPT_TRIANGLE_LIST)
 		return nullptr;
 
+	if (_outStats)
+	{
+		_outStats->indexCount = outbuffer->getIndexCount();
+		_outStats->before = CForsythVertexCacheOptimizer::analyzeVertexCache(upperBoundVertexID(outbuffer.get()), outbuffer->getIndexCount(), reinterpret_cast<const uint32_t*>(outbuffer->getIndices()));
+	}
+
 	// STEP: weld
     createMeshBufferWelded(outbuffer.get(), _errMetric, false, false);
 
@@ -658,12 +675,14 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createOptimizedMeshBuff
 	{
 		uint32_t* indices = reinterpret_cast<uint32_t*>(outbuffer->getIndices());
 		CForsythVertexCacheOptimizer forsyth;
-        const uint32_t vertexCount = IMeshManipulator::upperBoundVertexID(_inbuffer);
+        const uint32_t vertexCount = IMeshManipulator::upperBoundVertexID(outbuffer.get());
 		forsyth.optimizeTriangleOrdering(vertexCount, outbuffer->getIndexCount(), indices, indices);
 	}
 
 	// STEP: prefetch optimization
 	outbuffer = CMeshManipulator::createMeshBufferFetchOptimized(outbuffer.get()); // here we also get interleaved attributes (single vertex buffer)
+	if (_outStats)
+		_outStats->after = CForsythVertexCacheOptimizer::analyzeVertexCache(upperBoundVertexID(outbuffer.get()), outbuffer->getIndexCount(), reinterpret_cast<const uint32_t*>(outbuffer->getIndices()));
 	
 	// STEP: requantization
 	requantizeMeshBuffer(outbuffer.get(), _errMetric);
@@ -766,9 +785,134 @@ core::smart_refctd_ptr<ICPUMeshBuffer> IMeshManipulator::createOptimizedMeshBuff
 		}
 	}
 
+	if (_outStats)
+		_outStats->optimizeTime = std::chrono::steady_clock::now()-start;
 	return outbuffer;
 }
 
+core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> IMeshManipulator::createOptimizedMeshBuffers(std::span<const ICPUMeshBuffer* const> _inbuffers, const SErrorMetric* _errMetric, SOptimizationStatistics* _outStats)
+{
+	core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> retval(_inbuffers.size());
+
+	// meshbuffers don't share any of the state the optimizing steps modify, so they can all go at once
+	core::vector<size_t> jobs(_inbuffers.size());
+	std::iota(jobs.begin(), jobs.end(), 0ull);
+	core::for_each(core::execution::par, jobs.begin(), jobs.end(), [&](const size_t i) -> void
+		{
+			retval[i] = createOptimizedMeshBuffer(_inbuffers[i], _errMetric, _outStats ? (_outStats+i):nullptr);
+		}
+	);
+	return retval;
+}
+
+// the per-vertex passes of requantization run as parallel loops over chunks of this many vertices
+constexpr size_t VertexChunkSize = 4096ull;
+
+static inline size_t getVertexChunkCount(const size_t vertexCount)
+{
+	return (vertexCount+VertexChunkSize-1ull)/VertexChunkSize;
+}
+
+// calls `f(chunk,begin,end)` for every chunk of [0,vertexCount) in parallel and returns false if any call did,
+// chunks which haven't started by the time one fails get skipped
+template<typename F>
+static bool forEachVertexChunk(const size_t vertexCount, F&& f)
+{
+	core::vector<size_t> chunks(getVertexChunkCount(vertexCount));
+	std::iota(chunks.begin(), chunks.end(), 0ull);
+	std::atomic_bool failed = false;
+	core::for_each(core::execution::par, chunks.begin(), chunks.end(), [&](const size_t chunk) -> void
+		{
+			if (failed.load(std::memory_order_relaxed))
+				return;
+			const size_t begin = chunk*VertexChunkSize;
+			if (!f(chunk, begin, std::min(begin+VertexChunkSize, vertexCount)))
+				failed.store(true, std::memory_order_relaxed);
+		}
+	);
+	return !failed.load(std::memory_order_relaxed);
+}
+
+// where the elements of an attribute live, resolved once before the parallel passes so none of them touch the meshbuffer or its buffers' storage
+struct SVertexAttribSource
+{
+	// first element, with the binding offset, `baseVertex` (or `baseInstance`) and relative offset applied
+	const uint8_t* base = nullptr;
+	const uint8_t* bufferEnd = nullptr;
+	size_t stride = 0ull;
+	E_FORMAT format = EF_UNKNOWN;
+};
+static SVertexAttribSource resolveVertexAttribSource(const ICPUMeshBuffer* _meshbuffer, const uint32_t _attrId)
+{
+	SVertexAttribSource retval;
+	if (!_meshbuffer->isAttributeEnabled(_attrId))
+		return retval;
+	const ICPUBuffer* buffer = _meshbuffer->getAttribBoundBuffer(_attrId).buffer.get();
+	if (!buffer)
+		return retval;
+	// const all the way, so shared or mapped storage never gets privatized just to be read
+	retval.base = _meshbuffer->getAttribPointer(_attrId);
+	if (!retval.base)
+		return retval;
+	retval.bufferEnd = reinterpret_cast<const uint8_t*>(buffer->getPointer())+buffer->getSize();
+	retval.stride = _meshbuffer->getAttribStride(_attrId);
+	retval.format = _meshbuffer->getAttribFormat(_attrId);
+	return retval;
+}
+
+// same as calling `ICPUMeshBuffer::getAttribute` for every vertex in [_begin,_end),
+// except 32bit float formats get copied straight instead of going through `decodePixels<double>`, elements past the end of the buffer are left alone
+template<typename T>
+static void decodeVertexRange(const SVertexAttribSource& _src, const size_t _begin, const size_t _end, T* _out)
+{
+	if (!_src.base)
+		return;
+	const uint8_t* const base = _src.base;
+	const uint8_t* const bufferEnd = _src.bufferEnd;
+	const size_t stride = _src.stride;
+	const E_FORMAT format = _src.format;
+
+	uint32_t floatCount = 0u;
+	if constexpr (std::is_same_v<T,core::vectorSIMDf>)
+	switch (format)
+	{
+		case EF_R32_SFLOAT:
+			floatCount = 1u;
+			break;
+		case EF_R32G32_SFLOAT:
+			floatCount = 2u;
+			break;
+		case EF_R32G32B32_SFLOAT:
+			floatCount = 3u;
+			break;
+		case EF_R32G32B32A32_SFLOAT:
+			floatCount = 4u;
+			break;
+		default:
+			break;
+	}
+
+	for (size_t ix = _begin; ix < _end; ++ix)
+	{
+		const uint8_t* const src = base+ix*stride;
+		if (src >= bufferEnd)
+			break;
+		if constexpr (std::is_same_v<T,core::vectorSIMDf>)
+		{
+			if (floatCount)
+			{
+				// missing components decode to 0 and W to 1
+				_out[ix] = core::vectorSIMDf(0.f, 0.f, 0.f, 1.f);
+				memcpy(_out[ix].pointer, src, floatCount*sizeof(float));
+			}
+			else
+				ICPUMeshBuffer::getAttribute(_out[ix], src, format);
+		}
+		else
+			ICPUMeshBuffer::getAttribute(_out[ix].pointer, src, format);
+	}
+}
+
 void IMeshManipulator::requantizeMeshBuffer(ICPUMeshBuffer* _meshbuffer, const SErrorMetric* _errMetric)
 {
     constexpr uint32_t MAX_ATTRIBS = ICPUMeshBuffer::MAX_VERTEX_ATTRIB_COUNT;
@@ -846,11 +990,17 @@ void IMeshManipulator::requantizeMeshBuffer(ICPUMeshBuffer* _meshbuffer, const S
 		if (iti != attribsI.end())
 		{
 			const core::vector<CMeshManipulator::SIntegerAttr>& attrVec = iti->second;
-			for (size_t ai = 0u; ai < attrVec.size(); ++ai)
-			{
-				const bool check = _meshbuffer->setAttribute(attrVec[ai].pointer, newAttribs[i].vaid, ai);
-				_NBL_DEBUG_BREAK_IF(!check)
-			}
+			// every vertex gets written to its own bytes, so the chunks can go in parallel
+			forEachVertexChunk(attrVec.size(), [&](size_t, const size_t begin, const size_t end) -> bool
+				{
+					for (size_t ai = begin; ai < end; ++ai)
+					{
+						const bool check = _meshbuffer->setAttribute(attrVec[ai].pointer, newAttribs[i].vaid, ai);
+						_NBL_DEBUG_BREAK_IF(!check)
+					}
+					return true;
+				}
+			);
 			continue;
 		}
 
@@ -858,11 +1008,16 @@ void IMeshManipulator::requantizeMeshBuffer(ICPUMeshBuffer* _meshbuffer, const S
 		if (itf != attribsF.end())
 		{
 			const core::vector<core::vectorSIMDf>& attrVec = itf->second;
-			for (size_t ai = 0u; ai < attrVec.size(); ++ai)
-			{
-				const bool check = _meshbuffer->setAttribute(attrVec[ai], newAttribs[i].vaid, ai);
-				_NBL_DEBUG_BREAK_IF(!check)
-			}
+			forEachVertexChunk(attrVec.size(), [&](size_t, const size_t begin, const size_t end) -> bool
+				{
+					for (size_t ai = begin; ai < end; ++ai)
+					{
+						const bool check = _meshbuffer->setAttribute(attrVec[ai], newAttribs[i].vaid, ai);
+						_NBL_DEBUG_BREAK_IF(!check)
+					}
+					return true;
+				}
+			);
 		}
 	}
 }
@@ -930,27 +1085,41 @@ core::vector<core::vectorSIMDf> CMeshManipulator::findBetterFormatF(E_FORMAT* _o
     if (!isFloatingPointFormat(thisType) && !isNormalizedFormat(thisType) && !isScaledFormat(thisType))
         return {};
 
-	core::vector<core::vectorSIMDf> attribs;
-
-
     const uint32_t cpa = getFormatChannelCount(thisType);
+    const uint32_t cnt = IMeshManipulator::upperBoundVertexID(_meshbuffer);
 
-	float min[4]{ FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
-	float max[4]{ -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	core::vector<core::vectorSIMDf> attribs(cnt);
 
-	core::vectorSIMDf attr;
-    const uint32_t cnt = IMeshManipulator::upperBoundVertexID(_meshbuffer);
-    for (uint32_t idx = 0u; idx < cnt; ++idx)
+	// decode and find the bounds in parallel, each chunk keeps its own bounds which get reduced after
+	struct SBounds
 	{
-        _meshbuffer->getAttribute(attr, _attrId, idx);
-		attribs.push_back(attr);
-		for (uint32_t i = 0; i < cpa ; ++i)
+		float min[4]{ FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+		float max[4]{ -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	};
+	core::vector<SBounds> chunkBounds(getVertexChunkCount(cnt));
+	const SVertexAttribSource source = resolveVertexAttribSource(_meshbuffer, _attrId);
+	forEachVertexChunk(cnt, [&](const size_t chunk, const size_t begin, const size_t end) -> bool
 		{
-			if (attr.pointer[i] < min[i])
-				min[i] = attr.pointer[i];
-			if (attr.pointer[i] > max[i])
-				max[i] = attr.pointer[i];
+			decodeVertexRange(source, begin, end, attribs.data());
+			auto& bounds = chunkBounds[chunk];
+			for (size_t idx = begin; idx < end; ++idx)
+			for (uint32_t i = 0; i < cpa; ++i)
+			{
+				if (attribs[idx].pointer[i] < bounds.min[i])
+					bounds.min[i] = attribs[idx].pointer[i];
+				if (attribs[idx].pointer[i] > bounds.max[i])
+					bounds.max[i] = attribs[idx].pointer[i];
+			}
+			return true;
 		}
+	);
+	float min[4]{ FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+	float max[4]{ -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (const auto& bounds : chunkBounds)
+	for (uint32_t i = 0; i < cpa; ++i)
+	{
+		min[i] = std::min(min[i], bounds.min[i]);
+		max[i] = std::max(max[i], bounds.max[i]);
 	}
 
 	core::vector<SAttribTypeChoice> possibleTypes = findTypesOfProperRangeF(thisType, getTexelOrBlockBytesize(thisType), min, max, _errMetric);
@@ -990,51 +1159,63 @@ core::vector<CMeshManipulator::SIntegerAttr> CMeshManipulator::findBetterFormatI
     if (isBGRALayoutFormat(thisType))
         return {}; // BGRA is supported only by a few normalized types (this is function for integer types)
 
-	core::vector<SIntegerAttr> attribs;
-
-
     const uint32_t cpa = getFormatChannelCount(thisType);
+    const bool isSigned = isSignedFormat(thisType);
+    const uint32_t cnt = IMeshManipulator::upperBoundVertexID(_meshbuffer);
 
-	uint32_t min[4];
-	uint32_t max[4];
-	if (!isSignedFormat(thisType))
-		for (size_t i = 0; i < 4; ++i)
-			min[i] = UINT_MAX;
-	else
-		for (size_t i = 0; i < 4; ++i)
-			min[i] = INT_MAX;
-	if (!isSignedFormat(thisType))
-		for (size_t i = 0; i < 4; ++i)
-			max[i] = 0;
-	else
-		for (size_t i = 0; i < 4; ++i)
-			max[i] = INT_MIN;
-
+	core::vector<SIntegerAttr> attribs(cnt);
 
-	SIntegerAttr attr;
-    const uint32_t cnt = IMeshManipulator::upperBoundVertexID(_meshbuffer);
-    for (uint32_t idx = 0u; idx < cnt; ++idx)
+	struct SBounds
+	{
+		uint32_t min[4];
+		uint32_t max[4];
+	};
+	SBounds initialBounds;
+	for (size_t i = 0; i < 4; ++i)
+	{
+		initialBounds.min[i] = isSigned ? INT_MAX : UINT_MAX;
+		initialBounds.max[i] = isSigned ? INT_MIN : 0;
+	}
+	// grows `bounds` to contain `attr`
+	auto extend = [cpa, isSigned](SBounds& bounds, const uint32_t* attr) -> void
 	{
-        _meshbuffer->getAttribute(attr.pointer, _attrId, idx);
-		attribs.push_back(attr);
 		for (uint32_t i = 0; i < cpa; ++i)
 		{
-			if (!isSignedFormat(thisType))
+			if (!isSigned)
 			{
-				if (attr.pointer[i] < min[i])
-					min[i] = attr.pointer[i];
-				if (attr.pointer[i] > max[i])
-					max[i] = attr.pointer[i];
+				if (attr[i] < bounds.min[i])
+					bounds.min[i] = attr[i];
+				if (attr[i] > bounds.max[i])
+					bounds.max[i] = attr[i];
 			}
 			else
 			{
-				if (((int32_t*)attr.pointer + i)[0] < ((int32_t*)min + i)[0])
-					min[i] = attr.pointer[i];
-				if (((int32_t*)attr.pointer + i)[0] > ((int32_t*)max + i)[0])
-					max[i] = attr.pointer[i];
+				if (((const int32_t*)attr + i)[0] < ((int32_t*)bounds.min + i)[0])
+					bounds.min[i] = attr[i];
+				if (((const int32_t*)attr + i)[0] > ((int32_t*)bounds.max + i)[0])
+					bounds.max[i] = attr[i];
 			}
 		}
+	};
+
+	core::vector<SBounds> chunkBounds(getVertexChunkCount(cnt), initialBounds);
+	const SVertexAttribSource source = resolveVertexAttribSource(_meshbuffer, _attrId);
+	forEachVertexChunk(cnt, [&](const size_t chunk, const size_t begin, const size_t end) -> bool
+		{
+			decodeVertexRange(source, begin, end, attribs.data());
+			for (size_t idx = begin; idx < end; ++idx)
+				extend(chunkBounds[chunk], attribs[idx].pointer);
+			return true;
+		}
+	);
+	SBounds bounds = initialBounds;
+	for (const auto& chunk : chunkBounds)
+	{
+		extend(bounds, chunk.min);
+		extend(bounds, chunk.max);
 	}
+	uint32_t* const min = bounds.min;
+	uint32_t* const max = bounds.max;
 
 	*_outPrevType = *_outType = thisType;
 	*_outSize = getTexelOrBlockBytesize(thisType);
@@ -1372,6 +1553,30 @@ core::vector<CMeshManipulator::SAttribTypeChoice> CMeshManipulator::findTypesOfP
 	return possibleTypes;
 }
 
+// quantizes whole chunks in one batch, so that the cache misses get fitted together, the cache is shared between the threads
+template<E_FORMAT CacheFormat, E_FORMAT DecodeFormat>
+static bool checkNormalQuantizationError(const core::vector<core::vectorSIMDf>& _srcData, const uint32_t _channelCount, const IMeshManipulator::SErrorMetric& _errMetric, CQuantNormalCache& _cache)
+{
+	return forEachVertexChunk(_srcData.size(), [&](size_t, const size_t begin, const size_t end) -> bool
+		{
+			CQuantNormalCache::value_type_t<CacheFormat> quantized[VertexChunkSize];
+			_cache.quantize<CacheFormat>({ _srcData.data()+begin, end-begin }, quantized);
+			for (size_t i = begin; i < end; ++i)
+			{
+				uint8_t buf[32];
+				((CQuantNormalCache::value_type_t<CacheFormat>*)buf)[0] = quantized[i-begin];
+
+				core::vectorSIMDf retval;
+				ICPUMeshBuffer::getAttribute(retval, buf, DecodeFormat);
+				retval.w = 1.f;
+				if (!IMeshManipulator::compareFloatingPointAttribute(_srcData[i], retval, _channelCount, _errMetric))
+					return false;
+			}
+			return true;
+		}
+	);
+}
+
 bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcType, const SAttribTypeChoice& _dstType, const core::vector<core::vectorSIMDf>& _srcData, const SErrorMetric& _errMetric, CQuantNormalCache& _cache)
 {
     using namespace video;
@@ -1382,48 +1587,22 @@ bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcTyp
 
 	if (_errMetric.method == EEM_ANGLES)
 	{
+		const uint32_t channelCount = getFormatChannelCount(_srcType.type);
 		switch (_dstType.type)
 		{
 		case EF_R8_SNORM:
         case EF_R8G8_SNORM:
         case EF_R8G8B8_SNORM:
         case EF_R8G8B8A8_SNORM:
-			quantFunc = [](const core::vectorSIMDf& _in, E_FORMAT, E_FORMAT, CQuantNormalCache& _cache) -> core::vectorSIMDf {
-				uint8_t buf[32];
-				((CQuantNormalCache::value_type_t<EF_R8G8B8_SNORM>*)buf)[0] = _cache.quantize<EF_R8G8B8_SNORM>(_in);
-
-				core::vectorSIMDf retval;
-				ICPUMeshBuffer::getAttribute(retval, buf, EF_R8G8B8A8_SNORM);
-				retval.w = 1.f;
-				return retval;
-			};
-			break;
+			return checkNormalQuantizationError<EF_R8G8B8_SNORM,EF_R8G8B8A8_SNORM>(_srcData,channelCount,_errMetric,_cache);
 		case EF_A2R10G10B10_SNORM_PACK32:
 		case EF_A2B10G10R10_SNORM_PACK32: // bgra
-			quantFunc = [](const core::vectorSIMDf& _in, E_FORMAT, E_FORMAT, CQuantNormalCache& _cache) -> core::vectorSIMDf {
-				uint8_t buf[32];
-				((CQuantNormalCache::value_type_t<EF_A2B10G10R10_SNORM_PACK32>*)buf)[0] = _cache.quantize<EF_A2B10G10R10_SNORM_PACK32>(_in);
-
-				core::vectorSIMDf retval;
-				ICPUMeshBuffer::getAttribute(retval, buf, EF_A2R10G10B10_SNORM_PACK32);
-				retval.w = 1.f;
-				return retval;
-			};
-			break;
+			return checkNormalQuantizationError<EF_A2B10G10R10_SNORM_PACK32,EF_A2R10G10B10_SNORM_PACK32>(_srcData,channelCount,_errMetric,_cache);
         case EF_R16_SNORM:
         case EF_R16G16_SNORM:
         case EF_R16G16B16_SNORM:
         case EF_R16G16B16A16_SNORM:
-			quantFunc = [](const core::vectorSIMDf& _in, E_FORMAT, E_FORMAT, CQuantNormalCache& _cache) -> core::vectorSIMDf {
-				uint8_t buf[32];
-				((CQuantNormalCache::value_type_t<EF_R16G16B16_SNORM>*)buf)[0] = _cache.quantize<EF_R16G16B16_SNORM>(_in);
-
-				core::vectorSIMDf retval;
-				ICPUMeshBuffer::getAttribute(retval, buf, EF_R16G16B16A16_SNORM);
-				retval.w = 1.f;
-				return retval;
-			};
-			break;
+			return checkNormalQuantizationError<EF_R16G16B16_SNORM,EF_R16G16B16A16_SNORM>(_srcData,channelCount,_errMetric,_cache);
         default: 
             quantFunc = nullptr;
             break;
@@ -1444,14 +1623,19 @@ bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcTyp
 	if (!quantFunc)
 		return false;
 
-	for (const core::vectorSIMDf& d : _srcData)
-	{
-		const core::vectorSIMDf quantized = quantFunc(d, _srcType.type, _dstType.type, _cache);
-        if (!compareFloatingPointAttribute(d, quantized, getFormatChannelCount(_srcType.type), _errMetric))
-            return false;
-	}
-
-	return true;
+	// the first vertex over the error bound stops the remaining chunks
+	return forEachVertexChunk(_srcData.size(), [&](size_t, const size_t begin, const size_t end) -> bool
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				const core::vectorSIMDf& d = _srcData[i];
+				const core::vectorSIMDf quantized = quantFunc(d, _srcType.type, _dstType.type, _cache);
+				if (!compareFloatingPointAttribute(d, quantized, getFormatChannelCount(_srcType.type), _errMetric))
+					return false;
+			}
+			return true;
+		}
+	);
 }
 
 core::smart_refctd_ptr<ICPUBuffer> IMeshManipulator::idxBufferFromLineStripsToLines(const void* _input, uint32_t& _idxCount, E_INDEX_TYPE _inIndexType, E_INDEX_TYPE _outIndexType)
@@ -1576,26 +1760,20 @@ core::matrix3x4SIMD IMeshManipulator::calculateOBB(const nbl::asset::ICPUMeshBuf
     N[3] = core::vectorSIMDf(1, -A, 0);
     N[4] = core::vectorSIMDf(A, 0, 1);
     N[5] = core::vectorSIMDf(A, 0, -1);
-    float Bs[12];
-    float B;
-    int indexcount = meshbuffer->getIndexCount();
-    core::vectorSIMDf CachedVertex = meshbuffer->getPosition(meshbuffer->getIndexValue(0));
-    core::vectorSIMDf AABBMax = CachedVertex;
-    core::vectorSIMDf AABBMin = CachedVertex;
+    const uint32_t indexcount = meshbuffer->getIndexCount();
+    // gather once, then the box and all 6 extremal pairs come out of wide SIMD passes over the positions
+    core::vector<core::vectorSIMDf> positions(core::max(indexcount,1u));
+    for (uint32_t j = 0u; j < positions.size(); j++)
+        positions[j] = meshbuffer->getPosition(meshbuffer->getIndexValue(j));
+    core::vectorSIMDf AABBMin, AABBMax;
+    core::batch::minMax(positions, AABBMin, AABBMax);
+    uint32_t MinIx[6], MaxIx[6];
+    core::batch::extremalPoints(positions, N, MinIx, MaxIx);
     for (int k = 0; k < 12; k += 2) {
-        B = core::dot(N[k / 2], CachedVertex).x;
-        Extrema[k] = core::vectorSIMDf(CachedVertex.x, CachedVertex.y, CachedVertex.z); Bs[k] = B;
-        Extrema[k + 1] = core::vectorSIMDf(CachedVertex.x, CachedVertex.y, CachedVertex.z); Bs[k + 1] = B;
-    }
-    for (uint32_t j = 1u; j < indexcount; j += 1u) {
-        CachedVertex = meshbuffer->getPosition(meshbuffer->getIndexValue(j));
-        for (int k = 0; k < 12; k += 2) {
-            B = core::dot(N[k / 2], CachedVertex).x;
-            if (B > Bs[k] || j == 0) { Extrema[k] = core::vectorSIMDf(CachedVertex.x, CachedVertex.y, CachedVertex.z); Bs[k] = B; }
-            if (B < Bs[k + 1] || j == 0) { Extrema[k + 1] = core::vectorSIMDf(CachedVertex.x, CachedVertex.y, CachedVertex.z); Bs[k + 1] = B; }
-        }
-        AABBMax = core::max(AABBMax, CachedVertex);
-        AABBMin = core::min(AABBMin, CachedVertex);
+        const auto& MaxVertex = positions[MaxIx[k / 2]];
+        const auto& MinVertex = positions[MinIx[k / 2]];
+        Extrema[k] = core::vectorSIMDf(MaxVertex.x, MaxVertex.y, MaxVertex.z);
+        Extrema[k + 1] = core::vectorSIMDf(MinVertex.x, MinVertex.y, MinVertex.z);
     }
 
     int LBTE1 = -1;
@@ -1689,15 +1867,11 @@ core::matrix3x4SIMD IMeshManipulator::calculateOBB(const nbl::asset::ICPUMeshBuf
 
     core::vectorSIMDf MinPoint;
     core::vectorSIMDf MaxPoint;
-    CachedVertex = meshbuffer->getPosition(meshbuffer->getIndexValue(0));
-    MinPoint = core::vectorSIMDf(core::dot(BestAxis[0], CachedVertex).x, core::dot(BestAxis[1], CachedVertex).x, core::dot(BestAxis[2], CachedVertex).x);
-    MaxPoint = MinPoint;
-    for (uint32_t j = 1u; j < indexcount; j += 1u)
     {
-        CachedVertex = meshbuffer->getPosition(meshbuffer->getIndexValue(j));
-        core::vectorSIMDf Proj = core::vectorSIMDf(core::dot(BestAxis[0], CachedVertex).x, core::dot(BestAxis[1], CachedVertex).x, core::dot(BestAxis[2], CachedVertex).x);
-        MinPoint = core::min(MinPoint, Proj);
-        MaxPoint = core::max(MaxPoint, Proj);
+        // project onto the chosen axes in place, the positions aren't needed anymore
+        const core::matrix3x4SIMD ProjMat(BestAxis[0], BestAxis[1], BestAxis[2]);
+        core::batch::transformPoints(ProjMat, positions, positions.data());
+        core::batch::minMax(positions, MinPoint, MaxPoint);
     }
 
     core::vectorSIMDf OBBDiff = MaxPoint - MinPoint;
@@ -0,0 +1,514 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/declarations.h"
+#include "nbl/core/execution.h"
+#include "nbl/core/algorithm/radix_sort.h"
+
+#include "nbl/asset/utils/CMeshSimplifier.h"
+#include "nbl/asset/utils/IMeshManipulator.h"
+
+#include <bit>
+#include <numeric>
+
+namespace nbl::asset
+{
+
+namespace
+{
+// plane quadric, stored as the symmetric 3x3 `A`, the vector `b` and scalar `c` of `v^T*A*v+2*b^T*v+c`, premultiplied by the weight
+struct SQuadric
+{
+	static inline SQuadric fromPlane(const core::vectorSIMDf& n, const float d, const float w)
+	{
+		SQuadric q;
+		q.a00 = w*n.x*n.x;
+		q.a11 = w*n.y*n.y;
+		q.a22 = w*n.z*n.z;
+		q.a10 = w*n.y*n.x;
+		q.a20 = w*n.z*n.x;
+		q.a21 = w*n.z*n.y;
+		q.b0 = w*n.x*d;
+		q.b1 = w*n.y*d;
+		q.b2 = w*n.z*d;
+		q.c = w*d*d;
+		q.w = w;
+		return q;
+	}
+
+	inline SQuadric& operator+=(const SQuadric& other)
+	{
+		a00 += other.a00; a11 += other.a11; a22 += other.a22;
+		a10 += other.a10; a20 += other.a20; a21 += other.a21;
+		b0 += other.b0; b1 += other.b1; b2 += other.b2;
+		c += other.c;
+		w += other.w;
+		return *this;
+	}
+
+	// weighted average squared distance of `v` to the planes
+	inline float error(const core::vectorSIMDf& v) const
+	{
+		const float rx = (b0+a10*v.y)*2.f+a00*v.x;
+		const float ry = (b1+a21*v.z)*2.f+a11*v.y;
+		const float rz = (b2+a20*v.x)*2.f+a22*v.z;
+		const float r = c+rx*v.x+ry*v.y+rz*v.z;
+		return w>0.f ? std::abs(r)/w:0.f;
+	}
+
+	float a00 = 0.f, a11 = 0.f, a22 = 0.f;
+	float a10 = 0.f, a20 = 0.f, a21 = 0.f;
+	float b0 = 0.f, b1 = 0.f, b2 = 0.f;
+	float c = 0.f;
+	float w = 0.f;
+};
+
+enum E_VERTEX_KIND : uint8_t
+{
+	EVK_MANIFOLD,
+	EVK_BORDER,
+	EVK_SEAM,
+	EVK_LOCKED
+};
+
+// whether a vertex of the first kind may collapse onto one of the second, border and seam ones only along their open edge
+constexpr bool CanCollapse[4][4] = {
+	{true,	true,	true,	true},
+	{false,	true,	false,	false},
+	{false,	false,	true,	false},
+	{false,	false,	false,	false}
+};
+// borders and seams get a plane perpendicular to the surface through the open edge, so they keep their shape
+constexpr float EdgeWeight = 10.f;
+
+constexpr uint32_t NoEdge = ~0u;
+constexpr uint32_t ManyEdges = ~1u;
+
+struct SCollapse
+{
+	uint32_t v0;
+	uint32_t v1;
+	float error;
+};
+// errors are never negative, so their bits sort the same as they do
+struct SCollapseErrorKey
+{
+	_NBL_STATIC_INLINE_CONSTEXPR size_t key_bit_count = 32ull;
+
+	template<auto bit_offset, auto radix_mask>
+	inline decltype(radix_mask) operator()(const SCollapse& item) const
+	{
+		return static_cast<decltype(radix_mask)>(std::bit_cast<uint32_t>(item.error)>>static_cast<uint32_t>(bit_offset))&radix_mask;
+	}
+};
+
+// vertex -> triangles in compressed rows
+struct SAdjacency
+{
+	inline void build(const uint32_t* indices, const size_t indexCount, const uint32_t vertexCount, const uint32_t* remap)
+	{
+		offsets.assign(vertexCount+1u,0u);
+		for (size_t i=0u; i<indexCount; i++)
+			offsets[remap[indices[i]]+1u]++;
+		std::inclusive_scan(offsets.begin(),offsets.end(),offsets.begin());
+		triangles.resize(indexCount);
+		cursor.assign(offsets.begin(),offsets.end()-1);
+		for (size_t i=0u; i<indexCount; i++)
+			triangles[cursor[remap[indices[i]]]++] = i/3u;
+	}
+
+	core::vector<uint32_t> offsets;
+	core::vector<uint32_t> triangles;
+	core::vector<uint32_t> cursor;
+};
+}
+
+
+bool CMeshSimplifier::simplify(core::vector<uint32_t>& _outIndices, std::span<const uint32_t> _indices, std::span<const core::vectorSIMDf> _positions, const SParams& _params, SStatistics* _outStats)
+{
+	if (_indices.size()%3u)
+		return false;
+	const auto start = std::chrono::steady_clock::now();
+	const uint32_t vertexCount = _positions.size();
+	for (const auto index : _indices)
+	if (index>=vertexCount)
+		return false;
+	_outIndices.assign(_indices.begin(),_indices.end());
+
+	// work in the unit cube so the errors are relative and float precision is the same for any mesh
+	core::vectorSIMDf minPos(FLT_MAX), maxPos(-FLT_MAX);
+	for (const auto index : _indices)
+	{
+		minPos = core::min(minPos,_positions[index]);
+		maxPos = core::max(maxPos,_positions[index]);
+	}
+	const auto extents = maxPos-minPos;
+	const float extent = std::max(std::max(extents.x,extents.y),extents.z);
+	const float invExtent = extent>0.f ? 1.f/extent:0.f;
+	core::vector<core::vectorSIMDf> positions(vertexCount);
+	for (uint32_t v=0u; v<vertexCount; v++)
+	{
+		positions[v] = (_positions[v]-minPos)*invExtent;
+		positions[v].w = 0.f;
+	}
+
+	// vertices at the same position get remapped to one of them, and are linked in a cyclic list
+	core::vector<uint32_t> remap(vertexCount);
+	core::vector<uint32_t> wedge(vertexCount);
+	{
+		core::vector<uint32_t> sorted(vertexCount);
+		std::iota(sorted.begin(),sorted.end(),0u);
+		auto key = [&](const uint32_t v) {return std::tuple(positions[v].x,positions[v].y,positions[v].z);};
+		std::sort(sorted.begin(),sorted.end(),[&](const uint32_t a, const uint32_t b) {return key(a)<key(b);});
+		for (uint32_t i=0u; i<vertexCount;)
+		{
+			uint32_t end = i+1u;
+			while (end<vertexCount && key(sorted[end])==key(sorted[i]))
+				end++;
+			const uint32_t first = *std::min_element(sorted.begin()+i,sorted.begin()+end);
+			for (uint32_t j=i; j<end; j++)
+			{
+				remap[sorted[j]] = first;
+				wedge[sorted[j]] = sorted[j+1u<end ? j+1u:i];
+			}
+			i = end;
+		}
+	}
+
+	core::vector<uint32_t> identity(vertexCount);
+	std::iota(identity.begin(),identity.end(),0u);
+	SAdjacency adjacency;
+	adjacency.build(_outIndices.data(),_outIndices.size(),vertexCount,identity.data());
+	auto hasEdge = [&](const uint32_t a, const uint32_t b) -> bool
+	{
+		for (uint32_t j=adjacency.offsets[a]; j<adjacency.offsets[a+1u]; j++)
+		{
+			const auto* tri = _outIndices.data()+adjacency.triangles[j]*3u;
+			for (uint32_t c=0u; c<3u; c++)
+			if (tri[c]==a && tri[(c+1u)%3u]==b)
+				return true;
+		}
+		return false;
+	};
+
+	// open edges of every vertex, the ones without a twin in the opposite direction
+	core::vector<uint32_t> openOut(vertexCount,NoEdge);
+	core::vector<uint32_t> openIn(vertexCount,NoEdge);
+	for (size_t i=0u; i<_outIndices.size(); i+=3u)
+	for (uint32_t c=0u; c<3u; c++)
+	{
+		const uint32_t a = _outIndices[i+c];
+		const uint32_t b = _outIndices[i+(c+1u)%3u];
+		if (a==b || hasEdge(b,a))
+			continue;
+		openOut[a] = openOut[a]==NoEdge ? b:ManyEdges;
+		openIn[b] = openIn[b]==NoEdge ? a:ManyEdges;
+	}
+	auto isSingle = [](const uint32_t edge) -> bool {return edge!=NoEdge && edge!=ManyEdges;};
+
+	core::vector<E_VERTEX_KIND> kinds(vertexCount,EVK_LOCKED);
+	for (uint32_t v=0u; v<vertexCount; v++)
+	{
+		const uint32_t w = wedge[v];
+		if (w==v)
+		{
+			if (openOut[v]==NoEdge && openIn[v]==NoEdge)
+				kinds[v] = EVK_MANIFOLD;
+			else if (isSingle(openOut[v]) && isSingle(openIn[v]) && !_params.lockBorders)
+				kinds[v] = EVK_BORDER;
+		}
+		// a seam has its open edges matched by the other side's, going the opposite way
+		else if (wedge[w]==v && isSingle(openOut[v]) && isSingle(openIn[v]) && isSingle(openOut[w]) && isSingle(openIn[w]))
+		{
+			if (remap[openOut[v]]==remap[openIn[w]] && remap[openIn[v]]==remap[openOut[w]])
+				kinds[v] = EVK_SEAM;
+		}
+	}
+
+	// per position
+	core::vector<SQuadric> quadrics(vertexCount);
+	for (size_t i=0u; i<_outIndices.size(); i+=3u)
+	{
+		const auto* tri = _outIndices.data()+i;
+		const auto& p0 = positions[tri[0]];
+		auto normal = core::cross(positions[tri[1]]-p0,positions[tri[2]]-p0);
+		const float area = core::length(normal).x;
+		if (area<=0.f)
+			continue;
+		normal /= area;
+		const auto q = SQuadric::fromPlane(normal,-core::dot(normal,p0).x,area);
+		for (uint32_t c=0u; c<3u; c++)
+			quadrics[remap[tri[c]]] += q;
+
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			const uint32_t a = tri[c];
+			const uint32_t b = tri[(c+1u)%3u];
+			if (openOut[a]!=b || kinds[a]==EVK_MANIFOLD)
+				continue;
+			const auto& pa = positions[a];
+			auto edge = positions[b]-pa;
+			const float length = core::length(edge).x;
+			if (length<=0.f)
+				continue;
+			edge /= length;
+			const auto toOpposite = positions[tri[(c+2u)%3u]]-pa;
+			auto perpendicular = toOpposite-edge*core::dot(toOpposite,edge).x;
+			const float perpendicularLength = core::length(perpendicular).x;
+			if (perpendicularLength<=0.f)
+				continue;
+			perpendicular /= perpendicularLength;
+			const auto q = SQuadric::fromPlane(perpendicular,-core::dot(perpendicular,pa).x,length*length*EdgeWeight);
+			quadrics[remap[a]] += q;
+			quadrics[remap[b]] += q;
+		}
+	}
+
+	const size_t targetIndexCount = size_t(double(_indices.size()/3u)*std::clamp(_params.targetRatio,0.f,1.f))*3ull;
+	const float errorLimit = _params.targetError*_params.targetError;
+	float resultError = 0.f;
+
+	core::vector<SCollapse> collapses;
+	core::vector<SCollapse> collapseScratch;
+	core::vector<uint32_t> collapseRemap(identity);
+	core::vector<uint8_t> collapseLocked(vertexCount);
+	while (_outIndices.size()>targetIndexCount)
+	{
+		adjacency.build(_outIndices.data(),_outIndices.size(),vertexCount,identity.data());
+
+		// gather the collapses allowed on every edge, in their cheaper direction
+		collapses.clear();
+		for (size_t i=0u; i<_outIndices.size(); i+=3u)
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			const uint32_t i0 = _outIndices[i+c];
+			const uint32_t i1 = _outIndices[i+(c+1u)%3u];
+			const auto k0 = kinds[i0];
+			const auto k1 = kinds[i1];
+			// between two border or seam vertices only the open edge can collapse, not a chord across the surface
+			if (k0==k1 && (k0==EVK_BORDER || k0==EVK_SEAM) && openOut[i0]!=i1)
+				continue;
+			// every closed edge is there twice
+			if (i0>i1 && hasEdge(i1,i0))
+				continue;
+			const bool can0 = CanCollapse[k0][k1];
+			const bool can1 = CanCollapse[k1][k0];
+			if (!can0 && !can1)
+				continue;
+			const float error0 = can0 ? quadrics[remap[i0]].error(positions[i1]):FLT_MAX;
+			const float error1 = can1 ? quadrics[remap[i1]].error(positions[i0]):FLT_MAX;
+			if (error0<=error1)
+				collapses.push_back({i0,i1,error0});
+			else
+				collapses.push_back({i1,i0,error1});
+		}
+		if (collapses.empty())
+			break;
+		collapseScratch.resize(collapses.size());
+		const SCollapse* const sorted = core::radix_sort(collapses.data(),collapseScratch.data(),collapses.size(),SCollapseErrorKey());
+
+		// collapsing an edge drops 2 triangles, or 1 on the border
+		const size_t triangleGoal = (_outIndices.size()-targetIndexCount)/3u;
+		const size_t edgeGoal = triangleGoal/2u;
+		// collapses sharing vertices with ones done this pass get skipped, so allow more error than the cheapest `edgeGoal` have,
+		// unless they're all free (flat regions) and blocked by flips, which would make every pass do a handful of collapses
+		float errorGoal = edgeGoal<collapses.size() ? sorted[edgeGoal].error*1.5f:FLT_MAX;
+		if (errorGoal<=0.f)
+			errorGoal = FLT_MAX;
+
+		adjacency.build(_outIndices.data(),_outIndices.size(),vertexCount,remap.data());
+		auto hasTriangleFlips = [&](const uint32_t v0, const uint32_t v1) -> bool
+		{
+			const uint32_t r0 = remap[v0];
+			const uint32_t r1 = remap[v1];
+			const auto& p0 = positions[v0];
+			const auto& p1 = positions[v1];
+			for (uint32_t j=adjacency.offsets[r0]; j<adjacency.offsets[r0+1u]; j++)
+			{
+				const auto* tri = _outIndices.data()+adjacency.triangles[j]*3u;
+				const uint32_t c = remap[tri[0]]==r0 ? 0u:(remap[tri[1]]==r0 ? 1u:2u);
+				const uint32_t b = tri[(c+1u)%3u];
+				const uint32_t d = tri[(c+2u)%3u];
+				// these become degenerate
+				if (remap[b]==r1 || remap[d]==r1)
+					continue;
+				const auto before = core::cross(positions[b]-p0,positions[d]-p0);
+				const auto after = core::cross(positions[b]-p1,positions[d]-p1);
+				// not just flips, slivers turning by more than ~75 degrees add up to flips over several passes
+				if (core::dot(before,after).x<=0.25f*core::length(before).x*core::length(after).x)
+					return true;
+			}
+			return false;
+		};
+		// keeps the open edge lists current when `v0` collapses onto its neighbour `v1` along the border or seam
+		auto collapseOpenEdges = [&](const uint32_t v0, const uint32_t v1) -> void
+		{
+			if (openOut[v0]==v1)
+			{
+				openIn[v1] = openIn[v0];
+				openOut[openIn[v0]] = v1;
+			}
+			else
+			{
+				openOut[v1] = openOut[v0];
+				openIn[openOut[v0]] = v1;
+			}
+		};
+
+		std::fill(collapseLocked.begin(),collapseLocked.end(),0u);
+		size_t triangleCollapses = 0u;
+		for (size_t i=0u; i<collapses.size(); i++)
+		{
+			const auto& collapse = sorted[i];
+			if (collapse.error>errorLimit || triangleCollapses>=triangleGoal)
+				break;
+			if (collapse.error>errorGoal && triangleCollapses>triangleGoal/10u)
+				break;
+
+			const uint32_t v0 = collapse.v0;
+			const uint32_t v1 = collapse.v1;
+			const uint32_t r0 = remap[v0];
+			const uint32_t r1 = remap[v1];
+			if (collapseLocked[r0] || collapseLocked[r1] || hasTriangleFlips(v0,v1))
+				continue;
+
+			const auto kind = kinds[v0];
+			if (kind==EVK_SEAM)
+			{
+				// the other side of the seam collapses onto the other side of `v1`
+				const uint32_t s0 = wedge[v0];
+				const uint32_t s1 = openOut[v0]==v1 ? openIn[s0]:openOut[s0];
+				if (!isSingle(s1) || remap[s1]!=r1)
+					continue;
+				collapseOpenEdges(v0,v1);
+				collapseOpenEdges(s0,s1);
+				collapseRemap[s0] = s1;
+			}
+			else if (kind==EVK_BORDER)
+				collapseOpenEdges(v0,v1);
+			collapseRemap[v0] = v1;
+
+			quadrics[r1] += quadrics[r0];
+			// the flip test assumed the rest of the triangles around `v0` stay put
+			for (uint32_t j=adjacency.offsets[r0]; j<adjacency.offsets[r0+1u]; j++)
+			{
+				const auto* tri = _outIndices.data()+adjacency.triangles[j]*3u;
+				for (uint32_t c=0u; c<3u; c++)
+					collapseLocked[remap[tri[c]]] = 1u;
+			}
+			collapseLocked[r1] = 1u;
+			triangleCollapses += kind==EVK_BORDER ? 1u:2u;
+			resultError = std::max(resultError,collapse.error);
+		}
+		if (!triangleCollapses)
+			break;
+
+		// apply and drop the triangles which became degenerate
+		size_t outCount = 0u;
+		for (size_t i=0u; i<_outIndices.size(); i+=3u)
+		{
+			const uint32_t a = collapseRemap[_outIndices[i+0u]];
+			const uint32_t b = collapseRemap[_outIndices[i+1u]];
+			const uint32_t c = collapseRemap[_outIndices[i+2u]];
+			if (a==b || a==c || b==c)
+				continue;
+			_outIndices[outCount++] = a;
+			_outIndices[outCount++] = b;
+			_outIndices[outCount++] = c;
+		}
+		_outIndices.resize(outCount);
+	}
+
+	if (_outStats)
+	{
+		_outStats->inputTriangleCount = _indices.size()/3u;
+		_outStats->outputTriangleCount = _outIndices.size()/3u;
+		_outStats->relativeError = std::sqrt(resultError);
+		_outStats->absoluteError = _outStats->relativeError*extent;
+		_outStats->buildTime = std::chrono::steady_clock::now()-start;
+	}
+	return true;
+}
+
+core::smart_refctd_ptr<ICPUMeshBuffer> CMeshSimplifier::createSimplified(const ICPUMeshBuffer* _inbuffer, const SParams& _params, SStatistics* _outStats, const system::logger_opt_ptr logger)
+{
+	if (!_inbuffer)
+		return nullptr;
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto* pipeline = _inbuffer->getPipeline();
+	if (!pipeline || pipeline->getCachedCreationParams().primitiveAssembly.primitiveType!=EPT_TRIANGLE_LIST)
+	{
+		logger.log("Mesh simplification: meshbuffer is not a triangle list.",system::ILogger::ELL_ERROR);
+		return nullptr;
+	}
+	const E_INDEX_TYPE indexType = _inbuffer->getIndexType();
+	const void* const inIndices = _inbuffer->getIndices();
+	if (!inIndices || indexType==EIT_UNKNOWN)
+	{
+		logger.log("Mesh simplification: no index buffer, weld the meshbuffer first.",system::ILogger::ELL_ERROR);
+		return nullptr;
+	}
+	const uint32_t posAttrId = _inbuffer->getPositionAttributeIx();
+	if (!_inbuffer->isAttributeEnabled(posAttrId))
+	{
+		logger.log("Mesh simplification: meshbuffer has no position attribute.",system::ILogger::ELL_ERROR);
+		return nullptr;
+	}
+
+	const uint32_t indexCount = _inbuffer->getIndexCount();
+	if (indexCount%3u)
+	{
+		logger.log("Mesh simplification: index count %d is not a multiple of 3.",system::ILogger::ELL_ERROR,indexCount);
+		return nullptr;
+	}
+	core::vector<uint32_t> indices(indexCount);
+	if (indexType==EIT_16BIT)
+		std::copy_n(reinterpret_cast<const uint16_t*>(inIndices),indexCount,indices.begin());
+	else
+		std::copy_n(reinterpret_cast<const uint32_t*>(inIndices),indexCount,indices.begin());
+
+	const uint32_t vertexCount = IMeshManipulator::upperBoundVertexID(_inbuffer);
+	core::vector<core::vectorSIMDf> positions(vertexCount);
+	for (uint32_t i=0u; i<vertexCount; ++i)
+		_inbuffer->getAttribute(positions[i],posAttrId,i);
+
+	core::vector<uint32_t> outIndices;
+	// with the index count checked above, the only remaining failure is an index out of the range `upperBoundVertexID` reported
+	if (!simplify(outIndices,indices,positions,_params,_outStats))
+	{
+		logger.log("Mesh simplification: an index is out of range of the %d vertices.",system::ILogger::ELL_ERROR,vertexCount);
+		return nullptr;
+	}
+
+	auto outbuffer = core::move_and_static_cast<ICPUMeshBuffer>(_inbuffer->clone(0u));
+	const size_t indexSize = indexType==EIT_16BIT ? sizeof(uint16_t):sizeof(uint32_t);
+	auto indexBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(std::max<size_t>(outIndices.size(),1u)*indexSize);
+	if (indexType==EIT_16BIT)
+		std::copy(outIndices.begin(),outIndices.end(),reinterpret_cast<uint16_t*>(indexBuffer->getPointer()));
+	else
+		std::copy(outIndices.begin(),outIndices.end(),reinterpret_cast<uint32_t*>(indexBuffer->getPointer()));
+	outbuffer->setIndexBufferBinding({0ull,std::move(indexBuffer)});
+	outbuffer->setIndexCount(outIndices.size());
+
+	// count the fetches and conversions too
+	if (_outStats)
+		_outStats->buildTime = std::chrono::steady_clock::now()-start;
+	return outbuffer;
+}
+
+core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> CMeshSimplifier::createLoDChain(const ICPUMeshBuffer* _inbuffer, std::span<const SParams> _levels, SStatistics* _outStats, const system::logger_opt_ptr logger)
+{
+	core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> lods(_levels.size());
+	core::vector<size_t> jobs(_levels.size());
+	std::iota(jobs.begin(),jobs.end(),0ull);
+	core::for_each(core::execution::par, jobs.begin(), jobs.end(), [&](const size_t i) -> void
+		{
+			lods[i] = createSimplified(_inbuffer,_levels[i],_outStats ? (_outStats+i):nullptr,logger);
+		}
+	);
+	return lods;
+}
+
+}
@@ -0,0 +1,341 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/declarations.h"
+#include "nbl/core/execution.h"
+
+#include "nbl/asset/utils/CMeshletBuilder.h"
+#include "nbl/asset/utils/IMeshManipulator.h"
+
+#include <atomic>
+#include <numeric>
+
+namespace nbl::asset
+{
+
+bool CMeshletBuilder::build(SResult& _out, const ICPUMeshBuffer* _meshbuffer, const SParams& _params, const system::logger_opt_ptr logger)
+{
+	_out = {};
+	if (!_meshbuffer)
+		return false;
+
+	const auto* pipeline = _meshbuffer->getPipeline();
+	if (!pipeline || pipeline->getCachedCreationParams().primitiveAssembly.primitiveType!=EPT_TRIANGLE_LIST)
+	{
+		logger.log("Meshlet building: meshbuffer is not a triangle list.",system::ILogger::ELL_ERROR);
+		return false;
+	}
+	const uint32_t posAttrId = _meshbuffer->getPositionAttributeIx();
+	if (!_meshbuffer->isAttributeEnabled(posAttrId))
+	{
+		logger.log("Meshlet building: meshbuffer has no position attribute.",system::ILogger::ELL_ERROR);
+		return false;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const uint32_t indexCount = _meshbuffer->getIndexCount();
+	core::vector<uint32_t> indices(indexCount);
+	const void* const inIndices = _meshbuffer->getIndices();
+	switch (inIndices ? _meshbuffer->getIndexType():EIT_UNKNOWN)
+	{
+		case EIT_16BIT:
+			std::copy_n(reinterpret_cast<const uint16_t*>(inIndices),indexCount,indices.begin());
+			break;
+		case EIT_32BIT:
+			std::copy_n(reinterpret_cast<const uint32_t*>(inIndices),indexCount,indices.begin());
+			break;
+		default:
+			std::iota(indices.begin(),indices.end(),0u);
+			break;
+	}
+
+	const uint32_t vertexCount = IMeshManipulator::upperBoundVertexID(_meshbuffer);
+	core::vector<core::vectorSIMDf> positions(vertexCount);
+	for (uint32_t i=0u; i<vertexCount; ++i)
+		_meshbuffer->getAttribute(positions[i],posAttrId,i);
+
+	if (!build(_out,indices,positions,_params))
+	{
+		logger.log("Meshlet building: invalid parameters or index buffer -- no meshlets built.",system::ILogger::ELL_ERROR);
+		return false;
+	}
+	// count the fetches and conversions too
+	_out.statistics.buildTime = std::chrono::steady_clock::now()-start;
+	return true;
+}
+
+bool CMeshletBuilder::build(std::span<SResult> _out, std::span<const ICPUMeshBuffer* const> _meshbuffers, const SParams& _params, const system::logger_opt_ptr logger)
+{
+	if (_out.size()!=_meshbuffers.size())
+		return false;
+
+	core::vector<size_t> jobs(_meshbuffers.size());
+	std::iota(jobs.begin(),jobs.end(),0ull);
+	std::atomic_bool failed = false;
+	core::for_each(core::execution::par, jobs.begin(), jobs.end(), [&](const size_t i) -> void
+		{
+			if (!build(_out[i],_meshbuffers[i],_params,logger))
+				failed.store(true,std::memory_order_relaxed);
+		}
+	);
+	return !failed.load(std::memory_order_relaxed);
+}
+
+bool CMeshletBuilder::build(SResult& _out, std::span<const uint32_t> _indices, std::span<const core::vectorSIMDf> _positions, const SParams& _params)
+{
+	_out = {};
+	if (!_params.valid() || _indices.size()%3u)
+		return false;
+	const auto start = std::chrono::steady_clock::now();
+
+	constexpr uint32_t InvalidTriangle = ~0u;
+	constexpr uint16_t InvalidLocal = 0xffffu;
+	const uint32_t triangleCount = _indices.size()/3u;
+	const uint32_t vertexCount = _positions.size();
+
+	// vertex -> triangles adjacency, in compressed rows
+	core::vector<uint32_t> adjacencyOffsets(vertexCount+1u,0u);
+	for (const auto index : _indices)
+	{
+		if (index>=vertexCount)
+			return false;
+		adjacencyOffsets[index+1u]++;
+	}
+	std::inclusive_scan(adjacencyOffsets.begin(),adjacencyOffsets.end(),adjacencyOffsets.begin());
+	core::vector<uint32_t> adjacency(_indices.size());
+	{
+		core::vector<uint32_t> cursor(adjacencyOffsets.begin(),adjacencyOffsets.end()-1);
+		for (uint32_t i=0u; i<_indices.size(); i++)
+			adjacency[cursor[_indices[i]]++] = i/3u;
+	}
+	// triangles not yet in a meshlet, per vertex
+	core::vector<uint32_t> liveTriangles(vertexCount);
+	std::adjacent_difference(adjacencyOffsets.begin()+1,adjacencyOffsets.end(),liveTriangles.begin());
+	core::vector<uint8_t> emitted(triangleCount,0u);
+
+	// only needed to keep the normal cones tight
+	core::vector<core::vectorSIMDf> triangleNormals;
+	if (_params.coneWeight>0.f)
+	{
+		triangleNormals.resize(triangleCount);
+		for (uint32_t t=0u; t<triangleCount; t++)
+		{
+			const auto* tri = _indices.data()+t*3u;
+			const auto normal = core::cross(_positions[tri[1]]-_positions[tri[0]],_positions[tri[2]]-_positions[tri[0]]);
+			const float area = core::length(normal).x;
+			triangleNormals[t] = area>0.f ? normal/area:core::vectorSIMDf();
+		}
+	}
+
+	// meshlet local index of every vertex in the current meshlet
+	core::vector<uint16_t> localIndex(vertexCount,InvalidLocal);
+	auto countNewVertices = [&](const uint32_t* tri) -> uint32_t
+	{
+		return uint32_t(localIndex[tri[0]]==InvalidLocal)+
+			uint32_t(localIndex[tri[1]]==InvalidLocal && tri[1]!=tri[0])+
+			uint32_t(localIndex[tri[2]]==InvalidLocal && tri[2]!=tri[0] && tri[2]!=tri[1]);
+	};
+
+	_out.vertexRemap.reserve(_indices.size()/2u);
+	_out.localIndices.reserve(_indices.size());
+	SMeshlet meshlet = {0u,0u,0u,0u};
+	core::vectorSIMDf meshletNormal;
+	core::vectorSIMDf meshletAxis;
+	auto flush = [&]() -> void
+	{
+		if (!meshlet.triangleCount)
+			return;
+		for (uint32_t i=0u; i<meshlet.vertexCount; i++)
+			localIndex[_out.vertexRemap[meshlet.vertexOffset+i]] = InvalidLocal;
+		_out.meshlets.push_back(meshlet);
+		meshlet = {uint32_t(_out.vertexRemap.size()),uint32_t(_out.localIndices.size()),0u,0u};
+		meshletNormal = meshletAxis = core::vectorSIMDf();
+	};
+
+	uint32_t scanCursor = 0u;
+	for (uint32_t emittedCount=0u; emittedCount<triangleCount; emittedCount++)
+	{
+		if (meshlet.triangleCount==_params.maxTriangles)
+			flush();
+
+		// grow across the vertices already in the meshlet
+		uint32_t best = InvalidTriangle;
+		float bestScore = FLT_MAX;
+		uint32_t bestLive = ~0u;
+		for (uint32_t i=0u; i<meshlet.vertexCount; i++)
+		{
+			const uint32_t vertex = _out.vertexRemap[meshlet.vertexOffset+i];
+			if (!liveTriangles[vertex])
+				continue;
+			for (uint32_t j=adjacencyOffsets[vertex]; j<adjacencyOffsets[vertex+1u]; j++)
+			{
+				const uint32_t t = adjacency[j];
+				if (emitted[t])
+					continue;
+				const auto* tri = _indices.data()+t*3u;
+				const uint32_t newVertices = countNewVertices(tri);
+				if (meshlet.vertexCount+newVertices>_params.maxVertices)
+					continue;
+				const uint32_t live = liveTriangles[tri[0]]+liveTriangles[tri[1]]+liveTriangles[tri[2]];
+				// no new vertices is best, then the ones finishing off a vertex since they'd be expensive in any other meshlet
+				uint32_t priority = newVertices;
+				if (newVertices && (liveTriangles[tri[0]]==1u || liveTriangles[tri[1]]==1u || liveTriangles[tri[2]]==1u))
+					priority = 0u;
+				float score = float(priority+(newVertices ? 1u:0u));
+				if (!triangleNormals.empty())
+					score += _params.coneWeight*(1.f-core::dot(triangleNormals[t],meshletAxis).x);
+				if (score<bestScore || score==bestScore && live<bestLive)
+				{
+					best = t;
+					bestScore = score;
+					bestLive = live;
+				}
+			}
+		}
+		// nothing connected, continue with the next triangle in index order, which is close by in a cache optimized mesh
+		if (best==InvalidTriangle)
+		{
+			while (emitted[scanCursor])
+				scanCursor++;
+			best = scanCursor;
+			if (meshlet.vertexCount+countNewVertices(_indices.data()+best*3u)>_params.maxVertices)
+				flush();
+		}
+
+		const auto* tri = _indices.data()+best*3u;
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			const uint32_t vertex = tri[c];
+			if (localIndex[vertex]==InvalidLocal)
+			{
+				localIndex[vertex] = meshlet.vertexCount++;
+				_out.vertexRemap.push_back(vertex);
+			}
+			_out.localIndices.push_back(localIndex[vertex]);
+			liveTriangles[vertex]--;
+		}
+		emitted[best] = 1u;
+		meshlet.triangleCount++;
+		if (!triangleNormals.empty())
+		{
+			meshletNormal += triangleNormals[best];
+			const float len = core::length(meshletNormal).x;
+			meshletAxis = len>0.f ? meshletNormal/len:core::vectorSIMDf();
+		}
+	}
+	flush();
+
+	_out.bounds.reserve(_out.meshlets.size());
+	for (const auto& m : _out.meshlets)
+		_out.bounds.push_back(computeBounds(_out.vertexRemap.data(),_out.localIndices.data(),m,_positions.data()));
+
+	_out.statistics.meshletCount = _out.meshlets.size();
+	_out.statistics.triangleCount = triangleCount;
+	_out.statistics.vertexCount = _out.vertexRemap.size();
+	_out.statistics.buildTime = std::chrono::steady_clock::now()-start;
+	return true;
+}
+
+CMeshletBuilder::SBounds CMeshletBuilder::computeBounds(const uint32_t* _remap, const uint8_t* _localIndices, const SMeshlet& _meshlet, const core::vectorSIMDf* _positions)
+{
+	const uint32_t* vertices = _remap+_meshlet.vertexOffset;
+	const uint8_t* localIndices = _localIndices+_meshlet.triangleOffset;
+	auto getPosition = [&](const uint32_t i) -> core::vectorSIMDf
+	{
+		auto p = _positions[vertices[i]];
+		p.w = 0.f;
+		return p;
+	};
+	auto distance = [](const core::vectorSIMDf& a, const core::vectorSIMDf& b) -> float
+	{
+		return core::length(a-b).x;
+	};
+
+	// Ritter's sphere, within a few percent of the optimal one
+	core::vectorSIMDf center;
+	float radius = 0.f;
+	{
+		auto farthestFrom = [&](const core::vectorSIMDf& p) -> core::vectorSIMDf
+		{
+			uint32_t farthest = 0u;
+			float maxDist = -1.f;
+			for (uint32_t i=0u; i<_meshlet.vertexCount; i++)
+			{
+				const float d = distance(getPosition(i),p);
+				if (d>maxDist)
+				{
+					farthest = i;
+					maxDist = d;
+				}
+			}
+			return getPosition(farthest);
+		};
+		const auto a = farthestFrom(getPosition(0u));
+		const auto b = farthestFrom(a);
+		center = (a+b)*0.5f;
+		radius = distance(a,b)*0.5f;
+		for (uint32_t i=0u; i<_meshlet.vertexCount; i++)
+		{
+			const auto p = getPosition(i);
+			const float d = distance(p,center);
+			if (d>radius)
+			{
+				const float newRadius = (radius+d)*0.5f;
+				center += (p-center)*((newRadius-radius)/d);
+				radius = newRadius;
+			}
+		}
+	}
+
+	SBounds retval;
+	retval.boundingSphere = center;
+	retval.boundingSphere.w = radius;
+	// a cone which never culls anything
+	retval.coneApex = center;
+	retval.coneAxisCutoff = core::vectorSIMDf(0.f,0.f,0.f,1.f);
+
+	struct STriangle
+	{
+		core::vectorSIMDf corner;
+		core::vectorSIMDf normal;
+	};
+	core::vector<STriangle> triangles;
+	triangles.reserve(_meshlet.triangleCount);
+	core::vectorSIMDf normalSum;
+	for (uint32_t t=0u; t<_meshlet.triangleCount; t++)
+	{
+		const auto* tri = localIndices+t*3u;
+		const auto p0 = getPosition(tri[0]);
+		const auto normal = core::cross(getPosition(tri[1])-p0,getPosition(tri[2])-p0);
+		const float area = core::length(normal).x;
+		// degenerate triangles can't be seen from anywhere
+		if (area>0.f)
+		{
+			triangles.push_back({p0,normal/area});
+			normalSum += triangles.back().normal;
+		}
+	}
+	const float normalSumLen = core::length(normalSum).x;
+	if (triangles.empty() || normalSumLen==0.f)
+		return retval;
+	const auto axis = normalSum/normalSumLen;
+
+	float minDot = 1.f;
+	for (const auto& triangle : triangles)
+		minDot = std::min(minDot,core::dot(triangle.normal,axis).x);
+	// the cone would be too wide to ever cull, and the apex math below divides by the dot
+	if (minDot<=0.1f)
+		return retval;
+
+	// move the apex back along the axis until every triangle's plane is in front of it
+	float maxT = 0.f;
+	for (const auto& triangle : triangles)
+		maxT = std::max(maxT,core::dot(center-triangle.corner,triangle.normal).x/core::dot(axis,triangle.normal).x);
+	retval.coneApex = center-axis*maxT;
+	retval.coneAxisCutoff = axis;
+	retval.coneAxisCutoff.w = std::sqrt(1.f-minDot*minDot);
+	return retval;
+}
+
+}
@@ -45,9 +45,9 @@ void COverdrawMeshOptimizer::createOptimized(asset::ICPUMeshBuffer* _outbuffer,
 	{
 		const size_t dataSize = indexSize*idxCount;
 		indexCopy = _NBL_ALIGNED_MALLOC(dataSize,indexSize);
-		memcpy(outIndices,inIndices,dataSize);
-		inIndices16 = reinterpret_cast<const uint16_t*>(dataSize);
-		inIndices32 = reinterpret_cast<const uint32_t*>(dataSize);
+		memcpy(indexCopy,inIndices,dataSize);
+		inIndices16 = reinterpret_cast<const uint16_t*>(indexCopy);
+		inIndices32 = reinterpret_cast<const uint32_t*>(indexCopy);
 	}
 	uint16_t* outIndices16 = reinterpret_cast<uint16_t*>(outIndices);
 	uint32_t* outIndices32 = reinterpret_cast<uint32_t*>(outIndices);
@@ -57,15 +57,19 @@ void COverdrawMeshOptimizer::createOptimized(asset::ICPUMeshBuffer* _outbuffer,
 	for (uint32_t i=0u; i<vertexCount; ++i)
 		_inbuffer->getAttribute(vertexPositions[i],_inbuffer->getPositionAttributeIx(),i);
 
+	// both cluster passes simulate the cache with the same timestamp array, each starts a fresh cache by clearing it
+	size_t* const cacheTimestamps = reinterpret_cast<size_t*>(_NBL_ALIGNED_MALLOC(vertexCount*sizeof(size_t),_NBL_SIMD_ALIGNMENT));
+
 	uint32_t* const hardClusters = reinterpret_cast<uint32_t*>(_NBL_ALIGNED_MALLOC((idxCount/3)*sizeof(uint32_t),_NBL_SIMD_ALIGNMENT));
 	const size_t hardClusterCount = indexType == asset::EIT_16BIT ?
-		genHardBoundaries(hardClusters, inIndices16, idxCount, vertexCount) :
-		genHardBoundaries(hardClusters, inIndices32, idxCount, vertexCount);
+		genHardBoundaries(hardClusters, inIndices16, idxCount, vertexCount, cacheTimestamps) :
+		genHardBoundaries(hardClusters, inIndices32, idxCount, vertexCount, cacheTimestamps);
 
 	uint32_t* const softClusters = reinterpret_cast<uint32_t*>(_NBL_ALIGNED_MALLOC((idxCount/3+1)*sizeof(uint32_t),_NBL_SIMD_ALIGNMENT));
 	const size_t softClusterCount = indexType == asset::EIT_16BIT ?
-		genSoftBoundaries(softClusters, inIndices16, idxCount, vertexCount, hardClusters, hardClusterCount, _threshold) :
-		genSoftBoundaries(softClusters, inIndices32, idxCount, vertexCount, hardClusters, hardClusterCount, _threshold);
+		genSoftBoundaries(softClusters, inIndices16, idxCount, vertexCount, hardClusters, hardClusterCount, _threshold, cacheTimestamps) :
+		genSoftBoundaries(softClusters, inIndices32, idxCount, vertexCount, hardClusters, hardClusterCount, _threshold, cacheTimestamps);
+	_NBL_ALIGNED_FREE(cacheTimestamps);
 
 	ClusterSortData* sortedData = (ClusterSortData*)_NBL_ALIGNED_MALLOC(softClusterCount*sizeof(ClusterSortData),_NBL_SIMD_ALIGNMENT);
 	if (indexType == asset::EIT_16BIT)
@@ -105,10 +109,9 @@ void COverdrawMeshOptimizer::createOptimized(asset::ICPUMeshBuffer* _outbuffer,
 }
 
 template<typename IdxT>
-size_t COverdrawMeshOptimizer::genHardBoundaries(uint32_t* _dst, const IdxT* _indices, size_t _idxCount, size_t _vtxCount)
+size_t COverdrawMeshOptimizer::genHardBoundaries(uint32_t* _dst, const IdxT* _indices, size_t _idxCount, size_t _vtxCount, size_t* _cacheTimestamps)
 {
-	size_t* cacheTimestamps = (size_t*)_NBL_ALIGNED_MALLOC(sizeof(size_t)*_vtxCount,_NBL_SIMD_ALIGNMENT);
-	memset(cacheTimestamps, 0, sizeof(size_t)*_vtxCount);
+	memset(_cacheTimestamps, 0, sizeof(size_t)*_vtxCount);
 
 	size_t timestamp = CACHE_SIZE + 1;
 
@@ -117,7 +120,7 @@ size_t COverdrawMeshOptimizer::genHardBoundaries(uint32_t* _dst, const IdxT* _in
 	size_t retval = 0u;
 	for (size_t i = 0u; i < faceCount; ++i)
 	{
-		size_t misses = updateCache(_indices[3*i + 0], _indices[3*i + 1], _indices[3*i + 2], cacheTimestamps, timestamp);
+		size_t misses = updateCache(_indices[3*i + 0], _indices[3*i + 1], _indices[3*i + 2], _cacheTimestamps, timestamp);
 
 		// when all three vertices are not in the cache it's usually relatively safe to assume that this is a new patch in the mesh
 		// that is disjoint from previous vertices; sometimes it might come back to reference existing vertices but that frequently
@@ -127,16 +130,13 @@ size_t COverdrawMeshOptimizer::genHardBoundaries(uint32_t* _dst, const IdxT* _in
 			_dst[retval++] = (uint32_t)i;
 	}
 
-	_NBL_ALIGNED_FREE(cacheTimestamps);
-
 	return retval;
 }
 
 template<typename IdxT>
-size_t COverdrawMeshOptimizer::genSoftBoundaries(uint32_t* _dst, const IdxT* _indices, size_t _idxCount, size_t _vtxCount, const uint32_t* _clusters, size_t _clusterCount, float _threshold)
+size_t COverdrawMeshOptimizer::genSoftBoundaries(uint32_t* _dst, const IdxT* _indices, size_t _idxCount, size_t _vtxCount, const uint32_t* _clusters, size_t _clusterCount, float _threshold, size_t* _cacheTimestamps)
 {
-	size_t* cacheTimestamps = (size_t*)_NBL_ALIGNED_MALLOC(sizeof(size_t)*_vtxCount,_NBL_SIMD_ALIGNMENT);
-	memset(cacheTimestamps, 0, sizeof(size_t)*_vtxCount);
+	memset(_cacheTimestamps, 0, sizeof(size_t)*_vtxCount);
 
 	size_t timestamp = 0u;
 
@@ -153,7 +153,7 @@ size_t COverdrawMeshOptimizer::genSoftBoundaries(uint32_t* _dst, const IdxT* _in
 
 		size_t clusterMisses = 0u; // cluster ACMR
 		for (size_t j = start; j < end; ++j)
-			clusterMisses += updateCache(_indices[j*3 + 0], _indices[j*3 + 1], _indices[j*3 + 2], cacheTimestamps, timestamp);
+			clusterMisses += updateCache(_indices[j*3 + 0], _indices[j*3 + 1], _indices[j*3 + 2], _cacheTimestamps, timestamp);
 
 		const float clusterThreshold = _threshold * (float(clusterMisses) / (end - start));
 
@@ -165,7 +165,7 @@ size_t COverdrawMeshOptimizer::genSoftBoundaries(uint32_t* _dst, const IdxT* _in
 		size_t runningFaces = 0u;
 		for (size_t j = start; j < end; ++j)
 		{
-			runningMisses += updateCache(_indices[j*3 + 0], _indices[j*3 + 1], _indices[j*3 + 2], cacheTimestamps, timestamp);
+			runningMisses += updateCache(_indices[j*3 + 0], _indices[j*3 + 1], _indices[j*3 + 2], _cacheTimestamps, timestamp);
 			++runningFaces;
 
 			if (float(runningMisses)/runningFaces <= clusterThreshold)
@@ -192,8 +192,6 @@ size_t COverdrawMeshOptimizer::genSoftBoundaries(uint32_t* _dst, const IdxT* _in
 			--retval;
 	}
 
-	_NBL_ALIGNED_FREE(cacheTimestamps);
-
 	_NBL_DEBUG_BREAK_IF(retval < _clusterCount || retval > _idxCount/3u)
 
 	return retval;
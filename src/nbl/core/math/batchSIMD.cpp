@@ -0,0 +1,169 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/math/batchSIMD.h"
+
+#include "batchSIMDKernels.h"
+
+#include <atomic>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+using namespace nbl;
+using namespace nbl::core;
+using namespace nbl::core::batch;
+
+// the kernels see everything as raw floats
+static_assert(sizeof(vectorSIMDf)==4*sizeof(float));
+static_assert(sizeof(aabbox3df)==6*sizeof(float));
+static_assert(sizeof(plane3dSIMDf)==4*sizeof(float));
+
+impl::SKernelTable impl::getKernelTableSSE4_2()
+{
+	return makeKernelTable<PackSSE4_2>();
+}
+
+namespace
+{
+E_ISA detectISA()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info,0);
+	const int maxLeaf = info[0];
+	__cpuid(info,1);
+	constexpr int FMABit = 0x1<<12;
+	constexpr int OSXSAVEBit = 0x1<<27;
+	constexpr int AVXBit = 0x1<<28;
+	if ((info[2]&(FMABit|OSXSAVEBit|AVXBit))!=(FMABit|OSXSAVEBit|AVXBit) || maxLeaf<7)
+		return E_ISA::SSE4_2;
+	// the OS needs to save the YMM (and ZMM + opmask) state on context switch
+	const uint64_t xcr0 = _xgetbv(0);
+	if ((xcr0&0x6ull)!=0x6ull)
+		return E_ISA::SSE4_2;
+	__cpuidex(info,7,0);
+	if ((info[1]&(0x1<<16)) && (xcr0&0xe6ull)==0xe6ull)
+		return E_ISA::AVX512;
+	if (info[1]&(0x1<<5))
+		return E_ISA::AVX2;
+	return E_ISA::SSE4_2;
+#else
+	// these check the OS support for the register state as well
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return E_ISA::AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return E_ISA::AVX2;
+	return E_ISA::SSE4_2;
+#endif
+}
+
+// the getters live in TUs compiled for their ISA and can themselves use its instructions,
+// so only the one for an ISA which got selected (thus is supported) may ever be called
+const impl::SKernelTable& getKernelTable(const E_ISA isa)
+{
+	switch (isa)
+	{
+		case E_ISA::AVX512:
+		{
+			static const impl::SKernelTable table = impl::getKernelTableAVX512();
+			return table;
+		}
+		case E_ISA::AVX2:
+		{
+			static const impl::SKernelTable table = impl::getKernelTableAVX2();
+			return table;
+		}
+		default:
+		{
+			static const impl::SKernelTable table = impl::getKernelTableSSE4_2();
+			return table;
+		}
+	}
+}
+
+std::atomic<E_ISA>& currentISA()
+{
+	static std::atomic<E_ISA> isa = getMaxSupportedISA();
+	return isa;
+}
+
+inline const impl::SKernelTable& kernels()
+{
+	return getKernelTable(currentISA().load(std::memory_order_relaxed));
+}
+}
+
+E_ISA batch::getISA()
+{
+	return currentISA().load(std::memory_order_relaxed);
+}
+
+E_ISA batch::getMaxSupportedISA()
+{
+	static const E_ISA maxISA = detectISA();
+	return maxISA;
+}
+
+E_ISA batch::setISA(const E_ISA isa)
+{
+	const E_ISA maxISA = getMaxSupportedISA();
+	const E_ISA clamped = isa<maxISA ? isa:maxISA;
+	currentISA().store(clamped,std::memory_order_relaxed);
+	return clamped;
+}
+
+
+void batch::minMax(const std::span<const vectorSIMDf> points, vectorSIMDf& outMin, vectorSIMDf& outMax)
+{
+	const float* data = reinterpret_cast<const float*>(points.data());
+	outMin = outMax = vectorSIMDf(0.f);
+	kernels().minMax(data,data+1,data+2,4ull,points.size(),outMin.pointer,outMax.pointer);
+}
+
+void batch::minMax(const SConstPointsSoA points, const size_t count, vectorSIMDf& outMin, vectorSIMDf& outMax)
+{
+	outMin = outMax = vectorSIMDf(0.f);
+	kernels().minMax(points.x,points.y,points.z,1ull,count,outMin.pointer,outMax.pointer);
+}
+
+void batch::transformPoints(const matrix3x4SIMD& m, const std::span<const vectorSIMDf> in, vectorSIMDf* out)
+{
+	const float* src = reinterpret_cast<const float*>(in.data());
+	float* dst = reinterpret_cast<float*>(out);
+	kernels().transformPoints(m.rows[0].pointer,src,src+1,src+2,4ull,dst,dst+1,dst+2,dst+3,4ull,in.size());
+}
+
+void batch::transformPoints(const matrix3x4SIMD& m, const SConstPointsSoA in, const SPointsSoA out, const size_t count)
+{
+	kernels().transformPoints(m.rows[0].pointer,in.x,in.y,in.z,1ull,out.x,out.y,out.z,nullptr,1ull,count);
+}
+
+void batch::transformAABBs(const matrix3x4SIMD& m, const std::span<const aabbox3df> in, aabbox3df* out)
+{
+	kernels().transformAABBs(m.rows[0].pointer,reinterpret_cast<const float*>(in.data()),reinterpret_cast<float*>(out),in.size());
+}
+
+size_t batch::cullAABBs(const std::span<const plane3dSIMDf> planes, const std::span<const aabbox3df> boxes, uint8_t* outVisible)
+{
+	return kernels().cullAABBs(
+		reinterpret_cast<const float*>(planes.data()),planes.size(),
+		reinterpret_cast<const float*>(boxes.data()),boxes.size(),outVisible
+	);
+}
+
+void batch::extremalPoints(const std::span<const vectorSIMDf> points, const std::span<const vectorSIMDf> dirs, uint32_t* outMinIx, uint32_t* outMaxIx)
+{
+	const float* data = reinterpret_cast<const float*>(points.data());
+	kernels().extremalPoints(
+		data,data+1,data+2,4ull,points.size(),
+		reinterpret_cast<const float*>(dirs.data()),dirs.size(),outMinIx,outMaxIx
+	);
+}
+
+void batch::bestFitDirections(const std::span<const vectorSIMDf> dirs, const uint32_t maxComponent, vectorSIMDf* out)
+{
+	kernels().bestFitDirections(reinterpret_cast<const float*>(dirs.data()),dirs.size(),maxComponent,reinterpret_cast<float*>(out));
+}
@@ -0,0 +1,649 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_CORE_MATH_BATCH_SIMD_KERNELS_H_INCLUDED_
+#define _NBL_CORE_MATH_BATCH_SIMD_KERNELS_H_INCLUDED_
+
+// This header gets compiled with different `-m`/`/arch` flags in different translation units.
+// It must NOT pull in anything with external linkage inline functions (Nabla math headers, STL algorithms) because the linker
+// is free to keep the AVX-512 copy of such a function for the whole program, and then it blows up on older CPUs.
+// For the same reason everything but the dispatch table lives in an anonymous namespace, and only raw floats cross the boundary.
+#include <immintrin.h>
+#include <cstdint>
+#include <cstddef>
+
+namespace nbl::core::batch::impl
+{
+
+// matrices are 3x4 row-major (12 floats), boxes are 6 floats (min XYZ, max XYZ), planes and directions are 4 floats
+struct SKernelTable
+{
+	void(*transformPoints)(
+		const float* m, const float* inX, const float* inY, const float* inZ, const size_t inStride,
+		float* outX, float* outY, float* outZ, float* outW, const size_t outStride, const size_t count
+	);
+	void(*minMax)(const float* x, const float* y, const float* z, const size_t stride, const size_t count, float* outMin, float* outMax);
+	void(*transformAABBs)(const float* m, const float* in, float* out, const size_t count);
+	size_t(*cullAABBs)(const float* planes, const size_t planeCount, const float* boxes, const size_t count, uint8_t* outVisible);
+	void(*extremalPoints)(
+		const float* x, const float* y, const float* z, const size_t stride, const size_t count,
+		const float* dirs, const size_t dirCount, uint32_t* outMinIx, uint32_t* outMaxIx
+	);
+	void(*bestFitDirections)(const float* dirs, const size_t count, const uint32_t maxComponent, float* out);
+};
+// each defined in its own translation unit
+SKernelTable getKernelTableSSE4_2();
+SKernelTable getKernelTableAVX2();
+SKernelTable getKernelTableAVX512();
+
+namespace
+{
+constexpr float FloatMax = 3.402823466e+38f;
+
+// Lane pack abstractions, `load` and `store` take a stride in floats so the same kernel handles SoA (stride 1) and AoS input
+struct PackSSE4_2
+{
+	using reg_t = __m128;
+	using ireg_t = __m128i;
+	using mask_t = __m128;
+	static inline constexpr uint32_t Width = 4u;
+
+	static inline reg_t load(const float* p, const size_t stride)
+	{
+		if (stride==1u)
+			return _mm_loadu_ps(p);
+		return _mm_setr_ps(p[0],p[stride],p[stride*2u],p[stride*3u]);
+	}
+	static inline void store(float* p, const size_t stride, const reg_t v)
+	{
+		if (stride==1u)
+		{
+			_mm_storeu_ps(p,v);
+			return;
+		}
+		alignas(16) float tmp[Width];
+		_mm_store_ps(tmp,v);
+		for (uint32_t i=0u; i<Width; i++)
+			p[stride*i] = tmp[i];
+	}
+	static inline void storeIndices(uint32_t* p, const ireg_t v) {_mm_storeu_si128(reinterpret_cast<__m128i*>(p),v);}
+
+	static inline reg_t set1(const float v) {return _mm_set1_ps(v);}
+	static inline reg_t add(const reg_t a, const reg_t b) {return _mm_add_ps(a,b);}
+	static inline reg_t sub(const reg_t a, const reg_t b) {return _mm_sub_ps(a,b);}
+	static inline reg_t mul(const reg_t a, const reg_t b) {return _mm_mul_ps(a,b);}
+	// no FMA in the baseline
+	static inline reg_t fmadd(const reg_t a, const reg_t b, const reg_t c) {return _mm_add_ps(_mm_mul_ps(a,b),c);}
+	static inline reg_t fnmadd(const reg_t a, const reg_t b, const reg_t c) {return _mm_sub_ps(c,_mm_mul_ps(a,b));}
+	static inline reg_t div(const reg_t a, const reg_t b) {return _mm_div_ps(a,b);}
+	static inline reg_t floor(const reg_t a) {return _mm_floor_ps(a);}
+	static inline reg_t min(const reg_t a, const reg_t b) {return _mm_min_ps(a,b);}
+	static inline reg_t max(const reg_t a, const reg_t b) {return _mm_max_ps(a,b);}
+	static inline reg_t abs(const reg_t a) {return _mm_andnot_ps(_mm_set1_ps(-0.f),a);}
+
+	static inline mask_t noneMask() {return _mm_setzero_ps();}
+	static inline mask_t cmplt(const reg_t a, const reg_t b) {return _mm_cmplt_ps(a,b);}
+	static inline mask_t maskOr(const mask_t a, const mask_t b) {return _mm_or_ps(a,b);}
+	static inline uint32_t maskBits(const mask_t m) {return uint32_t(_mm_movemask_ps(m));}
+	// picks `b` where `m` is set
+	static inline reg_t blend(const mask_t m, const reg_t a, const reg_t b) {return _mm_blendv_ps(a,b,m);}
+
+	static inline ireg_t iota() {return _mm_setr_epi32(0,1,2,3);}
+	static inline ireg_t iadd(const ireg_t a, const uint32_t b) {return _mm_add_epi32(a,_mm_set1_epi32(int32_t(b)));}
+	static inline ireg_t iset1(const uint32_t v) {return _mm_set1_epi32(int32_t(v));}
+	static inline ireg_t iblend(const mask_t m, const ireg_t a, const ireg_t b)
+	{
+		return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(a),_mm_castsi128_ps(b),m));
+	}
+};
+
+#ifdef __AVX2__
+struct PackAVX2
+{
+	using reg_t = __m256;
+	using ireg_t = __m256i;
+	using mask_t = __m256;
+	static inline constexpr uint32_t Width = 8u;
+
+	static inline reg_t load(const float* p, const size_t stride)
+	{
+		if (stride==1u)
+			return _mm256_loadu_ps(p);
+		const __m256i offsets = _mm256_mullo_epi32(_mm256_setr_epi32(0,1,2,3,4,5,6,7),_mm256_set1_epi32(int32_t(stride)));
+		return _mm256_i32gather_ps(p,offsets,4);
+	}
+	// there's no scatter in AVX2
+	static inline void store(float* p, const size_t stride, const reg_t v)
+	{
+		if (stride==1u)
+		{
+			_mm256_storeu_ps(p,v);
+			return;
+		}
+		alignas(32) float tmp[Width];
+		_mm256_store_ps(tmp,v);
+		for (uint32_t i=0u; i<Width; i++)
+			p[stride*i] = tmp[i];
+	}
+	static inline void storeIndices(uint32_t* p, const ireg_t v) {_mm256_storeu_si256(reinterpret_cast<__m256i*>(p),v);}
+
+	static inline reg_t set1(const float v) {return _mm256_set1_ps(v);}
+	static inline reg_t add(const reg_t a, const reg_t b) {return _mm256_add_ps(a,b);}
+	static inline reg_t sub(const reg_t a, const reg_t b) {return _mm256_sub_ps(a,b);}
+	static inline reg_t mul(const reg_t a, const reg_t b) {return _mm256_mul_ps(a,b);}
+	static inline reg_t fmadd(const reg_t a, const reg_t b, const reg_t c) {return _mm256_fmadd_ps(a,b,c);}
+	static inline reg_t fnmadd(const reg_t a, const reg_t b, const reg_t c) {return _mm256_fnmadd_ps(a,b,c);}
+	static inline reg_t div(const reg_t a, const reg_t b) {return _mm256_div_ps(a,b);}
+	static inline reg_t floor(const reg_t a) {return _mm256_floor_ps(a);}
+	static inline reg_t min(const reg_t a, const reg_t b) {return _mm256_min_ps(a,b);}
+	static inline reg_t max(const reg_t a, const reg_t b) {return _mm256_max_ps(a,b);}
+	static inline reg_t abs(const reg_t a) {return _mm256_andnot_ps(_mm256_set1_ps(-0.f),a);}
+
+	static inline mask_t noneMask() {return _mm256_setzero_ps();}
+	static inline mask_t cmplt(const reg_t a, const reg_t b) {return _mm256_cmp_ps(a,b,_CMP_LT_OQ);}
+	static inline mask_t maskOr(const mask_t a, const mask_t b) {return _mm256_or_ps(a,b);}
+	static inline uint32_t maskBits(const mask_t m) {return uint32_t(_mm256_movemask_ps(m));}
+	static inline reg_t blend(const mask_t m, const reg_t a, const reg_t b) {return _mm256_blendv_ps(a,b,m);}
+
+	static inline ireg_t iota() {return _mm256_setr_epi32(0,1,2,3,4,5,6,7);}
+	static inline ireg_t iadd(const ireg_t a, const uint32_t b) {return _mm256_add_epi32(a,_mm256_set1_epi32(int32_t(b)));}
+	static inline ireg_t iset1(const uint32_t v) {return _mm256_set1_epi32(int32_t(v));}
+	static inline ireg_t iblend(const mask_t m, const ireg_t a, const ireg_t b)
+	{
+		return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a),_mm256_castsi256_ps(b),m));
+	}
+};
+#endif
+
+#ifdef __AVX512F__
+// only uses AVX-512F so it runs on everything from Knights Landing onwards
+struct PackAVX512
+{
+	using reg_t = __m512;
+	using ireg_t = __m512i;
+	using mask_t = __mmask16;
+	static inline constexpr uint32_t Width = 16u;
+
+	static inline reg_t load(const float* p, const size_t stride)
+	{
+		if (stride==1u)
+			return _mm512_loadu_ps(p);
+		const __m512i offsets = _mm512_mullo_epi32(iota(),_mm512_set1_epi32(int32_t(stride)));
+		return _mm512_i32gather_ps(offsets,p,4);
+	}
+	static inline void store(float* p, const size_t stride, const reg_t v)
+	{
+		if (stride==1u)
+		{
+			_mm512_storeu_ps(p,v);
+			return;
+		}
+		const __m512i offsets = _mm512_mullo_epi32(iota(),_mm512_set1_epi32(int32_t(stride)));
+		_mm512_i32scatter_ps(p,offsets,v,4);
+	}
+	static inline void storeIndices(uint32_t* p, const ireg_t v) {_mm512_storeu_si512(p,v);}
+
+	static inline reg_t set1(const float v) {return _mm512_set1_ps(v);}
+	static inline reg_t add(const reg_t a, const reg_t b) {return _mm512_add_ps(a,b);}
+	static inline reg_t sub(const reg_t a, const reg_t b) {return _mm512_sub_ps(a,b);}
+	static inline reg_t mul(const reg_t a, const reg_t b) {return _mm512_mul_ps(a,b);}
+	static inline reg_t fmadd(const reg_t a, const reg_t b, const reg_t c) {return _mm512_fmadd_ps(a,b,c);}
+	static inline reg_t fnmadd(const reg_t a, const reg_t b, const reg_t c) {return _mm512_fnmadd_ps(a,b,c);}
+	static inline reg_t div(const reg_t a, const reg_t b) {return _mm512_div_ps(a,b);}
+	static inline reg_t floor(const reg_t a) {return _mm512_roundscale_ps(a,_MM_FROUND_TO_NEG_INF|_MM_FROUND_NO_EXC);}
+	static inline reg_t min(const reg_t a, const reg_t b) {return _mm512_min_ps(a,b);}
+	static inline reg_t max(const reg_t a, const reg_t b) {return _mm512_max_ps(a,b);}
+	static inline reg_t abs(const reg_t a) {return _mm512_abs_ps(a);}
+
+	static inline mask_t noneMask() {return mask_t(0);}
+	static inline mask_t cmplt(const reg_t a, const reg_t b) {return _mm512_cmp_ps_mask(a,b,_CMP_LT_OQ);}
+	static inline mask_t maskOr(const mask_t a, const mask_t b) {return mask_t(a|b);}
+	static inline uint32_t maskBits(const mask_t m) {return uint32_t(m);}
+	static inline reg_t blend(const mask_t m, const reg_t a, const reg_t b) {return _mm512_mask_blend_ps(m,a,b);}
+
+	static inline ireg_t iota() {return _mm512_set_epi32(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0);}
+	static inline ireg_t iadd(const ireg_t a, const uint32_t b) {return _mm512_add_epi32(a,_mm512_set1_epi32(int32_t(b)));}
+	static inline ireg_t iset1(const uint32_t v) {return _mm512_set1_epi32(int32_t(v));}
+	static inline ireg_t iblend(const mask_t m, const ireg_t a, const ireg_t b) {return _mm512_mask_blend_epi32(m,a,b);}
+};
+#endif
+
+// the kernels, the geometric ones use the ISA's FMA where it has one (SSE4.2 emulates it with a multiply and an add) while their scalar tails
+// use separate multiplies and adds (the kernel TUs are compiled without contraction), so the tails may differ from the wide lanes in the last bit
+template<class P>
+void transformPoints(
+	const float* m, const float* inX, const float* inY, const float* inZ, const size_t inStride,
+	float* outX, float* outY, float* outZ, float* outW, const size_t outStride, const size_t count
+)
+{
+	using reg_t = typename P::reg_t;
+	reg_t rows[3][4];
+	for (uint32_t r=0u; r<3u; r++)
+	for (uint32_t c=0u; c<4u; c++)
+		rows[r][c] = P::set1(m[r*4u+c]);
+	const reg_t one = P::set1(1.f);
+
+	size_t i = 0ull;
+	for (; i+P::Width<=count; i+=P::Width)
+	{
+		const size_t inOff = i*inStride;
+		const reg_t x = P::load(inX+inOff,inStride);
+		const reg_t y = P::load(inY+inOff,inStride);
+		const reg_t z = P::load(inZ+inOff,inStride);
+		reg_t out[3];
+		for (uint32_t r=0u; r<3u; r++)
+			out[r] = P::fmadd(rows[r][0],x,P::fmadd(rows[r][1],y,P::fmadd(rows[r][2],z,rows[r][3])));
+		// only store after all loads in case `out` aliases `in`
+		const size_t outOff = i*outStride;
+		P::store(outX+outOff,outStride,out[0]);
+		P::store(outY+outOff,outStride,out[1]);
+		P::store(outZ+outOff,outStride,out[2]);
+		if (outW)
+			P::store(outW+outOff,outStride,one);
+	}
+	for (; i<count; i++)
+	{
+		const float x = inX[i*inStride];
+		const float y = inY[i*inStride];
+		const float z = inZ[i*inStride];
+		float out[3];
+		for (uint32_t r=0u; r<3u; r++)
+			out[r] = m[r*4u+0u]*x+m[r*4u+1u]*y+m[r*4u+2u]*z+m[r*4u+3u];
+		outX[i*outStride] = out[0];
+		outY[i*outStride] = out[1];
+		outZ[i*outStride] = out[2];
+		if (outW)
+			outW[i*outStride] = 1.f;
+	}
+}
+
+template<class P>
+void minMax(const float* x, const float* y, const float* z, const size_t stride, const size_t count, float* outMin, float* outMax)
+{
+	using reg_t = typename P::reg_t;
+	const float* in[3] = {x,y,z};
+	reg_t mn[3],mx[3];
+	for (uint32_t c=0u; c<3u; c++)
+	{
+		mn[c] = P::set1(FloatMax);
+		mx[c] = P::set1(-FloatMax);
+	}
+
+	size_t i = 0ull;
+	for (; i+P::Width<=count; i+=P::Width)
+	for (uint32_t c=0u; c<3u; c++)
+	{
+		const reg_t v = P::load(in[c]+i*stride,stride);
+		mn[c] = P::min(mn[c],v);
+		mx[c] = P::max(mx[c],v);
+	}
+
+	for (uint32_t c=0u; c<3u; c++)
+	{
+		alignas(64) float lanesMin[P::Width];
+		alignas(64) float lanesMax[P::Width];
+		P::store(lanesMin,1u,mn[c]);
+		P::store(lanesMax,1u,mx[c]);
+		float cmin = FloatMax;
+		float cmax = -FloatMax;
+		for (uint32_t l=0u; l<P::Width; l++)
+		{
+			cmin = lanesMin[l]<cmin ? lanesMin[l]:cmin;
+			cmax = lanesMax[l]>cmax ? lanesMax[l]:cmax;
+		}
+		for (size_t j=i; j<count; j++)
+		{
+			const float v = in[c][j*stride];
+			cmin = v<cmin ? v:cmin;
+			cmax = v>cmax ? v:cmax;
+		}
+		outMin[c] = cmin;
+		outMax[c] = cmax;
+	}
+}
+
+// Arvo's method via center and half-extent: new extent is the original one multiplied by the absolute value of the 3x3 part
+template<class P>
+void transformAABBs(const float* m, const float* in, float* out, const size_t count)
+{
+	using reg_t = typename P::reg_t;
+	constexpr size_t Stride = 6ull;
+	reg_t rows[3][4],absRows[3][3];
+	for (uint32_t r=0u; r<3u; r++)
+	for (uint32_t c=0u; c<4u; c++)
+	{
+		rows[r][c] = P::set1(m[r*4u+c]);
+		if (c<3u)
+			absRows[r][c] = P::abs(rows[r][c]);
+	}
+	const reg_t half = P::set1(0.5f);
+
+	size_t i = 0ull;
+	for (; i+P::Width<=count; i+=P::Width)
+	{
+		const float* box = in+i*Stride;
+		reg_t center[3],extent[3];
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			const reg_t mn = P::load(box+c,Stride);
+			const reg_t mx = P::load(box+3u+c,Stride);
+			center[c] = P::mul(P::add(mn,mx),half);
+			extent[c] = P::mul(P::sub(mx,mn),half);
+		}
+		float* outBox = out+i*Stride;
+		for (uint32_t r=0u; r<3u; r++)
+		{
+			const reg_t c = P::fmadd(rows[r][0],center[0],P::fmadd(rows[r][1],center[1],P::fmadd(rows[r][2],center[2],rows[r][3])));
+			const reg_t e = P::fmadd(absRows[r][0],extent[0],P::fmadd(absRows[r][1],extent[1],P::mul(absRows[r][2],extent[2])));
+			P::store(outBox+r,Stride,P::sub(c,e));
+			P::store(outBox+3u+r,Stride,P::add(c,e));
+		}
+	}
+	for (; i<count; i++)
+	{
+		const float* box = in+i*Stride;
+		float center[3],extent[3];
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			center[c] = (box[c]+box[3u+c])*0.5f;
+			extent[c] = (box[3u+c]-box[c])*0.5f;
+		}
+		float* outBox = out+i*Stride;
+		for (uint32_t r=0u; r<3u; r++)
+		{
+			float c = m[r*4u+3u];
+			float e = 0.f;
+			for (uint32_t k=0u; k<3u; k++)
+			{
+				const float mrk = m[r*4u+k];
+				c += mrk*center[k];
+				e += (mrk<0.f ? -mrk:mrk)*extent[k];
+			}
+			outBox[r] = c-e;
+			outBox[3u+r] = c+e;
+		}
+	}
+}
+
+// a box is fully behind a plane iff the plane distance of its center plus its extent projected onto the absolute normal is negative
+template<class P>
+size_t cullAABBs(const float* planes, const size_t planeCount, const float* boxes, const size_t count, uint8_t* outVisible)
+{
+	using reg_t = typename P::reg_t;
+	constexpr size_t Stride = 6ull;
+	const reg_t half = P::set1(0.5f);
+	const reg_t zero = P::set1(0.f);
+
+	size_t visibleCount = 0ull;
+	size_t i = 0ull;
+	for (; i+P::Width<=count; i+=P::Width)
+	{
+		const float* box = boxes+i*Stride;
+		reg_t center[3],extent[3];
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			const reg_t mn = P::load(box+c,Stride);
+			const reg_t mx = P::load(box+3u+c,Stride);
+			center[c] = P::mul(P::add(mn,mx),half);
+			extent[c] = P::mul(P::sub(mx,mn),half);
+		}
+		auto culled = P::noneMask();
+		for (size_t p=0ull; p<planeCount; p++)
+		{
+			const float* plane = planes+p*4ull;
+			const reg_t nx = P::set1(plane[0]);
+			const reg_t ny = P::set1(plane[1]);
+			const reg_t nz = P::set1(plane[2]);
+			const reg_t dist = P::fmadd(nx,center[0],P::fmadd(ny,center[1],P::fmadd(nz,center[2],P::set1(plane[3]))));
+			const reg_t radius = P::fmadd(P::abs(nx),extent[0],P::fmadd(P::abs(ny),extent[1],P::mul(P::abs(nz),extent[2])));
+			culled = P::maskOr(culled,P::cmplt(P::add(dist,radius),zero));
+		}
+		const uint32_t culledBits = P::maskBits(culled);
+		for (uint32_t l=0u; l<P::Width; l++)
+		{
+			const bool visible = !((culledBits>>l)&0x1u);
+			if (outVisible)
+				outVisible[i+l] = visible;
+			visibleCount += visible;
+		}
+	}
+	for (; i<count; i++)
+	{
+		const float* box = boxes+i*Stride;
+		bool visible = true;
+		for (size_t p=0ull; visible&&p<planeCount; p++)
+		{
+			const float* plane = planes+p*4ull;
+			float d = plane[3];
+			for (uint32_t c=0u; c<3u; c++)
+			{
+				const float center = (box[c]+box[3u+c])*0.5f;
+				const float extent = (box[3u+c]-box[c])*0.5f;
+				d += plane[c]*center+(plane[c]<0.f ? -plane[c]:plane[c])*extent;
+			}
+			visible = !(d<0.f);
+		}
+		if (outVisible)
+			outVisible[i] = visible;
+		visibleCount += visible;
+	}
+	return visibleCount;
+}
+
+// processes up to 8 directions per pass over the points, so the common case (OBB candidate axes) reads the points once
+template<class P>
+void extremalPoints(
+	const float* x, const float* y, const float* z, const size_t stride, const size_t count,
+	const float* dirs, const size_t dirCount, uint32_t* outMinIx, uint32_t* outMaxIx
+)
+{
+	using reg_t = typename P::reg_t;
+	using ireg_t = typename P::ireg_t;
+	constexpr size_t MaxDirsPerPass = 8ull;
+	for (size_t d0=0ull; d0<dirCount; d0+=MaxDirsPerPass)
+	{
+		const size_t n = dirCount-d0<MaxDirsPerPass ? (dirCount-d0):MaxDirsPerPass;
+		reg_t dir[MaxDirsPerPass][3];
+		reg_t bestMin[MaxDirsPerPass],bestMax[MaxDirsPerPass];
+		ireg_t bestMinIx[MaxDirsPerPass],bestMaxIx[MaxDirsPerPass];
+		for (size_t k=0ull; k<n; k++)
+		{
+			for (uint32_t c=0u; c<3u; c++)
+				dir[k][c] = P::set1(dirs[(d0+k)*4ull+c]);
+			bestMin[k] = P::set1(FloatMax);
+			bestMax[k] = P::set1(-FloatMax);
+			bestMinIx[k] = bestMaxIx[k] = P::iset1(0u);
+		}
+
+		size_t i = 0ull;
+		ireg_t ix = P::iota();
+		for (; i+P::Width<=count; i+=P::Width)
+		{
+			const reg_t px = P::load(x+i*stride,stride);
+			const reg_t py = P::load(y+i*stride,stride);
+			const reg_t pz = P::load(z+i*stride,stride);
+			for (size_t k=0ull; k<n; k++)
+			{
+				const reg_t proj = P::fmadd(dir[k][0],px,P::fmadd(dir[k][1],py,P::mul(dir[k][2],pz)));
+				// strict comparisons keep the earliest index within a lane
+				const auto less = P::cmplt(proj,bestMin[k]);
+				bestMin[k] = P::blend(less,bestMin[k],proj);
+				bestMinIx[k] = P::iblend(less,bestMinIx[k],ix);
+				const auto greater = P::cmplt(bestMax[k],proj);
+				bestMax[k] = P::blend(greater,bestMax[k],proj);
+				bestMaxIx[k] = P::iblend(greater,bestMaxIx[k],ix);
+			}
+			ix = P::iadd(ix,P::Width);
+		}
+
+		for (size_t k=0ull; k<n; k++)
+		{
+			alignas(64) float lanesMin[P::Width];
+			alignas(64) float lanesMax[P::Width];
+			alignas(64) uint32_t lanesMinIx[P::Width];
+			alignas(64) uint32_t lanesMaxIx[P::Width];
+			P::store(lanesMin,1u,bestMin[k]);
+			P::store(lanesMax,1u,bestMax[k]);
+			P::storeIndices(lanesMinIx,bestMinIx[k]);
+			P::storeIndices(lanesMaxIx,bestMaxIx[k]);
+			float mn = lanesMin[0];
+			float mx = lanesMax[0];
+			uint32_t mnIx = lanesMinIx[0];
+			uint32_t mxIx = lanesMaxIx[0];
+			for (uint32_t l=1u; l<P::Width; l++)
+			{
+				if (lanesMin[l]<mn || (lanesMin[l]==mn&&lanesMinIx[l]<mnIx))
+				{
+					mn = lanesMin[l];
+					mnIx = lanesMinIx[l];
+				}
+				if (lanesMax[l]>mx || (lanesMax[l]==mx&&lanesMaxIx[l]<mxIx))
+				{
+					mx = lanesMax[l];
+					mxIx = lanesMaxIx[l];
+				}
+			}
+			const float* d = dirs+(d0+k)*4ull;
+			for (size_t j=i; j<count; j++)
+			{
+				const float proj = d[0]*x[j*stride]+d[1]*y[j*stride]+d[2]*z[j*stride];
+				if (proj<mn)
+				{
+					mn = proj;
+					mnIx = uint32_t(j);
+				}
+				if (proj>mx)
+				{
+					mx = proj;
+					mxIx = uint32_t(j);
+				}
+			}
+			outMinIx[d0+k] = mnIx;
+			outMaxIx[d0+k] = mxIx;
+		}
+	}
+}
+
+// Per direction `v` with largest component `v[m]`, candidates are the integer vectors `c` with `c[m]=n` for every `n` in [1,maxComponent]
+// and the other components rounded down or up from `n*v/v[m]`, same as `asset::CDirQuantCacheBase::findBestFit`.
+// With `f=v/v[m]` and the rounding residuals `e=c-n*f` (note `e[m]=0`), Lagrange's identity gives
+//		|c x f|^2 = e[a]^2 + e[b]^2 + (e[a]*f[b]-e[b]*f[a])^2
+// so the squared sine of the angle to `v` is that over |c|^2|f|^2. Minimizing it needs no square roots or divisions, and unlike the
+// cosine it doesn't round to 1 in single precision at 16 bits. Nothing in here is fused, so every ISA rounds every step identically.
+template<class P>
+void bestFitDirections(const float* dirs, const size_t count, const uint32_t maxComponent, float* out)
+{
+	using reg_t = typename P::reg_t;
+	constexpr size_t Stride = 4ull;
+	const reg_t one = P::set1(1.f);
+	const reg_t zero = P::set1(0.f);
+	const reg_t maxComp = P::set1(float(maxComponent));
+	const reg_t invalid = P::set1(FloatMax);
+
+	auto fitPack = [&](const float* in, float* dst) -> void
+	{
+		const reg_t x = P::abs(P::load(in,Stride));
+		const reg_t y = P::abs(P::load(in+1u,Stride));
+		const reg_t z = P::abs(P::load(in+2u,Stride));
+		// first largest component wins ties, `a` and `b` are the other two in order
+		const auto isY = P::cmplt(x,y);
+		const reg_t maxXY = P::blend(isY,x,y);
+		const auto isZ = P::cmplt(maxXY,z);
+		const auto notX = P::maskOr(isY,isZ);
+		const reg_t maxDir = P::blend(isZ,maxXY,z);
+		// zero length gives NaNs which never compare as better, so the result stays 0
+		const reg_t a = P::div(P::blend(notX,y,x),maxDir);
+		const reg_t b = P::div(P::blend(isZ,z,y),maxDir);
+
+		// starting with a zero denominator makes the first candidate always win
+		reg_t bestNum = one;
+		reg_t bestDen = zero;
+		reg_t bestN = zero;
+		reg_t bestA = zero;
+		reg_t bestB = zero;
+		// strict comparison and descending `n` prefer the longest of equally good vectors, like the scalar search
+		auto evaluate = [&](const reg_t num, const reg_t den, const reg_t n, const reg_t pa, const reg_t pb) -> void
+		{
+			const auto better = P::cmplt(P::mul(num,bestDen),P::mul(bestNum,den));
+			bestNum = P::blend(better,bestNum,num);
+			bestDen = P::blend(better,bestDen,den);
+			bestN = P::blend(better,bestN,n);
+			bestA = P::blend(better,bestA,pa);
+			bestB = P::blend(better,bestB,pb);
+		};
+		reg_t n = maxComp;
+		for (uint32_t i=maxComponent; i; i--)
+		{
+			const reg_t pa0 = P::floor(P::mul(n,a));
+			const reg_t pb0 = P::floor(P::mul(n,b));
+			const reg_t pa1 = P::add(pa0,one);
+			const reg_t pb1 = P::add(pb0,one);
+			// residuals of rounding down are in (-1,0]
+			// NOTE: no fused ops in here, rounding differently on different ISAs would make near ties resolve differently and the caches machine dependent
+			const reg_t ea0 = P::sub(pa0,P::mul(n,a));
+			const reg_t eb0 = P::sub(pb0,P::mul(n,b));
+			const reg_t ea1 = P::add(ea0,one);
+			const reg_t eb1 = P::add(eb0,one);
+			const reg_t cross00 = P::sub(P::mul(ea0,b),P::mul(eb0,a));
+			const reg_t cross10 = P::add(cross00,b);
+			const reg_t cross01 = P::sub(cross00,a);
+			const reg_t cross11 = P::sub(cross10,a);
+
+			const reg_t ea0Sq = P::mul(ea0,ea0);
+			const reg_t eb0Sq = P::mul(eb0,eb0);
+			// rounding up past the largest representable value is not an option
+			const reg_t ea1Sq = P::blend(P::cmplt(maxComp,pa1),P::mul(ea1,ea1),invalid);
+			const reg_t eb1Sq = P::blend(P::cmplt(maxComp,pb1),P::mul(eb1,eb1),invalid);
+			const reg_t nSq = P::mul(n,n);
+			const reg_t pa0Sq = P::mul(pa0,pa0);
+			const reg_t pb0Sq = P::mul(pb0,pb0);
+			const reg_t pa1Sq = P::mul(pa1,pa1);
+			const reg_t pb1Sq = P::mul(pb1,pb1);
+			evaluate(P::add(P::mul(cross00,cross00),P::add(ea0Sq,eb0Sq)),P::add(nSq,P::add(pa0Sq,pb0Sq)),n,pa0,pb0);
+			evaluate(P::add(P::mul(cross10,cross10),P::add(ea1Sq,eb0Sq)),P::add(nSq,P::add(pa1Sq,pb0Sq)),n,pa1,pb0);
+			evaluate(P::add(P::mul(cross01,cross01),P::add(ea0Sq,eb1Sq)),P::add(nSq,P::add(pa0Sq,pb1Sq)),n,pa0,pb1);
+			evaluate(P::add(P::mul(cross11,cross11),P::add(ea1Sq,eb1Sq)),P::add(nSq,P::add(pa1Sq,pb1Sq)),n,pa1,pb1);
+			n = P::sub(n,one);
+		}
+
+		// scatter back into the original component order
+		P::store(dst,Stride,P::blend(notX,bestN,bestA));
+		P::store(dst+1u,Stride,P::blend(isZ,P::blend(isY,bestA,bestN),bestB));
+		P::store(dst+2u,Stride,P::blend(isZ,bestB,bestN));
+		P::store(dst+3u,Stride,zero);
+	};
+
+	size_t i = 0ull;
+	for (; i+P::Width<=count; i+=P::Width)
+		fitPack(dirs+i*Stride,out+i*Stride);
+	// the tail goes through the same lanes so that a direction's fit doesn't depend on its position in the batch
+	if (i<count)
+	{
+		alignas(64) float inTail[P::Width*Stride] = {};
+		alignas(64) float outTail[P::Width*Stride];
+		const size_t tailFloats = (count-i)*Stride;
+		for (size_t j=0ull; j<tailFloats; j++)
+			inTail[j] = dirs[i*Stride+j];
+		fitPack(inTail,outTail);
+		for (size_t j=0ull; j<tailFloats; j++)
+			out[i*Stride+j] = outTail[j];
+	}
+}
+
+template<class P>
+inline SKernelTable makeKernelTable()
+{
+	return {
+		.transformPoints = &transformPoints<P>,
+		.minMax = &minMax<P>,
+		.transformAABBs = &transformAABBs<P>,
+		.cullAABBs = &cullAABBs<P>,
+		.extremalPoints = &extremalPoints<P>,
+		.bestFitDirections = &bestFitDirections<P>
+	};
+}
+
+}
+}
+
+#endif
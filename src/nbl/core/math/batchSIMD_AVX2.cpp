@@ -0,0 +1,15 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+// compiled with AVX2 and FMA enabled (see src/nbl/CMakeLists.txt), don't include anything but the kernels here!
+#include "batchSIMDKernels.h"
+
+#ifndef __AVX2__
+#error "This translation unit needs to be compiled with AVX2 and FMA enabled!"
+#endif
+
+nbl::core::batch::impl::SKernelTable nbl::core::batch::impl::getKernelTableAVX2()
+{
+	return makeKernelTable<PackAVX2>();
+}
@@ -118,12 +118,16 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
             break;
         case CElementBSDF::MASK:
             ir_node = ir->allocNode<IR::COpacityNode>();
+            if (!ir_node)
+                return nullptr;
             ir_node->children.count = 1u;
             getSpectrumOrTexture(_bsdf->mask.opacity,static_cast<IR::COpacityNode*>(ir_node)->opacity,EIVS_BLEND_WEIGHT);
             break;
         case CElementBSDF::DIFFUSE:
         case CElementBSDF::ROUGHDIFFUSE:
             ir_node = ir->allocNode<IR::CMicrofacetDiffuseBSDFNode>();
+            if (!ir_node)
+                return nullptr;
             getSpectrumOrTexture(_bsdf->diffuse.reflectance, static_cast<IR::CMicrofacetDiffuseBSDFNode*>(ir_node)->reflectance);
             if (type == CElementBSDF::ROUGHDIFFUSE)
             {
@@ -139,6 +143,8 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::ROUGHCONDUCTOR:
         {
             ir_node = ir->allocNode<IR::CMicrofacetSpecularBSDFNode>();
+            if (!ir_node)
+                return nullptr;
             auto* node = static_cast<IR::CMicrofacetSpecularBSDFNode*>(ir_node);
             node->shadowing = IR::CMicrofacetSpecularBSDFNode::EST_SMITH;
             const float extEta = _bsdf->conductor.extEta;
@@ -163,6 +169,8 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::DIFFUSE_TRANSMITTER:
         {
             ir_node = ir->allocNode<IR::CMicrofacetDifftransBSDFNode>();
+            if (!ir_node)
+                return nullptr;
             auto* node = static_cast<IR::CMicrofacetDifftransBSDFNode*>(ir_node);
             node->setSmooth();
 
@@ -173,11 +181,15 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::ROUGHPLASTIC:
         {
             ir_node = ir->allocNode<IR::CMicrofacetCoatingBSDFNode>();
+            if (!ir_node)
+                return nullptr;
             auto* coat = static_cast<IR::CMicrofacetCoatingBSDFNode*>(ir_node);
             coat->children.count = 1u;
 
             auto& coated = ir_node->children[0];
             coated = ir->allocNode<IR::CMicrofacetDiffuseBSDFNode>();
+            if (!coated)
+                return nullptr;
 
             const float eta = _bsdf->plastic.intIOR/_bsdf->plastic.extIOR;
 
@@ -206,6 +218,8 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::ROUGHDIELECTRIC:
         {
             auto* dielectric = ir->allocNode<IR::CMicrofacetDielectricBSDFNode>();
+            if (!dielectric)
+                return nullptr;
             ir_node = dielectric;
 
             const float eta = _bsdf->dielectric.intIOR/_bsdf->dielectric.extIOR;
@@ -235,6 +249,8 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::BUMPMAP:
         {
             ir_node = ir->allocNode<IR::CGeomModifierNode>(IR::CGeomModifierNode::ET_DERIVATIVE);
+            if (!ir_node)
+                return nullptr;
             ir_node->children.count = 1u;
 
             auto* node = static_cast<IR::CGeomModifierNode*>(ir_node);
@@ -249,6 +265,8 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::ROUGHCOATING:
         {
             ir_node = ir->allocNode<IR::CMicrofacetCoatingBSDFNode>();
+            if (!ir_node)
+                return nullptr;
             ir_node->children.count = 1u;
 
             const float eta = _bsdf->dielectric.intIOR/_bsdf->dielectric.extIOR;
@@ -282,6 +300,8 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::BLEND_BSDF:
         {
             ir_node = ir->allocNode<IR::CBSDFBlendNode>();
+            if (!ir_node)
+                return nullptr;
             ir_node->children.count = 2u;
 
             auto* node = static_cast<IR::CBSDFBlendNode*>(ir_node);
@@ -301,6 +321,8 @@ auto CMitsubaMaterialCompilerFrontend::getErrorTexture() const -> tex_ass_type
         case CElementBSDF::MIXTURE_BSDF:
         {
             ir_node = ir->allocNode<IR::CBSDFMixNode>();
+            if (!ir_node)
+                return nullptr;
             auto* node = static_cast<IR::CBSDFMixNode*>(ir_node);
             const size_t cnt = _bsdf->mixturebsdf.childCount;
             ir_node->children.count = cnt;
@@ -405,6 +427,8 @@ auto CMitsubaMaterialCompilerFrontend::compileToIRTree(asset::material_compiler:
             {
                 auto* dielectric = static_cast<const IR::CMicrofacetDielectricBSDFNode*>(bsdf);
                 auto* copy = static_cast<IR::CMicrofacetDielectricBSDFNode*>(ir->copyNode(front));
+                if (!copy)
+                    return nullptr;
                 if (!copy->thin) //we're always outside in case of thin dielectric
                     copy->eta = IRNode::color_t(1.f) / copy->eta;
 
@@ -418,6 +442,8 @@ auto CMitsubaMaterialCompilerFrontend::compileToIRTree(asset::material_compiler:
         {
             // black diffuse otherwise
             auto* invalid = ir->allocNode<IR::CMicrofacetDiffuseBSDFNode>();
+            if (!invalid)
+                return nullptr;
             invalid->setSmooth();
             invalid->reflectance = IR::INode::color_t(0.f);
 
@@ -440,6 +466,11 @@ auto CMitsubaMaterialCompilerFrontend::compileToIRTree(asset::material_compiler:
             dst = const_cast<IRNode**>(&node_parent(node, bfs)->ir_node->children[node.child_num]);
 
         node.ir_node = *dst = createIRNode(ir, node.bsdf, logger);
+        if (!node.ir_node)
+        {
+            logger.log("Failed to create the material compiler IR node of BSDF %s!", system::ILogger::ELL_ERROR, node.bsdf->id.c_str());
+            return { nullptr,nullptr };
+        }
     }
     IRNode* backroot = nullptr;
     for (uint32_t i = 0u; i < bfs.size(); ++i)
@@ -461,6 +492,11 @@ auto CMitsubaMaterialCompilerFrontend::compileToIRTree(asset::material_compiler:
             else
                 ir_node = createIRNode(ir, node.bsdf, logger);
         }
+        if (!ir_node)
+        {
+            logger.log("Failed to create the material compiler IR node of BSDF %s!", system::ILogger::ELL_ERROR, node.bsdf->id.c_str());
+            return { nullptr,nullptr };
+        }
         node.ir_node = ir_node;
 
         IRNode** dst = nullptr;
@@ -472,8 +508,9 @@ auto CMitsubaMaterialCompilerFrontend::compileToIRTree(asset::material_compiler:
         *dst = ir_node;
     }
 
-    ir->addRootNode(frontroot);
-    ir->addRootNode(backroot);
+    // identical material trees get hash-consed into the same roots
+    frontroot = ir->addRootNode(frontroot);
+    backroot = ir->addRootNode(backroot);
 
     return { frontroot, backroot };
 }
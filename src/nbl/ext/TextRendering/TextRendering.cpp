@@ -6,9 +6,8 @@ using namespace nbl::video;
 #include "nabla.h"
 #include <nbl/ext/TextRendering/TextRendering.h>
 
-// TODO sticking to using this library?
-// #define STB_RECT_PACK_IMPLEMENTATION
-//#include <nbl/ext/TextRendering/stb_rect_pack.h>
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <nbl/ext/TextRendering/stb_rect_pack.h>
 
 namespace nbl
 {
@@ -50,9 +49,9 @@ void TextRenderer::generateShapeMSDF(
 	float32_t pxRange = msdfPixelRange / (min(scale.x, scale.y));
 	msdfgen::generateMTSDF(msdfMap, glyph, pxRange, { scale.x, scale.y }, { translate.x, translate.y });
 
-	for (int y = 0; y < msdfExtents.x; ++y)
+	for (int y = 0; y < msdfExtents.y; ++y)
 	{
-		for (int x = 0; x < msdfExtents.y; ++x)
+		for (int x = 0; x < msdfExtents.x; ++x)
 		{
 			auto pixel = msdfMap(x, msdfExtents.y - 1 - y);
 			data[offset + (x + y * msdfExtents.x) * 4 + 0] = floatToSNORM8(pixel[0]);
@@ -235,6 +234,346 @@ msdfgen::Shape FontFace::generateGlyphShape(uint32_t glyphId)
 	return shape;
 }
 
+core::smart_refctd_ptr<ICPUImage> FontAtlas::createPages(uint32_t2 pageExtents, uint32_t pageCount)
+{
+	ICPUImage::SCreationParams imgParams;
+	{
+		imgParams.flags = static_cast<ICPUImage::E_CREATE_FLAGS>(0u); // no flags
+		imgParams.type = ICPUImage::ET_2D;
+		imgParams.format = TextRenderer::MSDFTextureFormat;
+		imgParams.extent = { pageExtents.x, pageExtents.y, 1 };
+		imgParams.mipLevels = 1u;
+		imgParams.arrayLayers = pageCount;
+		imgParams.samples = ICPUImage::ESCF_1_BIT;
+	}
+
+	const size_t pageSize = size_t(pageExtents.x) * pageExtents.y * sizeof(int8_t) * 4;
+	auto image = ICPUImage::create(std::move(imgParams));
+	auto buffer = core::make_smart_refctd_ptr<ICPUBuffer>(pageSize * pageCount);
+	// SNORM 127 is as far outside of any glyph as it gets
+	memset(buffer->getPointer(), 127, buffer->getSize());
+
+	auto regions = core::make_refctd_dynamic_array<core::smart_refctd_dynamic_array<IImage::SBufferCopy>>(1u);
+	auto& region = regions->front();
+	region.bufferOffset = 0ull;
+	region.bufferRowLength = pageExtents.x;
+	region.bufferImageHeight = pageExtents.y;
+	region.imageSubresource.aspectMask = asset::IImage::E_ASPECT_FLAGS::EAF_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0u;
+	region.imageSubresource.baseArrayLayer = 0u;
+	region.imageSubresource.layerCount = pageCount;
+	region.imageOffset = { 0u,0u,0u };
+	region.imageExtent = { pageExtents.x, pageExtents.y, 1u };
+	image->setBufferAndRegions(std::move(buffer), std::move(regions));
+
+	return image;
+}
+
+core::smart_refctd_ptr<FontAtlas> FontAtlas::create(FontFace* face, const SCreationParams& params)
+{
+	if (!face || params.pixelsPerEm <= 0.f || params.pageExtents.x == 0u || params.pageExtents.y == 0u)
+		return nullptr;
+
+	struct SPendingGlyph
+	{
+		wchar_t codepoint;
+		SGlyph glyph;
+		msdfgen::Shape shape;
+		float32_t2 translate;
+	};
+	core::vector<SPendingGlyph> pending;
+	pending.reserve(params.codepoints.size());
+
+	const float32_t scale = params.pixelsPerEm / float32_t(face->getFreetypeFace()->units_per_EM * FreeTypeFontScaling);
+	const float32_t range = float32_t(params.msdfPixelRange);
+	// FreeType faces aren't thread safe, so the outlines get extracted up front
+	for (const wchar_t codepoint : params.codepoints)
+	{
+		const uint32_t glyphIndex = face->getGlyphIndex(codepoint);
+		if (glyphIndex == 0u || glyphIndex == FontFace::InvalidGlyphIndex)
+			continue;
+
+		auto& entry = pending.emplace_back();
+		entry.codepoint = codepoint;
+		entry.glyph = {};
+		entry.glyph.glyphIndex = glyphIndex;
+		entry.shape = face->generateGlyphShape(glyphIndex);
+		if (entry.shape.contours.empty())
+			continue;
+
+		const auto bounds = entry.shape.getBounds();
+		// the distance field needs `msdfPixelRange` texels of margin around the outline on every side
+		const float32_t2 origin = float32_t2(bounds.l, bounds.b) - float32_t2(range / scale);
+		entry.glyph.extents = uint32_t2(
+			uint32_t(std::ceil((bounds.r - bounds.l) * scale + 2.f * range)),
+			uint32_t(std::ceil((bounds.t - bounds.b) * scale + 2.f * range))
+		);
+		entry.glyph.planeBounds = float32_t4(origin, origin + float32_t2(entry.glyph.extents) / scale);
+		entry.translate = -origin;
+	}
+
+	// pack into as many pages as it takes, whatever doesn't fit on the current page carries over to the next one
+	uint32_t pageCount = 0u;
+	{
+		core::vector<stbrp_rect> rects;
+		for (uint32_t i = 0u; i < pending.size(); i++)
+		{
+			const auto& extents = pending[i].glyph.extents;
+			if (extents.x == 0u)
+				continue;
+			if (extents.x > params.pageExtents.x || extents.y > params.pageExtents.y)
+				return nullptr;
+			rects.push_back({ .id = int(i), .w = stbrp_coord(extents.x), .h = stbrp_coord(extents.y) });
+		}
+
+		core::vector<stbrp_node> nodes(params.pageExtents.x);
+		while (!rects.empty())
+		{
+			stbrp_context context;
+			stbrp_init_target(&context, params.pageExtents.x, params.pageExtents.y, nodes.data(), nodes.size());
+			stbrp_pack_rects(&context, rects.data(), rects.size());
+
+			auto unpacked = rects.begin();
+			for (const auto& rect : rects)
+			{
+				if (rect.was_packed)
+				{
+					auto& glyph = pending[rect.id].glyph;
+					glyph.page = pageCount;
+					glyph.offset = uint32_t2(rect.x, rect.y);
+				}
+				else
+					*(unpacked++) = rect;
+			}
+			// nothing fitting on an empty page would otherwise make us spin forever
+			if (unpacked == rects.end())
+				return nullptr;
+			rects.erase(unpacked, rects.end());
+			pageCount++;
+		}
+	}
+
+	auto image = createPages(params.pageExtents, std::max(pageCount, 1u));
+	int8_t* const texels = reinterpret_cast<int8_t*>(image->getBuffer()->getPointer());
+	const size_t pageSize = size_t(params.pageExtents.x) * params.pageExtents.y * 4;
+	// every glyph owns a disjoint rectangle of the atlas, so they can be written without synchronization
+	core::for_each(core::execution::par, pending.begin(), pending.end(), [&](SPendingGlyph& entry) -> void
+		{
+			const auto& glyph = entry.glyph;
+			if (glyph.extents.x == 0u)
+				return;
+
+			auto scratch = core::make_smart_refctd_ptr<ICPUBuffer>(size_t(glyph.extents.x) * glyph.extents.y * 4);
+			size_t scratchOffset = 0ull;
+			face->m_textRenderer->generateShapeMSDF(scratch.get(), &scratchOffset, std::move(entry.shape), range, glyph.extents, float32_t2(scale, scale), entry.translate);
+
+			const int8_t* src = reinterpret_cast<const int8_t*>(scratch->getPointer());
+			int8_t* dst = texels + pageSize * glyph.page + (size_t(glyph.offset.y) * params.pageExtents.x + glyph.offset.x) * 4;
+			for (uint32_t y = 0u; y < glyph.extents.y; y++)
+				memcpy(dst + size_t(y) * params.pageExtents.x * 4, src + size_t(y) * glyph.extents.x * 4, size_t(glyph.extents.x) * 4);
+		}
+	);
+
+	core::unordered_map<wchar_t, SGlyph> glyphs;
+	glyphs.reserve(pending.size());
+	for (const auto& entry : pending)
+		glyphs.emplace(entry.codepoint, entry.glyph);
+	image->getBuffer()->setContentHash(image->getBuffer()->computeContentHash());
+	return core::smart_refctd_ptr<FontAtlas>(new FontAtlas(std::move(glyphs), std::move(image), {}), core::dont_grab);
+}
+
+namespace
+{
+constexpr char FontAtlasCacheMagic[8] = { 'N','B','L','M','S','D','F','A' };
+// bump whenever the baking or the file layout changes
+constexpr uint32_t FontAtlasCacheVersion = 2u;
+
+struct SFontAtlasCacheHeader
+{
+	char magic[8];
+	uint32_t version;
+	// glyphs are stored as raw structs, so a cache written by a build with a different layout must not be read
+	uint32_t glyphRecordSize;
+	uint32_t glyphCount;
+	core::blake3_hash_t cacheKey;
+	uint32_t pageWidth;
+	uint32_t pageHeight;
+	uint32_t pageCount;
+};
+struct SFontAtlasCachedGlyph
+{
+	// `wchar_t` is only 16bit on Windows
+	uint32_t codepoint;
+	FontAtlas::SGlyph glyph;
+};
+static_assert(std::is_trivially_copyable_v<SFontAtlasCachedGlyph>);
+}
+
+std::optional<core::blake3_hash_t> FontAtlas::computeCacheKey(system::ISystem* system, const FontFace* face, const SCreationParams& params)
+{
+	core::blake3_hasher hasher;
+	hasher << FontAtlasCacheVersion;
+	core::smart_refctd_ptr<system::IFile> file;
+	{
+		system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
+		system->createFile(future, face->getPath(), system::IFile::ECF_READ);
+		if (future.wait())
+			future.acquire().move_into(file);
+	}
+	// a key which doesn't cover the font could match an atlas baked from a different font
+	if (!file)
+		return std::nullopt;
+	{
+		core::vector<uint8_t> contents(file->getSize());
+		system::IFile::success_t succ;
+		file->read(succ, contents.data(), 0, contents.size());
+		if (!succ)
+			return std::nullopt;
+		hasher.update(contents.data(), contents.size());
+	}
+	for (const wchar_t codepoint : params.codepoints)
+		hasher << uint32_t(codepoint);
+	hasher << params.pixelsPerEm;
+	hasher << params.msdfPixelRange;
+	hasher << params.pageExtents.x;
+	hasher << params.pageExtents.y;
+	return static_cast<core::blake3_hash_t>(hasher);
+}
+
+core::smart_refctd_ptr<FontAtlas> FontAtlas::create(system::ISystem* system, const system::path& cachePath, FontFace* face, const SCreationParams& params)
+{
+	if (!system || !face)
+		return nullptr;
+
+	const auto cacheKey = computeCacheKey(system, face, params);
+	if (!cacheKey)
+		return create(face, params);
+	if (auto cached = load(system, cachePath, *cacheKey))
+		return cached;
+
+	auto atlas = create(face, params);
+	if (!atlas)
+		return nullptr;
+	atlas->m_cacheKey = *cacheKey;
+	atlas->save(system, cachePath);
+	return atlas;
+}
+
+bool FontAtlas::save(system::ISystem* system, const system::path& cachePath) const
+{
+	if (m_cacheKey == core::blake3_hash_t{})
+		return false;
+
+	core::smart_refctd_ptr<system::IFile> file;
+	{
+		system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
+		system->createFile(future, cachePath, system::IFile::ECF_WRITE);
+		if (!future.wait())
+			return false;
+		future.acquire().move_into(file);
+	}
+	if (!file)
+		return false;
+
+	const auto& imageParams = m_image->getCreationParameters();
+	SFontAtlasCacheHeader header = {};
+	memcpy(header.magic, FontAtlasCacheMagic, sizeof(header.magic));
+	header.version = FontAtlasCacheVersion;
+	header.glyphRecordSize = sizeof(SFontAtlasCachedGlyph);
+	header.glyphCount = m_glyphs.size();
+	header.cacheKey = m_cacheKey;
+	header.pageWidth = imageParams.extent.width;
+	header.pageHeight = imageParams.extent.height;
+	header.pageCount = imageParams.arrayLayers;
+
+	core::vector<SFontAtlasCachedGlyph> glyphs;
+	glyphs.reserve(m_glyphs.size());
+	for (const auto& [codepoint, glyph] : m_glyphs)
+		glyphs.push_back({ uint32_t(codepoint), glyph });
+
+	size_t offset = 0ull;
+	auto write = [&](const void* data, const size_t size) -> bool
+	{
+		system::IFile::success_t succ;
+		file->write(succ, data, offset, size);
+		offset += size;
+		return bool(succ);
+	};
+	const auto* texels = m_image->getBuffer();
+	return write(&header, sizeof(header)) && write(glyphs.data(), glyphs.size() * sizeof(SFontAtlasCachedGlyph)) && write(texels->getPointer(), texels->getSize());
+}
+
+core::smart_refctd_ptr<FontAtlas> FontAtlas::load(system::ISystem* system, const system::path& cachePath, const core::blake3_hash_t& cacheKey)
+{
+	core::smart_refctd_ptr<system::IFile> file;
+	{
+		system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
+		system->createFile(future, cachePath, system::IFile::ECF_READ);
+		if (!future.wait())
+			return nullptr;
+		future.acquire().move_into(file);
+	}
+	if (!file)
+		return nullptr;
+
+	size_t offset = 0ull;
+	auto read = [&](void* data, const size_t size) -> bool
+	{
+		system::IFile::success_t succ;
+		file->read(succ, data, offset, size);
+		offset += size;
+		return bool(succ);
+	};
+
+	SFontAtlasCacheHeader header;
+	if (!read(&header, sizeof(header)))
+		return nullptr;
+	// stale caches are expected, they simply get rebaked
+	if (memcmp(header.magic, FontAtlasCacheMagic, sizeof(header.magic)) != 0 || header.version != FontAtlasCacheVersion || header.glyphRecordSize != sizeof(SFontAtlasCachedGlyph) || header.cacheKey != cacheKey)
+		return nullptr;
+	if (header.pageWidth == 0u || header.pageHeight == 0u || header.pageCount == 0u)
+		return nullptr;
+
+	// nothing gets allocated before the file is known to be large enough to back it
+	if (file->getSize() < offset)
+		return nullptr;
+	const size_t remainingSize = file->getSize() - offset;
+	const size_t glyphsSize = size_t(header.glyphCount) * sizeof(SFontAtlasCachedGlyph);
+	if (glyphsSize > remainingSize)
+		return nullptr;
+	// texel count is checked with divisions since the product of the header's dimensions can overflow
+	const size_t texelCount = size_t(header.pageWidth) * header.pageHeight;
+	if (texelCount > (remainingSize - glyphsSize) / 4 / header.pageCount)
+		return nullptr;
+	const size_t texelsSize = texelCount * header.pageCount * 4;
+	if (glyphsSize + texelsSize != remainingSize)
+		return nullptr;
+
+	core::vector<SFontAtlasCachedGlyph> cachedGlyphs(header.glyphCount);
+	if (!read(cachedGlyphs.data(), glyphsSize))
+		return nullptr;
+	for (const auto& cached : cachedGlyphs)
+	{
+		const auto& glyph = cached.glyph;
+		if (glyph.extents.x == 0u)
+			continue;
+		if (glyph.page >= header.pageCount || glyph.offset.x + uint64_t(glyph.extents.x) > header.pageWidth || glyph.offset.y + uint64_t(glyph.extents.y) > header.pageHeight)
+			return nullptr;
+	}
+
+	auto image = createPages(uint32_t2(header.pageWidth, header.pageHeight), header.pageCount);
+	auto* texels = image->getBuffer();
+	if (texels->getSize() != texelsSize || !read(texels->getPointer(), texels->getSize()))
+		return nullptr;
+	texels->setContentHash(texels->computeContentHash());
+
+	core::unordered_map<wchar_t, SGlyph> glyphs;
+	glyphs.reserve(cachedGlyphs.size());
+	for (const auto& cached : cachedGlyphs)
+		glyphs.emplace(wchar_t(cached.codepoint), cached.glyph);
+	return core::smart_refctd_ptr<FontAtlas>(new FontAtlas(std::move(glyphs), std::move(image), cacheKey), core::dont_grab);
+}
+
 }
 }
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/scene/CCPUTransformTree.h"
+
+
+using namespace nbl;
+using namespace scene;
+
+
+auto CCPUTransformTree::addNodes(const relative_transform_t* relativeTransforms, const parent_t* parents, const uint32_t count) -> node_t
+{
+	const node_t firstNode = getNodeCount();
+	for (uint32_t i=0u; i<count; i++)
+	{
+		const node_t node = firstNode+i;
+		const parent_t parent = parents ? parents[i]:invalid_node;
+		assert(parent==invalid_node || parent<node);
+
+		// new nodes go at the end, until the next `propagate` sorts them into their levels
+		const uint32_t slot = m_slotToNode.size();
+		m_nodeToSlot.push_back(slot);
+		m_depth.push_back(parent!=invalid_node ? (m_depth[parent]+1u):0u);
+		m_slotToNode.push_back(node);
+		m_parentSlot.push_back(parent!=invalid_node ? m_nodeToSlot[parent]:invalid_node);
+		m_relativeTransforms.push_back(relativeTransforms[i]);
+		m_globalTransforms.emplace_back();
+		if (m_withNormalMatrices)
+			m_normalMatrices.emplace_back();
+		m_dirty.push_back(true);
+	}
+	m_layoutOutdated = m_layoutOutdated || count;
+	return firstNode;
+}
+
+void CCPUTransformTree::sortByDepth()
+{
+	const uint32_t nodeCount = getNodeCount();
+
+	m_levelBegin.clear();
+	for (const auto depth : m_depth)
+	{
+		if (depth>=m_levelBegin.size())
+			m_levelBegin.resize(depth+1u,0u);
+		m_levelBegin[depth]++;
+	}
+	// exclusive prefix sum turns the counts into level offsets
+	uint32_t sum = 0u;
+	for (auto& levelBegin : m_levelBegin)
+	{
+		const uint32_t count = levelBegin;
+		levelBegin = sum;
+		sum += count;
+	}
+	m_levelBegin.push_back(nodeCount);
+
+	core::vector<uint32_t> oldToNewSlot(nodeCount);
+	{
+		core::vector<uint32_t> levelCursor(m_levelBegin.begin(),m_levelBegin.end()-1u);
+		for (uint32_t oldSlot=0u; oldSlot<nodeCount; oldSlot++)
+			oldToNewSlot[oldSlot] = levelCursor[m_depth[m_slotToNode[oldSlot]]]++;
+	}
+
+	auto permute = [&](auto& attribute) -> void
+	{
+		std::remove_reference_t<decltype(attribute)> permuted(attribute.size());
+		for (uint32_t oldSlot=0u; oldSlot<attribute.size(); oldSlot++)
+			permuted[oldToNewSlot[oldSlot]] = attribute[oldSlot];
+		attribute = std::move(permuted);
+	};
+	permute(m_slotToNode);
+	permute(m_parentSlot);
+	permute(m_relativeTransforms);
+	permute(m_globalTransforms);
+	if (m_withNormalMatrices)
+		permute(m_normalMatrices);
+	permute(m_dirty);
+
+	for (auto& parentSlot : m_parentSlot)
+	if (parentSlot!=invalid_node)
+		parentSlot = oldToNewSlot[parentSlot];
+	for (uint32_t slot=0u; slot<nodeCount; slot++)
+		m_nodeToSlot[m_slotToNode[slot]] = slot;
+
+	m_layoutOutdated = false;
+}
+
+auto CCPUTransformTree::encodeNormalMatrix(const global_transform_t& globalTransform) -> normal_matrix_t
+{
+	const auto cofactors = globalTransform.getSub3x3TransposeCofactors();
+	const bool flipped = core::dot(globalTransform.rows[0],cofactors.rows[0]).x<0.f;
+
+	float maxAbs = 0.f;
+	for (auto r=0u; r<3u; r++)
+	for (auto c=0u; c<3u; c++)
+		maxAbs = std::max(maxAbs,std::abs(cofactors.rows[r].pointer[c]));
+	const float rcpScale = (flipped ? -1.f:1.f)/maxAbs;
+	// `m(r,c)` is row `r` and column `c` of the normalized normal matrix, the GLSL encoder indexes it as `m[c][r]`
+	auto m = [&](const uint32_t r, const uint32_t c) -> float
+	{
+		return cofactors.rows[r].pointer[c]*rcpScale;
+	};
+	auto packSnorm2x16 = [](const float x, const float y) -> uint32_t
+	{
+		auto packSnorm = [](const float v) -> uint32_t
+		{
+			return static_cast<uint16_t>(static_cast<int16_t>(std::round(std::clamp(v,-1.f,1.f)*32767.f)));
+		};
+		return packSnorm(x)|(packSnorm(y)<<16u);
+	};
+
+	normal_matrix_t retval;
+	retval.compressedComponents[0] = packSnorm2x16(m(1,0),m(2,0))&0xFFFCFFFCu;
+	retval.compressedComponents[1] = packSnorm2x16(m(0,1),m(1,1))&0xFFFCFFFCu;
+	retval.compressedComponents[2] = packSnorm2x16(m(2,1),m(0,2))&0xFFFCFFFCu;
+	retval.compressedComponents[3] = packSnorm2x16(m(1,2),m(2,2))&0xFFFCFFFCu;
+
+	const uint32_t firstComp = packSnorm2x16(m(0,0),0.f);
+	const uint32_t firstCompParted = (firstComp<<8u)|firstComp;
+	retval.compressedComponents[0] |= firstCompParted&0x00030000u;
+	retval.compressedComponents[1] |= (firstCompParted>>2u)&0x00030003u;
+	retval.compressedComponents[2] |= (firstCompParted>>4u)&0x00030003u;
+	retval.compressedComponents[3] |= (firstCompParted>>6u)&0x00030003u;
+	return retval;
+}
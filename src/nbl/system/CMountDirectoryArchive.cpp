@@ -0,0 +1,268 @@
+#include "nbl/system/CMountDirectoryArchive.h"
+
+#include "nbl/system/ISystem.h"
+
+#if defined(_NBL_PLATFORM_LINUX_) || defined(_NBL_PLATFORM_ANDROID_)
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif defined(_NBL_PLATFORM_WINDOWS_)
+#include "Windows.h"
+#endif
+
+using namespace nbl;
+using namespace nbl::system;
+
+
+struct CMountDirectoryArchive::SWatcher
+{
+#if defined(_NBL_PLATFORM_LINUX_) || defined(_NBL_PLATFORM_ANDROID_)
+	// inotify watches aren't recursive, so every directory gets its own, mapped to the directory path relative to the archive
+	static inline constexpr uint32_t WatchMask = IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_DELETE_SELF|IN_MOVE_SELF|IN_ONLYDIR;
+
+	inline ~SWatcher()
+	{
+		if (fd>=0)
+			close(fd);
+	}
+
+	// dropping the whole instance is the easiest way to get rid of all the watches and any events still queued
+	inline bool reset()
+	{
+		if (fd>=0)
+			close(fd);
+		directories.clear();
+		fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+		return fd>=0;
+	}
+
+	inline bool watch(const path& absolute, const path& relative)
+	{
+		const int wd = inotify_add_watch(fd,absolute.string().c_str(),WatchMask);
+		if (wd<0)
+			return false;
+		directories[wd] = relative;
+		return true;
+	}
+
+	int fd = -1;
+	core::unordered_map<int,path> directories;
+#elif defined(_NBL_PLATFORM_WINDOWS_)
+	inline ~SWatcher()
+	{
+		if (handle!=INVALID_HANDLE_VALUE)
+			FindCloseChangeNotification(handle);
+	}
+
+	HANDLE handle = INVALID_HANDLE_VALUE;
+#endif
+	// false means we're polling
+	bool active = false;
+};
+
+
+namespace
+{
+inline IFileArchive::SFileList::SEntry makeEntry(const path& relative)
+{
+	return IFileArchive::SFileList::SEntry{relative,0xdeadbeefu,0xdeadbeefu,0xdeadbeefu,IFileArchive::EAT_NONE};
+}
+
+// keeps `entries` sorted and free of duplicates
+inline void insertEntry(core::vector<IFileArchive::SFileList::SEntry>& entries, const path& relative)
+{
+	auto entry = makeEntry(relative);
+	const auto found = std::lower_bound(entries.begin(),entries.end(),entry);
+	if (found==entries.end() || found->pathRelativeToArchive!=relative)
+		entries.insert(found,std::move(entry));
+}
+
+inline bool isWithin(const path& item, const path& directory)
+{
+	auto it = item.begin();
+	for (const auto& element : directory)
+	{
+		if (it==item.end() || *it!=element)
+			return false;
+		it++;
+	}
+	return true;
+}
+}
+
+
+CMountDirectoryArchive::CMountDirectoryArchive(path&& _defaultAbsolutePath, system::logger_opt_smart_ptr&& logger, ISystem* system) :
+	IFileArchive(std::move(_defaultAbsolutePath),std::move(logger)), m_system(system), m_watcher(std::make_unique<SWatcher>())
+{
+}
+
+CMountDirectoryArchive::~CMountDirectoryArchive() = default;
+
+
+IFileArchive::SFileList CMountDirectoryArchive::listAssets() const
+{
+	{
+		std::lock_guard lock(m_indexMutex);
+		if (!m_indexValid.load() || !applyChanges())
+			rebuildIndex();
+	}
+	return IFileArchive::listAssets();
+}
+
+
+void CMountDirectoryArchive::rebuildIndex() const
+{
+	// (re)arm the notifications before scanning, so nothing that changes during the scan gets missed
+#if defined(_NBL_PLATFORM_LINUX_) || defined(_NBL_PLATFORM_ANDROID_)
+	m_watcher->active = m_watcher->reset() && m_watcher->watch(m_defaultAbsolutePath,path());
+#elif defined(_NBL_PLATFORM_WINDOWS_)
+	if (m_watcher->handle==INVALID_HANDLE_VALUE)
+		m_watcher->handle = FindFirstChangeNotificationW(m_defaultAbsolutePath.wstring().c_str(),TRUE,FILE_NOTIFY_CHANGE_FILE_NAME|FILE_NOTIFY_CHANGE_DIR_NAME);
+	else if (!FindNextChangeNotification(m_watcher->handle))
+	{
+		FindCloseChangeNotification(m_watcher->handle);
+		m_watcher->handle = INVALID_HANDLE_VALUE;
+	}
+	m_watcher->active = m_watcher->handle!=INVALID_HANDLE_VALUE;
+#endif
+
+	auto new_entries = std::make_shared<core::vector<SFileList::SEntry>>();
+	const auto items = m_system->listItemsInDirectory(m_defaultAbsolutePath);
+	new_entries->reserve(items.size());
+	for (const auto& item : items)
+	{
+		const auto relpath = item.lexically_relative(m_defaultAbsolutePath);
+#if defined(_NBL_PLATFORM_LINUX_) || defined(_NBL_PLATFORM_ANDROID_)
+		std::error_code err;
+		if (m_watcher->active && std::filesystem::is_directory(item,err))
+			m_watcher->active = m_watcher->watch(item,relpath);
+#endif
+		if (item.has_extension())
+			new_entries->push_back(makeEntry(relpath));
+	}
+	setItemList(new_entries);
+
+#if defined(_NBL_PLATFORM_LINUX_) || defined(_NBL_PLATFORM_ANDROID_) || defined(_NBL_PLATFORM_WINDOWS_)
+	// a single watch we failed to add means we can't trust the notifications anymore
+	if (!m_watcher->active && m_lastScan==std::chrono::steady_clock::time_point{})
+		m_logger.log("Could not set up change notifications for mounted directory %s, falling back to polling.",ILogger::ELL_PERFORMANCE,m_defaultAbsolutePath.string().c_str());
+#endif
+	m_lastScan = std::chrono::steady_clock::now();
+	m_indexValid.store(true);
+}
+
+
+bool CMountDirectoryArchive::applyChanges() const
+{
+	if (!m_watcher->active)
+		return std::chrono::steady_clock::now()-m_lastScan<m_pollingInterval;
+
+#if defined(_NBL_PLATFORM_LINUX_) || defined(_NBL_PLATFORM_ANDROID_)
+	// only copy the current list if something actually changed
+	std::shared_ptr<core::vector<SFileList::SEntry>> entries;
+	auto getEntries = [&]() -> core::vector<SFileList::SEntry>&
+	{
+		if (!entries)
+		{
+			const auto current = IFileArchive::listAssets();
+			const auto span = SFileList::span_t(current);
+			entries = std::make_shared<core::vector<SFileList::SEntry>>(span.begin(),span.end());
+		}
+		return *entries;
+	};
+
+	alignas(inotify_event) char buffer[16<<10];
+	while (true)
+	{
+		const auto bytesRead = read(m_watcher->fd,buffer,sizeof(buffer));
+		// `EAGAIN` means there are no more events
+		if (bytesRead<=0)
+			break;
+		for (auto* it=buffer; it<buffer+bytesRead;)
+		{
+			const auto* event = reinterpret_cast<const inotify_event*>(it);
+			it += sizeof(inotify_event)+event->len;
+			// lost events, can't do anything but rescan
+			if (event->mask&IN_Q_OVERFLOW)
+				return false;
+
+			const auto directory = m_watcher->directories.find(event->wd);
+			if (directory==m_watcher->directories.end())
+				continue;
+			const path dirRelative = directory->second;
+			if (event->mask&IN_IGNORED)
+			{
+				m_watcher->directories.erase(directory);
+				if (dirRelative.empty())
+					return false;
+				continue;
+			}
+			// subdirectories going away get handled by the events on their parent
+			if (event->mask&(IN_DELETE_SELF|IN_MOVE_SELF))
+			{
+				if (dirRelative.empty())
+					return false;
+				continue;
+			}
+
+			const path relative = dirRelative/event->name;
+			const bool isDirectory = event->mask&IN_ISDIR;
+			if (event->mask&(IN_CREATE|IN_MOVED_TO))
+			{
+				auto& list = getEntries();
+				if (relative.has_extension())
+					insertEntry(list,relative);
+				if (isDirectory)
+				{
+					// anything created inside before the watch got added will only be picked up by the scan
+					const auto absolute = m_defaultAbsolutePath/relative;
+					if (!m_watcher->watch(absolute,relative))
+						return false;
+					for (const auto& item : m_system->listItemsInDirectory(absolute))
+					{
+						const auto relpath = item.lexically_relative(m_defaultAbsolutePath);
+						std::error_code err;
+						if (std::filesystem::is_directory(item,err) && !m_watcher->watch(item,relpath))
+							return false;
+						if (item.has_extension())
+							insertEntry(list,relpath);
+					}
+				}
+			}
+			else if (event->mask&(IN_DELETE|IN_MOVED_FROM))
+			{
+				auto& list = getEntries();
+				if (isDirectory)
+				{
+					std::erase_if(list,[&](const SFileList::SEntry& entry)->bool{return isWithin(entry.pathRelativeToArchive,relative);});
+					// a directory moved elsewhere keeps its watches, a deleted one will get `IN_IGNORED` anyway
+					if (event->mask&IN_MOVED_FROM)
+					for (auto watched=m_watcher->directories.begin(); watched!=m_watcher->directories.end();)
+					{
+						if (isWithin(watched->second,relative))
+						{
+							inotify_rm_watch(m_watcher->fd,watched->first);
+							watched = m_watcher->directories.erase(watched);
+						}
+						else
+							watched++;
+					}
+				}
+				else
+				{
+					const auto found = std::lower_bound(list.begin(),list.end(),makeEntry(relative));
+					if (found!=list.end() && found->pathRelativeToArchive==relative)
+						list.erase(found);
+				}
+			}
+		}
+	}
+	if (entries)
+		setItemList(entries);
+	return true;
+#elif defined(_NBL_PLATFORM_WINDOWS_)
+	// the handle doesn't tell us what changed, but at least we only rescan when something did
+	return WaitForSingleObject(m_watcher->handle,0)!=WAIT_OBJECT_0;
+#else
+	return true;
+#endif
+}
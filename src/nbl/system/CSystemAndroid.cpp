@@ -16,7 +16,7 @@ using namespace nbl::system;
 CSystemAndroid::CSystemAndroid(ANativeActivity* activity, JNIEnv* jni, const path& APKResourcesPath) :
 	ISystemPOSIX(), m_nativeActivity(activity), m_jniEnv(jni)
 {
-	m_cachedArchiveFiles.insert(APKResourcesPath,core::make_smart_refctd_ptr<CAPKResourcesArchive>(
+	m_mountPoints.insert(APKResourcesPath,core::make_smart_refctd_ptr<CAPKResourcesArchive>(
 		path(APKResourcesPath),
 		nullptr, // for now no logger
 		m_nativeActivity,
@@ -50,19 +50,8 @@ bool ISystem::exists(const system::path& filename, const core::bitflag<IFile::E_
 
 bool ISystem::isPathReadOnly(const system::path& p) const
 {
-    // check all parent subpaths
-    auto curPath = p;
-    while (!curPath.empty() && curPath.parent_path() != curPath)
-    {
-        // then check for presence in an archive
-        auto archives = m_cachedArchiveFiles.findRange(curPath);
-        if (!archives.empty())
-            return true;
-
-        curPath = curPath.parent_path().generic_string();
-    }
-
-    return false;
+    // any archive mounted at `p` or one of its parents
+    return m_mountPoints.forEachMountOf(p,[](const IFileArchive*, const CMountPointTrie::string_view_t) -> bool {return true;});
 }
 
 core::vector<system::path> ISystem::listItemsInDirectory(const system::path& p) const
@@ -72,13 +61,12 @@ core::vector<system::path> ISystem::listItemsInDirectory(const system::path& p)
 
     auto addArchiveItems = [this,&res](const path& archPath, const path& dirPath) -> void
     {
-        const auto archives = m_cachedArchiveFiles.findRange(archPath);
-        for (auto& arch : archives)
+        m_mountPoints.forEachAt(archPath,[&](const IFileArchive* arch) -> void
         {
-            const auto assets = static_cast<IFileArchive::SFileList::range_t>(arch.second->listAssets(std::filesystem::relative(dirPath,archPath)));
+            const auto assets = static_cast<IFileArchive::SFileList::range_t>(arch->listAssets(std::filesystem::relative(dirPath,archPath)));
             for (auto& item : assets)
                 res.push_back(archPath/item.pathRelativeToArchive);
-        }
+        });
     };
 
     std::error_code err;
@@ -255,26 +243,36 @@ core::smart_refctd_ptr<IFileArchive> ISystem::openFileArchive(core::smart_refctd
 
 ISystem::FoundArchiveFile ISystem::findFileInArchive(const system::path& absolutePath) const
 {
-    system::path path = std::filesystem::exists(absolutePath) ? std::filesystem::canonical(absolutePath.parent_path()):absolutePath.parent_path();
-    // going up the directory tree
-    while (!path.empty() && path.parent_path()!=path)
+    FoundArchiveFile retval = {nullptr,{}};
+    auto findInMounts = [&](const system::path& p) -> bool
     {
-        path = std::filesystem::exists(path) ? std::filesystem::canonical(path):path;
-
-        const auto archives = m_cachedArchiveFiles.findRange(path);
-        for (auto& archive : archives)
+        return m_mountPoints.forEachMountOf(p,[&](IFileArchive* archive, const CMountPointTrie::string_view_t relative) -> bool
         {
-            const auto relative = std::filesystem::relative(absolutePath,path);
-            const auto items = static_cast<IFileArchive::SFileList::range_t>(archive.second->listAssets());
-
-            const IFileArchive::SFileList::SEntry itemToFind = { relative };
+            // the archive must be mounted at one of the file's parents
+            if (relative.empty())
+                return false;
+            const IFileArchive::SFileList::SEntry itemToFind = {system::path(relative)};
+            const auto items = static_cast<IFileArchive::SFileList::range_t>(archive->listAssets());
             auto found = std::lower_bound(items.begin(), items.end(), itemToFind);
-            if (found!=items.end() && found->pathRelativeToArchive==relative)
-                return {archive.second.get(),relative};
-        }
-        path = path.parent_path();
+            if (found==items.end() || found->pathRelativeToArchive!=itemToFind.pathRelativeToArchive)
+                return false;
+            retval = {archive,itemToFind.pathRelativeToArchive};
+            return true;
+        });
+    };
+    // mount points are matched lexically, so only touch the real filesystem if that fails,
+    // an existing directory could still be a symlink or a relative path to a mount point
+    if (findInMounts(absolutePath))
+        return retval;
+    std::error_code err;
+    const auto parent = absolutePath.parent_path();
+    if (!parent.empty() && std::filesystem::exists(parent,err))
+    {
+        const auto canonicalPath = std::filesystem::canonical(parent,err)/absolutePath.filename();
+        if (!err && canonicalPath!=absolutePath && findInMounts(canonicalPath))
+            return retval;
     }
-    return { nullptr,{} };
+    return {nullptr,{}};
 }
 
 
@@ -323,17 +321,7 @@ bool ISystem::ICaller::flushMapping(IFile* file, size_t offset, size_t size)
 void ISystem::unmountBuiltins() {
 
     auto removeByKey = [&, this](const char* s) {
-        auto range = m_cachedArchiveFiles.findRange(s);
-
-        std::vector<core::smart_refctd_ptr<IFileArchive>> items_to_remove = {}; //is it always just 1 item?
-        for (auto it = range.begin(); it != range.end(); ++it)
-        {
-            items_to_remove.push_back(it->second);
-        }
-        for (size_t i = 0; i < items_to_remove.size(); i++)
-        {
-            m_cachedArchiveFiles.removeObject(items_to_remove[i], s);
-        }
+        m_mountPoints.removeAll(s);
     };
 
     removeByKey("nbl");
@@ -228,7 +228,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 							event.movementEvent.relativeMovementX = rawMouse.lLastX;
 							event.movementEvent.relativeMovementY = rawMouse.lLastY;
 							event.window = window;
-							auto lk = inputChannel->lockBackgroundBuffer();
 							inputChannel->pushIntoBackground(std::move(event));
 						}
 					}
@@ -241,7 +240,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						auto mousePos = window->getCursorControl()->getPosition();
 						event.clickEvent.clickPosX = mousePos.x;
 						event.clickEvent.clickPosY = mousePos.y;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					else if (rawMouse.usButtonFlags & RI_MOUSE_LEFT_BUTTON_UP)
@@ -253,7 +251,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						auto mousePos = window->getCursorControl()->getPosition();
 						event.clickEvent.clickPosX = mousePos.x;
 						event.clickEvent.clickPosY = mousePos.y;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					if (rawMouse.usButtonFlags & RI_MOUSE_RIGHT_BUTTON_DOWN)
@@ -265,7 +262,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						auto mousePos = window->getCursorControl()->getPosition();
 						event.clickEvent.clickPosX = mousePos.x;
 						event.clickEvent.clickPosY = mousePos.y;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					else if (rawMouse.usButtonFlags & RI_MOUSE_RIGHT_BUTTON_UP)
@@ -277,7 +273,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						auto mousePos = window->getCursorControl()->getPosition();
 						event.clickEvent.clickPosX = mousePos.x;
 						event.clickEvent.clickPosY = mousePos.y;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					if (rawMouse.usButtonFlags & RI_MOUSE_MIDDLE_BUTTON_DOWN)
@@ -289,7 +284,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						auto mousePos = window->getCursorControl()->getPosition();
 						event.clickEvent.clickPosX = mousePos.x;
 						event.clickEvent.clickPosY = mousePos.y;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					else if (rawMouse.usButtonFlags & RI_MOUSE_MIDDLE_BUTTON_UP)
@@ -301,7 +295,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						auto mousePos = window->getCursorControl()->getPosition();
 						event.clickEvent.clickPosX = mousePos.x;
 						event.clickEvent.clickPosY = mousePos.y;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					// TODO other mouse buttons
@@ -313,7 +306,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						event.scrollEvent.verticalScroll = wheelDelta;
 						event.scrollEvent.horizontalScroll = 0;
 						event.window = window;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					else if (rawMouse.usButtonFlags & RI_MOUSE_HWHEEL)
@@ -323,7 +315,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 						event.scrollEvent.verticalScroll = 0;
 						event.scrollEvent.horizontalScroll = wheelDelta;
 						event.window = window;
-						auto lk = inputChannel->lockBackgroundBuffer();
 						inputChannel->pushIntoBackground(std::move(event));
 					}
 					break;
@@ -341,7 +332,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 							event.action = SKeyboardEvent::ECA_PRESSED;
 							event.window = window;
 							event.keyCode = getNablaKeyCodeFromNative(rawKeyboard.VKey);
-							auto lk = inputChannel->lockBackgroundBuffer();
 							inputChannel->pushIntoBackground(std::move(event));
 							break;
 						}
@@ -352,7 +342,6 @@ LRESULT CALLBACK CWindowWin32::WndProc(HWND hWnd, UINT message, WPARAM wParam, L
 							event.action = SKeyboardEvent::ECA_RELEASED;
 							event.window = window;
 							event.keyCode = getNablaKeyCodeFromNative(rawKeyboard.VKey);
-							auto lk = inputChannel->lockBackgroundBuffer();
 							inputChannel->pushIntoBackground(std::move(event));
 							break;
 						}
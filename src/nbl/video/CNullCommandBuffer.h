@@ -0,0 +1,102 @@
+#ifndef _NBL_VIDEO_C_NULL_COMMAND_BUFFER_H_INCLUDED_
+#define _NBL_VIDEO_C_NULL_COMMAND_BUFFER_H_INCLUDED_
+
+#include "nbl/video/IGPUCommandBuffer.h"
+
+namespace nbl::video
+{
+
+//! All the validation, resource tracking and command segment recording of `IGPUCommandBuffer` happens as usual, the backend part is a no-op
+class CNullCommandBuffer final : public IGPUCommandBuffer
+{
+    public:
+        inline CNullCommandBuffer(core::smart_refctd_ptr<const ILogicalDevice>&& logicalDevice, const IGPUCommandPool::BUFFER_LEVEL level,
+            core::smart_refctd_ptr<IGPUCommandPool>&& commandPool, system::logger_opt_smart_ptr&& logger)
+            : IGPUCommandBuffer(std::move(logicalDevice), level, std::move(commandPool), std::move(logger))
+        {}
+
+        inline bool insertDebugMarker(const char* name, const core::vector4df_SIMD& color) override {return true;}
+        inline bool beginDebugMarker(const char* name, const core::vector4df_SIMD& color) override {return true;}
+        inline bool endDebugMarker() override {return true;}
+
+        inline const void* getNativeHandle() const override {return this;}
+
+    private:
+        inline void checkForParentPoolReset_impl() const override {}
+
+        inline bool begin_impl(const core::bitflag<USAGE> flags, const SInheritanceInfo* inheritanceInfo) override {return true;}
+        inline bool end_impl() override {return true;}
+
+        inline bool setEvent_impl(IEvent* const _event, const SEventDependencyInfo& depInfo) override {return true;}
+        inline bool resetEvent_impl(IEvent* const _event, const core::bitflag<stage_flags_t> stageMask) override {return true;}
+        inline bool waitEvents_impl(const std::span<IEvent*> events, const SEventDependencyInfo* depInfos) override {return true;}
+        inline bool pipelineBarrier_impl(const core::bitflag<asset::E_DEPENDENCY_FLAGS> dependencyFlags, const SPipelineBarrierDependencyInfo& depInfo) override {return true;}
+
+        inline bool fillBuffer_impl(const asset::SBufferRange<IGPUBuffer>& range, const uint32_t data) override {return true;}
+        inline bool updateBuffer_impl(const asset::SBufferRange<IGPUBuffer>& range, const void* const pData) override {return true;}
+        inline bool copyBuffer_impl(const IGPUBuffer* const srcBuffer, IGPUBuffer* const dstBuffer, const uint32_t regionCount, const SBufferCopy* const pRegions) override {return true;}
+
+        inline bool clearColorImage_impl(IGPUImage* const image, const IGPUImage::LAYOUT imageLayout, const SClearColorValue* const pColor, const uint32_t rangeCount, const IGPUImage::SSubresourceRange* const pRanges) override {return true;}
+        inline bool clearDepthStencilImage_impl(IGPUImage* const image, const IGPUImage::LAYOUT imageLayout, const SClearDepthStencilValue* const pDepthStencil, const uint32_t rangeCount, const IGPUImage::SSubresourceRange* const pRanges) override {return true;}
+        inline bool copyBufferToImage_impl(const IGPUBuffer* const srcBuffer, IGPUImage* const dstImage, const IGPUImage::LAYOUT dstImageLayout, const uint32_t regionCount, const IGPUImage::SBufferCopy* const pRegions) override {return true;}
+        inline bool copyImageToBuffer_impl(const IGPUImage* const srcImage, const IGPUImage::LAYOUT srcImageLayout, const IGPUBuffer* const dstBuffer, const uint32_t regionCount, const IGPUImage::SBufferCopy* const pRegions) override {return true;}
+        inline bool copyImage_impl(const IGPUImage* const srcImage, const IGPUImage::LAYOUT srcImageLayout, IGPUImage* const dstImage, const IGPUImage::LAYOUT dstImageLayout, const uint32_t regionCount, const IGPUImage::SImageCopy* const pRegions) override {return true;}
+
+        inline bool buildAccelerationStructures_impl(const std::span<const IGPUBottomLevelAccelerationStructure::DeviceBuildInfo> infos, const IGPUBottomLevelAccelerationStructure::BuildRangeInfo* const* const ppBuildRangeInfos, const uint32_t totalGeometryCount) override {return true;}
+        inline bool buildAccelerationStructures_impl(const std::span<const IGPUTopLevelAccelerationStructure::DeviceBuildInfo> infos, const IGPUTopLevelAccelerationStructure::BuildRangeInfo* const pBuildRangeInfos) override {return true;}
+        inline bool buildAccelerationStructuresIndirect_impl(const IGPUBuffer* indirectRangeBuffer, const std::span<const IGPUBottomLevelAccelerationStructure::DeviceBuildInfo> infos, const uint64_t* const pIndirectOffsets, const uint32_t* const pIndirectStrides, const uint32_t* const* const ppMaxPrimitiveCounts, const uint32_t totalGeometryCount) override {return true;}
+        inline bool buildAccelerationStructuresIndirect_impl(const IGPUBuffer* indirectRangeBuffer, const std::span<const IGPUTopLevelAccelerationStructure::DeviceBuildInfo> infos, const uint64_t* const pIndirectOffsets, const uint32_t* const pIndirectStrides, const uint32_t* const pMaxInstanceCounts) override {return true;}
+
+        inline bool copyAccelerationStructure_impl(const IGPUAccelerationStructure::CopyInfo& copyInfo) override {return true;}
+        inline bool copyAccelerationStructureToMemory_impl(const IGPUAccelerationStructure::DeviceCopyToMemoryInfo& copyInfo) override {return true;}
+        inline bool copyAccelerationStructureFromMemory_impl(const IGPUAccelerationStructure::DeviceCopyFromMemoryInfo& copyInfo) override {return true;}
+
+        inline bool bindComputePipeline_impl(const IGPUComputePipeline* const pipeline) override {return true;}
+        inline bool bindGraphicsPipeline_impl(const IGPUGraphicsPipeline* const pipeline) override {return true;}
+        inline bool bindDescriptorSets_impl(const asset::E_PIPELINE_BIND_POINT pipelineBindPoint, const IGPUPipelineLayout* const layout, const uint32_t firstSet, const uint32_t descriptorSetCount, const IGPUDescriptorSet* const* const pDescriptorSets, const uint32_t dynamicOffsetCount, const uint32_t* const dynamicOffsets) override {return true;}
+        inline bool pushConstants_impl(const IGPUPipelineLayout* const layout, const core::bitflag<IGPUShader::E_SHADER_STAGE> stageFlags, const uint32_t offset, const uint32_t size, const void* const pValues) override {return true;}
+        inline bool bindVertexBuffers_impl(const uint32_t firstBinding, const uint32_t bindingCount, const asset::SBufferBinding<const IGPUBuffer>* const pBindings) override {return true;}
+        inline bool bindIndexBuffer_impl(const asset::SBufferBinding<const IGPUBuffer>& binding, const asset::E_INDEX_TYPE indexType) override {return true;}
+
+        inline bool setScissor_impl(const uint32_t first, const uint32_t count, const VkRect2D* const pScissors) override {return true;}
+        inline bool setViewport_impl(const uint32_t first, const uint32_t count, const asset::SViewport* const pViewports) override {return true;}
+        inline bool setLineWidth_impl(const float width) override {return true;}
+        inline bool setDepthBias_impl(const float depthBiasConstantFactor, const float depthBiasClamp, const float depthBiasSlopeFactor) override {return true;}
+        inline bool setBlendConstants_impl(const hlsl::float32_t4& constants) override {return true;}
+        inline bool setDepthBounds_impl(const float minDepthBounds, const float maxDepthBounds) override {return true;}
+        inline bool setStencilCompareMask_impl(const asset::E_FACE_CULL_MODE faces, const uint8_t compareMask) override {return true;}
+        inline bool setStencilWriteMask_impl(const asset::E_FACE_CULL_MODE faces, const uint8_t writeMask) override {return true;}
+        inline bool setStencilReference_impl(const asset::E_FACE_CULL_MODE faces, const uint8_t reference) override {return true;}
+
+        inline bool resetQueryPool_impl(IQueryPool* const queryPool, const uint32_t firstQuery, const uint32_t queryCount) override {return true;}
+        inline bool beginQuery_impl(IQueryPool* const queryPool, const uint32_t query, const core::bitflag<QUERY_CONTROL_FLAGS> flags) override {return true;}
+        inline bool endQuery_impl(IQueryPool* const queryPool, const uint32_t query) override {return true;}
+        inline bool writeTimestamp_impl(const asset::PIPELINE_STAGE_FLAGS pipelineStage, IQueryPool* const queryPool, const uint32_t query) override {return true;}
+        inline bool writeAccelerationStructureProperties_impl(const std::span<const IGPUAccelerationStructure* const> pAccelerationStructures, const IQueryPool::TYPE queryType, IQueryPool* const queryPool, const uint32_t firstQuery) override {return true;}
+        inline bool copyQueryPoolResults_impl(const IQueryPool* const queryPool, const uint32_t firstQuery, const uint32_t queryCount, const asset::SBufferBinding<IGPUBuffer>& dstBuffer, const size_t stride, const core::bitflag<IQueryPool::RESULTS_FLAGS> flags) override {return true;}
+
+        inline bool dispatch_impl(const uint32_t groupCountX, const uint32_t groupCountY, const uint32_t groupCountZ) override {return true;}
+        inline bool dispatchIndirect_impl(const asset::SBufferBinding<const IGPUBuffer>& binding) override {return true;}
+
+        inline bool beginRenderPass_impl(const SRenderpassBeginInfo& info, SUBPASS_CONTENTS contents) override {return true;}
+        inline bool nextSubpass_impl(const SUBPASS_CONTENTS contents) override {return true;}
+        inline bool endRenderPass_impl() override {return true;}
+
+        inline bool clearAttachments_impl(const SClearAttachments& info) override {return true;}
+
+        inline bool draw_impl(const uint32_t vertexCount, const uint32_t instanceCount, const uint32_t firstVertex, const uint32_t firstInstance) override {return true;}
+        inline bool drawIndexed_impl(const uint32_t indexCount, const uint32_t instanceCount, const uint32_t firstIndex, const int32_t vertexOffset, const uint32_t firstInstance) override {return true;}
+        inline bool drawIndirect_impl(const asset::SBufferBinding<const IGPUBuffer>& binding, const uint32_t drawCount, const uint32_t stride) override {return true;}
+        inline bool drawIndexedIndirect_impl(const asset::SBufferBinding<const IGPUBuffer>& binding, const uint32_t drawCount, const uint32_t stride) override {return true;}
+        inline bool drawIndirectCount_impl(const asset::SBufferBinding<const IGPUBuffer>& indirectBinding, const asset::SBufferBinding<const IGPUBuffer>& countBinding, const uint32_t maxDrawCount, const uint32_t stride) override {return true;}
+        inline bool drawIndexedIndirectCount_impl(const asset::SBufferBinding<const IGPUBuffer>& indirectBinding, const asset::SBufferBinding<const IGPUBuffer>& countBinding, const uint32_t maxDrawCount, const uint32_t stride) override {return true;}
+
+        inline bool blitImage_impl(const IGPUImage* const srcImage, const IGPUImage::LAYOUT srcImageLayout, IGPUImage* const dstImage, const IGPUImage::LAYOUT dstImageLayout, const std::span<const SImageBlit> regions, const IGPUSampler::E_TEXTURE_FILTER filter) override {return true;}
+        inline bool resolveImage_impl(const IGPUImage* const srcImage, const IGPUImage::LAYOUT srcImageLayout, IGPUImage* const dstImage, const IGPUImage::LAYOUT dstImageLayout, const uint32_t regionCount, const SImageResolve* pRegions) override {return true;}
+
+        inline bool executeCommands_impl(const uint32_t count, IGPUCommandBuffer* const* const cmdbufs) override {return true;}
+};
+
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef _NBL_VIDEO_C_NULL_COMMAND_POOL_H_INCLUDED_
+#define _NBL_VIDEO_C_NULL_COMMAND_POOL_H_INCLUDED_
+
+#include "nbl/video/IGPUCommandPool.h"
+#include "nbl/video/ILogicalDevice.h"
+#include "nbl/video/CNullCommandBuffer.h"
+
+namespace nbl::video
+{
+
+class CNullCommandPool final : public IGPUCommandPool
+{
+    public:
+        inline CNullCommandPool(core::smart_refctd_ptr<const ILogicalDevice>&& dev, const core::bitflag<IGPUCommandPool::CREATE_FLAGS> flags, const uint32_t queueFamilyIndex)
+            : IGPUCommandPool(std::move(dev), flags, queueFamilyIndex) {}
+
+        inline void trim() override {}
+
+        inline const void* getNativeHandle() const override {return this;}
+
+    private:
+        ~CNullCommandPool() = default;
+
+        inline bool createCommandBuffers_impl(const BUFFER_LEVEL level, const std::span<core::smart_refctd_ptr<IGPUCommandBuffer>> outCmdBufs, core::smart_refctd_ptr<system::ILogger>&& logger) override
+        {
+            if (!logger)
+            {
+                auto debugCB = getOriginDevice()->getPhysicalDevice()->getDebugCallback();
+                if (debugCB)
+                    logger = core::smart_refctd_ptr<system::ILogger>(debugCB->getLogger());
+            }
+            for (auto i=0u; i<outCmdBufs.size(); ++i)
+                outCmdBufs[i] = core::make_smart_refctd_ptr<CNullCommandBuffer>(core::smart_refctd_ptr<const ILogicalDevice>(getOriginDevice()),level,core::smart_refctd_ptr<IGPUCommandPool>(this),core::smart_refctd_ptr(logger));
+            return true;
+        }
+
+        inline bool reset_impl() override {return true;}
+};
+
+}
+#endif
@@ -0,0 +1,101 @@
+#include "nbl/video/CNullConnection.h"
+
+#include "nbl/video/CNullPhysicalDevice.h"
+
+namespace nbl::video
+{
+
+core::smart_refctd_ptr<CNullConnection> CNullConnection::create(
+    core::smart_refctd_ptr<system::ISystem>&& sys, core::smart_refctd_ptr<system::ILogger>&& logger,
+    SCreationParams&& params, const SFeatures& featuresToEnable
+)
+{
+    if (!sys)
+        return nullptr;
+
+    core::smart_refctd_ptr<CNullConnection> api(new CNullConnection(featuresToEnable,std::move(logger)),core::dont_grab);
+
+    IPhysicalDevice::SInitData initData = {};
+    initData.system = std::move(sys);
+    initData.api = api.get();
+
+    // properties
+    initData.properties = params.properties;
+    {
+        auto& props = initData.properties;
+        if (props.apiVersion.major==0u)
+        {
+            props.apiVersion.major = 1u;
+            props.apiVersion.minor = 3u;
+        }
+        if (props.deviceName[0]=='\0')
+        {
+            strcpy(props.deviceName,"Nabla Null Device");
+            props.deviceType = IPhysicalDevice::ET_CPU;
+        }
+        if (props.driverName[0]=='\0')
+            strcpy(props.driverName,"Nabla Null Driver");
+    }
+    initData.features = params.features;
+
+    // memory
+    initData.memoryProperties = params.memoryProperties;
+    if (initData.memoryProperties.memoryTypeCount==0u)
+    {
+        using mem_props_t = IDeviceMemoryAllocation::E_MEMORY_PROPERTY_FLAGS;
+        auto& memProps = initData.memoryProperties;
+        memProps.memoryHeapCount = 2u;
+        memProps.memoryHeaps[0] = {.size=8ull<<30ull,.flags=IDeviceMemoryAllocation::EMHF_DEVICE_LOCAL_BIT};
+        memProps.memoryHeaps[1] = {.size=16ull<<30ull,.flags=IDeviceMemoryAllocation::EMHF_NONE};
+        memProps.memoryTypeCount = 3u;
+        memProps.memoryTypes[0] = {.propertyFlags=mem_props_t::EMPF_DEVICE_LOCAL_BIT,.heapIndex=0u};
+        memProps.memoryTypes[1] = {
+            .propertyFlags=core::bitflag(mem_props_t::EMPF_HOST_READABLE_BIT)|mem_props_t::EMPF_HOST_WRITABLE_BIT|mem_props_t::EMPF_HOST_COHERENT_BIT|mem_props_t::EMPF_HOST_CACHED_BIT,
+            .heapIndex=1u
+        };
+        memProps.memoryTypes[2] = {
+            .propertyFlags=core::bitflag(mem_props_t::EMPF_DEVICE_LOCAL_BIT)|mem_props_t::EMPF_HOST_READABLE_BIT|mem_props_t::EMPF_HOST_WRITABLE_BIT|mem_props_t::EMPF_HOST_COHERENT_BIT,
+            .heapIndex=0u
+        };
+    }
+
+    // queue families
+    if (params.queueFamilies.empty())
+    {
+        IPhysicalDevice::SQueueFamilyProperties qfam = {};
+        qfam.queueFlags = core::bitflag(IQueue::FAMILY_FLAGS::GRAPHICS_BIT)|IQueue::FAMILY_FLAGS::COMPUTE_BIT|IQueue::FAMILY_FLAGS::TRANSFER_BIT|IQueue::FAMILY_FLAGS::SPARSE_BINDING_BIT;
+        qfam.queueCount = 16u;
+        qfam.timestampValidBits = 64u;
+        qfam.minImageTransferGranularity = {1u,1u,1u};
+        params.queueFamilies.push_back(qfam);
+    }
+    initData.qfamProperties = core::make_refctd_dynamic_array<core::smart_refctd_dynamic_array<const IPhysicalDevice::SQueueFamilyProperties>>(params.queueFamilies);
+
+    // format usages
+    if (params.allFormatUsages)
+    {
+        // the usage structs are plain bitfields, so just set every bit
+        for (auto i=0u; i<asset::EF_COUNT; ++i)
+        {
+            auto& linear = initData.linearTilingUsages.m_usages[i];
+            memset(&linear,0xff,sizeof(linear));
+            linear.log2MaxSamples = 6u; // 64 samples, the max Vulkan allows
+            auto& optimal = initData.optimalTilingUsages.m_usages[i];
+            memset(&optimal,0xff,sizeof(optimal));
+            optimal.log2MaxSamples = 6u;
+            auto& buffer = initData.bufferUsages.m_usages[i];
+            memset(&buffer,0xff,sizeof(buffer));
+        }
+    }
+    else
+    {
+        initData.linearTilingUsages = params.linearTilingUsages;
+        initData.optimalTilingUsages = params.optimalTilingUsages;
+        initData.bufferUsages = params.bufferUsages;
+    }
+
+    api->m_physicalDevices.emplace_back(std::make_unique<CNullPhysicalDevice>(std::move(initData)));
+    return api;
+}
+
+}
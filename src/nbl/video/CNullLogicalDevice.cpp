@@ -0,0 +1,188 @@
+#include "nbl/video/CNullLogicalDevice.h"
+
+#include "nbl/video/CThreadSafeQueueAdapter.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace nbl;
+using namespace nbl::video;
+
+
+CNullLogicalDevice::CNullLogicalDevice(core::smart_refctd_ptr<const IAPIConnection>&& api, const IPhysicalDevice* const physicalDevice, const SCreationParams& params)
+    : ILogicalDevice(std::move(api),physicalDevice,params,false)
+{
+    // create actual queue objects
+    for (uint32_t i=0u; i<ILogicalDevice::MaxQueueFamilies; ++i)
+    {
+        const auto& qci = params.queueParams[i];
+        const uint32_t offset = m_queueFamilyInfos[i].firstQueueIndex;
+        const auto flags = qci.flags;
+
+        for (uint32_t j=0u; j<qci.count; ++j)
+        {
+            const float priority = qci.priorities[j];
+
+            auto queue = new CNullQueue(this,i,flags,priority);
+            (*m_queues)[offset+j] = new CThreadSafeQueueAdapter(this,queue);
+        }
+    }
+}
+
+
+ISemaphore::WAIT_RESULT CNullLogicalDevice::waitForSemaphores(const std::span<const ISemaphore::SWaitInfo> infos, const bool waitAll, const uint64_t timeout)
+{
+    using retval_t = ISemaphore::WAIT_RESULT;
+
+    for (const auto& info : infos)
+    if (!IBackendObject::device_compatibility_cast<const CNullSemaphore*>(info.semaphore,this))
+        return retval_t::_ERROR;
+
+    auto satisfied = [&]() -> bool
+    {
+        for (const auto& info : infos)
+        {
+            const bool reached = info.semaphore->getCounterValue()>=info.value;
+            if (reached!=waitAll)
+                return reached;
+        }
+        return waitAll;
+    };
+    // submits complete immediately, so only the host signalling from another thread can make us wait
+    const auto start = std::chrono::steady_clock::now();
+    while (!satisfied())
+    {
+        if (uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-start).count())>=timeout)
+            return retval_t::TIMEOUT;
+        std::this_thread::yield();
+    }
+    return retval_t::SUCCESS;
+}
+
+
+IDeviceMemoryAllocator::SAllocation CNullLogicalDevice::allocate(const SAllocateInfo& info)
+{
+    IDeviceMemoryAllocator::SAllocation ret = {};
+    if (info.memoryTypeIndex>=m_physicalDevice->getMemoryProperties().memoryTypeCount)
+        return ret;
+
+    const core::bitflag<IDeviceMemoryAllocation::E_MEMORY_ALLOCATE_FLAGS> allocateFlags(info.flags);
+    const auto memoryPropertyFlags = m_physicalDevice->getMemoryProperties().memoryTypes[info.memoryTypeIndex].propertyFlags;
+    ret.memory = core::make_smart_refctd_ptr<CNullMemoryAllocation>(this,info.size,allocateFlags,memoryPropertyFlags,info.dedication);
+    ret.offset = 0ull; // LogicalDevice doesn't suballocate, so offset is always 0, if you want to suballocate, write/use an allocator
+    if(info.dedication)
+    {
+        bool dedicationSuccess = false;
+        switch (info.dedication->getObjectType())
+        {
+            case IDeviceMemoryBacked::EOT_BUFFER:
+            {
+                SBindBufferMemoryInfo bindBufferInfo = {};
+                bindBufferInfo.buffer = static_cast<IGPUBuffer*>(info.dedication);
+                bindBufferInfo.binding.memory = ret.memory.get();
+                bindBufferInfo.binding.offset = ret.offset;
+                dedicationSuccess = bindBufferMemory(1u,&bindBufferInfo);
+            }
+                break;
+            case IDeviceMemoryBacked::EOT_IMAGE:
+            {
+                SBindImageMemoryInfo bindImageInfo = {};
+                bindImageInfo.image = static_cast<IGPUImage*>(info.dedication);
+                bindImageInfo.binding.memory = ret.memory.get();
+                bindImageInfo.binding.offset = ret.offset;
+                dedicationSuccess = bindImageMemory(1u,&bindImageInfo);
+            }
+                break;
+        }
+        if(!dedicationSuccess)
+            ret = {};
+    }
+    return ret;
+}
+
+
+bool CNullLogicalDevice::bindBufferMemory_impl(const uint32_t count, const SBindBufferMemoryInfo* pInfos)
+{
+    for (uint32_t i=0u; i<count; ++i)
+    {
+        auto* nullBuffer = static_cast<CNullBuffer*>(pInfos[i].buffer);
+        nullBuffer->setMemoryBinding(pInfos[i].binding);
+        // there's no address space to speak of, but the address must be unique and non-zero
+        if (nullBuffer->getCreationParams().usage.hasFlags(IGPUBuffer::EUF_SHADER_DEVICE_ADDRESS_BIT))
+            nullBuffer->setDeviceAddress(reinterpret_cast<uint64_t>(pInfos[i].binding.memory)+pInfos[i].binding.offset);
+    }
+    return true;
+}
+bool CNullLogicalDevice::bindImageMemory_impl(const uint32_t count, const SBindImageMemoryInfo* pInfos)
+{
+    for (uint32_t i=0u; i<count; ++i)
+        static_cast<CNullImage*>(pInfos[i].image)->setMemoryBinding(pInfos[i].binding);
+    return true;
+}
+
+
+IDeviceMemoryBacked::SDeviceMemoryRequirements CNullLogicalDevice::getMemoryRequirements(const size_t size, const uint32_t alignmentLog2) const
+{
+    IDeviceMemoryBacked::SDeviceMemoryRequirements reqs = {};
+    reqs.size = core::roundUp<size_t>(size,0x1ull<<alignmentLog2);
+    // every memory type is compatible with every resource
+    const uint32_t memoryTypeCount = m_physicalDevice->getMemoryProperties().memoryTypeCount;
+    reqs.memoryTypeBits = memoryTypeCount<32u ? ((0x1u<<memoryTypeCount)-1u):(~0u);
+    reqs.alignmentLog2 = alignmentLog2;
+    reqs.prefersDedicatedAllocation = false;
+    reqs.requiresDedicatedAllocation = false;
+    return reqs;
+}
+
+core::smart_refctd_ptr<IGPUBuffer> CNullLogicalDevice::createBuffer_impl(IGPUBuffer::SCreationParams&& creationParams)
+{
+    // same as the most common `minStorageBufferOffsetAlignment`
+    const auto reqs = getMemoryRequirements(creationParams.size,8u);
+    return core::make_smart_refctd_ptr<CNullBuffer>(this,std::move(creationParams),reqs);
+}
+
+core::smart_refctd_ptr<IGPUImage> CNullLogicalDevice::createImage_impl(IGPUImage::SCreationParams&& params)
+{
+    // tightly packed mip chain of all the layers, drivers tile and pad but this is close enough for allocator behaviour
+    const auto blockDims = asset::getBlockDimensions(params.format);
+    const size_t blockByteSize = asset::getTexelOrBlockBytesize(params.format);
+    size_t size = 0ull;
+    for (uint32_t mip=0u; mip<params.mipLevels; mip++)
+    {
+        const uint32_t width = std::max(params.extent.width>>mip,1u);
+        const uint32_t height = std::max(params.extent.height>>mip,1u);
+        const uint32_t depth = std::max(params.extent.depth>>mip,1u);
+        const size_t blockCount = size_t((width+blockDims.x-1u)/blockDims.x)*((height+blockDims.y-1u)/blockDims.y)*((depth+blockDims.z-1u)/blockDims.z);
+        size += blockCount*blockByteSize;
+    }
+    size *= params.arrayLayers*static_cast<uint32_t>(params.samples);
+    // 64kb pages, like most discrete GPUs
+    const auto reqs = getMemoryRequirements(size,16u);
+    return core::make_smart_refctd_ptr<CNullImage>(this,std::move(params),reqs);
+}
+
+
+void CNullLogicalDevice::createComputePipelines_impl(
+    IGPUPipelineCache* const pipelineCache,
+    const std::span<const IGPUComputePipeline::SCreationParams> createInfos,
+    core::smart_refctd_ptr<IGPUComputePipeline>* const output,
+    const IGPUComputePipeline::SCreationParams::SSpecializationValidationResult& validation
+)
+{
+    for (size_t i=0ull; i<createInfos.size(); ++i)
+    {
+        const auto& info = createInfos[i];
+        output[i] = core::make_smart_refctd_ptr<CNullComputePipeline>(core::smart_refctd_ptr<const IGPUPipelineLayout>(info.layout),info.flags);
+    }
+}
+
+void CNullLogicalDevice::createGraphicsPipelines_impl(
+    IGPUPipelineCache* const pipelineCache,
+    const std::span<const IGPUGraphicsPipeline::SCreationParams> createInfos,
+    core::smart_refctd_ptr<IGPUGraphicsPipeline>* const output,
+    const IGPUGraphicsPipeline::SCreationParams::SSpecializationValidationResult& validation
+)
+{
+    for (size_t i=0ull; i<createInfos.size(); ++i)
+        output[i] = core::make_smart_refctd_ptr<CNullGraphicsPipeline>(createInfos[i]);
+}
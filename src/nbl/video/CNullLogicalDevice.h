@@ -0,0 +1,194 @@
+#ifndef _NBL_VIDEO_C_NULL_LOGICAL_DEVICE_H_INCLUDED_
+#define _NBL_VIDEO_C_NULL_LOGICAL_DEVICE_H_INCLUDED_
+
+
+#include "nbl/video/ILogicalDevice.h"
+#include "nbl/video/CNullObjects.h"
+#include "nbl/video/CNullQueue.h"
+#include "nbl/video/CNullCommandPool.h"
+
+
+namespace nbl::video
+{
+
+//! Logical Device of `CNullConnection`, all the engine-side validation and bookkeeping in `ILogicalDevice` runs but the backend calls are no-ops.
+/**
+Mappable memory gets backed by host allocations on first map, nothing else allocates any storage.
+Acceleration Structures are not supported (creation returns nullptr), and neither is reading back query results since nothing ever runs.
+*/
+class CNullLogicalDevice final : public ILogicalDevice
+{
+    public:
+        CNullLogicalDevice(core::smart_refctd_ptr<const IAPIConnection>&& api, const IPhysicalDevice* const physicalDevice, const SCreationParams& params);
+
+        // sync stuff
+        inline core::smart_refctd_ptr<ISemaphore> createSemaphore(const uint64_t initialValue) override
+        {
+            return core::make_smart_refctd_ptr<CNullSemaphore>(core::smart_refctd_ptr<const ILogicalDevice>(this),initialValue);
+        }
+        ISemaphore::WAIT_RESULT waitForSemaphores(const std::span<const ISemaphore::SWaitInfo> infos, const bool waitAll, const uint64_t timeout) override;
+
+        inline core::smart_refctd_ptr<IEvent> createEvent(const IEvent::CREATE_FLAGS flags) override
+        {
+            return core::make_smart_refctd_ptr<CNullEvent>(core::smart_refctd_ptr<const ILogicalDevice>(this),flags);
+        }
+
+        inline core::smart_refctd_ptr<IDeferredOperation> createDeferredOperation() override
+        {
+            return core::make_smart_refctd_ptr<CNullDeferredOperation>(core::smart_refctd_ptr<const ILogicalDevice>(this));
+        }
+
+        // memory  stuff
+        SAllocation allocate(const SAllocateInfo& info) override;
+
+        // descriptor creation
+        inline core::smart_refctd_ptr<IGPUSampler> createSampler(const IGPUSampler::SParams& _params) override
+        {
+            return core::make_smart_refctd_ptr<CNullSampler>(core::smart_refctd_ptr<const ILogicalDevice>(this),_params);
+        }
+
+        inline core::smart_refctd_ptr<IGPUPipelineCache> createPipelineCache(const std::span<const uint8_t> initialData, const bool notThreadsafe=false) override
+        {
+            return core::make_smart_refctd_ptr<CNullPipelineCache>(core::smart_refctd_ptr<const ILogicalDevice>(this));
+        }
+
+        inline const void* getNativeHandle() const override {return this;}
+
+    private:
+        inline ~CNullLogicalDevice() = default;
+
+        // sync stuff
+        inline IQueue::RESULT waitIdle_impl() const override {return IQueue::RESULT::SUCCESS;}
+
+        // memory stuff, mappable memory of the null device is always coherent with itself
+        inline bool flushMappedMemoryRanges_impl(const std::span<const MappedMemoryRange> ranges) override {return true;}
+        inline bool invalidateMappedMemoryRanges_impl(const std::span<const MappedMemoryRange> ranges) override {return true;}
+
+        // memory binding
+        bool bindBufferMemory_impl(const uint32_t count, const SBindBufferMemoryInfo* pInfos) override;
+        bool bindImageMemory_impl(const uint32_t count, const SBindImageMemoryInfo* pInfos) override;
+
+        // descriptor creation
+        core::smart_refctd_ptr<IGPUBuffer> createBuffer_impl(IGPUBuffer::SCreationParams&& creationParams) override;
+        inline core::smart_refctd_ptr<IGPUBufferView> createBufferView_impl(const asset::SBufferRange<const IGPUBuffer>& underlying, const asset::E_FORMAT _fmt) override
+        {
+            return core::make_smart_refctd_ptr<CNullBufferView>(core::smart_refctd_ptr<const ILogicalDevice>(this),underlying,_fmt);
+        }
+        core::smart_refctd_ptr<IGPUImage> createImage_impl(IGPUImage::SCreationParams&& params) override;
+        inline core::smart_refctd_ptr<IGPUImageView> createImageView_impl(IGPUImageView::SCreationParams&& params) override
+        {
+            return core::make_smart_refctd_ptr<CNullImageView>(core::smart_refctd_ptr<const ILogicalDevice>(this),std::move(params));
+        }
+        inline core::smart_refctd_ptr<IGPUBottomLevelAccelerationStructure> createBottomLevelAccelerationStructure_impl(IGPUAccelerationStructure::SCreationParams&& params) override {return nullptr;}
+        inline core::smart_refctd_ptr<IGPUTopLevelAccelerationStructure> createTopLevelAccelerationStructure_impl(IGPUTopLevelAccelerationStructure::SCreationParams&& params) override {return nullptr;}
+
+        // acceleration structure modifiers
+        inline AccelerationStructureBuildSizes getAccelerationStructureBuildSizes_impl(
+            const core::bitflag<IGPUBottomLevelAccelerationStructure::BUILD_FLAGS> flags, const bool motionBlur,
+            const std::span<const IGPUBottomLevelAccelerationStructure::AABBs<const IGPUBuffer>> geometries, const uint32_t* const pMaxPrimitiveCounts
+        ) const override {return {};}
+        inline AccelerationStructureBuildSizes getAccelerationStructureBuildSizes_impl(
+            const core::bitflag<IGPUBottomLevelAccelerationStructure::BUILD_FLAGS> flags, const bool motionBlur,
+            const std::span<const IGPUBottomLevelAccelerationStructure::AABBs<const asset::ICPUBuffer>> geometries, const uint32_t* const pMaxPrimitiveCounts
+        ) const override {return {};}
+        inline AccelerationStructureBuildSizes getAccelerationStructureBuildSizes_impl(
+            const core::bitflag<IGPUBottomLevelAccelerationStructure::BUILD_FLAGS> flags, const bool motionBlur,
+            const std::span<const IGPUBottomLevelAccelerationStructure::Triangles<const IGPUBuffer>> geometries, const uint32_t* const pMaxPrimitiveCounts
+        ) const override {return {};}
+        inline AccelerationStructureBuildSizes getAccelerationStructureBuildSizes_impl(
+            const core::bitflag<IGPUBottomLevelAccelerationStructure::BUILD_FLAGS> flags, const bool motionBlur,
+            const std::span<const IGPUBottomLevelAccelerationStructure::Triangles<const asset::ICPUBuffer>> geometries, const uint32_t* const pMaxPrimitiveCounts
+        ) const override {return {};}
+        inline AccelerationStructureBuildSizes getAccelerationStructureBuildSizes_impl(
+            const bool hostBuild, const core::bitflag<IGPUTopLevelAccelerationStructure::BUILD_FLAGS> flags,
+            const bool motionBlur, const uint32_t maxInstanceCount
+        ) const override {return {};}
+        inline DEFERRABLE_RESULT buildAccelerationStructures_impl(
+            IDeferredOperation* const deferredOperation, const std::span<const IGPUBottomLevelAccelerationStructure::HostBuildInfo> infos,
+            const IGPUBottomLevelAccelerationStructure::BuildRangeInfo* const* const ppBuildRangeInfos, const uint32_t totalGeometryCount
+        ) override {return DEFERRABLE_RESULT::SOME_ERROR;}
+        inline DEFERRABLE_RESULT buildAccelerationStructures_impl(
+            IDeferredOperation* const deferredOperation, const std::span<const IGPUTopLevelAccelerationStructure::HostBuildInfo> infos,
+            const IGPUTopLevelAccelerationStructure::BuildRangeInfo* const pBuildRangeInfos, const uint32_t totalGeometryCount
+        ) override {return DEFERRABLE_RESULT::SOME_ERROR;}
+        inline bool writeAccelerationStructuresProperties_impl(const std::span<const IGPUAccelerationStructure* const> accelerationStructures, const IQueryPool::TYPE type, size_t* data, const size_t stride) override {return false;}
+        inline DEFERRABLE_RESULT copyAccelerationStructure_impl(IDeferredOperation* const deferredOperation, const IGPUAccelerationStructure::CopyInfo& copyInfo) override {return DEFERRABLE_RESULT::SOME_ERROR;}
+        inline DEFERRABLE_RESULT copyAccelerationStructureToMemory_impl(IDeferredOperation* const deferredOperation, const IGPUAccelerationStructure::HostCopyToMemoryInfo& copyInfo) override {return DEFERRABLE_RESULT::SOME_ERROR;}
+        inline DEFERRABLE_RESULT copyAccelerationStructureFromMemory_impl(IDeferredOperation* const deferredOperation, const IGPUAccelerationStructure::HostCopyFromMemoryInfo& copyInfo) override {return DEFERRABLE_RESULT::SOME_ERROR;}
+
+        // shaders
+        inline core::smart_refctd_ptr<IGPUShader> createShader_impl(const asset::ICPUShader* spirvShader) override
+        {
+            return core::make_smart_refctd_ptr<CNullBackendObject<IGPUShader>>(core::smart_refctd_ptr<const ILogicalDevice>(this),spirvShader->getStage(),std::string(spirvShader->getFilepathHint()));
+        }
+
+        // layouts
+        inline core::smart_refctd_ptr<IGPUDescriptorSetLayout> createDescriptorSetLayout_impl(const std::span<const IGPUDescriptorSetLayout::SBinding> bindings, const uint32_t maxSamplersCount) override
+        {
+            return core::make_smart_refctd_ptr<CNullBackendObject<IGPUDescriptorSetLayout>>(core::smart_refctd_ptr<const ILogicalDevice>(this),bindings);
+        }
+        inline core::smart_refctd_ptr<IGPUPipelineLayout> createPipelineLayout_impl(
+            const std::span<const asset::SPushConstantRange> pcRanges,
+            core::smart_refctd_ptr<IGPUDescriptorSetLayout>&& layout0, core::smart_refctd_ptr<IGPUDescriptorSetLayout>&& layout1,
+            core::smart_refctd_ptr<IGPUDescriptorSetLayout>&& layout2, core::smart_refctd_ptr<IGPUDescriptorSetLayout>&& layout3
+        ) override
+        {
+            return core::make_smart_refctd_ptr<CNullBackendObject<IGPUPipelineLayout>>(
+                core::smart_refctd_ptr<const ILogicalDevice>(this),pcRanges,
+                core::smart_refctd_ptr<const IGPUDescriptorSetLayout>(std::move(layout0)),core::smart_refctd_ptr<const IGPUDescriptorSetLayout>(std::move(layout1)),
+                core::smart_refctd_ptr<const IGPUDescriptorSetLayout>(std::move(layout2)),core::smart_refctd_ptr<const IGPUDescriptorSetLayout>(std::move(layout3))
+            );
+        }
+
+        // descriptor sets, the engine-side storage of the pool and sets is all there is
+        inline core::smart_refctd_ptr<IDescriptorPool> createDescriptorPool_impl(const IDescriptorPool::SCreateInfo& createInfo) override
+        {
+            return core::make_smart_refctd_ptr<CNullDescriptorPool>(core::smart_refctd_ptr<const ILogicalDevice>(this),createInfo);
+        }
+        inline void updateDescriptorSets_impl(const SUpdateDescriptorSetsParams& params) override {}
+        inline void nullifyDescriptors_impl(const SDropDescriptorSetsParams& params) override {}
+
+        // renderpasses and framebuffers
+        inline core::smart_refctd_ptr<IGPURenderpass> createRenderpass_impl(const IGPURenderpass::SCreationParams& params, IGPURenderpass::SCreationParamValidationResult&& validation) override
+        {
+            return core::make_smart_refctd_ptr<CNullBackendObject<IGPURenderpass>>(core::smart_refctd_ptr<const ILogicalDevice>(this),params,validation);
+        }
+        inline core::smart_refctd_ptr<IGPUFramebuffer> createFramebuffer_impl(IGPUFramebuffer::SCreationParams&& params) override
+        {
+            return core::make_smart_refctd_ptr<CNullBackendObject<IGPUFramebuffer>>(core::smart_refctd_ptr<const ILogicalDevice>(this),std::move(params));
+        }
+
+        // pipelines
+        void createComputePipelines_impl(
+            IGPUPipelineCache* const pipelineCache,
+            const std::span<const IGPUComputePipeline::SCreationParams> createInfos,
+            core::smart_refctd_ptr<IGPUComputePipeline>* const output,
+            const IGPUComputePipeline::SCreationParams::SSpecializationValidationResult& validation
+        ) override;
+        void createGraphicsPipelines_impl(
+            IGPUPipelineCache* const pipelineCache,
+            const std::span<const IGPUGraphicsPipeline::SCreationParams> params,
+            core::smart_refctd_ptr<IGPUGraphicsPipeline>* const output,
+            const IGPUGraphicsPipeline::SCreationParams::SSpecializationValidationResult& validation
+        ) override;
+
+        // queries
+        inline core::smart_refctd_ptr<IQueryPool> createQueryPool_impl(const IQueryPool::SCreationParams& params) override
+        {
+            return core::make_smart_refctd_ptr<CNullBackendObject<IQueryPool>>(core::smart_refctd_ptr<const ILogicalDevice>(this),params);
+        }
+        inline bool getQueryPoolResults_impl(const IQueryPool* const queryPool, const uint32_t firstQuery, const uint32_t queryCount, void* const pData, const size_t stride, const core::bitflag<IQueryPool::RESULTS_FLAGS> flags) override {return false;}
+
+        // command buffers
+        inline core::smart_refctd_ptr<IGPUCommandPool> createCommandPool_impl(const uint32_t familyIx, const core::bitflag<IGPUCommandPool::CREATE_FLAGS> flags) override
+        {
+            return core::make_smart_refctd_ptr<CNullCommandPool>(core::smart_refctd_ptr<const ILogicalDevice>(this),flags,familyIx);
+        }
+
+        // what a fake resource needs to be backed by
+        IDeviceMemoryBacked::SDeviceMemoryRequirements getMemoryRequirements(const size_t size, const uint32_t alignmentLog2) const;
+};
+
+}
+
+#endif
@@ -0,0 +1,240 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_VIDEO_C_NULL_OBJECTS_H_INCLUDED_
+#define _NBL_VIDEO_C_NULL_OBJECTS_H_INCLUDED_
+
+#include "nbl/video/ILogicalDevice.h"
+
+#include <atomic>
+
+namespace nbl::video
+{
+
+// Objects of the null backend, none of them own any API handle so `getNativeHandle` (where there is one) just returns the object itself
+
+//! For interfaces which have nothing left to implement except a constructor we could call
+template<class Interface>
+class CNullBackendObject final : public Interface
+{
+    public:
+        template<typename... Args>
+        inline CNullBackendObject(Args&&... args) : Interface(std::forward<Args>(args)...) {}
+
+    private:
+        ~CNullBackendObject() = default;
+};
+
+class CNullSemaphore final : public ISemaphore
+{
+    public:
+        inline CNullSemaphore(core::smart_refctd_ptr<const ILogicalDevice>&& dev, const uint64_t initialValue) : ISemaphore(std::move(dev)), m_counter(initialValue) {}
+
+        inline uint64_t getCounterValue() const override {return m_counter.load();}
+        // the counter can only go up, concurrent host and "queue" signals just keep the max
+        inline void signal(const uint64_t value) override
+        {
+            uint64_t current = m_counter.load();
+            while (current<value && !m_counter.compare_exchange_weak(current,value)) {}
+        }
+
+        inline const void* getNativeHandle() const override {return this;}
+
+    private:
+        ~CNullSemaphore() = default;
+
+        std::atomic_uint64_t m_counter;
+};
+
+class CNullEvent final : public IEvent
+{
+    public:
+        inline CNullEvent(core::smart_refctd_ptr<const ILogicalDevice>&& dev, const core::bitflag<CREATE_FLAGS> flags) : IEvent(std::move(dev),flags) {}
+
+    private:
+        ~CNullEvent() = default;
+
+        inline STATUS getEventStatus_impl() const override {return m_set.load() ? STATUS::SET:STATUS::RESET;}
+        inline STATUS resetEvent_impl() override
+        {
+            m_set.store(false);
+            return STATUS::RESET;
+        }
+        inline STATUS setEvent_impl() override
+        {
+            m_set.store(true);
+            return STATUS::SET;
+        }
+
+        std::atomic_bool m_set = false;
+};
+
+//! Nothing ever gets deferred because all host operations either complete immediately or fail
+class CNullDeferredOperation final : public IDeferredOperation
+{
+    public:
+        inline CNullDeferredOperation(core::smart_refctd_ptr<const ILogicalDevice>&& dev) : IDeferredOperation(std::move(dev)) {}
+
+        inline uint32_t getMaxConcurrency() const override {return 1u;}
+        inline bool isPending() const override {return false;}
+
+    private:
+        ~CNullDeferredOperation() = default;
+
+        inline STATUS execute_impl() override {return STATUS::COMPLETED;}
+};
+
+//! Only mappable memory types get any storage, it's allocated on the first map and kept until destruction so contents survive unmapping
+class CNullMemoryAllocation final : public IDeviceMemoryAllocation
+{
+    public:
+        inline CNullMemoryAllocation(
+            const ILogicalDevice* dev, const size_t size, const core::bitflag<E_MEMORY_ALLOCATE_FLAGS> flags,
+            const core::bitflag<E_MEMORY_PROPERTY_FLAGS> memoryPropertyFlags, const bool isDedicated
+        ) : IDeviceMemoryAllocation(dev,size,flags,memoryPropertyFlags,isDedicated), m_device(dev) {}
+
+    private:
+        inline ~CNullMemoryAllocation()
+        {
+            if (m_hostStorage)
+                _NBL_ALIGNED_FREE(m_hostStorage);
+        }
+
+        inline void* map_impl(const MemoryRange& range, const core::bitflag<E_MAPPING_CPU_ACCESS_FLAGS> accessHint) override
+        {
+            if (!isMappable() || range.offset+range.length>m_allocationSize)
+                return nullptr;
+            if (!m_hostStorage)
+                m_hostStorage = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(m_allocationSize,_NBL_SIMD_ALIGNMENT));
+            return m_hostStorage ? (m_hostStorage+range.offset):nullptr;
+        }
+        inline bool unmap_impl() override {return true;}
+
+        // keeps the device alive for as long as its memory is
+        core::smart_refctd_ptr<const ILogicalDevice> m_device;
+        uint8_t* m_hostStorage = nullptr;
+};
+
+template<class Interface>
+class CNullDeviceMemoryBacked : public Interface
+{
+    public:
+        inline IDeviceMemoryBacked::SMemoryBinding getBoundMemory() const override {return {m_memory.get(),m_offset};}
+        inline void setMemoryBinding(const IDeviceMemoryBacked::SMemoryBinding& binding)
+        {
+            m_memory = core::smart_refctd_ptr<IDeviceMemoryAllocation>(binding.memory);
+            m_offset = binding.offset;
+        }
+
+        inline const void* getNativeHandle() const override {return this;}
+
+    protected:
+        inline CNullDeviceMemoryBacked(const ILogicalDevice* dev, Interface::SCreationParams&& _creationParams, const IDeviceMemoryBacked::SDeviceMemoryRequirements& _memReqs)
+            : Interface(core::smart_refctd_ptr<const ILogicalDevice>(dev),std::move(_creationParams),_memReqs) {}
+        inline ~CNullDeviceMemoryBacked()
+        {
+            this->preDestroyStep();
+        }
+
+    private:
+        core::smart_refctd_ptr<IDeviceMemoryAllocation> m_memory = nullptr;
+        size_t m_offset = 0u;
+};
+
+class CNullBuffer final : public CNullDeviceMemoryBacked<IGPUBuffer>
+{
+        using base_t = CNullDeviceMemoryBacked<IGPUBuffer>;
+
+    public:
+        inline CNullBuffer(const ILogicalDevice* dev, IGPUBuffer::SCreationParams&& creationParams, const IDeviceMemoryBacked::SDeviceMemoryRequirements& memReqs)
+            : base_t(dev,std::move(creationParams),memReqs) {}
+
+        inline void setDeviceAddress(const uint64_t address)
+        {
+            m_deviceAddress = address;
+        }
+};
+
+class CNullImage final : public CNullDeviceMemoryBacked<IGPUImage>
+{
+        using base_t = CNullDeviceMemoryBacked<IGPUImage>;
+
+    public:
+        inline CNullImage(const ILogicalDevice* dev, IGPUImage::SCreationParams&& creationParams, const IDeviceMemoryBacked::SDeviceMemoryRequirements& memReqs)
+            : base_t(dev,std::move(creationParams),memReqs) {}
+};
+
+class CNullBufferView final : public IGPUBufferView
+{
+    public:
+        inline CNullBufferView(core::smart_refctd_ptr<const ILogicalDevice>&& dev, const asset::SBufferRange<const IGPUBuffer>& underlying, const asset::E_FORMAT format)
+            : IGPUBufferView(std::move(dev),underlying,format) {}
+
+        inline const void* getNativeHandle() const override {return this;}
+};
+
+class CNullImageView final : public IGPUImageView
+{
+    public:
+        inline CNullImageView(core::smart_refctd_ptr<const ILogicalDevice>&& dev, SCreationParams&& params) : IGPUImageView(std::move(dev),std::move(params)) {}
+
+        inline const void* getNativeHandle() const override {return this;}
+};
+
+class CNullSampler final : public IGPUSampler
+{
+    public:
+        inline CNullSampler(core::smart_refctd_ptr<const ILogicalDevice>&& dev, const SParams& params) : IGPUSampler(std::move(dev),params) {}
+
+        inline const void* getNativeHandle() const override {return this;}
+};
+
+class CNullPipelineCache final : public IGPUPipelineCache
+{
+    public:
+        inline CNullPipelineCache(core::smart_refctd_ptr<const ILogicalDevice>&& dev) : IGPUPipelineCache(std::move(dev)) {}
+
+        // there's no driver blob to serialize
+        inline core::smart_refctd_ptr<asset::ICPUPipelineCache> convertToCPUCache() const override {return nullptr;}
+
+    private:
+        inline bool merge_impl(const std::span<const IGPUPipelineCache* const> _srcCaches) override {return true;}
+};
+
+class CNullDescriptorPool final : public IDescriptorPool
+{
+    public:
+        inline CNullDescriptorPool(core::smart_refctd_ptr<const ILogicalDevice>&& dev, const SCreateInfo& createInfo) : IDescriptorPool(std::move(dev),createInfo) {}
+
+    private:
+        inline ~CNullDescriptorPool() = default;
+
+        inline bool createDescriptorSets_impl(uint32_t count, const IGPUDescriptorSetLayout* const* layouts, SStorageOffsets* const offsets, core::smart_refctd_ptr<IGPUDescriptorSet>* output) override
+        {
+            for (uint32_t i=0u; i<count; ++i)
+                output[i] = core::make_smart_refctd_ptr<CNullBackendObject<IGPUDescriptorSet>>(core::smart_refctd_ptr<const IGPUDescriptorSetLayout>(layouts[i]),core::smart_refctd_ptr<IDescriptorPool>(this),std::move(offsets[i]));
+            return true;
+        }
+        inline bool reset_impl() override {return true;}
+};
+
+class CNullComputePipeline final : public IGPUComputePipeline
+{
+    public:
+        inline CNullComputePipeline(core::smart_refctd_ptr<const IGPUPipelineLayout>&& layout, const core::bitflag<SCreationParams::FLAGS> flags)
+            : IGPUComputePipeline(std::move(layout),flags) {}
+
+        inline const void* getNativeHandle() const override {return this;}
+};
+
+class CNullGraphicsPipeline final : public IGPUGraphicsPipeline
+{
+    public:
+        inline CNullGraphicsPipeline(const SCreationParams& params) : IGPUGraphicsPipeline(params) {}
+
+        inline const void* getNativeHandle() const override {return this;}
+};
+
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef _NBL_VIDEO_C_NULL_PHYSICAL_DEVICE_H_INCLUDED_
+#define _NBL_VIDEO_C_NULL_PHYSICAL_DEVICE_H_INCLUDED_
+
+#include "nbl/video/IPhysicalDevice.h"
+#include "nbl/video/CNullLogicalDevice.h"
+
+namespace nbl::video
+{
+
+class CNullPhysicalDevice final : public IPhysicalDevice
+{
+    public:
+        inline CNullPhysicalDevice(IPhysicalDevice::SInitData&& _initData) : IPhysicalDevice(std::move(_initData)) {}
+
+        inline E_API_TYPE getAPIType() const override { return EAT_NULL; }
+
+    protected:
+        inline core::smart_refctd_ptr<ILogicalDevice> createLogicalDevice_impl(ILogicalDevice::SCreationParams&& params) override
+        {
+            if (!params.compilerSet)
+                params.compilerSet = core::make_smart_refctd_ptr<asset::CCompilerSet>(core::smart_refctd_ptr(m_initData.system));
+
+            return core::make_smart_refctd_ptr<CNullLogicalDevice>(core::smart_refctd_ptr<const IAPIConnection>(m_initData.api),this,params);
+        }
+};
+
+}
+
+#endif
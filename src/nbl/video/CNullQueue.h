@@ -0,0 +1,40 @@
+#ifndef _NBL_VIDEO_C_NULL_QUEUE_H_INCLUDED_
+#define _NBL_VIDEO_C_NULL_QUEUE_H_INCLUDED_
+
+
+#include "nbl/video/IQueue.h"
+#include "nbl/video/ISemaphore.h"
+
+
+namespace nbl::video
+{
+
+class ILogicalDevice;
+
+//! Everything submitted "executes" instantly without honouring the wait semaphores, so the signal semaphores are signalled before `submit` even returns
+class CNullQueue final : public IQueue
+{
+    public:
+        inline CNullQueue(ILogicalDevice* logicalDevice, const uint32_t _famIx, const core::bitflag<IQueue::CREATE_FLAGS> _flags, const float _priority)
+            : IQueue(logicalDevice, _famIx, _flags, _priority) {}
+
+        inline bool insertDebugMarker(const char* name, const core::vector4df_SIMD& color) override {return true;}
+        inline bool beginDebugMarker(const char* name, const core::vector4df_SIMD& color) override {return true;}
+        inline bool endDebugMarker() override {return true;}
+
+        inline const void* getNativeHandle() const override {return this;}
+
+    private:
+        inline RESULT submit_impl(const std::span<const SSubmitInfo> _submits) override
+        {
+            for (const auto& submit : _submits)
+            for (const auto& signal : submit.signalSemaphores)
+                signal.semaphore->signal(signal.value);
+            return RESULT::SUCCESS;
+        }
+        inline RESULT waitIdle_impl() const override {return RESULT::SUCCESS;}
+};
+
+}
+
+#endif
@@ -143,7 +143,7 @@ bool IGPUCommandBuffer::begin(const core::bitflag<USAGE> flags, const SInheritan
     {
         if (inheritanceInfo->framebuffer && !inheritanceInfo->framebuffer->getCreationParameters().renderpass->compatible(inheritanceInfo->renderpass))
             return false;
-        if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBeginRenderPassCmd>(m_commandList,core::smart_refctd_ptr<const IGPURenderpass>(inheritanceInfo->renderpass),core::smart_refctd_ptr<const IGPUFramebuffer>(inheritanceInfo->framebuffer)))
+        if (!recordResources<IGPUCommandPool::CBeginRenderPassCmd>(inheritanceInfo->renderpass,inheritanceInfo->framebuffer))
             return false;
         m_cachedInheritanceInfo = *inheritanceInfo;
     }
@@ -237,7 +237,7 @@ bool IGPUCommandBuffer::setEvent(IEvent* _event, const SEventDependencyInfo& dep
     if (invalidDependency(depInfo))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CSetEventCmd>(m_commandList, core::smart_refctd_ptr<const IEvent>(_event)))
+    if (!recordResources<IGPUCommandPool::CSetEventCmd>(_event))
         return false;
 
     m_noCommands = false;
@@ -266,7 +266,7 @@ bool IGPUCommandBuffer::resetEvent(IEvent* _event, const core::bitflag<stage_fla
     if (!getOriginDevice()->supportsMask(m_cmdpool->getQueueFamilyIndex(),stageMask))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CResetEventCmd>(m_commandList,core::smart_refctd_ptr<const IEvent>(_event)))
+    if (!recordResources<IGPUCommandPool::CResetEventCmd>(_event))
         return false;
 
     m_noCommands = false;
@@ -299,18 +299,33 @@ bool IGPUCommandBuffer::waitEvents(const std::span<IEvent*> events, const SEvent
         totalImageCount += depInfo.imgBarriers.size();
     }
 
-    auto* cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CWaitEventsCmd>(m_commandList,events.size(),events.data(),totalBufferCount,totalImageCount);
-    if (!cmd)
-        return false;
-
-    auto outIt = cmd->getDeviceMemoryBacked();
-    for (auto i=0u; i<events.size(); ++i)
+    if (m_resourceTracking==RESOURCE_TRACKING::DEDUPLICATED)
     {
-        const auto& depInfo = depInfos[i];
-        for (const auto& barrier : depInfo.bufBarriers)
-            *(outIt++) = barrier.range.buffer;
-        for (const auto& barrier : depInfo.imgBarriers)
-            *(outIt++) = core::smart_refctd_ptr<const IGPUImage>(barrier.image);
+        for (auto i=0u; i<events.size(); ++i)
+        {
+            trackResource(events[i]);
+            const auto& depInfo = depInfos[i];
+            for (const auto& barrier : depInfo.bufBarriers)
+                trackResource(barrier.range.buffer.get());
+            for (const auto& barrier : depInfo.imgBarriers)
+                trackResource(barrier.image);
+        }
+    }
+    else
+    {
+        auto* cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CWaitEventsCmd>(m_commandList,events.size(),events.data(),totalBufferCount,totalImageCount);
+        if (!cmd)
+            return false;
+
+        auto outIt = cmd->getDeviceMemoryBacked();
+        for (auto i=0u; i<events.size(); ++i)
+        {
+            const auto& depInfo = depInfos[i];
+            for (const auto& barrier : depInfo.bufBarriers)
+                *(outIt++) = barrier.range.buffer;
+            for (const auto& barrier : depInfo.imgBarriers)
+                *(outIt++) = core::smart_refctd_ptr<const IGPUImage>(barrier.image);
+        }
     }
     m_noCommands = false;
     return waitEvents_impl(events,depInfos);
@@ -382,15 +397,25 @@ bool IGPUCommandBuffer::pipelineBarrier(const core::bitflag<asset::E_DEPENDENCY_
     else if (dependencyFlags.hasFlags(asset::EDF_VIEW_LOCAL_BIT))
         return false;
 
-    auto* cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CPipelineBarrierCmd>(m_commandList,depInfo.bufBarriers.size(),depInfo.imgBarriers.size());
-    if (!cmd)
-        return false;
+    if (m_resourceTracking==RESOURCE_TRACKING::DEDUPLICATED)
+    {
+        for (const auto& barrier : depInfo.bufBarriers)
+            trackResource(barrier.range.buffer.get());
+        for (const auto& barrier : depInfo.imgBarriers)
+            trackResource(barrier.image);
+    }
+    else
+    {
+        auto* cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CPipelineBarrierCmd>(m_commandList,depInfo.bufBarriers.size(),depInfo.imgBarriers.size());
+        if (!cmd)
+            return false;
 
-    auto outIt = cmd->getVariableCountResources();
-    for (const auto& barrier : depInfo.bufBarriers)
-        *(outIt++) = barrier.range.buffer;
-    for (const auto& barrier : depInfo.imgBarriers)
-        *(outIt++) = core::smart_refctd_ptr<const IGPUImage>(barrier.image);
+        auto outIt = cmd->getVariableCountResources();
+        for (const auto& barrier : depInfo.bufBarriers)
+            *(outIt++) = barrier.range.buffer;
+        for (const auto& barrier : depInfo.imgBarriers)
+            *(outIt++) = core::smart_refctd_ptr<const IGPUImage>(barrier.image);
+    }
     m_noCommands = false;
     return pipelineBarrier_impl(dependencyFlags,depInfo);
 }
@@ -407,7 +432,7 @@ bool IGPUCommandBuffer::fillBuffer(const asset::SBufferRange<IGPUBuffer>& range,
         return false;
     }
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CFillBufferCmd>(m_commandList,core::smart_refctd_ptr<const IGPUBuffer>(range.buffer)))
+    if (!recordResources<IGPUCommandPool::CFillBufferCmd>(range.buffer))
         return false;
     m_noCommands = false;
     return fillBuffer_impl(range,data);
@@ -429,7 +454,7 @@ bool IGPUCommandBuffer::updateBuffer(const asset::SBufferRange<IGPUBuffer>& rang
         return false;
     }
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CUpdateBufferCmd>(m_commandList,core::smart_refctd_ptr<const IGPUBuffer>(range.buffer)))
+    if (!recordResources<IGPUCommandPool::CUpdateBufferCmd>(range.buffer))
         return false;
     m_noCommands = false;
     return updateBuffer_impl(range,pData);
@@ -455,7 +480,7 @@ bool IGPUCommandBuffer::copyBuffer(const IGPUBuffer* const srcBuffer, IGPUBuffer
 
     // pRegions is too expensive to validate
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyBufferCmd>(m_commandList,core::smart_refctd_ptr<const IGPUBuffer>(srcBuffer),core::smart_refctd_ptr<const IGPUBuffer>(dstBuffer)))
+    if (!recordResources<IGPUCommandPool::CCopyBufferCmd>(srcBuffer,dstBuffer))
         return false;
     m_noCommands = false;
     return copyBuffer_impl(srcBuffer, dstBuffer, regionCount, pRegions);
@@ -473,7 +498,7 @@ bool IGPUCommandBuffer::clearColorImage(IGPUImage* const image, const IGPUImage:
     if (asset::isDepthOrStencilFormat(format) || asset::isBlockCompressionFormat(format))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CClearColorImageCmd>(m_commandList,core::smart_refctd_ptr<const IGPUImage>(image)))
+    if (!recordResources<IGPUCommandPool::CClearColorImageCmd>(image))
         return false;
     m_noCommands = false;
     return clearColorImage_impl(image, imageLayout, pColor, rangeCount, pRanges);
@@ -490,7 +515,7 @@ bool IGPUCommandBuffer::clearDepthStencilImage(IGPUImage* const image, const IGP
     if (!asset::isDepthOrStencilFormat(format))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CClearDepthStencilImageCmd>(m_commandList,core::smart_refctd_ptr<const IGPUImage>(image)))
+    if (!recordResources<IGPUCommandPool::CClearDepthStencilImageCmd>(image))
         return false;
     m_noCommands = false;
     return clearDepthStencilImage_impl(image, imageLayout, pDepthStencil, rangeCount, pRanges);
@@ -510,7 +535,7 @@ bool IGPUCommandBuffer::copyBufferToImage(const IGPUBuffer* const srcBuffer, IGP
 
     // pRegions is too expensive to validate
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyBufferToImageCmd>(m_commandList, core::smart_refctd_ptr<const IGPUBuffer>(srcBuffer), core::smart_refctd_ptr<const IGPUImage>(dstImage)))
+    if (!recordResources<IGPUCommandPool::CCopyBufferToImageCmd>(srcBuffer,dstImage))
         return false;
 
     m_noCommands = false;
@@ -531,7 +556,7 @@ bool IGPUCommandBuffer::copyImageToBuffer(const IGPUImage* const srcImage, const
 
     // pRegions is too expensive to validate
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyImageToBufferCmd>(m_commandList, core::smart_refctd_ptr<const IGPUImage>(srcImage), core::smart_refctd_ptr<const IGPUBuffer>(dstBuffer)))
+    if (!recordResources<IGPUCommandPool::CCopyImageToBufferCmd>(srcImage,dstBuffer))
         return false;
 
     m_noCommands = false;
@@ -561,7 +586,7 @@ bool IGPUCommandBuffer::copyImage(const IGPUImage* const srcImage, const IGPUIma
     if (!dstImage->validateCopies(pRegions,pRegions+regionCount,srcImage))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyImageCmd>(m_commandList, core::smart_refctd_ptr<const IGPUImage>(srcImage), core::smart_refctd_ptr<const IGPUImage>(dstImage)))
+    if (!recordResources<IGPUCommandPool::CCopyImageCmd>(srcImage,dstImage))
         return false;
 
     m_noCommands = false;
@@ -639,7 +664,7 @@ bool IGPUCommandBuffer::copyAccelerationStructure(const IGPUAccelerationStructur
     if (!copyInfo.dst || !this->isCompatibleDevicewise(copyInfo.dst))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyAccelerationStructureCmd>(m_commandList, core::smart_refctd_ptr<const IGPUAccelerationStructure>(copyInfo.src), core::smart_refctd_ptr<const IGPUAccelerationStructure>(copyInfo.dst)))
+    if (!recordResources<IGPUCommandPool::CCopyAccelerationStructureCmd>(copyInfo.src,copyInfo.dst))
         return false;
 
     m_noCommands = false;
@@ -656,7 +681,7 @@ bool IGPUCommandBuffer::copyAccelerationStructureToMemory(const IGPUAcceleration
     if (invalidBufferBinding(copyInfo.dst,256u,IGPUBuffer::EUF_TRANSFER_DST_BIT))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyAccelerationStructureToOrFromMemoryCmd>(m_commandList, core::smart_refctd_ptr<const IGPUAccelerationStructure>(copyInfo.src), core::smart_refctd_ptr<const IGPUBuffer>(copyInfo.dst.buffer)))
+    if (!recordResources<IGPUCommandPool::CCopyAccelerationStructureToOrFromMemoryCmd>(copyInfo.src,copyInfo.dst.buffer))
         return false;
 
     m_noCommands = false;
@@ -673,7 +698,7 @@ bool IGPUCommandBuffer::copyAccelerationStructureFromMemory(const IGPUAccelerati
     if (!copyInfo.dst || !this->isCompatibleDevicewise(copyInfo.dst))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyAccelerationStructureToOrFromMemoryCmd>(m_commandList, core::smart_refctd_ptr<const IGPUAccelerationStructure>(copyInfo.dst), core::smart_refctd_ptr<const IGPUBuffer>(copyInfo.src.buffer)))
+    if (!recordResources<IGPUCommandPool::CCopyAccelerationStructureToOrFromMemoryCmd>(copyInfo.dst,copyInfo.src.buffer))
         return false;
 
     m_noCommands = false;
@@ -689,7 +714,7 @@ bool IGPUCommandBuffer::bindComputePipeline(const IGPUComputePipeline* const pip
     if (!this->isCompatibleDevicewise(pipeline))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBindComputePipelineCmd>(m_commandList, core::smart_refctd_ptr<const IGPUComputePipeline>(pipeline)))
+    if (!recordResources<IGPUCommandPool::CBindComputePipelineCmd>(pipeline))
         return false;
 
     m_noCommands = false;
@@ -709,7 +734,7 @@ bool IGPUCommandBuffer::bindGraphicsPipeline(const IGPUGraphicsPipeline* const p
     if (!pipeline || !this->isCompatibleDevicewise(pipeline))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBindGraphicsPipelineCmd>(m_commandList, core::smart_refctd_ptr<const IGPUGraphicsPipeline>(pipeline)))
+    if (!recordResources<IGPUCommandPool::CBindGraphicsPipelineCmd>(pipeline))
         return false;
 
     m_noCommands = false;
@@ -742,7 +767,13 @@ bool IGPUCommandBuffer::bindDescriptorSets(
         }
     }
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBindDescriptorSetsCmd>(m_commandList,core::smart_refctd_ptr<const IGPUPipelineLayout>(layout),descriptorSetCount,pDescriptorSets))
+    if (m_resourceTracking==RESOURCE_TRACKING::DEDUPLICATED)
+    {
+        trackResource(layout);
+        for (uint32_t i=0u; i<descriptorSetCount; ++i)
+            trackResource(pDescriptorSets[i]);
+    }
+    else if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBindDescriptorSetsCmd>(m_commandList,core::smart_refctd_ptr<const IGPUPipelineLayout>(layout),descriptorSetCount,pDescriptorSets))
         return false;
 
     for (uint32_t i=0u; i<descriptorSetCount; ++i)
@@ -782,7 +813,7 @@ bool IGPUCommandBuffer::pushConstants(const IGPUPipelineLayout* const layout, co
     if (!layout || !this->isCompatibleDevicewise(layout))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CPushConstantsCmd>(m_commandList, core::smart_refctd_ptr<const IGPUPipelineLayout>(layout)))
+    if (!recordResources<IGPUCommandPool::CPushConstantsCmd>(layout))
         return false;
 
     m_noCommands = false;
@@ -800,7 +831,12 @@ bool IGPUCommandBuffer::bindVertexBuffers(const uint32_t firstBinding, const uin
     if (pBindings[i].buffer && invalidBufferBinding(pBindings[i],4u/*or should we derive from component format?*/,IGPUBuffer::EUF_VERTEX_BUFFER_BIT))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBindVertexBuffersCmd>(m_commandList,bindingCount,pBindings))
+    if (m_resourceTracking==RESOURCE_TRACKING::DEDUPLICATED)
+    {
+        for (uint32_t i=0u; i<bindingCount; ++i)
+            trackResource(pBindings[i].buffer.get());
+    }
+    else if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBindVertexBuffersCmd>(m_commandList,bindingCount,pBindings))
         return false;
 
     m_noCommands = false;
@@ -830,7 +866,7 @@ bool IGPUCommandBuffer::bindIndexBuffer(const asset::SBufferBinding<const IGPUBu
             return false;
     }
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBindIndexBufferCmd>(m_commandList, core::smart_refctd_ptr<const IGPUBuffer>(binding.buffer)))
+    if (!recordResources<IGPUCommandPool::CBindIndexBufferCmd>(binding.buffer))
         return false;
 
     m_noCommands = false;
@@ -896,7 +932,7 @@ bool IGPUCommandBuffer::resetQueryPool(IQueryPool* const queryPool, const uint32
     if (!queryPool || !this->isCompatibleDevicewise(queryPool))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CResetQueryPoolCmd>(m_commandList, core::smart_refctd_ptr<const IQueryPool>(queryPool)))
+    if (!recordResources<IGPUCommandPool::CResetQueryPoolCmd>(queryPool))
         return false;
 
     m_noCommands = false;
@@ -912,7 +948,7 @@ bool IGPUCommandBuffer::beginQuery(IQueryPool* const queryPool, const uint32_t q
     if (!queryPool || !this->isCompatibleDevicewise(queryPool))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBeginQueryCmd>(m_commandList, core::smart_refctd_ptr<const IQueryPool>(queryPool)))
+    if (!recordResources<IGPUCommandPool::CBeginQueryCmd>(queryPool))
         return false;
 
     m_noCommands = false;
@@ -928,7 +964,7 @@ bool IGPUCommandBuffer::endQuery(IQueryPool* const queryPool, const uint32_t que
     if (!queryPool || !this->isCompatibleDevicewise(queryPool))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CEndQueryCmd>(m_commandList, core::smart_refctd_ptr<const IQueryPool>(queryPool)))
+    if (!recordResources<IGPUCommandPool::CEndQueryCmd>(queryPool))
         return false;
 
     m_noCommands = false;
@@ -949,7 +985,7 @@ bool IGPUCommandBuffer::writeTimestamp(const stage_flags_t pipelineStage, IQuery
 
     assert(core::isPoT(static_cast<uint32_t>(pipelineStage))); // should only be 1 stage (1 bit set)
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CWriteTimestampCmd>(m_commandList, core::smart_refctd_ptr<const IQueryPool>(queryPool)))
+    if (!recordResources<IGPUCommandPool::CWriteTimestampCmd>(queryPool))
         return false;
 
     m_noCommands = false;
@@ -968,13 +1004,22 @@ bool IGPUCommandBuffer::writeAccelerationStructureProperties(const std::span<con
     if (!isCompatibleDevicewise(as))
         return false;
 
-    auto cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CWriteAccelerationStructurePropertiesCmd>(m_commandList, queryPool, pAccelerationStructures.size());
-    if (!cmd)
-        return false;
+    if (m_resourceTracking==RESOURCE_TRACKING::DEDUPLICATED)
+    {
+        trackResource(queryPool);
+        for (auto& as : pAccelerationStructures)
+            trackResource(as);
+    }
+    else
+    {
+        auto cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CWriteAccelerationStructurePropertiesCmd>(m_commandList, queryPool, pAccelerationStructures.size());
+        if (!cmd)
+            return false;
 
-    auto oit = cmd->getVariableCountResources();
-    for (auto& as : pAccelerationStructures)
-        *(oit++) = core::smart_refctd_ptr<const core::IReferenceCounted>(as);
+        auto oit = cmd->getVariableCountResources();
+        for (auto& as : pAccelerationStructures)
+            *(oit++) = core::smart_refctd_ptr<const core::IReferenceCounted>(as);
+    }
     m_noCommands = false;
     return writeAccelerationStructureProperties_impl(pAccelerationStructures, queryType, queryPool, firstQuery);
 }
@@ -994,7 +1039,7 @@ bool IGPUCommandBuffer::copyQueryPoolResults(
     if (invalidBufferRange({dstBuffer.offset,queryCount*stride,dstBuffer.buffer},alignment,IGPUBuffer::EUF_TRANSFER_DST_BIT))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CCopyQueryPoolResultsCmd>(m_commandList, core::smart_refctd_ptr<const IQueryPool>(queryPool), core::smart_refctd_ptr<const IGPUBuffer>(dstBuffer.buffer)))
+    if (!recordResources<IGPUCommandPool::CCopyQueryPoolResultsCmd>(queryPool,dstBuffer.buffer))
         return false;
 
     m_noCommands = false;
@@ -1026,7 +1071,7 @@ bool IGPUCommandBuffer::dispatchIndirect(const asset::SBufferBinding<const IGPUB
     if (invalidBufferBinding(binding,4u/*TODO: is it really 4?*/,IGPUBuffer::EUF_INDIRECT_BUFFER_BIT))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CIndirectCmd>(m_commandList,core::smart_refctd_ptr<const IGPUBuffer>(binding.buffer)))
+    if (!recordResources<IGPUCommandPool::CIndirectCmd>(binding.buffer))
         return false;
 
     m_noCommands = false;
@@ -1066,7 +1111,7 @@ bool IGPUCommandBuffer::beginRenderPass(SRenderpassBeginInfo info, const SUBPASS
     if (info.renderpass->getColorLoadOpAttachmentEnd()!=0u && !info.colorClearValues)
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBeginRenderPassCmd>(m_commandList,core::smart_refctd_ptr<const IGPURenderpass>(info.renderpass),core::smart_refctd_ptr<const IGPUFramebuffer>(info.framebuffer)))
+    if (!recordResources<IGPUCommandPool::CBeginRenderPassCmd>(info.renderpass,info.framebuffer))
         return false;
 
     m_noCommands = false;
@@ -1216,7 +1261,7 @@ bool IGPUCommandBuffer::drawIndirect(const asset::SBufferBinding<const IGPUBuffe
     if (invalidDrawIndirect<hlsl::DrawArraysIndirectCommand_t>(binding,drawCount,stride))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CIndirectCmd>(m_commandList,core::smart_refctd_ptr<const IGPUBuffer>(binding.buffer)))
+    if (!recordResources<IGPUCommandPool::CIndirectCmd>(binding.buffer))
         return false;
 
     m_noCommands = false;
@@ -1228,7 +1273,7 @@ bool IGPUCommandBuffer::drawIndexedIndirect(const asset::SBufferBinding<const IG
     if (invalidDrawIndirect<hlsl::DrawElementsIndirectCommand_t>(binding,drawCount,stride))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CIndirectCmd>(m_commandList, core::smart_refctd_ptr<const IGPUBuffer>(binding.buffer)))
+    if (!recordResources<IGPUCommandPool::CIndirectCmd>(binding.buffer))
         return false;
 
     m_noCommands = false;
@@ -1240,7 +1285,7 @@ bool IGPUCommandBuffer::drawIndirectCount(const asset::SBufferBinding<const IGPU
     if (!invalidDrawIndirectCount<hlsl::DrawArraysIndirectCommand_t>(indirectBinding,countBinding,maxDrawCount,stride))
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CDrawIndirectCountCmd>(m_commandList, core::smart_refctd_ptr<const IGPUBuffer>(indirectBinding.buffer), core::smart_refctd_ptr<const IGPUBuffer>(countBinding.buffer)))
+    if (!recordResources<IGPUCommandPool::CDrawIndirectCountCmd>(indirectBinding.buffer,countBinding.buffer))
         return false;
 
     m_noCommands = false;
@@ -1252,7 +1297,7 @@ bool IGPUCommandBuffer::drawIndexedIndirectCount(const asset::SBufferBinding<con
     if (!invalidDrawIndirectCount<hlsl::DrawElementsIndirectCommand_t>(indirectBinding,countBinding,maxDrawCount,stride))
         return false;
     
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CDrawIndirectCountCmd>(m_commandList, core::smart_refctd_ptr<const IGPUBuffer>(indirectBinding.buffer), core::smart_refctd_ptr<const IGPUBuffer>(countBinding.buffer)))
+    if (!recordResources<IGPUCommandPool::CDrawIndirectCountCmd>(indirectBinding.buffer,countBinding.buffer))
         return false;
 
     m_noCommands = false;
@@ -1346,7 +1391,7 @@ bool IGPUCommandBuffer::blitImage(const IGPUImage* const srcImage, const IGPUIma
         // probably validate the offsets, and extents
     }
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CBlitImageCmd>(m_commandList, core::smart_refctd_ptr<const IGPUImage>(srcImage), core::smart_refctd_ptr<const IGPUImage>(dstImage)))
+    if (!recordResources<IGPUCommandPool::CBlitImageCmd>(srcImage,dstImage))
         return false;
 
     m_noCommands = false;
@@ -1380,7 +1425,7 @@ bool IGPUCommandBuffer::resolveImage(const IGPUImage* const srcImage, const IGPU
     if (srcParams.format!=dstParams.format)
         return false;
 
-    if (!m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CResolveImageCmd>(m_commandList, core::smart_refctd_ptr<const IGPUImage>(srcImage), core::smart_refctd_ptr<const IGPUImage>(dstImage)))
+    if (!recordResources<IGPUCommandPool::CResolveImageCmd>(srcImage,dstImage))
         return false;
 
     m_noCommands = false;
@@ -1401,11 +1446,19 @@ bool IGPUCommandBuffer::executeCommands(const uint32_t count, IGPUCommandBuffer*
             return false;
     }
 
-    auto cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CExecuteCommandsCmd>(m_commandList,count);
-    if (!cmd)
-        return false;
-    for (auto i=0u; i<count; i++)
-        cmd->getVariableCountResources()[i] = core::smart_refctd_ptr<const core::IReferenceCounted>(cmdbufs[i]);
+    if (m_resourceTracking==RESOURCE_TRACKING::DEDUPLICATED)
+    {
+        for (auto i=0u; i<count; i++)
+            trackResource(cmdbufs[i]);
+    }
+    else
+    {
+        auto cmd = m_cmdpool->m_commandListPool.emplace<IGPUCommandPool::CExecuteCommandsCmd>(m_commandList,count);
+        if (!cmd)
+            return false;
+        for (auto i=0u; i<count; i++)
+            cmd->getVariableCountResources()[i] = core::smart_refctd_ptr<const core::IReferenceCounted>(cmdbufs[i]);
+    }
     m_noCommands = false;
     return executeCommands_impl(count,cmdbufs);
 }
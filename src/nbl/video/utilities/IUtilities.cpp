@@ -1,6 +1,8 @@
 #include "nbl/video/utilities/IUtilities.h"
 #include "nbl/video/utilities/ImageRegionIterator.h"
-//#include <numeric>
+#include "nbl/core/execution.h"
+
+#include <numeric>
 
 namespace nbl::video
 {
@@ -68,6 +70,10 @@ bool IUtilities::updateImageViaStagingBuffer(
 
     core::vector<asset::IImage::SBufferCopy> regionsToCopy;
 
+    // same early submit heuristic as `updateBufferRangeViaStagingBuffer`
+    const size_t earlySubmitSize = intendedNextSubmit.scratchCommandBuffers.size()>1 ? (m_defaultUploadBuffer->get_total_size()/2):(~0ull);
+    size_t recordedSinceSubmit = 0ull;
+
     // Worst case iterations: remaining blocks --> remaining rows --> remaining slices --> full layers
     const uint32_t maxIterations = regions.size() * 4u;
 
@@ -86,7 +92,8 @@ bool IUtilities::updateImageViaStagingBuffer(
         }
 
         uint32_t localOffset = video::StreamingTransientDataBufferMT<>::invalid_value;
-        uint32_t maxFreeBlock = m_defaultUploadBuffer.get()->max_size();
+        // stop at the next early submit, otherwise the first chunk takes the whole staging buffer and nothing can be filled while it's in flight
+        uint32_t maxFreeBlock = core::min<size_t>(m_defaultUploadBuffer.get()->max_size(), earlySubmitSize-recordedSinceSubmit);
         const uint32_t allocationSize = getAllocationSizeForStreamingBuffer(memoryNeededForRemainingRegions, m_allocationAlignmentForBufferImageCopy, maxFreeBlock, memoryLowerBound);
         // cannot use `multi_place` because of the extra padding size we could have added
         m_defaultUploadBuffer.get()->multi_allocate(std::chrono::steady_clock::now()+std::chrono::microseconds(500u), 1u, &localOffset, &allocationSize, &m_allocationAlignmentForBufferImageCopy);
@@ -98,11 +105,11 @@ bool IUtilities::updateImageViaStagingBuffer(
             const auto completed = intendedNextSubmit.getFutureScratchSemaphore();
             intendedNextSubmit.overflowSubmit(scratch);
             // overflowSubmit no longer blocks for the last submit to have completed, so we must do it ourselves here
-            // TODO: if we cleverly overflowed BEFORE completely running out of memory (better heuristics) then we wouldn't need to do this and some CPU-GPU overlap could be achieved
             if (intendedNextSubmit.overflowCallback)
                 intendedNextSubmit.overflowCallback(completed);
-            m_device->blockForSemaphores({&completed,1});
+            blockForStagingMemory(completed);
             m_defaultUploadBuffer->cull_frees(); // is this even needed anymore?
+            recordedSinceSubmit = 0ull;
             continue;
         }
         else
@@ -111,6 +118,8 @@ bool IUtilities::updateImageViaStagingBuffer(
             uint32_t availableUploadBufferMemory = allocationSize;
 
             regionsToCopy.clear();
+            // the image filters doing the copies are already parallel, we just count
+            const auto copyStart = std::chrono::steady_clock::now();
             for (uint32_t d = 0u; d < maxIterations && !regionIterator.isFinished(); ++d)
             {
                 asset::IImage::SBufferCopy nextRegionToCopy = {};
@@ -122,6 +131,11 @@ bool IUtilities::updateImageViaStagingBuffer(
                     break;
             }
 
+            const auto consumedMemory = allocationSize - availableUploadBufferMemory;
+            m_stagingStats.bytesStaged.fetch_add(consumedMemory,std::memory_order_relaxed);
+            m_stagingStats.stagingNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-copyStart).count(),std::memory_order_relaxed);
+            recordedSinceSubmit += consumedMemory;
+
             if (!regionsToCopy.empty())
                 scratch->cmdbuf->copyBufferToImage(m_defaultUploadBuffer.get()->getBuffer(), dstImage, currentDstImageLayout, regionsToCopy.size(), regionsToCopy.data());
 
@@ -130,7 +144,6 @@ bool IUtilities::updateImageViaStagingBuffer(
             // some platforms expose non-coherent host-visible GPU memory, so writes need to be flushed explicitly
             if (m_defaultUploadBuffer.get()->needsManualFlushOrInvalidate())
             {
-                const auto consumedMemory = allocationSize - availableUploadBufferMemory;
                 auto flushRange = AlignedMappedMemoryRange(m_defaultUploadBuffer.get()->getBuffer()->getBoundMemory().memory, localOffset, consumedMemory, limits.nonCoherentAtomSize);
                 m_device->flushMappedMemoryRanges(1u, &flushRange);
             }
@@ -138,10 +151,76 @@ bool IUtilities::updateImageViaStagingBuffer(
 
         // this doesn't actually free the memory, the memory is queued up to be freed only after the GPU fence/event is signalled
         m_defaultUploadBuffer.get()->multi_deallocate(1u,&localOffset,&allocationSize,intendedNextSubmit.getFutureScratchSemaphore()); // can queue with a reset but not yet pending fence, just fine
+        // don't make the GPU sit idle until we run out of staging memory
+        if (recordedSinceSubmit>=earlySubmitSize && !regionIterator.isFinished())
+        {
+            if (intendedNextSubmit.overflowSubmit(scratch)!=IQueue::RESULT::SUCCESS)
+                return false;
+            m_stagingStats.earlySubmits.fetch_add(1u,std::memory_order_relaxed);
+            recordedSinceSubmit = 0ull;
+        }
     }
     return true;
 }
 
+void IUtilities::copyToStagingMemory(void* dst, const void* src, const size_t size) const
+{
+    const bool nonTemporal = m_uploadBufferWriteCombined;
+    auto copyChunk = [nonTemporal](uint8_t* out, const uint8_t* in, size_t bytes) -> void
+    {
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+        if (nonTemporal && bytes>=256u)
+        {
+            // streaming stores need a 16 byte aligned destination
+            const size_t head = (16u-(reinterpret_cast<uintptr_t>(out)&15u))&15u;
+            memcpy(out,in,head);
+            out += head;
+            in += head;
+            bytes -= head;
+            for (; bytes>=64u; bytes-=64u,out+=64u,in+=64u)
+            {
+                const __m128i* in128 = reinterpret_cast<const __m128i*>(in);
+                __m128i* out128 = reinterpret_cast<__m128i*>(out);
+                const __m128i a = _mm_loadu_si128(in128+0);
+                const __m128i b = _mm_loadu_si128(in128+1);
+                const __m128i c = _mm_loadu_si128(in128+2);
+                const __m128i d = _mm_loadu_si128(in128+3);
+                _mm_stream_si128(out128+0,a);
+                _mm_stream_si128(out128+1,b);
+                _mm_stream_si128(out128+2,c);
+                _mm_stream_si128(out128+3,d);
+            }
+            memcpy(out,in,bytes);
+            // streaming stores are weakly ordered, need them visible before anyone submits
+            _mm_sfence();
+            return;
+        }
+#endif
+        memcpy(out,in,bytes);
+    };
+
+    auto* const out = reinterpret_cast<uint8_t*>(dst);
+    const auto* const in = reinterpret_cast<const uint8_t*>(src);
+    if (size<ParallelStagingCopyThreshold)
+    {
+        copyChunk(out,in,size);
+        return;
+    }
+
+    constexpr uint32_t MaxChunks = 64u;
+    const uint32_t chunkCount = static_cast<uint32_t>(core::min<size_t>(size/ParallelStagingCopyMinChunk,MaxChunks));
+    const size_t chunkSize = core::alignUp((size-1ull)/chunkCount+1ull,64ull);
+    std::array<uint32_t,MaxChunks> chunks;
+    std::iota(chunks.begin(),chunks.begin()+chunkCount,0u);
+    core::for_each(core::execution::par,chunks.begin(),chunks.begin()+chunkCount,[&](const uint32_t chunk)->void
+        {
+            const size_t offset = chunk*chunkSize;
+            if (offset<size)
+                copyChunk(out+offset,in+offset,core::min(chunkSize,size-offset));
+        }
+    );
+}
+
 bool IUtilities::downloadImageViaStagingBuffer(
     SIntendedSubmitInfo& intendedNextSubmit, const IGPUImage* srcImage, const IGPUImage::LAYOUT currentSrcImageLayout,
     void* dest, const std::span<const asset::IImage::SBufferCopy> regions
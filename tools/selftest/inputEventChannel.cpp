@@ -0,0 +1,117 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "selftest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace nbl;
+using namespace nbl::ui;
+
+namespace
+{
+using replay_clock_t = std::chrono::steady_clock;
+
+inline std::chrono::microseconds now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(replay_clock_t::now().time_since_epoch());
+}
+
+// the sequence number of an event is split across the two movement components
+inline SMouseEvent createEvent(const uint32_t sequence)
+{
+	SMouseEvent ev(now());
+	ev.type = SMouseEvent::EET_MOVEMENT;
+	ev.movementEvent.relativeMovementX = int16_t(sequence&0xffffu);
+	ev.movementEvent.relativeMovementY = int16_t(sequence>>16u);
+	ev.window = nullptr;
+	return ev;
+}
+inline uint32_t getSequence(const SMouseEvent& ev)
+{
+	return uint32_t(uint16_t(ev.movementEvent.relativeMovementX))|(uint32_t(uint16_t(ev.movementEvent.relativeMovementY))<<16u);
+}
+
+struct SReplayStats
+{
+	core::vector<uint32_t> latencies;
+	uint64_t frontOverflows = 0ull;
+	uint32_t nextSequence = 0u;
+	uint32_t outOfOrder = 0u;
+};
+// `CChannelConsumer` keeps its functor to itself, so the results go elsewhere
+struct SReplayConsumer
+{
+	inline void overflow(const uint64_t count, const IMouseEventChannel* channel)
+	{
+		stats->frontOverflows += count;
+	}
+	inline void operator()(const IMouseEventChannel::range_t& events, const IMouseEventChannel* channel)
+	{
+		const auto received = now();
+		for (const auto& ev : events)
+		{
+			const uint32_t sequence = getSequence(ev);
+			// drops leave gaps, but the order must be kept
+			stats->outOfOrder += sequence<stats->nextSequence;
+			stats->nextSequence = sequence+1u;
+			stats->latencies.push_back(uint32_t((received-ev.timeStamp).count()));
+		}
+	}
+
+	SReplayStats* stats;
+};
+}
+
+namespace nbl::selftest
+{
+
+// Headless replay of synthetic mouse events through an input channel, one thread pushes like an OS event loop would while another consumes
+bool inputEventsPerSecond()
+{
+	constexpr uint32_t EventCount = 0x1u<<22;
+	// same as the Win32 windows use
+	constexpr size_t Capacity = 256ull;
+
+	SReplayStats stats;
+	stats.latencies.reserve(EventCount);
+	auto channel = core::make_smart_refctd_ptr<IMouseEventChannel>(Capacity);
+	auto consumer = core::make_smart_refctd_ptr<IMouseEventChannel::CChannelConsumer<SReplayConsumer>>(SReplayConsumer{&stats},core::smart_refctd_ptr<IMouseEventChannel>(channel));
+
+	std::atomic_bool producerDone = false;
+	uint32_t dropped = 0u;
+	const auto start = replay_clock_t::now();
+	std::thread producer([&]() -> void
+		{
+			for (uint32_t i=0u; i<EventCount; i++)
+			if (!channel->pushIntoBackground(createEvent(i)))
+				dropped++;
+			producerDone.store(true,std::memory_order_release);
+		}
+	);
+	while (!producerDone.load(std::memory_order_acquire))
+		(*consumer)();
+	producer.join();
+	(*consumer)();
+	const double seconds = std::chrono::duration<double>(replay_clock_t::now()-start).count();
+
+	bool ok = true;
+	const uint64_t received = stats.latencies.size();
+	ok &= NBL_SELFTEST_CHECK(received+dropped==EventCount);
+	ok &= NBL_SELFTEST_CHECK(channel->getDroppedEventCount()==dropped);
+	ok &= NBL_SELFTEST_CHECK(stats.outOfOrder==0u && stats.frontOverflows==0ull);
+	if (!ok || received==0ull)
+		return false;
+
+	std::sort(stats.latencies.begin(),stats.latencies.end());
+	auto percentile = [&](const double p) -> uint32_t {return stats.latencies[size_t(p*double(received-1ull))];};
+	std::cout << "input event replay: " << double(EventCount)/seconds*1e-6 << " Mevents/s pushed, " << double(received)/seconds*1e-6 << " Mevents/s received, "
+		<< dropped << " dropped by a ring of " << Capacity << std::endl;
+	std::cout << "input event latency: median " << percentile(0.5) << "us, p99 " << percentile(0.99) << "us, max " << stats.latencies.back() << "us" << std::endl;
+	return true;
+}
+
+}
@@ -0,0 +1,68 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "selftest.h"
+
+#include <argparse/argparse.hpp>
+
+using namespace nbl;
+
+namespace
+{
+struct SEntry
+{
+	std::string_view name;
+	// "test" entries check correctness, "perf" ones measure throughput and only fail if the measured work went wrong
+	std::string_view group;
+	bool(*run)();
+};
+constexpr SEntry tests[] = {
+	{"materialCompilerIR","test",selftest::materialCompilerIR},
+	{"meshBVH","test",selftest::meshBVH},
+	{"inputEventsPerSecond","perf",selftest::inputEventsPerSecond},
+	{"meshBVHRaysPerSecond","perf",selftest::meshBVHRaysPerSecond},
+	{"quantNormalsPerSecond","perf",selftest::quantNormalsPerSecond}
+};
+}
+
+int main(int argc, char* argv[])
+{
+	argparse::ArgumentParser program("Runs self-checking tests of engine internals which do not need a GPU");
+	program.add_argument("--test")
+		.help("Name of the test to run regardless of its group, all of the group's tests get run if omitted");
+	program.add_argument("--group")
+		.default_value(std::string("test"))
+		.help("Group of tests to run, \"test\" or \"perf\"");
+
+	try
+	{
+		program.parse_args(argc, argv);
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << err.what() << std::endl << program;
+		return 1;
+	}
+
+	const auto only = program.present<std::string>("--test");
+	const auto group = program.get<std::string>("--group");
+	bool found = false;
+	bool passed = true;
+	for (const auto& entry : tests)
+	{
+		if (only.has_value() ? only.value()!=entry.name:group!=entry.group)
+			continue;
+		found = true;
+
+		const bool ok = entry.run();
+		std::cout << (ok ? "[PASSED] ":"[FAILED] ") << entry.name << std::endl;
+		passed = passed && ok;
+	}
+
+	if (!found)
+	{
+		std::cerr << "No test named " << only.value_or(group) << std::endl;
+		return 1;
+	}
+	return passed ? 0:1;
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "selftest.h"
+
+#include "nbl/asset/material_compiler/IR.h"
+
+using namespace nbl;
+using namespace nbl::asset::material_compiler;
+
+namespace
+{
+using INode = IR::INode;
+
+// the IR only compares texture sources, so they don't need to reference any actual images
+INode* createTexturedDiffuse(IR* ir)
+{
+	auto* diffuse = ir->allocNode<IR::CMicrofacetDiffuseBSDFNode>();
+	diffuse->setSmooth();
+	diffuse->reflectance = INode::STextureSource{nullptr,nullptr,1.f};
+	return diffuse;
+}
+INode* createConductor(IR* ir)
+{
+	auto* conductor = ir->allocNode<IR::CMicrofacetSpecularBSDFNode>();
+	conductor->setSmooth();
+	return conductor;
+}
+INode* createBlendedTree(IR* ir)
+{
+	auto* blend = ir->allocNode<IR::CBSDFBlendNode>();
+	blend->weight = INode::color_t(0.5f);
+	blend->children = INode::createChildrenArray(createTexturedDiffuse(ir),createConductor(ir));
+	return blend;
+}
+INode* createCoatedTree(IR* ir)
+{
+	auto* coating = ir->allocNode<IR::CMicrofacetCoatingBSDFNode>();
+	coating->setSmooth();
+	coating->children = INode::createChildrenArray(createTexturedDiffuse(ir));
+	return coating;
+}
+
+void collectTree(const INode* root, core::unordered_set<const INode*>& out)
+{
+	out.insert(root);
+	for (const INode* child : root->children)
+		collectTree(child,out);
+}
+}
+
+namespace nbl::selftest
+{
+
+// Two different roots which both contain an equivalent textured diffuse BSDF, backends assign texture prefetch
+// registers per root so the roots must not end up sharing that node (or any other).
+bool materialCompilerIR()
+{
+	bool ok = true;
+	auto ir = core::make_smart_refctd_ptr<IR>();
+
+	INode* blended = ir->addRootNode(createBlendedTree(ir.get()));
+	INode* coated = ir->addRootNode(createCoatedTree(ir.get()));
+	ok &= NBL_SELFTEST_CHECK(blended!=coated);
+	ok &= NBL_SELFTEST_CHECK(ir->roots.size()==2u);
+
+	core::unordered_set<const INode*> blendedNodes, coatedNodes;
+	collectTree(blended,blendedNodes);
+	collectTree(coated,coatedNodes);
+	ok &= NBL_SELFTEST_CHECK(blendedNodes.size()==3u && coatedNodes.size()==2u);
+	for (const INode* node : coatedNodes)
+		ok &= NBL_SELFTEST_CHECK(blendedNodes.find(node)==blendedNodes.end());
+
+	// a whole duplicate tree is the only thing which gets shared
+	ok &= NBL_SELFTEST_CHECK(ir->addRootNode(createBlendedTree(ir.get()))==blended);
+	ok &= NBL_SELFTEST_CHECK(ir->addRootNode(createCoatedTree(ir.get()))==coated);
+	ok &= NBL_SELFTEST_CHECK(ir->roots.size()==2u);
+
+	// same structure but a different texture is a different material
+	auto* otherTexture = static_cast<IR::CMicrofacetDiffuseBSDFNode*>(createTexturedDiffuse(ir.get()));
+	otherTexture->reflectance = INode::STextureSource{nullptr,nullptr,2.f};
+	auto* otherCoating = ir->allocNode<IR::CMicrofacetCoatingBSDFNode>();
+	otherCoating->setSmooth();
+	otherCoating->children = INode::createChildrenArray(otherTexture);
+	ok &= NBL_SELFTEST_CHECK(ir->addRootNode(otherCoating)==otherCoating);
+	ok &= NBL_SELFTEST_CHECK(ir->roots.size()==3u);
+
+	// copies are shallow, they reference the same children
+	INode* copy = ir->copyNode(coated);
+	ok &= NBL_SELFTEST_CHECK(copy && copy!=coated && copy->children[0]==coated->children[0]);
+
+	return ok;
+}
+
+}
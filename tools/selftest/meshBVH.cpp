@@ -0,0 +1,244 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "selftest.h"
+
+#include "nbl/asset/utils/CMeshBVH.h"
+
+#include <chrono>
+#include <random>
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+struct STriangleSoup
+{
+	core::vector<uint32_t> indices;
+	core::vector<core::vectorSIMDf> positions;
+};
+// small random triangles in a cube, plus a few big ones lying exactly in axis aligned planes
+STriangleSoup createTriangleSoup(std::mt19937& rng, const uint32_t count, const float size)
+{
+	std::uniform_real_distribution<float> dist(-1.f,1.f);
+	STriangleSoup soup;
+	auto addTriangle = [&](const core::vectorSIMDf& a, const core::vectorSIMDf& b, const core::vectorSIMDf& c) -> void
+	{
+		for (const auto& p : {a,b,c})
+		{
+			soup.indices.push_back(uint32_t(soup.positions.size()));
+			soup.positions.push_back(p);
+		}
+	};
+	for (uint32_t i=0u; i<count; i++)
+	{
+		const core::vectorSIMDf center(dist(rng)*10.f,dist(rng)*10.f,dist(rng)*10.f);
+		auto vertex = [&]() -> core::vectorSIMDf {return center+core::vectorSIMDf(dist(rng),dist(rng),dist(rng))*size;};
+		addTriangle(vertex(),vertex(),vertex());
+	}
+	addTriangle(core::vectorSIMDf(-12.f,-11.f,-12.f),core::vectorSIMDf(12.f,-11.f,-12.f),core::vectorSIMDf(0.f,-11.f,12.f));
+	addTriangle(core::vectorSIMDf(-11.f,-12.f,-12.f),core::vectorSIMDf(-11.f,12.f,-12.f),core::vectorSIMDf(-11.f,0.f,12.f));
+	addTriangle(core::vectorSIMDf(-12.f,-12.f,11.f),core::vectorSIMDf(12.f,-12.f,11.f),core::vectorSIMDf(0.f,12.f,11.f));
+	return soup;
+}
+
+// Möller-Trumbore against every triangle in double precision, rays which come close to an edge or to a second hit
+// at almost the same distance are ambiguous in single precision and don't get compared
+struct SReference
+{
+	double t = DBL_MAX;
+	bool hit = false;
+	bool ambiguous = false;
+};
+SReference intersectBruteForce(const STriangleSoup& soup, const IBVH::SRay& ray)
+{
+	using vec_t = std::array<double,3>;
+	auto toDouble = [](const core::vectorSIMDf& v) -> vec_t {return {v.x,v.y,v.z};};
+	auto sub = [](const vec_t& a, const vec_t& b) -> vec_t {return {a[0]-b[0],a[1]-b[1],a[2]-b[2]};};
+	auto dot = [](const vec_t& a, const vec_t& b) -> double {return a[0]*b[0]+a[1]*b[1]+a[2]*b[2];};
+	auto cross = [](const vec_t& a, const vec_t& b) -> vec_t {return {a[1]*b[2]-a[2]*b[1],a[2]*b[0]-a[0]*b[2],a[0]*b[1]-a[1]*b[0]};};
+	constexpr double Epsilon = 1e-4;
+
+	const vec_t origin = toDouble(ray.origin);
+	const vec_t direction = toDouble(ray.direction);
+	SReference retval;
+	double secondT = DBL_MAX;
+	double ambiguousT = DBL_MAX;
+	for (size_t i=0ull; i<soup.indices.size(); i+=3ull)
+	{
+		const vec_t v0 = toDouble(soup.positions[soup.indices[i]]);
+		const vec_t edge1 = sub(toDouble(soup.positions[soup.indices[i+1ull]]),v0);
+		const vec_t edge2 = sub(toDouble(soup.positions[soup.indices[i+2ull]]),v0);
+		const vec_t p = cross(direction,edge2);
+		const double det = dot(edge1,p);
+		if (det==0.0)
+			continue;
+		const vec_t s = sub(origin,v0);
+		const double u = dot(s,p)/det;
+		const vec_t q = cross(s,edge1);
+		const double v = dot(direction,q)/det;
+		const double t = dot(edge2,q)/det;
+		const double margin = std::min({u,v,1.0-u-v});
+		if (margin<-Epsilon || t<ray.tMin-Epsilon || t>ray.tMax+Epsilon)
+			continue;
+		if (margin<Epsilon || std::abs(t-ray.tMin)<Epsilon || std::abs(t-ray.tMax)<Epsilon)
+		{
+			ambiguousT = std::min(ambiguousT,t);
+			continue;
+		}
+		if (t<retval.t)
+		{
+			secondT = retval.t;
+			retval.t = t;
+		}
+		else
+			secondT = std::min(secondT,t);
+		retval.hit = true;
+	}
+	// an ambiguous hit further away than the closest clean one doesn't matter
+	if (retval.hit)
+	{
+		const double tolerance = Epsilon*std::max(1.0,retval.t);
+		retval.ambiguous = ambiguousT-retval.t<tolerance || secondT-retval.t<tolerance;
+	}
+	else
+		retval.ambiguous = ambiguousT!=DBL_MAX;
+	return retval;
+}
+
+core::vector<IBVH::SRay> createRays(std::mt19937& rng, const uint32_t count)
+{
+	std::uniform_real_distribution<float> dist(-1.f,1.f);
+	core::vector<IBVH::SRay> rays(count);
+	for (uint32_t i=0u; i<count; i++)
+	{
+		auto& ray = rays[i];
+		ray.origin = core::vectorSIMDf(dist(rng),dist(rng),dist(rng))*14.f;
+		ray.direction = core::vectorSIMDf(dist(rng),dist(rng),dist(rng));
+		switch (i%4u)
+		{
+			// axis aligned, the slab test divides by the zero components
+			case 1u:
+				ray.direction = core::vectorSIMDf(0.f);
+				ray.direction.pointer[i/4u%3u] = dist(rng)<0.f ? -1.f:1.f;
+				break;
+			// same with negative zeroes, whose reciprocals are -inf instead of +inf
+			case 2u:
+				ray.direction = core::vectorSIMDf(-0.f);
+				ray.direction.pointer[i/4u%3u] = dist(rng)<0.f ? -1.f:1.f;
+				ray.direction.pointer[(i/4u+1u)%3u] = i%8u<4u ? 0.f:-0.f;
+				break;
+			// a finite interval
+			case 3u:
+				ray.tMin = 0.25f;
+				ray.tMax = 2.f;
+				break;
+			default:
+				break;
+		}
+	}
+	return rays;
+}
+}
+
+namespace nbl::selftest
+{
+
+// closest hit, any hit and the batched queries against brute force
+bool meshBVH()
+{
+	bool ok = true;
+	std::mt19937 rng(0x45u);
+	const auto soup = createTriangleSoup(rng,3000u,0.5f);
+	for (const uint32_t maxLeafSize : {1u,4u,13u})
+	{
+		IBVH::SBuildParams params;
+		params.maxLeafSize = maxLeafSize;
+		const auto bvh = CMeshBVH::create(soup.indices,soup.positions,params);
+		if (!NBL_SELFTEST_CHECK(bvh && bvh->getTriangleCount()==soup.indices.size()/3ull))
+			return false;
+
+		const auto rays = createRays(rng,4000u);
+		core::vector<IBVH::SHit> batchHits(rays.size());
+		core::vector<uint8_t> batchOccluded(rays.size());
+		bvh->intersect(rays,batchHits.data());
+		bvh->occluded(rays,batchOccluded.data());
+
+		uint32_t compared = 0u, hits = 0u, mismatches = 0u;
+		for (size_t i=0ull; i<rays.size(); i++)
+		{
+			const auto& ray = rays[i];
+			IBVH::SHit hit;
+			const bool intersected = bvh->intersect(ray,hit);
+			const bool occluded = bvh->occluded(ray);
+			// the batched queries run the same code, so they have to agree exactly
+			ok &= NBL_SELFTEST_CHECK(batchHits[i].valid()==intersected && (!intersected || batchHits[i].t==hit.t && batchHits[i].primitiveID==hit.primitiveID));
+			ok &= NBL_SELFTEST_CHECK(bool(batchOccluded[i])==occluded);
+			ok &= NBL_SELFTEST_CHECK(intersected==hit.valid());
+
+			const auto reference = intersectBruteForce(soup,ray);
+			if (reference.ambiguous)
+				continue;
+			compared++;
+			hits += reference.hit;
+			const bool match = intersected==reference.hit && occluded==reference.hit && (!reference.hit || std::abs(hit.t-reference.t)<=1e-4*std::max(1.0,reference.t));
+			if (!match && mismatches++<8u)
+				std::cerr << "meshBVH: ray " << i << " (maxLeafSize " << maxLeafSize << ") hit " << intersected << " occluded " << occluded << " t " << hit.t
+					<< ", brute force hit " << reference.hit << " t " << reference.t << std::endl;
+		}
+		ok &= NBL_SELFTEST_CHECK(mismatches==0u);
+		// make sure the rays actually test something
+		ok &= NBL_SELFTEST_CHECK(compared>rays.size()*9u/10u && hits>compared/8u && hits<compared);
+	}
+
+	// the triangle lies in the plane the ray's zero components make degenerate
+	{
+		const core::vector<core::vectorSIMDf> positions = {core::vectorSIMDf(-1.f,-1.f,0.f),core::vectorSIMDf(1.f,-1.f,0.f),core::vectorSIMDf(0.f,1.f,0.f)};
+		const core::vector<uint32_t> indices = {0u,1u,2u};
+		const auto bvh = CMeshBVH::create(indices,positions,{});
+		for (const float zero : {0.f,-0.f})
+		{
+			IBVH::SRay ray;
+			ray.origin = core::vectorSIMDf(0.f,0.f,-5.f);
+			ray.direction = core::vectorSIMDf(zero,zero,1.f);
+			IBVH::SHit hit;
+			ok &= NBL_SELFTEST_CHECK(bvh->intersect(ray,hit) && hit.t==5.f && hit.primitiveID==0u);
+			ok &= NBL_SELFTEST_CHECK(bvh->occluded(ray));
+		}
+	}
+	return ok;
+}
+
+// throughput of the batched closest hit and any hit queries on a larger scene
+bool meshBVHRaysPerSecond()
+{
+	std::mt19937 rng(0x50u);
+	const auto soup = createTriangleSoup(rng,500000u,0.05f);
+	IBVH::SStatistics stats;
+	const auto bvh = CMeshBVH::create(soup.indices,soup.positions,{},&stats);
+	if (!NBL_SELFTEST_CHECK(bvh))
+		return false;
+	std::cout << "CMeshBVH build: " << stats.primitiveCount << " triangles, " << stats.getPrimitivesPerSecond()*1e-6 << " Mtris/s, SAH cost " << stats.sahCost << std::endl;
+
+	const auto rays = createRays(rng,1000000u);
+	core::vector<IBVH::SHit> hits(rays.size());
+	core::vector<uint8_t> occluded(rays.size());
+	auto measure = [&](const char* name, auto&& query) -> void
+	{
+		const auto start = std::chrono::steady_clock::now();
+		query();
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+		std::cout << "CMeshBVH " << name << ": " << double(rays.size())/seconds*1e-6 << " Mrays/s" << std::endl;
+	};
+	measure("intersect",[&]() -> void {bvh->intersect(rays,hits.data());});
+	measure("occluded",[&]() -> void {bvh->occluded(rays,occluded.data());});
+
+	// the numbers only mean something if both queries agree
+	bool ok = true;
+	for (size_t i=0ull; i<rays.size(); i++)
+		ok &= hits[i].valid()==bool(occluded[i]);
+	return NBL_SELFTEST_CHECK(ok);
+}
+
+}
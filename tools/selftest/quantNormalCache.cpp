@@ -0,0 +1,80 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#include "selftest.h"
+
+#include "nbl/asset/utils/CQuantNormalCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+core::vector<core::vectorSIMDf> createNormals(const uint32_t count)
+{
+	std::mt19937 rng(0x45u);
+	std::normal_distribution<float> dist;
+	core::vector<core::vectorSIMDf> normals(count);
+	for (auto& normal : normals)
+	{
+		const float x = dist(rng);
+		const float y = dist(rng);
+		const float z = dist(rng);
+		normal = core::normalize(core::vectorSIMDf(x,y,z));
+	}
+	return normals;
+}
+
+template<E_FORMAT Format>
+bool measureFormat(const char* name, const uint32_t count)
+{
+	using value_t = CQuantNormalCache::value_type_t<Format>;
+	const auto normals = createNormals(count);
+	auto seconds = [](const auto start) -> double {return std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();};
+
+	// every direction misses the cache the first time around and hits it the second time
+	CQuantNormalCache batchCache;
+	core::vector<value_t> batch(count), batchWarm(count);
+	auto start = std::chrono::steady_clock::now();
+	batchCache.quantize<Format>(normals,batch.data());
+	const double batchCold = seconds(start);
+	start = std::chrono::steady_clock::now();
+	batchCache.quantize<Format>(normals,batchWarm.data());
+	const double batchHot = seconds(start);
+
+	CQuantNormalCache singleCache;
+	core::vector<value_t> single(count);
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i=0u; i<count; i++)
+		single[i] = singleCache.quantize<Format>(normals[i]);
+	const double singleCold = seconds(start);
+
+	std::cout << "CQuantNormalCache " << name << " (" << count << " normals): batch " << double(count)/batchCold*1e-6 << " M/s cold, "
+		<< double(count)/batchHot*1e-6 << " M/s warm, one by one " << double(count)/singleCold*1e-6 << " M/s cold" << std::endl;
+
+	// the numbers only mean something if all the ways of quantizing agree
+	bool ok = true;
+	for (uint32_t i=0u; i<count; i++)
+		ok &= memcmp(&batch[i],&batchWarm[i],sizeof(value_t))==0 && memcmp(&batch[i],&single[i],sizeof(value_t))==0;
+	return NBL_SELFTEST_CHECK(ok);
+}
+}
+
+namespace nbl::selftest
+{
+
+// the best fit search is linear in the largest representable component, so the wider formats get fewer normals
+bool quantNormalsPerSecond()
+{
+	bool ok = true;
+	ok &= measureFormat<EF_R8G8B8_SNORM>("8bit",0x1u<<20);
+	ok &= measureFormat<EF_A2B10G10R10_SNORM_PACK32>("10bit",0x1u<<18);
+	ok &= measureFormat<EF_R16G16B16_SNORM>("16bit",0x1u<<12);
+	return ok;
+}
+
+}
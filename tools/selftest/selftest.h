@@ -0,0 +1,34 @@
+// Copyright (C) 2018-2024 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+#ifndef _NBL_TOOLS_SELFTEST_H_INCLUDED_
+#define _NBL_TOOLS_SELFTEST_H_INCLUDED_
+
+#include "nabla.h"
+
+#include <iostream>
+
+namespace nbl::selftest
+{
+
+//! Reports a failed expectation without stopping, so one run lists every broken check
+inline bool check(const bool condition, const char* expression, const char* file, const int line)
+{
+	if (!condition)
+		std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+	return condition;
+}
+#define NBL_SELFTEST_CHECK(...) (::nbl::selftest::check(static_cast<bool>(__VA_ARGS__),#__VA_ARGS__,__FILE__,__LINE__))
+
+// every test returns whether all of its checks passed
+bool materialCompilerIR();
+bool meshBVH();
+
+// perf tests print what they measured
+bool inputEventsPerSecond();
+bool meshBVHRaysPerSecond();
+bool quantNormalsPerSecond();
+
+}
+
+#endif